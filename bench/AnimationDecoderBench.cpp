@@ -0,0 +1,98 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "Resources.h"
+#include "SkAnimationDecoder.h"
+#include "SkBitmap.h"
+#include "SkCodec.h"
+#include "SkData.h"
+
+// Plays an animated image through once, pulling every frame in order, starting from nothing
+// decoded.  Frames per second is the frame count over the time per loop.
+//   sequential: one SkCodec on this thread, handing each frame its required frame.
+//   predecoded: SkAnimationDecoder, which decodes ahead on SkTaskGroup threads.
+class AnimationDecoderBench : public Benchmark {
+public:
+    AnimationDecoderBench(const char* filename, bool predecode)
+        : fFilename(filename)
+        , fPredecode(predecode)
+    {
+        fName.printf("AnimationDecode_%s_%s", filename, predecode ? "predecoded" : "sequential");
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fData = GetResourceAsData(fFilename);
+        std::unique_ptr<SkCodec> codec(SkCodec::NewFromData(fData));
+        SkASSERT(codec);
+        fInfo = codec->getInfo().makeColorType(kN32_SkColorType);
+        if (kUnpremul_SkAlphaType == fInfo.alphaType()) {
+            fInfo = fInfo.makeAlphaType(kPremul_SkAlphaType);
+        }
+        fFrameInfos = codec->getFrameInfo();
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            if (fPredecode) {
+                this->playPredecoded();
+            } else {
+                this->playSequential();
+            }
+        }
+    }
+
+private:
+    void playPredecoded() {
+        auto decoder = SkAnimationDecoder::Make(fData);
+        SkASSERT(decoder);
+        SkBitmap frame;
+        for (size_t i = 0; i < decoder->frameCount(); i++) {
+            SkAssertResult(decoder->getFrame(i, &frame));
+        }
+    }
+
+    void playSequential() {
+        std::unique_ptr<SkCodec> codec(SkCodec::NewFromData(fData));
+        std::vector<SkBitmap> frames(fFrameInfos.size());
+        for (size_t i = 0; i < fFrameInfos.size(); i++) {
+            SkCodec::Options options;
+            options.fFrameIndex = i;
+            const size_t required = fFrameInfos[i].fRequiredFrame;
+            options.fHasPriorFrame = SkCodec::kNone != required;
+            if (options.fHasPriorFrame) {
+                frames[required].copyTo(&frames[i]);
+            } else {
+                frames[i].allocPixels(fInfo);
+            }
+#ifdef SK_DEBUG
+            const SkCodec::Result result =
+#endif
+            codec->getPixels(fInfo, frames[i].getPixels(), frames[i].rowBytes(), &options,
+                             nullptr, nullptr);
+            SkASSERT(SkCodec::kSuccess == result || SkCodec::kIncompleteInput == result);
+        }
+    }
+
+    const char*                     fFilename;
+    const bool                      fPredecode;
+    SkString                        fName;
+    sk_sp<SkData>                   fData;
+    SkImageInfo                     fInfo;
+    std::vector<SkCodec::FrameInfo> fFrameInfos;
+};
+
+DEF_BENCH(return new AnimationDecoderBench("randPixelsAnim.gif", false);)
+DEF_BENCH(return new AnimationDecoderBench("randPixelsAnim.gif", true);)
+DEF_BENCH(return new AnimationDecoderBench("test640x479.gif", false);)
+DEF_BENCH(return new AnimationDecoderBench("test640x479.gif", true);)
+DEF_BENCH(return new AnimationDecoderBench("colorTables.gif", false);)
+DEF_BENCH(return new AnimationDecoderBench("colorTables.gif", true);)
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkCanvas.h"
+#include "SkDeferredCanvas.h"
+#include "SkRRect.h"
+#include "SkString.h"
+#include "SkSurface.h"
+
+// Draws a UI-ish frame through SkDeferredCanvas: a background, a grid of cards, and then an
+// opaque panel that slides over half of them.  kLazy can skip the cards the panel hides.
+class DeferredCanvasBench : public Benchmark {
+public:
+    explicit DeferredCanvasBench(SkDeferredCanvas::EvalType evalType) : fEvalType(evalType) {
+        fName.printf("deferred_canvas_%s", SkDeferredCanvas::kLazy == evalType ? "lazy" : "eager");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        fSurface = SkSurface::MakeRasterN32Premul(1024, 768);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkPaint paint;
+        while (loops --> 0) {
+            SkDeferredCanvas canvas(fSurface->getCanvas(), fEvalType);
+            paint.setAntiAlias(false);
+            paint.setColor(0xFFEEEEEE);
+            canvas.drawRect(SkRect::MakeWH(1024, 768), paint);
+
+            for (int y = 0; y < 6; ++y) {
+                for (int x = 0; x < 8; ++x) {
+                    canvas.save();
+                    canvas.translate(x * 128.0f + 8, y * 128.0f + 8);
+                    paint.setAntiAlias(true);
+                    paint.setColor(0xFFFFFFFF);
+                    canvas.drawRRect(SkRRect::MakeRectXY(SkRect::MakeWH(112, 112), 8, 8), paint);
+                    paint.setColor(0xFF000000 | (x * 0x1F0000 + y * 0x2F00 + 0x80));
+                    canvas.drawOval(SkRect::MakeXYWH(8, 8, 40, 40), paint);
+                    paint.setAntiAlias(false);
+                    for (int line = 0; line < 4; ++line) {
+                        canvas.drawRect(SkRect::MakeXYWH(8, 56 + line * 12.0f, 96, 8), paint);
+                    }
+                    canvas.restore();
+                }
+            }
+
+            paint.setColor(0xFF303030);
+            canvas.drawRect(SkRect::MakeWH(512, 768), paint);
+        }
+    }
+
+private:
+    const SkDeferredCanvas::EvalType    fEvalType;
+    SkString                            fName;
+    sk_sp<SkSurface>                    fSurface;
+};
+
+DEF_BENCH(return new DeferredCanvasBench(SkDeferredCanvas::kEager);)
+DEF_BENCH(return new DeferredCanvasBench(SkDeferredCanvas::kLazy);)
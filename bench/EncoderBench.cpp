@@ -10,15 +10,18 @@
 #include "SkBitmap.h"
 #include "SkData.h"
 #include "SkImageEncoder.h"
+#include "SkImageEncoderPriv.h"
 
 #include "sk_tool_utils.h"
 
 class EncodeBench : public Benchmark {
 public:
-    EncodeBench(const char* filename, SkEncodedImageFormat type, int quality)
+    EncodeBench(const char* filename, SkEncodedImageFormat type, int quality,
+                bool parallel = false)
         : fFilename(filename)
         , fType(type)
         , fQuality(quality)
+        , fParallel(parallel)
     {
         // Set the name of the bench
         SkString name("Encode_");
@@ -38,7 +41,10 @@ public:
                 name.append("Unknown");
                 break;
         }
-        
+        if (parallel) {
+            name.append("_parallel");
+        }
+
         fName = name;
     }
 
@@ -55,6 +61,19 @@ public:
     }
 
     void onDraw(int loops, SkCanvas*) override {
+        if (fParallel) {
+            SkASSERT(SkEncodedImageFormat::kPNG == fType);
+            SkPixmap pixmap;
+            SkAssertResult(fBitmap.peekPixels(&pixmap));
+            SkEncodeOptions options;
+            options.fParallel = true;
+            for (int i = 0; i < loops; i++) {
+                SkDynamicMemoryWStream stream;
+                SkAssertResult(SkEncodeImageAsPNG(&stream, pixmap, options));
+            }
+            return;
+        }
+
         for (int i = 0; i < loops; i++) {
             sk_sp<SkData> data(sk_tool_utils::EncodeImageToData(fBitmap, fType, fQuality));
             SkASSERT(data);
@@ -65,6 +84,7 @@ private:
     const char*                fFilename;
     const SkEncodedImageFormat fType;
     const int                  fQuality;
+    const bool                 fParallel;
     SkString                   fName;
     SkBitmap                   fBitmap;
 };
@@ -78,6 +98,11 @@ DEF_BENCH(return new EncodeBench("color_wheel.jpg", SkEncodedImageFormat::kJPEG,
 DEF_BENCH(return new EncodeBench("mandrill_512.png", SkEncodedImageFormat::kPNG, 90));
 DEF_BENCH(return new EncodeBench("color_wheel.jpg", SkEncodedImageFormat::kPNG, 90));
 
+// Filter and compress bands of rows in parallel.
+DEF_BENCH(return new EncodeBench("mandrill_512.png", SkEncodedImageFormat::kPNG, 90, true));
+DEF_BENCH(return new EncodeBench("yellow_rose.png", SkEncodedImageFormat::kPNG, 90));
+DEF_BENCH(return new EncodeBench("yellow_rose.png", SkEncodedImageFormat::kPNG, 90, true));
+
 // TODO: What is the appropriate quality to use to benchmark WEBP encodes?
 DEF_BENCH(return new EncodeBench("mandrill_512.png", SkEncodedImageFormat::kWEBP, 90));
 DEF_BENCH(return new EncodeBench("color_wheel.jpg", SkEncodedImageFormat::kWEBP, 90));
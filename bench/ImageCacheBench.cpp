@@ -7,6 +7,8 @@
 
 #include "Benchmark.h"
 #include "SkResourceCache.h"
+#include "SkString.h"
+#include "SkTaskGroup.h"
 
 namespace {
 static void* gGlobalAddress;
@@ -72,6 +74,55 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// Finds and adds in the global cache from many threads at once, as raster worker threads do.
+class ImageCacheContentionBench : public Benchmark {
+    enum {
+        CACHE_COUNT = 500,
+        FINDS_PER_ADD = 8,
+    };
+    const int fThreads;
+    SkString  fName;
+
+public:
+    ImageCacheContentionBench(int threads) : fThreads(threads) {
+        fName.printf("imagecache_contention_%d", threads);
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        for (int i = 0; i < CACHE_COUNT; ++i) {
+            SkResourceCache::Add(new TestRec(TestKey(i), i));
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkTaskGroup().batch(fThreads, [&](int thread) {
+            for (int i = 0; i < loops; ++i) {
+                // Mostly hits, with the occasional racy re-add of an existing key.
+                const int value = (i * 31 + thread * 97) % CACHE_COUNT;
+                if (i % FINDS_PER_ADD == 0) {
+                    SkResourceCache::Add(new TestRec(TestKey(value), value));
+                } else {
+                    SkResourceCache::Find(TestKey(value), TestRec::Visitor, nullptr);
+                }
+            }
+        });
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new ImageCacheBench(); )
+DEF_BENCH( return new ImageCacheContentionBench(1); )
+DEF_BENCH( return new ImageCacheContentionBench(8); )
@@ -0,0 +1,120 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "Resources.h"
+#include "SkCodec.h"
+#include "SkData.h"
+#include "SkStream.h"
+#include "SkTemplates.h"
+
+// A stream that only has the first fLimit bytes of its data, as if the rest were still on the
+// way over the network.
+class TrickleStream : public SkStream {
+public:
+    explicit TrickleStream(sk_sp<SkData> data)
+        : fTotalSize(data->size())
+        , fLimit(0)
+        , fStream(std::move(data))
+    {}
+
+    void addNewData(size_t extra) { fLimit = SkTMin(fTotalSize, fLimit + extra); }
+    bool isAllDataReceived() const { return fLimit == fTotalSize; }
+
+    size_t read(void* buffer, size_t size) override {
+        return fStream.read(buffer, SkTMin(size, fLimit - fStream.getPosition()));
+    }
+    bool isAtEnd() const override { return fStream.isAtEnd(); }
+    bool rewind() override { return fStream.rewind(); }
+
+private:
+    const size_t   fTotalSize;
+    size_t         fLimit;
+    SkMemoryStream fStream;
+};
+
+// How much decoding it takes to show something while a progressive jpeg arrives kChunkSize bytes
+// at a time.
+//   - kFirstPixels decodes incrementally until the first scan can be drawn.
+//   - kIncremental decodes incrementally to the end, drawing each scan as it completes.
+//   - kWholeFile waits for all of the data and decodes once, which is the first time anything
+//     can be drawn without incremental decoding.
+class JpegProgressiveBench : public Benchmark {
+public:
+    enum Mode {
+        kFirstPixels,
+        kIncremental,
+        kWholeFile,
+    };
+
+    JpegProgressiveBench(const char* filename, Mode mode)
+        : fFilename(filename)
+        , fMode(mode)
+    {
+        static const char* kNames[] = { "firstPixels", "incremental", "wholeFile" };
+        fName.printf("JpegProgressive_%s_%s", filename, kNames[mode]);
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fData = GetResourceAsData(fFilename);
+        std::unique_ptr<SkCodec> codec(SkCodec::NewFromData(fData));
+        SkASSERT(codec);
+        fInfo = codec->getInfo().makeColorType(kN32_SkColorType);
+        fPixelStorage.reset(fInfo.getSafeSize(fInfo.minRowBytes()));
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            // The first chunk has the header.  The codec takes ownership of the stream.
+            TrickleStream* stream = new TrickleStream(fData);
+            stream->addNewData(kWholeFile == fMode ? fData->size() : kChunkSize);
+            std::unique_ptr<SkCodec> codec(SkCodec::NewFromStream(stream));
+            SkASSERT(codec);
+
+            if (kWholeFile == fMode) {
+                codec->getPixels(fInfo, fPixelStorage.get(), fInfo.minRowBytes());
+                continue;
+            }
+
+            while (SkCodec::kSuccess != codec->startIncrementalDecode(fInfo, fPixelStorage.get(),
+                                                                      fInfo.minRowBytes())) {
+                SkASSERT(!stream->isAllDataReceived());
+                stream->addNewData(kChunkSize);
+            }
+
+            int rowsDecoded = 0;
+            while (SkCodec::kSuccess != codec->incrementalDecode(&rowsDecoded)) {
+                if (kFirstPixels == fMode && rowsDecoded > 0) {
+                    break;
+                }
+                SkASSERT(!stream->isAllDataReceived());
+                stream->addNewData(kChunkSize);
+            }
+        }
+    }
+
+private:
+    static constexpr size_t kChunkSize = 4096;
+
+    const char*            fFilename;
+    const Mode             fMode;
+    SkString               fName;
+    sk_sp<SkData>          fData;
+    SkImageInfo            fInfo;
+    SkAutoTMalloc<uint8_t> fPixelStorage;
+};
+
+DEF_BENCH(return new JpegProgressiveBench("brickwork-texture.jpg",
+                                          JpegProgressiveBench::kFirstPixels));
+DEF_BENCH(return new JpegProgressiveBench("brickwork-texture.jpg",
+                                          JpegProgressiveBench::kIncremental));
+DEF_BENCH(return new JpegProgressiveBench("brickwork-texture.jpg",
+                                          JpegProgressiveBench::kWholeFile));
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "Resources.h"
+#include "SkAndroidCodec.h"
+#include "SkData.h"
+#include "SkTemplates.h"
+
+// Decodes a region of a jpeg through SkAndroidCodec, as a thumbnailer would.  Sample sizes of
+// 2, 4 and 8 are done by libjpeg-turbo while it decodes; others are partly sampled afterward.
+// Compare against the whole image at the same sample size.
+class JpegRegionDecodeBench : public Benchmark {
+public:
+    JpegRegionDecodeBench(const char* filename, int sampleSize, bool region)
+        : fFilename(filename)
+        , fSampleSize(sampleSize)
+        , fRegion(region)
+    {
+        fName.printf("JpegRegionDecode_%s_%s_%d", filename, region ? "region" : "full", sampleSize);
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fData = GetResourceAsData(fFilename);
+        std::unique_ptr<SkAndroidCodec> codec(SkAndroidCodec::NewFromData(fData));
+        SkASSERT(codec);
+
+        // The middle quarter of the image.
+        const SkISize size = codec->getInfo().dimensions();
+        fSubset = fRegion ? SkIRect::MakeXYWH(size.width() / 4, size.height() / 4,
+                                              size.width() / 2, size.height() / 2)
+                          : SkIRect::MakeSize(size);
+
+        const SkISize dims = codec->getSampledSubsetDimensions(fSampleSize, fSubset);
+        fInfo = codec->getInfo().makeWH(dims.width(), dims.height())
+                                .makeColorType(kN32_SkColorType);
+        fPixelStorage.reset(fInfo.getSafeSize(fInfo.minRowBytes()));
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkAndroidCodec::AndroidOptions options;
+        options.fSampleSize = fSampleSize;
+        options.fSubset = fRegion ? &fSubset : nullptr;
+        for (int i = 0; i < loops; i++) {
+            std::unique_ptr<SkAndroidCodec> codec(SkAndroidCodec::NewFromData(fData));
+#ifdef SK_DEBUG
+            const SkCodec::Result result =
+#endif
+            codec->getAndroidPixels(fInfo, fPixelStorage.get(), fInfo.minRowBytes(), &options);
+            SkASSERT(SkCodec::kSuccess == result);
+        }
+    }
+
+private:
+    const char*            fFilename;
+    const int              fSampleSize;
+    const bool             fRegion;
+    SkString               fName;
+    sk_sp<SkData>          fData;
+    SkIRect                fSubset;
+    SkImageInfo            fInfo;
+    SkAutoTMalloc<uint8_t> fPixelStorage;
+};
+
+DEF_BENCH(return new JpegRegionDecodeBench("mandrill_512_q075.jpg", 1, false));
+DEF_BENCH(return new JpegRegionDecodeBench("mandrill_512_q075.jpg", 1, true));
+DEF_BENCH(return new JpegRegionDecodeBench("mandrill_512_q075.jpg", 2, true));
+DEF_BENCH(return new JpegRegionDecodeBench("mandrill_512_q075.jpg", 3, false));
+DEF_BENCH(return new JpegRegionDecodeBench("mandrill_512_q075.jpg", 3, true));
+DEF_BENCH(return new JpegRegionDecodeBench("mandrill_512_q075.jpg", 8, true));
+DEF_BENCH(return new JpegRegionDecodeBench("mandrill_512_q075.jpg", 16, true));
@@ -0,0 +1,56 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "Resources.h"
+#include "SkCodec.h"
+#include "SkData.h"
+#include "SkTemplates.h"
+
+// Jpegs with restart markers are decoded in parallel bands when their data is in memory.
+// Compare each one to the same image encoded without restart markers.
+class JpegRestartBench : public Benchmark {
+public:
+    explicit JpegRestartBench(const char* filename) : fFilename(filename) {
+        fName.printf("JpegRestart_%s", filename);
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fData = GetResourceAsData(fFilename);
+        std::unique_ptr<SkCodec> codec(SkCodec::NewFromData(fData));
+        SkASSERT(codec);
+        fInfo = codec->getInfo().makeColorType(kN32_SkColorType);
+        fPixelStorage.reset(fInfo.getSafeSize(fInfo.minRowBytes()));
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            std::unique_ptr<SkCodec> codec(SkCodec::NewFromData(fData));
+#ifdef SK_DEBUG
+            const SkCodec::Result result =
+#endif
+            codec->getPixels(fInfo, fPixelStorage.get(), fInfo.minRowBytes());
+            SkASSERT(SkCodec::kSuccess == result);
+        }
+    }
+
+private:
+    const char*            fFilename;
+    SkString               fName;
+    sk_sp<SkData>          fData;
+    SkImageInfo            fInfo;
+    SkAutoTMalloc<uint8_t> fPixelStorage;
+};
+
+DEF_BENCH(return new JpegRestartBench("mandrill_512_q075.jpg"));
+DEF_BENCH(return new JpegRestartBench("mandrill_512_q075_restart.jpg"));
+DEF_BENCH(return new JpegRestartBench("mandrill_h2v1.jpg"));
+DEF_BENCH(return new JpegRestartBench("mandrill_h2v1_restart.jpg"));
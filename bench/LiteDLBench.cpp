@@ -0,0 +1,76 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkCanvas.h"
+#include "SkLiteDL.h"
+#include "SkLiteRecorder.h"
+#include "SkRandom.h"
+#include "SkString.h"
+
+// Plays back a display list of a few thousand anti-aliased draws spread over a 1024x1024 target,
+// either straight into a canvas or in horizontal bands on SkTaskGroup threads.
+class LiteDLBench : public Benchmark {
+public:
+    explicit LiteDLBench(bool banded) : fBanded(banded) {
+        fName.printf("litedl_draw_%s", banded ? "banded" : "serial");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        fDL = SkLiteDL::New(SkRect::MakeWH(kSize, kSize));
+        SkLiteRecorder recorder;
+        recorder.reset(fDL.get());
+
+        SkRandom rand;
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int i = 0; i < 3000; i++) {
+            paint.setColor(rand.nextU() | 0xFF000000);
+            SkScalar x = rand.nextRangeF(0, kSize - 64),
+                     y = rand.nextRangeF(0, kSize - 64);
+            SkRect r = SkRect::MakeXYWH(x, y, rand.nextRangeF(8, 64), rand.nextRangeF(8, 64));
+            recorder.save();
+            recorder.clipRect(r.makeOutset(4, 4));
+            if (i % 3) {
+                recorder.drawRRect(SkRRect::MakeRectXY(r, 6, 6), paint);
+            } else {
+                recorder.drawOval(r, paint);
+            }
+            recorder.restore();
+        }
+
+        fPixels.allocN32Pixels(kSize, kSize);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkPixmap pixmap;
+        SkAssertResult(fPixels.peekPixels(&pixmap));
+        for (int i = 0; i < loops; i++) {
+            if (fBanded) {
+                fDL->drawBanded(pixmap);
+            } else {
+                SkCanvas canvas(fPixels);
+                fDL->draw(&canvas);
+            }
+        }
+    }
+
+private:
+    static constexpr int kSize = 1024;
+
+    const bool      fBanded;
+    SkString        fName;
+    sk_sp<SkLiteDL> fDL;
+    SkBitmap        fPixels;
+};
+
+DEF_BENCH(return new LiteDLBench(false);)
+DEF_BENCH(return new LiteDLBench(true);)
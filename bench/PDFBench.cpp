@@ -10,6 +10,7 @@
 #include "Resources.h"
 #include "SkAutoPixmapStorage.h"
 #include "SkData.h"
+#include "SkDocument.h"
 #include "SkGradientShader.h"
 #include "SkImage.h"
 #include "SkPixmap.h"
@@ -250,6 +251,50 @@ struct WritePDFTextBenchmark : public Benchmark {
     }
 };
 
+// Writes a whole multi-page report: text in a few sizes plus an image on every page.
+struct PDFDocumentBench : public Benchmark {
+    bool fParallel;
+    sk_sp<SkImage> fImage;
+    PDFDocumentBench(bool parallel) : fParallel(parallel) {}
+    const char* onGetName() override {
+        return fParallel ? "PDFDocument_parallel" : "PDFDocument";
+    }
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+    void onDelayedSetup() override {
+        fImage = GetResourceAsImage("mandrill_256.png");
+    }
+    void onDraw(int loops, SkCanvas*) override {
+        SkDocument::PDFMetadata metadata;
+        metadata.fParallel = fParallel;
+        SkPaint paint;
+        while (loops-- > 0) {
+            NullWStream nullStream;
+            auto doc = SkDocument::MakePDF(&nullStream, SK_ScalarDefaultRasterDPI,
+                                           metadata, nullptr, false);
+            for (int page = 0; page < 100; ++page) {
+                SkCanvas* canvas = doc->beginPage(612, 792);
+                for (int line = 0; line < 50; ++line) {
+                    SkString text = SkStringPrintf("Page %d, line %d: HELLO SKIA!", page, line);
+                    paint.setTextSize(SkIntToScalar(8 + line % 5));
+                    canvas->drawText(text.c_str(), text.size(),
+                                     36, SkIntToScalar(36 + 14 * line), paint);
+                }
+                if (fImage) {
+                    canvas->save();
+                    canvas->translate(300, 400);
+                    canvas->rotate(SkIntToScalar(page));
+                    canvas->drawImage(fImage, 0, 0);
+                    canvas->restore();
+                }
+                doc->endPage();
+            }
+            doc->close();
+        }
+    }
+};
+
 }  // namespace
 DEF_BENCH(return new PDFImageBench;)
 DEF_BENCH(return new PDFJpegImageBench;)
@@ -258,6 +303,8 @@ DEF_BENCH(return new PDFScalarBench;)
 DEF_BENCH(return new PDFColorComponentBench;)
 DEF_BENCH(return new PDFShaderBench;)
 DEF_BENCH(return new WritePDFTextBenchmark;)
+DEF_BENCH(return new PDFDocumentBench(false);)
+DEF_BENCH(return new PDFDocumentBench(true);)
 
 #endif
 
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+// What it costs the recording thread to update a picture each frame when a little of it changes:
+// re-recording all of it, or re-recording just the damage with beginRecordingDamage().
+// The damage modes share the undamaged parts of the previous picture instead of recording them.
+
+#include "Benchmark.h"
+#include "SkBBHFactory.h"
+#include "SkCanvas.h"
+#include "SkPictureRecorder.h"
+
+static const int kCells = 32;       // kCells x kCells cells,
+static const int kCellSize = 20;    // each kCellSize x kCellSize.
+
+static SkRect cell_bounds(int i) {
+    return SkRect::MakeXYWH(SkIntToScalar(i % kCells * kCellSize),
+                            SkIntToScalar(i / kCells * kCellSize),
+                            SkIntToScalar(kCellSize), SkIntToScalar(kCellSize));
+}
+
+static void draw_cell(SkCanvas* canvas, int i, bool highlight) {
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(SK_ColorLTGRAY);
+    const SkRect bounds = cell_bounds(i);
+    canvas->drawRect(bounds, paint);
+    paint.setColor(highlight ? SK_ColorRED : SK_ColorBLUE);
+    canvas->drawCircle(bounds.centerX(), bounds.centerY(), SkIntToScalar(kCellSize / 2 - 2),
+                       paint);
+}
+
+class PictureDamageBench : public Benchmark {
+public:
+    enum Mode {
+        kFull,          // beginRecording() and draw every cell.
+        kDamage,        // beginRecordingDamage() and draw just the cells that meet the damage.
+        kDamageNoBBH,   // kDamage, without a BBH to rebuild.
+    };
+
+    explicit PictureDamageBench(Mode mode) : fMode(mode) {
+        static const char* kNames[] = { "full", "damage", "damage_nobbh" };
+        fName.printf("picture_damage_%s", kNames[mode]);
+    }
+
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(kCells * kCellSize, kCells * kCellSize);
+        for (int i = 0; i < kCells * kCells; i++) {
+            draw_cell(canvas, i, i == 0);
+        }
+        fPicture = recorder.finishRecordingAsPicture();
+        fHighlight = 0;
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkRTreeFactory factory;
+        SkBBHFactory* bbh = kDamageNoBBH == fMode ? nullptr : &factory;
+        SkPictureRecorder recorder;
+        for (int i = 0; i < loops; i++) {
+            // Move the highlight along one cell each frame, damaging the old cell and the new.
+            const int prev = fHighlight;
+            fHighlight = (fHighlight + 1) % (kCells * kCells);
+
+            if (kFull == fMode) {
+                SkCanvas* canvas = recorder.beginRecording(fPicture->cullRect(), bbh);
+                for (int j = 0; j < kCells * kCells; j++) {
+                    draw_cell(canvas, j, j == fHighlight);
+                }
+            } else {
+                SkRect damage = cell_bounds(prev);
+                damage.join(cell_bounds(fHighlight));
+                SkCanvas* canvas = recorder.beginRecordingDamage(*fPicture, damage, bbh);
+                for (int j = 0; j < kCells * kCells; j++) {
+                    if (cell_bounds(j).intersects(damage)) {
+                        draw_cell(canvas, j, j == fHighlight);
+                    }
+                }
+            }
+            fPicture = recorder.finishRecordingAsPicture();
+        }
+    }
+
+private:
+    const Mode       fMode;
+    SkString         fName;
+    sk_sp<SkPicture> fPicture;
+    int              fHighlight;
+};
+
+DEF_BENCH(return new PictureDamageBench(PictureDamageBench::kFull);)
+DEF_BENCH(return new PictureDamageBench(PictureDamageBench::kDamage);)
+DEF_BENCH(return new PictureDamageBench(PictureDamageBench::kDamageNoBBH);)
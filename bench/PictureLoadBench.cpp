@@ -0,0 +1,67 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+// Measures how long it takes to turn serialized picture data back into an SkPicture,
+// either by copying everything out (MakeFromData) or by reading it in place (MakeFromMappedData).
+
+#include "Benchmark.h"
+#include "SkCanvas.h"
+#include "SkData.h"
+#include "SkPath.h"
+#include "SkPicture.h"
+#include "SkPictureRecorder.h"
+#include "SkRandom.h"
+
+class PictureLoadBench : public Benchmark {
+public:
+    explicit PictureLoadBench(bool mapped) : fMapped(mapped) {
+        fName.printf("picture_load_%s", mapped ? "mapped" : "copied");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(1000, 1000);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int i = 0; i < 5000; i++) {
+            SkPath path;
+            path.moveTo(rand.nextRangeScalar(0, 1000), rand.nextRangeScalar(0, 1000));
+            for (int j = 0; j < 10; j++) {
+                path.quadTo(rand.nextRangeScalar(0, 1000), rand.nextRangeScalar(0, 1000),
+                            rand.nextRangeScalar(0, 1000), rand.nextRangeScalar(0, 1000));
+            }
+            paint.setColor(rand.nextU() | 0xFF000000);
+            canvas->drawPath(path, paint);
+            canvas->drawRect(SkRect::MakeXYWH(rand.nextRangeScalar(0, 1000),
+                                              rand.nextRangeScalar(0, 1000), 10, 10), paint);
+        }
+        fData = recorder.finishRecordingAsPicture()->serialize();
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            sk_sp<SkPicture> picture = fMapped ? SkPicture::MakeFromMappedData(fData)
+                                               : SkPicture::MakeFromData(fData.get());
+            SkASSERT(picture);
+        }
+    }
+
+private:
+    bool           fMapped;
+    SkString       fName;
+    sk_sp<SkData>  fData;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH(return new PictureLoadBench(false);)
+DEF_BENCH(return new PictureLoadBench(true);)
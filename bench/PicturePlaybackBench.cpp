@@ -7,6 +7,7 @@
 #include "Benchmark.h"
 #include "SkCanvas.h"
 #include "SkColor.h"
+#include "SkMultiPictureDraw.h"
 #include "SkPaint.h"
 #include "SkPicture.h"
 #include "SkPictureRecorder.h"
@@ -144,7 +145,7 @@ DEF_BENCH( return new PosTextPlaybackBench(false); )
 // Chrome draws into small tiles with impl-side painting.
 // This benchmark measures the relative performance of our bounding-box hierarchies,
 // both when querying tiles perfectly and when not.
-enum BBH  { kNone, kRTree };
+enum BBH  { kNone, kRTree, kPackedRTree };
 enum Mode { kTiled, kRandom };
 class TiledPlaybackBench : public Benchmark {
 public:
@@ -152,6 +153,7 @@ public:
         switch (fBBH) {
             case kNone:     fName.append("_none"    ); break;
             case kRTree:    fName.append("_rtree"   ); break;
+            case kPackedRTree: fName.append("_packed_rtree"); break;
         }
         switch (fMode) {
             case kTiled:  fName.append("_tiled" ); break;
@@ -167,6 +169,7 @@ public:
         switch (fBBH) {
             case kNone:                                                 break;
             case kRTree:    factory.reset(new SkRTreeFactory);          break;
+            case kPackedRTree: factory.reset(new SkPackedRTreeFactory); break;
         }
 
         SkPictureRecorder recorder;
@@ -217,3 +220,71 @@ DEF_BENCH( return new TiledPlaybackBench(kNone,     kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kNone,     kTiled ); )
 DEF_BENCH( return new TiledPlaybackBench(kRTree,    kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kRTree,    kTiled ); )
+DEF_BENCH( return new TiledPlaybackBench(kPackedRTree, kRandom); )
+DEF_BENCH( return new TiledPlaybackBench(kPackedRTree, kTiled ); )
+
+// Plays back one large picture, either serially or split into bands drawn in parallel.
+class BandedPlaybackBench : public Benchmark {
+public:
+    BandedPlaybackBench(BBH bbh, int bandCount)
+        : fBBH(bbh), fBandCount(bandCount), fName("banded_playback") {
+        switch (fBBH) {
+            case kNone:     fName.append("_none"    ); break;
+            case kRTree:    fName.append("_rtree"   ); break;
+            case kPackedRTree: fName.append("_packed_rtree"); break;
+        }
+        fName.appendf("_%d", fBandCount);
+    }
+
+    const char* onGetName() override { return fName.c_str(); }
+    SkIPoint onGetSize() override { return SkIPoint::Make(1024,1024); }
+
+    void onDelayedSetup() override {
+        std::unique_ptr<SkBBHFactory> factory;
+        switch (fBBH) {
+            case kNone:                                                 break;
+            case kRTree:    factory.reset(new SkRTreeFactory);          break;
+            case kPackedRTree: factory.reset(new SkPackedRTreeFactory); break;
+        }
+
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(1024, 1024, factory.get());
+            SkRandom rand;
+            for (int i = 0; i < 10000; i++) {
+                SkScalar x = rand.nextRangeScalar(0, 1024),
+                         y = rand.nextRangeScalar(0, 1024),
+                         w = rand.nextRangeScalar(0, 128),
+                         h = rand.nextRangeScalar(0, 128);
+                SkPaint paint;
+                paint.setColor(rand.nextU());
+                paint.setAntiAlias(true);
+                canvas->drawOval(SkRect::MakeXYWH(x,y,w,h), paint);
+            }
+        fPic = recorder.finishRecordingAsPicture();
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkMultiPictureDraw mpd;
+        for (int i = 0; i < loops; i++) {
+            if (fBandCount > 1) {
+                mpd.addBanded(canvas, fPic.get(), nullptr, nullptr, fBandCount);
+                mpd.draw();
+            } else {
+                canvas->drawPicture(fPic);
+            }
+        }
+    }
+
+private:
+    BBH                 fBBH;
+    int                 fBandCount;
+    SkString            fName;
+    sk_sp<SkPicture>    fPic;
+};
+
+DEF_BENCH( return new BandedPlaybackBench(kNone,   1); )
+DEF_BENCH( return new BandedPlaybackBench(kNone,  16); )
+DEF_BENCH( return new BandedPlaybackBench(kRTree,  1); )
+DEF_BENCH( return new BandedPlaybackBench(kRTree, 16); )
+DEF_BENCH( return new BandedPlaybackBench(kPackedRTree,  1); )
+DEF_BENCH( return new BandedPlaybackBench(kPackedRTree, 16); )
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkCanvas.h"
+#include "SkGraphics.h"
+#include "SkMutex.h"
+#include "SkPersistentCache.h"
+#include "SkPictureRecorder.h"
+#include "SkRandom.h"
+#include "SkShader.h"
+#include "SkString.h"
+#include "SkSurface.h"
+
+namespace {
+    // Holds on to just the last tile stored.  When cold, it never finds anything.
+    struct LastTileCache : public SkPersistentCache {
+        explicit LastTileCache(bool warm) : fWarm(warm) {}
+
+        sk_sp<SkData> load(const SkData& key) override {
+            SkAutoMutexAcquire lock(fMutex);
+            return fWarm && fKey && fKey->equals(&key) ? fData : nullptr;
+        }
+        void store(const SkData& key, const SkData& data) override {
+            SkAutoMutexAcquire lock(fMutex);
+            fKey  = SkData::MakeWithCopy(key.data(), key.size());
+            fData = SkData::MakeWithCopy(data.data(), data.size());
+        }
+
+        const bool    fWarm;
+        SkMutex       fMutex;
+        sk_sp<SkData> fKey, fData;
+    };
+}
+
+// Draws with a picture shader whose tile isn't in SkResourceCache, as if in a new process.
+// The tile either has to be drawn again (cold) or is found in a persistent cache (warm).
+class PictureShaderCacheBench : public Benchmark {
+public:
+    explicit PictureShaderCacheBench(bool warm) : fWarm(warm) {
+        fName.printf("picture_shader_cache_%s", warm ? "warm" : "cold");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(256, 256);
+        SkRandom rand;
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int i = 0; i < 200; i++) {
+            paint.setColor(rand.nextU() | 0xFF000000);
+            canvas->drawCircle(rand.nextRangeF(0, 256), rand.nextRangeF(0, 256),
+                               rand.nextRangeF(4, 32), paint);
+        }
+        fPicture = recorder.finishRecordingAsPicture();
+        fSurface = SkSurface::MakeRasterN32Premul(512, 512);
+        fCache.reset(new LastTileCache(fWarm));
+    }
+
+    void onPreDraw(SkCanvas*) override {
+        SkGraphics::SetPictureShaderTileCache(fCache);
+    }
+
+    void onPostDraw(SkCanvas*) override {
+        SkGraphics::SetPictureShaderTileCache(nullptr);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops --> 0) {
+            SkGraphics::PurgeResourceCache();
+            SkPaint paint;
+            paint.setShader(SkShader::MakePictureShader(fPicture, SkShader::kRepeat_TileMode,
+                                                        SkShader::kRepeat_TileMode,
+                                                        nullptr, nullptr));
+            fSurface->getCanvas()->drawPaint(paint);
+        }
+    }
+
+private:
+    const bool             fWarm;
+    SkString               fName;
+    sk_sp<SkPicture>       fPicture;
+    sk_sp<SkSurface>       fSurface;
+    sk_sp<LastTileCache>   fCache;
+};
+
+DEF_BENCH(return new PictureShaderCacheBench(false);)
+DEF_BENCH(return new PictureShaderCacheBench(true);)
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkCanvas.h"
+#include "SkPath.h"
+#include "SkPicture.h"
+#include "SkPipe.h"
+#include "SkRandom.h"
+#include "SkStream.h"
+#include "SkString.h"
+#include "SkSurface.h"
+
+// Records frames of a few hundred draws through SkPipe and plays them back into a raster surface.
+//   sync:       record then play back each frame on this thread.
+//   throughput: record frames back to back, played back on a reader thread as we go.
+//   latency:    record a frame, then wait for the reader thread to finish playing it back.
+class PipeBench : public Benchmark {
+public:
+    enum Mode { kSync_Mode, kThroughput_Mode, kLatency_Mode };
+
+    explicit PipeBench(Mode mode) : fMode(mode) {
+        static const char* kNames[] = { "sync", "async_throughput", "async_latency" };
+        fName.printf("pipe_%s", kNames[mode]);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        for (SkPath& path : fPaths) {
+            path.moveTo(rand.nextRangeF(0, 32), rand.nextRangeF(0, 32));
+            for (int i = 0; i < 8; ++i) {
+                path.quadTo(rand.nextRangeF(0, 32), rand.nextRangeF(0, 32),
+                            rand.nextRangeF(0, 32), rand.nextRangeF(0, 32));
+            }
+            path.close();
+        }
+        fSurface = SkSurface::MakeRasterN32Premul(512, 512);
+        if (kSync_Mode != fMode) {
+            fPlayer.reset(new SkPipeAsyncPlayer(fSurface->getCanvas()));
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const SkRect cull = SkRect::MakeWH(512, 512);
+        for (int frame = 0; frame < loops; ++frame) {
+            switch (fMode) {
+                case kSync_Mode: {
+                    SkDynamicMemoryWStream stream;
+                    this->drawFrame(fSerializer.beginWrite(cull, &stream), frame);
+                    fSerializer.endWrite();
+                    sk_sp<SkData> data = stream.detachAsData();
+                    fDeserializer.playback(data->data(), data->size(), fSurface->getCanvas());
+                } break;
+                case kThroughput_Mode:
+                    this->drawFrame(fPlayer->beginFrame(cull), frame);
+                    fPlayer->endFrame();
+                    break;
+                case kLatency_Mode:
+                    this->drawFrame(fPlayer->beginFrame(cull), frame);
+                    fPlayer->endFrame();
+                    fPlayer->flush();
+                    break;
+            }
+        }
+        if (fPlayer) {
+            fPlayer->flush();
+        }
+    }
+
+private:
+    void drawFrame(SkCanvas* canvas, int frame) {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int i = 0; i < 300; ++i) {
+            paint.setColor(0xFF000000 | (i * 0x10305 + frame));
+            canvas->save();
+            canvas->translate(SkIntToScalar((i * 37 + frame) % 480),
+                              SkIntToScalar((i * 53) % 480));
+            canvas->drawPath(fPaths[i % SK_ARRAY_COUNT(fPaths)], paint);
+            canvas->drawRect(SkRect::MakeWH(4, 4), paint);
+            canvas->restore();
+        }
+    }
+
+    const Mode                          fMode;
+    SkString                            fName;
+    SkPath                              fPaths[16];
+    sk_sp<SkSurface>                    fSurface;
+    SkPipeSerializer                    fSerializer;
+    SkPipeDeserializer                  fDeserializer;
+    std::unique_ptr<SkPipeAsyncPlayer>  fPlayer;
+};
+
+DEF_BENCH(return new PipeBench(PipeBench::kSync_Mode);)
+DEF_BENCH(return new PipeBench(PipeBench::kThroughput_Mode);)
+DEF_BENCH(return new PipeBench(PipeBench::kLatency_Mode);)
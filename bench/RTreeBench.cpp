@@ -7,6 +7,7 @@
 
 #include "Benchmark.h"
 #include "SkCanvas.h"
+#include "SkPackedRTree.h"
 #include "SkRTree.h"
 #include "SkRandom.h"
 #include "SkString.h"
@@ -20,10 +21,11 @@ static const int GRID_WIDTH = 100;
 typedef SkRect (*MakeRectProc)(SkRandom&, int, int);
 
 // Time how long it takes to build an R-Tree.
+template <typename RTree>
 class RTreeBuildBench : public Benchmark {
 public:
-    RTreeBuildBench(const char* name, MakeRectProc proc) : fProc(proc) {
-        fName.printf("rtree_%s_build", name);
+    RTreeBuildBench(const char* prefix, const char* name, MakeRectProc proc) : fProc(proc) {
+        fName.printf("%s_%s_build", prefix, name);
     }
 
     bool isSuitableFor(Backend backend) override {
@@ -42,7 +44,7 @@ protected:
         }
 
         for (int i = 0; i < loops; ++i) {
-            SkRTree tree;
+            RTree tree;
             tree.insert(rects.get(), NUM_BUILD_RECTS);
             SkASSERT(rects != nullptr);  // It'd break this bench if the tree took ownership of rects.
         }
@@ -54,10 +56,11 @@ private:
 };
 
 // Time how long it takes to perform queries on an R-Tree.
+template <typename RTree>
 class RTreeQueryBench : public Benchmark {
 public:
-    RTreeQueryBench(const char* name, MakeRectProc proc) : fProc(proc) {
-        fName.printf("rtree_%s_query", name);
+    RTreeQueryBench(const char* prefix, const char* name, MakeRectProc proc) : fProc(proc) {
+        fName.printf("%s_%s_query", prefix, name);
     }
 
     bool isSuitableFor(Backend backend) override {
@@ -89,7 +92,7 @@ protected:
         }
     }
 private:
-    SkRTree fTree;
+    RTree fTree;
     MakeRectProc fProc;
     SkString fName;
     typedef Benchmark INHERITED;
@@ -127,12 +130,30 @@ static inline SkRect make_concentric_rects(SkRandom&, int index, int numRects) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-DEF_BENCH(return new RTreeBuildBench("XY", &make_XYordered_rects));
-DEF_BENCH(return new RTreeBuildBench("YX", &make_YXordered_rects));
-DEF_BENCH(return new RTreeBuildBench("random", &make_random_rects));
-DEF_BENCH(return new RTreeBuildBench("concentric", &make_concentric_rects));
-
-DEF_BENCH(return new RTreeQueryBench("XY", &make_XYordered_rects));
-DEF_BENCH(return new RTreeQueryBench("YX", &make_YXordered_rects));
-DEF_BENCH(return new RTreeQueryBench("random", &make_random_rects));
-DEF_BENCH(return new RTreeQueryBench("concentric", &make_concentric_rects));
+DEF_BENCH(return new RTreeBuildBench<SkRTree>("rtree", "XY", &make_XYordered_rects));
+DEF_BENCH(return new RTreeBuildBench<SkRTree>("rtree", "YX", &make_YXordered_rects));
+DEF_BENCH(return new RTreeBuildBench<SkRTree>("rtree", "random", &make_random_rects));
+DEF_BENCH(return new RTreeBuildBench<SkRTree>("rtree", "concentric", &make_concentric_rects));
+
+DEF_BENCH(return new RTreeQueryBench<SkRTree>("rtree", "XY", &make_XYordered_rects));
+DEF_BENCH(return new RTreeQueryBench<SkRTree>("rtree", "YX", &make_YXordered_rects));
+DEF_BENCH(return new RTreeQueryBench<SkRTree>("rtree", "random", &make_random_rects));
+DEF_BENCH(return new RTreeQueryBench<SkRTree>("rtree", "concentric", &make_concentric_rects));
+
+DEF_BENCH(return new RTreeBuildBench<SkPackedRTree>("packed_rtree", "XY",
+                                                    &make_XYordered_rects));
+DEF_BENCH(return new RTreeBuildBench<SkPackedRTree>("packed_rtree", "YX",
+                                                    &make_YXordered_rects));
+DEF_BENCH(return new RTreeBuildBench<SkPackedRTree>("packed_rtree", "random",
+                                                    &make_random_rects));
+DEF_BENCH(return new RTreeBuildBench<SkPackedRTree>("packed_rtree", "concentric",
+                                                    &make_concentric_rects));
+
+DEF_BENCH(return new RTreeQueryBench<SkPackedRTree>("packed_rtree", "XY",
+                                                    &make_XYordered_rects));
+DEF_BENCH(return new RTreeQueryBench<SkPackedRTree>("packed_rtree", "YX",
+                                                    &make_YXordered_rects));
+DEF_BENCH(return new RTreeQueryBench<SkPackedRTree>("packed_rtree", "random",
+                                                    &make_random_rects));
+DEF_BENCH(return new RTreeQueryBench<SkPackedRTree>("packed_rtree", "concentric",
+                                                    &make_concentric_rects));
@@ -86,3 +86,31 @@ void PipingBench::onDraw(int loops, SkCanvas*) {
         stream.reset();
     }
 }
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "SkData.h"
+#include "SkSurface.h"
+
+FirstTileBench::FirstTileBench(const char* name, const SkPicture* pic, bool mapped)
+    : INHERITED(name, pic)
+    , fMapped(mapped) {
+    fName.prepend(mapped ? "first_tile_mapped_" : "first_tile_");
+}
+
+void FirstTileBench::onDelayedSetup() {
+    // Record with a BBH, so that the serialized picture carries the bounds of each op.
+    SkRTreeFactory factory;
+    SkPictureRecorder recorder;
+    fSrc->playback(recorder.beginRecording(fSrc->cullRect(), &factory));
+    fData = recorder.finishRecordingAsPicture()->serialize();
+    fTile = SkSurface::MakeRasterN32Premul(256, 256);
+}
+
+void FirstTileBench::onDraw(int loops, SkCanvas*) {
+    while (loops --> 0) {
+        sk_sp<SkPicture> pic = fMapped ? SkPicture::MakeFromMappedData(fData)
+                                       : SkPicture::MakeFromData(fData.get());
+        fTile->getCanvas()->drawPicture(pic);
+    }
+}
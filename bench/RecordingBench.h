@@ -12,6 +12,8 @@
 #include "SkPicture.h"
 #include "SkLiteDL.h"
 
+class SkSurface;
+
 class PictureCentricBench : public Benchmark {
 public:
     PictureCentricBench(const char* name, const SkPicture*);
@@ -53,4 +55,22 @@ private:
     typedef PictureCentricBench INHERITED;
 };
 
+// Times how long it takes to load a serialized picture and draw its first tile,
+// either copying the picture out of its data, or playing it back in place.
+class FirstTileBench : public PictureCentricBench {
+public:
+    FirstTileBench(const char* name, const SkPicture*, bool mapped);
+
+protected:
+    void onDelayedSetup() override;
+    void onDraw(int loops, SkCanvas*) override;
+
+private:
+    sk_sp<SkData>    fData;
+    sk_sp<SkSurface> fTile;
+    bool             fMapped;
+
+    typedef PictureCentricBench INHERITED;
+};
+
 #endif//RecordingBench_DEFINED
@@ -112,7 +112,56 @@ private:
     SkString fName;
 };
 
+// Many threads each drawing a little text at a few sizes, as raster worker threads do.
+// The strikes stay cached, so this mostly measures finding and returning them.
+class SkGlyphCacheThreads : public Benchmark {
+public:
+    explicit SkGlyphCacheThreads(int threads) : fThreads(threads) { }
+
+protected:
+    const char* onGetName() override {
+        fName.printf("SkGlyphCacheThreads%d", fThreads);
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        fTypeface = sk_tool_utils::create_portable_typeface(
+                        "serif", SkFontStyle::FromOldStyle(SkTypeface::kItalic));
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkTaskGroup().batch(fThreads, [&](int) {
+            SkPaint paint;
+            paint.setAntiAlias(true);
+            paint.setTypeface(fTypeface);
+            for (int work = 0; work < loops; work++) {
+                for (SkScalar size : { 10, 12, 14 }) {
+                    paint.setTextSize(size);
+                    SkAutoGlyphCacheNoGamma autoCache(paint, nullptr, nullptr);
+                    SkGlyphCache* cache = autoCache.getCache();
+                    for (int c = 'a'; c <= 'h'; c++) {
+                        cache->getUnicharMetrics(c);
+                    }
+                }
+            }
+        });
+    }
+
+private:
+    typedef Benchmark INHERITED;
+    const int fThreads;
+    sk_sp<SkTypeface> fTypeface;
+    SkString fName;
+};
+
 DEF_BENCH( return new SkGlyphCacheBasic(256 * 1024); )
 DEF_BENCH( return new SkGlyphCacheBasic(32 * 1024 * 1024); )
 DEF_BENCH( return new SkGlyphCacheStressTest(256 * 1024); )
 DEF_BENCH( return new SkGlyphCacheStressTest(32 * 1024 * 1024); )
+DEF_BENCH( return new SkGlyphCacheThreads(1); )
+DEF_BENCH( return new SkGlyphCacheThreads(4); )
+DEF_BENCH( return new SkGlyphCacheThreads(16); )
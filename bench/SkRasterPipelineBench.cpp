@@ -8,6 +8,7 @@
 #include "Benchmark.h"
 #include "SkOpts.h"
 #include "SkRasterPipeline.h"
+#include "SkString.h"
 
 static const int N = 1023;
 
@@ -111,3 +112,102 @@ public:
 };
 DEF_BENCH( return (new SkRasterPipelineLegacyBench< true>); )
 DEF_BENCH( return (new SkRasterPipelineLegacyBench<false>); )
+
+// Measures one stage inside a minimal 8888 pipeline, in lowp (16-bit fixed point) or float,
+// so we can see the lowp speedup per stage:  load dst, load src, <stage>, store dst.
+class SkRasterPipelineLowpBench : public Benchmark {
+public:
+    SkRasterPipelineLowpBench(SkRasterPipeline::StockStage stage, const char* name, bool lowp)
+        : fStage(stage)
+        , fLowp(lowp) {
+        fName.printf("SkRasterPipeline_%s_%s", lowp ? "lowp" : "highp", name);
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDraw(int loops, SkCanvas*) override {
+        void* mask_ctx = mask;
+        void*  src_ctx = src;
+        void*  dst_ctx = dst;
+        float  coverage = 0.5f;
+
+        SkRasterPipeline p(fLowp);
+        p.append(SkRasterPipeline::load_8888, &dst_ctx);
+        p.append(SkRasterPipeline::move_src_dst);
+        p.append(SkRasterPipeline::load_8888, &src_ctx);
+        switch (fStage) {
+            case SkRasterPipeline::scale_u8:
+            case SkRasterPipeline::lerp_u8:      p.append(fStage, &mask_ctx); break;
+            case SkRasterPipeline::scale_1_float:
+            case SkRasterPipeline::lerp_1_float: p.append(fStage, &coverage); break;
+            default:                             p.append(fStage);            break;
+        }
+        p.append(SkRasterPipeline::store_8888, &dst_ctx);
+
+        while (loops --> 0) {
+            p.run(0,N);
+        }
+    }
+
+private:
+    SkRasterPipeline::StockStage fStage;
+    bool                         fLowp;
+    SkString                     fName;
+};
+#define DEF_LOWP_BENCH(stage)                                                                  \
+    DEF_BENCH( return new SkRasterPipelineLowpBench(SkRasterPipeline::stage, #stage,  true); ) \
+    DEF_BENCH( return new SkRasterPipelineLowpBench(SkRasterPipeline::stage, #stage, false); )
+DEF_LOWP_BENCH(srcover)
+DEF_LOWP_BENCH(modulate)
+DEF_LOWP_BENCH(screen)
+DEF_LOWP_BENCH(scale_u8)
+DEF_LOWP_BENCH(lerp_u8)
+DEF_LOWP_BENCH(scale_1_float)
+DEF_LOWP_BENCH(lerp_1_float)
+DEF_LOWP_BENCH(premul)
+#undef DEF_LOWP_BENCH
+
+// Blitters compile a pipeline each time they're created, usually to draw only a few spans, so
+// the cost of compile() itself matters.  Pipelines with the same stages share compiled code.
+//
+// Each iteration builds a fresh pipeline, cycling through a number of variants that differ
+// only in a run of clamp_1 / clamp_a stages.  A handful of variants always hit the shared code;
+// more variants than it keeps (64) miss every time, which is what compiling cost before sharing.
+class SkRasterPipelineCompileEachBench : public Benchmark {
+public:
+    SkRasterPipelineCompileEachBench(bool cached) : fCached(cached) {}
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override {
+        return fCached ? "SkRasterPipeline_legacy_compile_each"
+                       : "SkRasterPipeline_legacy_compile_each_uncached";
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        void*  src_ctx = src;
+        void*  dst_ctx = dst;
+
+        const int kClamps = 7;
+        const int variants = fCached ? 8 : 1 << kClamps;
+        for (int i = 0; loops --> 0; i = (i + 1) % variants) {
+            SkRasterPipeline p;
+            p.append(SkRasterPipeline::load_8888, &dst_ctx);
+            p.append(SkRasterPipeline::move_src_dst);
+            p.append(SkRasterPipeline::load_8888, &src_ctx);
+            p.append(SkRasterPipeline::srcover);
+            for (int bit = 0; bit < kClamps; bit++) {
+                p.append(i & (1 << bit) ? SkRasterPipeline::clamp_a : SkRasterPipeline::clamp_1);
+            }
+            p.append(SkRasterPipeline::store_8888, &dst_ctx);
+
+            auto compiled = p.compile();
+            compiled(0,64);
+        }
+    }
+
+private:
+    bool fCached;
+};
+DEF_BENCH( return new SkRasterPipelineCompileEachBench(true); )
+DEF_BENCH( return new SkRasterPipelineCompileEachBench(false); )
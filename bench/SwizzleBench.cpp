@@ -6,7 +6,12 @@
  */
 
 #include "Benchmark.h"
+#include "SkCodec.h"
 #include "SkOpts.h"
+#include "SkString.h"
+#include "SkSwizzler.h"
+
+static const int K = 1023; // Arbitrary, but nice to be a non-power-of-two to trip up SIMD.
 
 class SwizzleBench : public Benchmark {
 public:
@@ -15,8 +20,8 @@ public:
     bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
     const char* onGetName() override { return fName; }
     void onDraw(int loops, SkCanvas*) override {
-        static const int K = 1023; // Arbitrary, but nice to be a non-power-of-two to trip up SIMD.
-        uint32_t dst[K], src[K];
+        uint32_t dst[K];
+        uint64_t src[K];  // Big enough for 16-bit RGBA.
         while (loops --> 0) {
             fFn(dst, src, K);
         }
@@ -37,3 +42,165 @@ DEF_BENCH(return new SwizzleBench("SkOpts::grayA_to_RGBA", SkOpts::grayA_to_RGBA
 DEF_BENCH(return new SwizzleBench("SkOpts::grayA_to_rgbA", SkOpts::grayA_to_rgbA));
 DEF_BENCH(return new SwizzleBench("SkOpts::inverted_CMYK_to_RGB1", SkOpts::inverted_CMYK_to_RGB1));
 DEF_BENCH(return new SwizzleBench("SkOpts::inverted_CMYK_to_BGR1", SkOpts::inverted_CMYK_to_BGR1));
+DEF_BENCH(return new SwizzleBench("SkOpts::RGB16_to_RGB1", SkOpts::RGB16_to_RGB1));
+DEF_BENCH(return new SwizzleBench("SkOpts::RGB16_to_BGR1", SkOpts::RGB16_to_BGR1));
+DEF_BENCH(return new SwizzleBench("SkOpts::RGBA16_to_RGBA", SkOpts::RGBA16_to_RGBA));
+DEF_BENCH(return new SwizzleBench("SkOpts::RGBA16_to_BGRA", SkOpts::RGBA16_to_BGRA));
+DEF_BENCH(return new SwizzleBench("SkOpts::RGBA16_to_rgbA", SkOpts::RGBA16_to_rgbA));
+DEF_BENCH(return new SwizzleBench("SkOpts::RGBA16_to_bgrA", SkOpts::RGBA16_to_bgrA));
+
+class Index8SwizzleBench : public Benchmark {
+public:
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return "SkOpts::index8_to_8888"; }
+    void onDraw(int loops, SkCanvas*) override {
+        uint32_t dst[K], table[256];
+        uint8_t src[K];
+        for (int i = 0; i < K; i++) {
+            src[i] = (uint8_t)(i * 37);
+        }
+        for (uint32_t& color : table) {
+            color = 0xFF000000;
+        }
+        while (loops --> 0) {
+            SkOpts::index8_to_8888(dst, src, K, table);
+        }
+    }
+};
+DEF_BENCH(return new Index8SwizzleBench);
+
+class GatherBench : public Benchmark {
+public:
+    GatherBench(int bpp, int sampleX) : fBpp(bpp), fSampleX(sampleX) {
+        fName.printf("SkOpts::gather_pixels_%dbpp_sample%d", bpp, sampleX);
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+    void onDelayedSetup() override {
+        fSrc.reset(K * fBpp * fSampleX);
+        fDst.reset(K * fBpp);
+    }
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops --> 0) {
+            SkOpts::gather_pixels(fDst.get(), fSrc.get(), K, fBpp, fBpp * fSampleX);
+        }
+    }
+private:
+    int                     fBpp;
+    int                     fSampleX;
+    SkString                fName;
+    SkAutoTMalloc<uint8_t>  fSrc;
+    SkAutoTMalloc<uint8_t>  fDst;
+};
+DEF_BENCH(return new GatherBench(1, 4));
+DEF_BENCH(return new GatherBench(3, 4));
+DEF_BENCH(return new GatherBench(4, 2));
+DEF_BENCH(return new GatherBench(4, 4));
+DEF_BENCH(return new GatherBench(8, 4));
+
+// Swizzles a row through SkSwizzler, i.e. through whichever RowProc a codec would pick for this
+// encoding and destination, sampled or not.
+class SkSwizzlerBench : public Benchmark {
+public:
+    SkSwizzlerBench(const char* encoding, SkEncodedInfo::Color color, SkEncodedInfo::Alpha alpha,
+                    int bitsPerComponent, SkColorType dstColorType, SkAlphaType dstAlphaType,
+                    int sampleX)
+        : fEncodedInfo(SkEncodedInfo::Make(color, alpha, bitsPerComponent))
+        , fDstInfo(SkImageInfo::Make(K, 1, dstColorType, dstAlphaType))
+        , fSampleX(sampleX)
+    {
+        fName.printf("SkSwizzler_%s_to_%s_%s_sample%d", encoding,
+                     kRGBA_8888_SkColorType == dstColorType ? "rgba" :
+                     kBGRA_8888_SkColorType == dstColorType ? "bgra" :
+                     kRGB_565_SkColorType   == dstColorType ? "565"  : "gray",
+                     kOpaque_SkAlphaType == dstAlphaType ? "opaque" :
+                     kPremul_SkAlphaType == dstAlphaType ? "premul" : "unpremul", sampleX);
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+    void onDelayedSetup() override {
+        for (SkPMColor& color : fColorTable) {
+            color = 0xFF000000;
+        }
+        fSwizzler.reset(SkSwizzler::CreateSwizzler(fEncodedInfo, fColorTable, fDstInfo,
+                                                   SkCodec::Options()));
+        SkASSERT(fSwizzler);
+        fSwizzler->setSampleX(fSampleX);
+        fSrc.reset(K * 8);
+        sk_bzero(fSrc.get(), K * 8);
+        fDst.reset(fDstInfo.minRowBytes());
+    }
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops --> 0) {
+            fSwizzler->swizzle(fDst.get(), fSrc.get());
+        }
+    }
+private:
+    SkEncodedInfo               fEncodedInfo;
+    SkImageInfo                 fDstInfo;
+    int                         fSampleX;
+    SkString                    fName;
+    SkPMColor                   fColorTable[256];
+    std::unique_ptr<SkSwizzler> fSwizzler;
+    SkAutoTMalloc<uint8_t>      fSrc;
+    SkAutoTMalloc<uint8_t>      fDst;
+};
+
+#define SWIZZLER_BENCHES(name, color, alpha, bits, ct, at)                                         \
+    DEF_BENCH(return new SkSwizzlerBench(name, SkEncodedInfo::color, SkEncodedInfo::alpha, bits,   \
+                                         ct, at, 1));                                              \
+    DEF_BENCH(return new SkSwizzlerBench(name, SkEncodedInfo::color, SkEncodedInfo::alpha, bits,   \
+                                         ct, at, 4))
+
+SWIZZLER_BENCHES("bit",     kGray_Color,         kOpaque_Alpha,   1, kRGBA_8888_SkColorType,
+                 kPremul_SkAlphaType);
+SWIZZLER_BENCHES("index2",  kPalette_Color,      kOpaque_Alpha,   2, kRGBA_8888_SkColorType,
+                 kPremul_SkAlphaType);
+SWIZZLER_BENCHES("index8",  kPalette_Color,      kOpaque_Alpha,   8, kRGBA_8888_SkColorType,
+                 kPremul_SkAlphaType);
+SWIZZLER_BENCHES("index8",  kPalette_Color,      kOpaque_Alpha,   8, kRGB_565_SkColorType,
+                 kOpaque_SkAlphaType);
+SWIZZLER_BENCHES("gray8",   kGray_Color,         kOpaque_Alpha,   8, kRGBA_8888_SkColorType,
+                 kPremul_SkAlphaType);
+SWIZZLER_BENCHES("gray8",   kGray_Color,         kOpaque_Alpha,   8, kGray_8_SkColorType,
+                 kOpaque_SkAlphaType);
+SWIZZLER_BENCHES("gray8",   kGray_Color,         kOpaque_Alpha,   8, kRGB_565_SkColorType,
+                 kOpaque_SkAlphaType);
+SWIZZLER_BENCHES("grayA8",  kGrayAlpha_Color,    kUnpremul_Alpha, 8, kRGBA_8888_SkColorType,
+                 kPremul_SkAlphaType);
+SWIZZLER_BENCHES("grayA8",  kGrayAlpha_Color,    kUnpremul_Alpha, 8, kRGBA_8888_SkColorType,
+                 kUnpremul_SkAlphaType);
+SWIZZLER_BENCHES("rgb8",    kRGB_Color,          kOpaque_Alpha,   8, kRGBA_8888_SkColorType,
+                 kPremul_SkAlphaType);
+SWIZZLER_BENCHES("rgb8",    kRGB_Color,          kOpaque_Alpha,   8, kBGRA_8888_SkColorType,
+                 kPremul_SkAlphaType);
+SWIZZLER_BENCHES("rgb8",    kRGB_Color,          kOpaque_Alpha,   8, kRGB_565_SkColorType,
+                 kOpaque_SkAlphaType);
+SWIZZLER_BENCHES("rgb16",   kRGB_Color,          kOpaque_Alpha,  16, kRGBA_8888_SkColorType,
+                 kPremul_SkAlphaType);
+SWIZZLER_BENCHES("rgb16",   kRGB_Color,          kOpaque_Alpha,  16, kBGRA_8888_SkColorType,
+                 kPremul_SkAlphaType);
+SWIZZLER_BENCHES("rgba8",   kRGBA_Color,         kUnpremul_Alpha, 8, kRGBA_8888_SkColorType,
+                 kPremul_SkAlphaType);
+SWIZZLER_BENCHES("rgba8",   kRGBA_Color,         kUnpremul_Alpha, 8, kRGBA_8888_SkColorType,
+                 kUnpremul_SkAlphaType);
+SWIZZLER_BENCHES("rgba8",   kRGBA_Color,         kUnpremul_Alpha, 8, kBGRA_8888_SkColorType,
+                 kPremul_SkAlphaType);
+SWIZZLER_BENCHES("rgba16",  kRGBA_Color,         kUnpremul_Alpha, 16, kRGBA_8888_SkColorType,
+                 kPremul_SkAlphaType);
+SWIZZLER_BENCHES("rgba16",  kRGBA_Color,         kUnpremul_Alpha, 16, kRGBA_8888_SkColorType,
+                 kUnpremul_SkAlphaType);
+SWIZZLER_BENCHES("rgba16",  kRGBA_Color,         kUnpremul_Alpha, 16, kBGRA_8888_SkColorType,
+                 kPremul_SkAlphaType);
+SWIZZLER_BENCHES("rgba16",  kRGBA_Color,         kUnpremul_Alpha, 16, kBGRA_8888_SkColorType,
+                 kUnpremul_SkAlphaType);
+SWIZZLER_BENCHES("bgra8",   kBGRA_Color,         kUnpremul_Alpha, 8, kRGBA_8888_SkColorType,
+                 kPremul_SkAlphaType);
+SWIZZLER_BENCHES("bgra8",   kBGRA_Color,         kUnpremul_Alpha, 8, kBGRA_8888_SkColorType,
+                 kUnpremul_SkAlphaType);
+SWIZZLER_BENCHES("cmyk8",   kInvertedCMYK_Color, kOpaque_Alpha,   8, kRGBA_8888_SkColorType,
+                 kPremul_SkAlphaType);
+SWIZZLER_BENCHES("cmyk8",   kInvertedCMYK_Color, kOpaque_Alpha,   8, kRGB_565_SkColorType,
+                 kOpaque_SkAlphaType);
@@ -43,6 +43,7 @@
 #include "SkScan.h"
 #include "SkString.h"
 #include "SkSurface.h"
+#include "SkSurfacePriv.h"
 #include "SkTaskGroup.h"
 #include "SkThreadUtils.h"
 #include "ThermalManager.h"
@@ -115,8 +116,10 @@ DEFINE_string(scales, "1.0", "Space-separated scales for SKPs.");
 DEFINE_string(zoom, "1.0,0", "Comma-separated zoomMax,zoomPeriodMs factors for a periodic SKP zoom "
                              "function that ping-pongs between 1.0 and zoomMax.");
 DEFINE_bool(bbh, true, "Build a BBH for SKPs?");
+DEFINE_bool(optimizeDrawOrder, false, "Reorder and batch the draws in SKPs when re-recording?");
 DEFINE_bool(lite, false, "Use SkLiteRecorder in recording benchmarks?");
 DEFINE_bool(mpd, true, "Use MultiPictureDraw for the SKPs?");
+DEFINE_int32(threadedTiles, 0, "Tiles used by the 'threaded' config. 0 picks one per 128 rows.");
 DEFINE_bool(loopSKP, true, "Loop SKPs like we do for micro benches?");
 DEFINE_int32(flushEvery, 10, "Flush --outResultsFile every Nth run.");
 DEFINE_bool(resetGpuContext, true, "Reset the GrContext before running each test.");
@@ -141,7 +144,11 @@ static SkString humanize(double ms) {
 
 bool Target::init(SkImageInfo info, Benchmark* bench) {
     if (Benchmark::kRaster_Backend == config.backend) {
-        this->surface = SkSurface::MakeRaster(info);
+        if (config.name.equals("threaded")) {
+            this->surface = SkMakeThreadedRasterSurface(info, FLAGS_threadedTiles);
+        } else {
+            this->surface = SkSurface::MakeRaster(info);
+        }
         if (!this->surface) {
             return false;
         }
@@ -459,6 +466,9 @@ static void create_config(const SkCommandLineConfig* config, SkTArray<Config>* c
                    kN32_SkColorType, kPremul_SkAlphaType, nullptr)
         CPU_CONFIG(565,  kRaster_Backend,
                    kRGB_565_SkColorType, kOpaque_SkAlphaType, nullptr)
+        // 8888, rasterized in parallel tiles by SkThreadedBMPDevice.
+        CPU_CONFIG(threaded, kRaster_Backend,
+                   kN32_SkColorType, kPremul_SkAlphaType, nullptr)
         auto srgbColorSpace = SkColorSpace::MakeNamed(SkColorSpace::kSRGB_Named);
         CPU_CONFIG(srgb, kRaster_Backend,
                    kN32_SkColorType,  kPremul_SkAlphaType, srgbColorSpace)
@@ -587,6 +597,7 @@ public:
                       , fGMs(skiagm::GMRegistry::Head())
                       , fCurrentRecording(0)
                       , fCurrentPiping(0)
+                      , fCurrentFirstTile(0)
                       , fCurrentScale(0)
                       , fCurrentSKP(0)
                       , fCurrentSVG(0)
@@ -746,6 +757,22 @@ public:
             return new PipingBench(name.c_str(), pic.get());
         }
 
+        // Add all .skps as FirstTileBenches, loading them by copying and in place.
+        while (fCurrentFirstTile < 2 * fSKPs.count()) {
+            const bool mapped = fCurrentFirstTile % 2;
+            const SkString& path = fSKPs[fCurrentFirstTile++ / 2];
+            sk_sp<SkPicture> pic = ReadPicture(path.c_str());
+            if (!pic) {
+                continue;
+            }
+            SkString name = SkOSPath::Basename(path.c_str());
+            fSourceType = "skp";
+            fBenchType  = "first_tile";
+            fSKPBytes = static_cast<double>(SkPictureUtils::ApproximateBytesUsed(pic.get()));
+            fSKPOps   = pic->approximateOpCount();
+            return new FirstTileBench(name.c_str(), pic.get(), mapped);
+        }
+
         // Then once each for each scale as SKPBenches (playback).
         while (fCurrentScale < fScales.count()) {
             while (fCurrentSKP < fSKPs.count()) {
@@ -757,14 +784,16 @@ public:
                 }
 
                 while (fCurrentUseMPD < fUseMPDs.count()) {
-                    if (FLAGS_bbh) {
+                    if (FLAGS_bbh || FLAGS_optimizeDrawOrder) {
                         // The SKP we read off disk doesn't have a BBH.  Re-record so it grows one.
                         SkRTreeFactory factory;
                         SkPictureRecorder recorder;
+                        uint32_t flags = FLAGS_optimizeDrawOrder
+                                       ? SkPictureRecorder::kOptimizeDrawOrder_RecordFlag : 0;
                         pic->playback(recorder.beginRecording(pic->cullRect().width(),
                                                               pic->cullRect().height(),
-                                                              &factory,
-                                                              0));
+                                                              FLAGS_bbh ? &factory : nullptr,
+                                                              flags));
                         pic = recorder.finishRecordingAsPicture();
                     }
                     SkString name = SkOSPath::Basename(path.c_str());
@@ -1077,6 +1106,7 @@ private:
     const char* fBenchType;   // How we bench it: micro, recording, playback, ...
     int fCurrentRecording;
     int fCurrentPiping;
+    int fCurrentFirstTile;
     int fCurrentScale;
     int fCurrentSKP;
     int fCurrentSVG;
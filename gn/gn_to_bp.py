@@ -206,7 +206,8 @@ with open('Android.bp', 'w') as f:
                                      defs['sse41'] +
                                      defs['sse42'] +
                                      defs['avx'  ] +
-                                     defs['hsw'  ]))
+                                     defs['hsw'  ] +
+                                     defs['skx'  ]))
   })
 
 #... and all the #defines we want to put in SkUserConfig.h.
@@ -33,7 +33,8 @@
       'conditions': [
         [ '"x86" in skia_arch_type and skia_os != "ios"', {
           'cflags': [ '-msse2' ],
-          'dependencies': [ 'opts_ssse3', 'opts_sse41', 'opts_sse42', 'opts_avx', 'opts_hsw' ],
+          'dependencies': [ 'opts_ssse3', 'opts_sse41', 'opts_sse42', 'opts_avx', 'opts_hsw',
+                            'opts_skx' ],
           'sources': [ '<!@(python read_gni.py ../gn/opts.gni sse2)' ],
         }],
 
@@ -191,6 +192,30 @@
         }],
       ],
     },
+    {
+      'target_name': 'opts_skx',
+      'product_name': 'skia_opts_skx',
+      'type': 'static_library',
+      'standalone_static_library': 1,
+      'dependencies': [ 'core.gyp:*' ],
+      'include_dirs': [
+          '../include/private',
+          '../src/core',
+          '../src/utils',
+      ],
+      'sources': [ '<!@(python read_gni.py ../gn/opts.gni skx)' ],
+      'msvs_settings': { 'VCCLCompilerTool': { 'AdditionalOptions': [ '/arch:AVX512' ] } },
+      'xcode_settings': {
+          'OTHER_CPLUSPLUSFLAGS': [ '-mavx512f', '-mavx512dq', '-mavx512cd', '-mavx512bw',
+                                    '-mavx512vl', '-mavx2', '-mbmi', '-mbmi2', '-mf16c', '-mfma' ]
+      },
+      'conditions': [
+        [ 'not skia_android_framework', {
+            'cflags': [ '-mavx512f', '-mavx512dq', '-mavx512cd', '-mavx512bw', '-mavx512vl',
+                        '-mavx2', '-mbmi', '-mbmi2', '-mf16c', '-mfma' ]
+        }],
+      ],
+    },
     {
       'target_name': 'opts_neon',
       'product_name': 'skia_opts_neon',
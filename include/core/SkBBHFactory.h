@@ -28,4 +28,15 @@ private:
     typedef SkBBHFactory INHERITED;
 };
 
+/**
+ *  Like SkRTreeFactory, but the R-Tree is packed into one flat array, and searched four
+ *  boxes at a time.  Faster to search, especially for pictures with many ops.
+ */
+class SK_API SkPackedRTreeFactory : public SkBBHFactory {
+public:
+    SkBBoxHierarchy* operator()(const SkRect& bounds) const override;
+private:
+    typedef SkBBHFactory INHERITED;
+};
+
 #endif
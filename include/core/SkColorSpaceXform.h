@@ -27,6 +27,7 @@ public:
     enum ColorFormat {
         kRGBA_8888_ColorFormat,
         kBGRA_8888_ColorFormat,
+        kRGB_888_ColorFormat,      // Src only
 
         // Unsigned, big-endian, 16-bit integer
         kRGB_U16_BE_ColorFormat,   // Src only
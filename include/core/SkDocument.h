@@ -82,6 +82,12 @@ public:
          * The date and time the document was most recently modified.
          */
         OptionalTimestamp fModified;
+        /**
+         * If true, compress page contents, encode images and subset
+         * fonts on SkTaskGroup threads.  The output is the same either
+         * way, but page contents are kept in memory until close().
+         */
+        bool fParallel = false;
     };
 
     /**
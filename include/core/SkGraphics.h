@@ -8,10 +8,11 @@
 #ifndef SkGraphics_DEFINED
 #define SkGraphics_DEFINED
 
-#include "SkTypes.h"
+#include "SkRefCnt.h"
 
 class SkData;
 class SkImageGenerator;
+class SkPersistentCache;
 class SkTraceMemoryDump;
 
 class SK_API SkGraphics {
@@ -113,6 +114,14 @@ public:
     static size_t GetResourceCacheSingleAllocationByteLimit();
     static size_t SetResourceCacheSingleAllocationByteLimit(size_t newLimit);
 
+    /**
+     *  Set a cache for the tiles SkPictureShader draws its picture into, to keep them from one run
+     *  of the program to the next.  Tiles are found by the picture's content, not its identity,
+     *  so the cache also helps when drawing the same picture recorded again.  Pass nullptr to
+     *  stop using a cache.  By default there is none.
+     */
+    static void SetPictureShaderTileCache(sk_sp<SkPersistentCache>);
+
     /**
      *  Dumps memory usage of caches using the SkTraceMemoryDump interface. See SkTraceMemoryDump
      *  for usage of this method.
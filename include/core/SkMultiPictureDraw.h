@@ -8,9 +8,12 @@
 #ifndef SkMultiPictureDraw_DEFINED
 #define SkMultiPictureDraw_DEFINED
 
+#include "../private/SkTArray.h"
 #include "../private/SkTDArray.h"
 #include "SkMatrix.h"
 
+#include <memory>
+
 class SkCanvas;
 class SkPaint;
 class SkPicture;
@@ -43,6 +46,27 @@ public:
              const SkMatrix* matrix = NULL,
              const SkPaint* paint = NULL);
 
+    /**
+     *  Add a canvas/picture pair whose single draw should be split across threads.
+     *  The canvas' clip is cut into horizontal bands, and each band plays back on its own
+     *  thread only the ops the picture's bounding box hierarchy says may touch it.  This pays
+     *  off most for large pictures recorded with an SkBBHFactory.  Like any tiled drawing,
+     *  curves crossing a band boundary may be rasterized slightly differently than in one draw.
+     *
+     *  Banding needs direct access to the canvas' pixels and a rectangular clip.  When draw()
+     *  finds otherwise (e.g. a GPU canvas, or a canvas inside a layer) the picture is drawn
+     *  as if passed to add().  As with add(), a canvas shouldn't be the target of more than one
+     *  draw at a time.
+     *
+     *  @param bandCount  number of bands to split into, or <= 0 to pick one from the height
+     *                    of the canvas.
+     */
+    void addBanded(SkCanvas* canvas,
+                   const SkPicture* picture,
+                   const SkMatrix* matrix = NULL,
+                   const SkPaint* paint = NULL,
+                   int bandCount = 0);
+
     /**
      *  Perform all the previously added draws. This will reset the state
      *  of this object. If flush is true, all canvases are flushed after
@@ -61,9 +85,14 @@ private:
         const SkPicture* fPicture; // reffed
         SkMatrix         fMatrix;
         SkPaint*         fPaint;   // owned
+        int              fBandCount; // 0 unless added with addBanded()
 
         void init(SkCanvas*, const SkPicture*, const SkMatrix*, const SkPaint*);
-        void draw();
+        void draw(SkCanvas*) const;
+
+        // Makes one canvas per band, all sharing fCanvas' pixels.  Returns false if fCanvas
+        // can't be banded, leaving bands untouched.
+        bool makeBands(SkTArray<std::unique_ptr<SkCanvas>>* bands) const;
 
         static void Reset(SkTDArray<DrawData>&);
     };
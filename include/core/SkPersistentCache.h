@@ -0,0 +1,35 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPersistentCache_DEFINED
+#define SkPersistentCache_DEFINED
+
+#include "SkData.h"
+#include "SkRefCnt.h"
+
+/**
+ *  Interface for a key-value store that may outlive the process, for results that are slow to
+ *  compute and likely to be needed again, e.g. by the next run of the same program.
+ *
+ *  Keys and values are opaque bytes.  Skia may call load() and store() from any thread.
+ */
+class SK_API SkPersistentCache : public SkRefCnt {
+public:
+    virtual ~SkPersistentCache() {}
+
+    /**
+     *  Returns the data last stored under key, or nullptr if there isn't any.
+     */
+    virtual sk_sp<SkData> load(const SkData& key) = 0;
+
+    /**
+     *  Stores data under key.  The cache is free to drop it, now or later.
+     */
+    virtual void store(const SkData& key, const SkData& data) = 0;
+};
+
+#endif
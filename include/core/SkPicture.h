@@ -64,6 +64,18 @@ public:
                                          SkImageDeserializer* = nullptr);
     static sk_sp<SkPicture> MakeFromData(const SkData* data, SkImageDeserializer* = nullptr);
 
+    /**
+     *  Like MakeFromData(), but rather than copying every op, path and paint into a new
+     *  picture, the returned picture plays back straight from data, which is typically a
+     *  file mapped with SkData::MakeFromFD().  Paths, and encoded images if no deserializer
+     *  is passed, are read the first time they are drawn.
+     *
+     *  If the picture was recorded with a bounding box hierarchy, so is the returned picture,
+     *  and drawing it into a small clip (e.g. one tile) only reads the ops that clip touches.
+     *  The picture keeps data alive for as long as it lives.
+     */
+    static sk_sp<SkPicture> MakeFromMappedData(sk_sp<SkData>, SkImageDeserializer* = nullptr);
+
     /**
      *  Recreate a picture that was serialized into a buffer. If the creation requires bitmap
      *  decoding, the decoder must be set on the SkReadBuffer parameter by calling
@@ -172,13 +184,17 @@ private:
     SkPicture();
     friend class SkBigPicture;
     friend class SkEmptyPicture;
+    friend class SkMappedPicture;
     template <typename> friend class SkMiniPicture;
 
     void serialize(SkWStream*, SkPixelSerializer*, SkRefCntSet* typefaces) const;
-    static sk_sp<SkPicture> MakeFromStream(SkStream*, SkImageDeserializer*, SkTypefacePlayback*);
+    static sk_sp<SkPicture> MakeFromStream(SkStream*, SkImageDeserializer*, SkTypefacePlayback*,
+                                           const SkData* mapped = nullptr);
     friend class SkPictureData;
 
     virtual int numSlowPaths() const = 0;
+    // Pictures with a BBH are serialized with the bounds of each op.
+    virtual bool hasBBH() const { return false; }
     friend class SkPictureGpuAnalyzer;
     friend struct SkPathCounter;
 
@@ -199,10 +215,12 @@ private:
     // V49: Gradients serialized as SkColor4f + SkColorSpace
     // V50: SkXfermode -> SkBlendMode
     // V51: more SkXfermode -> SkBlendMode
+    // V52: Padding tags align the ops and buffer in serialized streams to 4 bytes
+    // V53: Optional op index (offset and bounds of each op) for pictures with a BBH
 
     // Only SKPs within the min/current picture version range (inclusive) can be read.
     static const uint32_t     MIN_PICTURE_VERSION = 35;     // Produced by Chrome M39.
-    static const uint32_t CURRENT_PICTURE_VERSION = 51;
+    static const uint32_t CURRENT_PICTURE_VERSION = 53;
 
     static_assert(MIN_PICTURE_VERSION <= 41,
                   "Remove kFontFileName and related code from SkFontDescriptor.cpp.");
@@ -225,7 +243,7 @@ private:
                                         SkReadBuffer* buffer);
 
     SkPictInfo createHeader() const;
-    SkPictureData* backport() const;
+    SkPictureData* backport(bool withOpIndex = false) const;
 
     mutable uint32_t fUniqueID;
 };
@@ -35,6 +35,11 @@ public:
         // If you call drawPicture() or drawDrawable() on the recording canvas, this flag forces
         // that object to playback its contents immediately rather than reffing the object.
         kPlaybackDrawPicture_RecordFlag     = 1 << 0,
+
+        // Before finishing, reorder draws that don't overlap so similar ones draw together, and
+        // batch the ones we can.  This makes recording slower but may speed up playback, which is
+        // pixel-identical when the picture is drawn at its recorded scale or larger.
+        kOptimizeDrawOrder_RecordFlag       = 1 << 1,
     };
 
     enum FinishFlags {
@@ -58,6 +63,24 @@ public:
         return this->beginRecording(SkRect::MakeWH(width, height), bbhFactory, recordFlags);
     }
 
+    /** Begin re-recording just the damaged part of a picture.  The returned canvas is clipped to
+        damage: draw everything that belongs there, as if recording the whole picture, and the
+        finished picture will show previous outside damage and your new draws inside it.
+        That picture can be updated the same way in turn.  The undamaged parts of previous are
+        shared by reference, not recorded again, so the cost of an update scales with the damage.
+        Draws covered by later damage are eventually dropped, so pictures updated frame after
+        frame don't keep growing.
+        @param previous the picture to update.  It is reffed, so it must be heap allocated.
+        @param damage the area to redraw, rounded out to whole units.
+        @param bbhFactory factory to create desired acceleration structure
+        @param recordFlags optional flags that control recording.
+        @return the canvas.
+    */
+    SkCanvas* beginRecordingDamage(const SkPicture& previous,
+                                   const SkRect& damage,
+                                   SkBBHFactory* bbhFactory = NULL,
+                                   uint32_t recordFlags = 0);
+
     /** Returns the recording canvas if one is active, or NULL if recording is
         not active. This does not alter the refcnt on the canvas (if present).
     */
@@ -100,7 +123,10 @@ public:
     sk_sp<SkDrawable> finishRecordingAsDrawable(uint32_t endFlags = 0);
 
 private:
+    struct Damage;
+
     void reset();
+    void finishRecordingDamage();
 
     /** Replay the current (partially recorded) operation stream into
         canvas. This call doesn't close the current recording.
@@ -118,6 +144,7 @@ private:
     std::unique_ptr<SkRecorder> fRecorder;
     sk_sp<SkRecord>             fRecord;
     SkMiniRecorder              fMiniRecorder;
+    std::unique_ptr<Damage>     fDamage;    // State for beginRecordingDamage().
 
     typedef SkNoncopyable INHERITED;
 };
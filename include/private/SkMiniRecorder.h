@@ -10,6 +10,7 @@
 
 #include "SkRecords.h"
 #include "SkScalar.h"
+#include "SkTLazy.h"
 #include "SkTypes.h"
 class SkCanvas;
 
@@ -51,6 +52,7 @@ private:
         Max<sizeof(SkRecords::DrawRect),
             sizeof(SkRecords::DrawTextBlob)>::val>::val;
     SkAlignedSStorage<kInlineStorage> fBuffer;
+    SkTLazy<SkPaint> fPaint;  // The paint of the op in fBuffer.
 };
 
 #endif//SkMiniRecorder_DEFINED
@@ -0,0 +1,36 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkDirectoryCache_DEFINED
+#define SkDirectoryCache_DEFINED
+
+#include "SkPersistentCache.h"
+#include "SkString.h"
+
+/**
+ *  An SkPersistentCache that keeps each entry in its own file in a local directory, named for a
+ *  hash of its key.  Nothing is ever evicted; clear out the directory to empty the cache.
+ */
+class SK_API SkDirectoryCache : public SkPersistentCache {
+public:
+    /**
+     *  Returns a cache keeping its files in dir, creating dir if needed, or nullptr on failure.
+     */
+    static sk_sp<SkDirectoryCache> Make(const char dir[]);
+
+    sk_sp<SkData> load(const SkData& key) override;
+    void store(const SkData& key, const SkData& data) override;
+
+private:
+    explicit SkDirectoryCache(const char dir[]) : fDir(dir) {}
+
+    SkString path(const SkData& key) const;
+
+    const SkString fDir;
+};
+
+#endif
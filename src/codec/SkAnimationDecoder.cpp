@@ -0,0 +1,285 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkAnimationDecoder.h"
+
+#include <cmath>
+
+std::unique_ptr<SkAnimationDecoder> SkAnimationDecoder::Make(sk_sp<SkData> data,
+                                                             int cachedFrames,
+                                                             int prefetchFrames) {
+    if (!data) {
+        return nullptr;
+    }
+    std::unique_ptr<SkCodec> codec(SkCodec::NewFromData(data));
+    if (!codec) {
+        return nullptr;
+    }
+    SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType);
+    if (kUnpremul_SkAlphaType == info.alphaType()) {
+        info = info.makeAlphaType(kPremul_SkAlphaType);
+    }
+    return std::unique_ptr<SkAnimationDecoder>(new SkAnimationDecoder(
+            std::move(data), std::move(codec), info, cachedFrames, prefetchFrames));
+}
+
+SkAnimationDecoder::SkAnimationDecoder(sk_sp<SkData> data, std::unique_ptr<SkCodec> codec,
+                                       const SkImageInfo& info, int cachedFrames,
+                                       int prefetchFrames)
+    : fData(std::move(data))
+    , fInfo(info)
+    , fCachedFrames(SkTMax(cachedFrames, prefetchFrames + 2))
+    , fPrefetchFrames(SkTMax(prefetchFrames, 0))
+    , fRepetitionCount(codec->getRepetitionCount())
+    , fTotalDuration(0)
+    , fCurrent(0)
+    , fReadyCount(0)
+    , fWaiting(false)
+{
+    std::vector<SkCodec::FrameInfo> infos = codec->getFrameInfo();
+    if (infos.empty()) {
+        // Not animated.
+        infos.push_back({ SkCodec::kNone, 0, true });
+    }
+
+    fFrames.resize(infos.size());
+    for (size_t i = 0; i < infos.size(); i++) {
+        Frame& frame = fFrames[i];
+        frame.fInfo = infos[i];
+        frame.fState = kEmpty_State;
+        fTotalDuration += infos[i].fDuration;
+
+        const size_t required = infos[i].fRequiredFrame;
+        SkASSERT(SkCodec::kNone == required || required < i);
+        if (SkCodec::kNone != required) {
+            fFrames[required].fDependents.push(SkToInt(i));
+        }
+    }
+
+    fIdleCodecs.push_back(std::move(codec));
+}
+
+SkAnimationDecoder::~SkAnimationDecoder() {
+    // Decodes refer back to us, and may launch more decodes as they finish.
+    fTasks.wait();
+}
+
+size_t SkAnimationDecoder::frameAtTime(double msec) const {
+    if (fTotalDuration <= 0 || msec < 0) {
+        return 0;
+    }
+    const double loops = msec / fTotalDuration;
+    if (SkCodec::kRepetitionCountInfinite != fRepetitionCount && loops >= fRepetitionCount + 1) {
+        return fFrames.size() - 1;
+    }
+    double t = msec - std::floor(loops) * fTotalDuration;
+    for (size_t i = 0; i < fFrames.size(); i++) {
+        if (t < fFrames[i].fInfo.fDuration) {
+            return i;
+        }
+        t -= fFrames[i].fInfo.fDuration;
+    }
+    return fFrames.size() - 1;
+}
+
+bool SkAnimationDecoder::getFrame(size_t index, SkBitmap* frame) {
+    SkASSERT(frame);
+    if (index >= fFrames.size()) {
+        return false;
+    }
+
+    SkTArray<Launch> launches;
+    {
+        SkAutoMutexAcquire lock(fMutex);
+        fCurrent = index;
+        this->want(index, &launches);
+    }
+    // Queue this frame before the prefetched ones, so they don't delay it.
+    this->launch(launches);
+    this->prefetch(index + 1, fPrefetchFrames);
+
+    for (;;) {
+        SkAutoMutexAcquire lock(fMutex);
+        const Frame& f = fFrames[index];
+        if (kReady_State == f.fState) {
+            *frame = f.fBitmap;
+            return true;
+        }
+        if (kFailed_State == f.fState) {
+            return false;
+        }
+        // fCurrent is never evicted, so this frame is still on its way.
+        SkASSERT(kWanted_State == f.fState || kDecoding_State == f.fState);
+        fWaiting = true;
+        lock.release();
+        fSignal.wait();
+    }
+}
+
+void SkAnimationDecoder::prefetch(size_t index, int count) {
+    SkTArray<Launch> launches;
+    {
+        SkAutoMutexAcquire lock(fMutex);
+        const size_t n = fFrames.size();
+        for (size_t i = 0; i < SkTMin<size_t>(count, n); i++) {
+            this->want((index + i) % n, &launches);
+        }
+    }
+    this->launch(launches);
+}
+
+void SkAnimationDecoder::want(size_t index, SkTArray<Launch>* launches) {
+    // Walk back through the frames this one requires until we find one that is decoded (or will
+    // be), or one that needs nothing.  Everything on the way waits for it.
+    size_t i = index;
+    while (kEmpty_State == fFrames[i].fState) {
+        Frame& f = fFrames[i];
+        const size_t required = f.fInfo.fRequiredFrame;
+        if (SkCodec::kNone == required) {
+            f.fState = kDecoding_State;
+            launches->push_back({ i, SkBitmap() });
+            return;
+        }
+
+        const Frame& prior = fFrames[required];
+        if (kReady_State == prior.fState) {
+            f.fState = kDecoding_State;
+            launches->push_back({ i, prior.fBitmap });
+            return;
+        }
+        if (kFailed_State == prior.fState) {
+            f.fState = kFailed_State;
+            return;
+        }
+        f.fState = kWanted_State;
+        i = required;
+    }
+}
+
+void SkAnimationDecoder::finished(size_t index, const SkBitmap& bitmap, bool success,
+                                  SkTArray<Launch>* launches) {
+    Frame& f = fFrames[index];
+    SkASSERT(kDecoding_State == f.fState);
+    if (success) {
+        f.fBitmap = bitmap;
+        f.fState = kReady_State;
+        fReadyCount++;
+        for (int dependent : f.fDependents) {
+            if (kWanted_State == fFrames[dependent].fState) {
+                fFrames[dependent].fState = kDecoding_State;
+                launches->push_back({ SkToSizeT(dependent), bitmap });
+            }
+        }
+        this->purge();
+    } else {
+        f.fState = kFailed_State;
+        SkTDArray<int> failed;
+        failed.push(SkToInt(index));
+        while (failed.count() > 0) {
+            int i;
+            failed.pop(&i);
+            for (int dependent : fFrames[i].fDependents) {
+                if (kWanted_State == fFrames[dependent].fState) {
+                    fFrames[dependent].fState = kFailed_State;
+                    failed.push(dependent);
+                }
+            }
+        }
+    }
+
+    if (fWaiting) {
+        fWaiting = false;
+        fSignal.signal();
+    }
+}
+
+bool SkAnimationDecoder::isNeeded(size_t index) const {
+    if (index == fCurrent) {
+        return true;
+    }
+    for (int dependent : fFrames[index].fDependents) {
+        if (kWanted_State == fFrames[dependent].fState) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void SkAnimationDecoder::purge() {
+    const size_t n = fFrames.size();
+    while (fReadyCount > fCachedFrames) {
+        // Drop the frame we'll show last if playback keeps going forward from fCurrent.
+        size_t victim = SkCodec::kNone;
+        size_t farthest = 0;
+        for (size_t i = 0; i < n; i++) {
+            if (kReady_State != fFrames[i].fState || this->isNeeded(i)) {
+                continue;
+            }
+            const size_t distance = (i + n - fCurrent) % n;
+            if (SkCodec::kNone == victim || distance > farthest) {
+                victim = i;
+                farthest = distance;
+            }
+        }
+        if (SkCodec::kNone == victim) {
+            return;
+        }
+        fFrames[victim].fBitmap.reset();
+        fFrames[victim].fState = kEmpty_State;
+        fReadyCount--;
+    }
+}
+
+void SkAnimationDecoder::launch(const SkTArray<Launch>& launches) {
+    for (const Launch& l : launches) {
+        fTasks.add([this, l] { this->decode(l); });
+    }
+}
+
+void SkAnimationDecoder::decode(const Launch& l) {
+    // SkCodecs aren't thread safe, so each decode borrows one of its own.
+    std::unique_ptr<SkCodec> codec;
+    {
+        SkAutoMutexAcquire lock(fMutex);
+        if (!fIdleCodecs.empty()) {
+            codec = std::move(fIdleCodecs.back());
+            fIdleCodecs.pop_back();
+        }
+    }
+    if (!codec) {
+        codec.reset(SkCodec::NewFromData(fData));
+    }
+
+    SkBitmap bitmap;
+    bool success = codec && bitmap.tryAllocPixels(fInfo);
+    if (success) {
+        SkCodec::Options options;
+        options.fFrameIndex = l.fIndex;
+        options.fHasPriorFrame = false;
+        if (!l.fPrior.isNull()) {
+            SkAssertResult(l.fPrior.readPixels(fInfo, bitmap.getPixels(), bitmap.rowBytes(), 0, 0));
+            options.fHasPriorFrame = true;
+        }
+        const SkCodec::Result result = codec->getPixels(fInfo, bitmap.getPixels(),
+                                                        bitmap.rowBytes(), &options,
+                                                        nullptr, nullptr);
+        success = SkCodec::kSuccess == result || SkCodec::kIncompleteInput == result;
+        if (success) {
+            bitmap.setImmutable();
+        }
+    }
+
+    SkTArray<Launch> launches;
+    {
+        SkAutoMutexAcquire lock(fMutex);
+        if (codec) {
+            fIdleCodecs.push_back(std::move(codec));
+        }
+        this->finished(l.fIndex, bitmap, success, &launches);
+    }
+    this->launch(launches);
+}
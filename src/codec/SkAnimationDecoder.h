@@ -0,0 +1,131 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkAnimationDecoder_DEFINED
+#define SkAnimationDecoder_DEFINED
+
+#include "SkBitmap.h"
+#include "SkCodec.h"
+#include "SkData.h"
+#include "SkMutex.h"
+#include "SkSemaphore.h"
+#include "SkTArray.h"
+#include "SkTDArray.h"
+#include "SkTaskGroup.h"
+
+#include <memory>
+#include <vector>
+
+/**
+ *  Decodes the frames of an animated image ahead of when they are shown.
+ *
+ *  Each frame's fRequiredFrame makes the frames a forest: a frame is decoded on top of a copy of
+ *  the frame it requires, or from scratch if it requires none.  Frames whose requirements are met
+ *  are decoded in parallel on SkTaskGroup threads, each with its own SkCodec over the shared
+ *  encoded data, so independent keyframes (and the chains hanging off them) don't wait on each
+ *  other.
+ *
+ *  Decoded frames are kept in a cache of a bounded number of frames.  When it is full, the frame
+ *  furthest ahead of the one most recently asked for (i.e. the one just shown) is dropped first,
+ *  unless a pending decode still needs it.
+ *
+ *  getFrame() and prefetch() must be called from a single thread, which should not be one of the
+ *  SkTaskGroup threads.
+ */
+class SkAnimationDecoder : SkNoncopyable {
+public:
+    /**
+     *  Returns nullptr if the data can't be decoded.  Images that are not animated are treated as
+     *  having a single frame.
+     *
+     *  cachedFrames is how many decoded frames to keep around; prefetchFrames is how many frames
+     *  getFrame() starts decoding past the one it returns.  cachedFrames is raised if needed to
+     *  hold the prefetched frames.
+     */
+    static std::unique_ptr<SkAnimationDecoder> Make(sk_sp<SkData>, int cachedFrames = 8,
+                                                     int prefetchFrames = 4);
+
+    ~SkAnimationDecoder();
+
+    /** The info every frame is decoded to: the codec's info, in N32 premul. */
+    const SkImageInfo& info() const { return fInfo; }
+
+    size_t frameCount() const { return fFrames.size(); }
+    const SkCodec::FrameInfo& frameInfo(size_t index) const { return fFrames[index].fInfo; }
+    int repetitionCount() const { return fRepetitionCount; }
+
+    /**
+     *  Returns the frame to show msec milliseconds after the animation started, following frame
+     *  durations and the repetition count.  Once a finite animation is over, this is the last
+     *  frame.
+     */
+    size_t frameAtTime(double msec) const;
+
+    /**
+     *  Sets *frame to the fully composited frame at index, waiting for it to be decoded if it isn't
+     *  cached, and starts decoding the next prefetchFrames frames (wrapping around) in the
+     *  background.  The returned pixels are immutable and stay valid after the frame is evicted.
+     *
+     *  Returns false if the frame (or a frame it requires) failed to decode.
+     */
+    bool getFrame(size_t index, SkBitmap* frame);
+
+    /** Starts decoding frames [index, index + count), wrapping around, without waiting. */
+    void prefetch(size_t index, int count);
+
+private:
+    enum State {
+        kEmpty_State,       // not decoded, nobody asked for it
+        kWanted_State,      // asked for, waiting on the frame it requires
+        kDecoding_State,    // queued or running on an SkTaskGroup thread
+        kReady_State,       // fBitmap holds the composited frame
+        kFailed_State,      // it or a frame it requires could not be decoded
+    };
+
+    struct Frame {
+        SkCodec::FrameInfo  fInfo;
+        SkTDArray<int>      fDependents;    // frames whose fRequiredFrame is this one
+        SkBitmap            fBitmap;
+        State               fState;
+    };
+
+    struct Launch {
+        size_t      fIndex;
+        SkBitmap    fPrior;     // the composited required frame, or empty
+    };
+
+    SkAnimationDecoder(sk_sp<SkData>, std::unique_ptr<SkCodec>, const SkImageInfo&,
+                       int cachedFrames, int prefetchFrames);
+
+    // These all expect fMutex to be held.
+    void want(size_t index, SkTArray<Launch>* launches);
+    void finished(size_t index, const SkBitmap&, bool success, SkTArray<Launch>* launches);
+    void purge();
+    bool isNeeded(size_t index) const;
+
+    void launch(const SkTArray<Launch>&);
+    void decode(const Launch&);
+
+    const sk_sp<SkData>                     fData;
+    const SkImageInfo                       fInfo;
+    const int                               fCachedFrames;
+    const int                               fPrefetchFrames;
+    int                                     fRepetitionCount;
+    double                                  fTotalDuration;
+
+    SkMutex                                 fMutex;
+    std::vector<Frame>                      fFrames;
+    std::vector<std::unique_ptr<SkCodec>>   fIdleCodecs;
+    size_t                                  fCurrent;
+    int                                     fReadyCount;
+    bool                                    fWaiting;   // getFrame() is blocked on fSignal
+    SkSemaphore                             fSignal;
+
+    SkTaskGroup                             fTasks;
+};
+
+#endif // SkAnimationDecoder_DEFINED
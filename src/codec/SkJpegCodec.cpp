@@ -13,9 +13,13 @@
 #include "SkColorPriv.h"
 #include "SkColorSpace_Base.h"
 #include "SkStream.h"
+#include "SkTArray.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 #include "SkTypes.h"
 
+#include <algorithm>
+
 // stdio is needed for libjpeg-turbo
 #include <stdio.h>
 #include "SkJpegUtility.h"
@@ -288,6 +292,15 @@ SkJpegCodec::SkJpegCodec(int width, int height, const SkEncodedInfo& info, SkStr
     , fSwizzleSrcRow(nullptr)
     , fColorXformSrcRow(nullptr)
     , fSwizzlerSubset(SkIRect::MakeEmpty())
+    , fIncrementalDst(nullptr)
+    , fIncrementalRowBytes(0)
+    , fFirstRow(0)
+    , fLastRow(0)
+    , fBufferedImage(false)
+    , fCompletedScan(0)
+    , fInOutputPass(false)
+    , fOutputRow(0)
+    , fRowsDecoded(0)
 {}
 
 /*
@@ -547,6 +560,314 @@ int SkJpegCodec::readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes
     return count;
 }
 
+/*
+ * Describes where the restart markers fall in a baseline jpeg with a single interleaved scan.
+ */
+struct RestartIntervals {
+    // Header bytes, from SOI through the end of the SOS segment.
+    size_t                  fHeaderSize;
+    // Offset of the 16-bit image height in the SOF segment.
+    size_t                  fHeightOffset;
+    int                     fMcuWidth;
+    int                     fMcuHeight;
+    // Fancy upsampling of vertically subsampled components reads one row above and below.
+    bool                    fNeedsContextRows;
+    // MCUs per restart interval.
+    int                     fInterval;
+    // Entropy coded data for each restart interval, without the RST markers.
+    SkTArray<const uint8_t*> fStarts;
+    SkTArray<const uint8_t*> fEnds;
+};
+
+static int div_round_up(int a, int b) {
+    return (a + b - 1) / b;
+}
+
+static int read_u16(const uint8_t* data) {
+    return (data[0] << 8) | data[1];
+}
+
+/*
+ * Walks the markers of an in-memory jpeg to find its restart intervals.  Returns false if the
+ * image has no restart markers, or is anything other than a complete, baseline (or extended
+ * sequential, Huffman coded) jpeg with all of its components in one scan.
+ */
+static bool find_restart_intervals(const uint8_t* data, size_t length, RestartIntervals* out) {
+    if (length < 4 || 0xFF != data[0] || 0xD8 != data[1]) {
+        return false;
+    }
+
+    const uint8_t* const end = data + length;
+    const uint8_t* ptr = data + 2;
+    int width = 0, height = 0, components = 0;
+    int maxH = 0, maxV = 0, minV = 0;
+    out->fInterval = 0;
+    out->fHeightOffset = 0;
+    while (true) {
+        if (end - ptr < 4 || 0xFF != ptr[0]) {
+            return false;
+        }
+        const uint8_t marker = ptr[1];
+        if (0xFF == marker) {
+            // Fill byte.
+            ptr++;
+            continue;
+        }
+        const uint8_t* segment = ptr + 2;
+        const int segmentLength = read_u16(segment);
+        if (segmentLength < 2 || end - segment < segmentLength) {
+            return false;
+        }
+
+        switch (marker) {
+            case 0xC0:
+            case 0xC1:
+                if (segmentLength < 8) {
+                    return false;
+                }
+                out->fHeightOffset = segment + 3 - data;
+                height = read_u16(segment + 3);
+                width = read_u16(segment + 5);
+                components = segment[7];
+                if (0 == components || segmentLength < 8 + 3 * components) {
+                    return false;
+                }
+                for (int i = 0; i < components; i++) {
+                    const int h = segment[9 + 3 * i] >> 4;
+                    const int v = segment[9 + 3 * i] & 0xF;
+                    maxH = SkTMax(maxH, h);
+                    maxV = SkTMax(maxV, v);
+                    minV = (0 == i) ? v : SkTMin(minV, v);
+                }
+                break;
+            case 0xC2: case 0xC3: case 0xC5: case 0xC6: case 0xC7:
+            case 0xC9: case 0xCA: case 0xCB: case 0xCD: case 0xCE: case 0xCF:
+                // Progressive, lossless, hierarchical, or arithmetic coded.
+                return false;
+            case 0xDD:
+                if (segmentLength < 4) {
+                    return false;
+                }
+                out->fInterval = read_u16(segment + 2);
+                break;
+            default:
+                break;
+        }
+        ptr = segment + segmentLength;
+
+        if (0xDA == marker) {
+            if (0 == out->fHeightOffset || segment[2] != components) {
+                return false;
+            }
+            break;
+        }
+    }
+
+    if (0 == out->fInterval || 0 == width || 0 == height || 0 == minV || maxH > 4 || maxV > 4) {
+        return false;
+    }
+
+    // A single component scan is not interleaved, so its MCU is just one block.
+    if (1 == components) {
+        maxH = maxV = minV = 1;
+    }
+    out->fHeaderSize = ptr - data;
+    out->fMcuWidth = 8 * maxH;
+    out->fMcuHeight = 8 * maxV;
+    out->fNeedsContextRows = minV != maxV;
+
+    // Split the entropy coded data at each RST marker, stopping at EOI.
+    out->fStarts.reset();
+    out->fEnds.reset();
+    out->fStarts.push_back(ptr);
+    while (true) {
+        ptr = (const uint8_t*) memchr(ptr, 0xFF, end - ptr);
+        if (!ptr) {
+            // Truncated.
+            return false;
+        }
+        const uint8_t* markerEnd = ptr + 1;
+        while (markerEnd < end && 0xFF == *markerEnd) {
+            markerEnd++;
+        }
+        if (markerEnd == end) {
+            return false;
+        }
+
+        const uint8_t marker = *markerEnd;
+        if (0x00 == marker) {
+            // Stuffed zero, part of the data.
+        } else if (marker >= 0xD0 && marker <= 0xD7) {
+            out->fEnds.push_back(ptr);
+            out->fStarts.push_back(markerEnd + 1);
+        } else if (0xD9 == marker) {
+            out->fEnds.push_back(ptr);
+            break;
+        } else {
+            // DNL, or the start of another scan.
+            return false;
+        }
+        ptr = markerEnd + 1;
+    }
+
+    const int mcusPerRow = div_round_up(width, out->fMcuWidth);
+    const int mcuRows = div_round_up(height, out->fMcuHeight);
+    const int64_t mcuCount = (int64_t) mcusPerRow * mcuRows;
+    return out->fStarts.count() == (mcuCount + out->fInterval - 1) / out->fInterval;
+}
+
+/*
+ * Builds a standalone jpeg that decodes to MCU rows [startRow, endRow) of the original.
+ */
+static sk_sp<SkData> make_restart_segment(const uint8_t* data, int height,
+                                          const RestartIntervals& intervals, int mcusPerRow,
+                                          int startRow, int endRow) {
+    const int first = startRow * mcusPerRow / intervals.fInterval;
+    const int last = SkTMin(intervals.fStarts.count(),
+                            div_round_up(endRow * mcusPerRow, intervals.fInterval));
+
+    size_t size = intervals.fHeaderSize;
+    for (int i = first; i < last; i++) {
+        size += intervals.fEnds[i] - intervals.fStarts[i] + 2;
+    }
+
+    sk_sp<SkData> segment = SkData::MakeUninitialized(size);
+    uint8_t* dst = (uint8_t*) segment->writable_data();
+    memcpy(dst, data, intervals.fHeaderSize);
+    const int segmentHeight = SkTMin(height, endRow * intervals.fMcuHeight)
+                            - startRow * intervals.fMcuHeight;
+    dst[intervals.fHeightOffset + 0] = segmentHeight >> 8;
+    dst[intervals.fHeightOffset + 1] = segmentHeight & 0xFF;
+    dst += intervals.fHeaderSize;
+
+    for (int i = first; i < last; i++) {
+        const size_t bytes = intervals.fEnds[i] - intervals.fStarts[i];
+        memcpy(dst, intervals.fStarts[i], bytes);
+        dst += bytes;
+        // Renumber the RST markers so that the segment's first one is RST0, and end with EOI.
+        *dst++ = 0xFF;
+        *dst++ = (i + 1 < last) ? 0xD0 + ((i - first) & 7) : 0xD9;
+    }
+    SkASSERT(dst == segment->bytes() + size);
+    return segment;
+}
+
+/*
+ * Jpegs with restart markers can be decoded in pieces, starting at any MCU row that begins a
+ * restart interval.  We split such images into horizontal bands, and decode each one in parallel
+ * with its own SkJpegCodec, so everything still goes through the same swizzling and color xforms.
+ */
+bool SkJpegCodec::decodeInParallel(const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes,
+                                   const Options& options) {
+    // Don't bother with less than this many rows per band.
+    static constexpr int kMinBandHeight = 128;
+
+    if (this->getInfo().height() < 2 * kMinBandHeight) {
+        return false;
+    }
+
+    const uint8_t* data = (const uint8_t*) this->stream()->getMemoryBase();
+    if (!data || !this->stream()->hasLength()) {
+        return false;
+    }
+
+    RestartIntervals intervals;
+    if (!find_restart_intervals(data, this->stream()->getLength(), &intervals)) {
+        return false;
+    }
+
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    if ((8 * dinfo->scale_num) % dinfo->scale_denom) {
+        return false;
+    }
+    const int num = 8 * dinfo->scale_num / dinfo->scale_denom;
+    const int height = this->getInfo().height();
+    const int mcuHeight = intervals.fMcuHeight;
+    const int mcusPerRow = div_round_up(this->getInfo().width(), intervals.fMcuWidth);
+    const int mcuRows = div_round_up(height, mcuHeight);
+    // Each MCU row scales to a whole number of rows, since mcuHeight is a multiple of 8.
+    const int dstRowsPerMcuRow = mcuHeight * num / 8;
+
+    // Find the MCU rows that we can start decoding from.
+    SkTArray<int> restartRows;
+    for (int row = 0; row < mcuRows; row++) {
+        if (0 == ((int64_t) row * mcusPerRow) % intervals.fInterval) {
+            restartRows.push_back(row);
+        }
+    }
+    restartRows.push_back(mcuRows);
+
+    // Group them into bands of at least kMinBandHeight rows.
+    SkTArray<int> bandRows;
+    bandRows.push_back(0);
+    for (int i = 1; i < restartRows.count(); i++) {
+        if ((restartRows[i] - bandRows.back()) * mcuHeight >= kMinBandHeight
+                && (mcuRows - restartRows[i]) * mcuHeight >= kMinBandHeight) {
+            bandRows.push_back(restartRows[i]);
+        }
+    }
+    bandRows.push_back(mcuRows);
+    const int bandCount = bandRows.count() - 1;
+    if (bandCount < 2) {
+        return false;
+    }
+
+    SkAutoTArray<bool> succeeded(bandCount);
+    SkTaskGroup().batch(bandCount, [&](int band) {
+        succeeded[band] = false;
+
+        // When fancy upsampling needs context rows, decode one extra restart interval above and
+        // below the band.  We throw away the extra rows.
+        const int startRow = bandRows[band];
+        const int endRow = bandRows[band + 1];
+        int decodeStartRow = startRow;
+        int decodeEndRow = endRow;
+        if (intervals.fNeedsContextRows) {
+            const int* start = std::lower_bound(restartRows.begin(), restartRows.end(), startRow);
+            const int* end = std::lower_bound(restartRows.begin(), restartRows.end(), endRow);
+            decodeStartRow = (start == restartRows.begin()) ? startRow : start[-1];
+            decodeEndRow = (endRow == mcuRows) ? endRow : end[1];
+        }
+
+        sk_sp<SkData> segment = make_restart_segment(data, height, intervals, mcusPerRow,
+                                                     decodeStartRow, decodeEndRow);
+        std::unique_ptr<SkCodec> codec(SkJpegCodec::NewFromStream(new SkMemoryStream(segment)));
+        if (!codec) {
+            return;
+        }
+
+        const int skipRows = (startRow - decodeStartRow) * dstRowsPerMcuRow;
+        const int dstTop = startRow * dstRowsPerMcuRow;
+        const int dstBottom = SkTMin(dstInfo.height(), endRow * dstRowsPerMcuRow);
+        const int segmentHeight = SkTMin(height, decodeEndRow * mcuHeight)
+                                - decodeStartRow * mcuHeight;
+        const SkImageInfo segmentInfo = dstInfo.makeWH(dstInfo.width(),
+                                                       div_round_up(segmentHeight * num, 8));
+        if (kSuccess != codec->startScanlineDecode(segmentInfo, &options, nullptr, nullptr)) {
+            return;
+        }
+
+        if (skipRows > 0) {
+            SkAutoTMalloc<uint8_t> storage(skipRows * dstRowBytes);
+            if (skipRows != codec->getScanlines(storage.get(), skipRows, dstRowBytes)) {
+                return;
+            }
+        }
+
+        const int rows = dstBottom - dstTop;
+        succeeded[band] = rows == codec->getScanlines(SkTAddOffset<void>(dst, dstTop * dstRowBytes),
+                                                      rows, dstRowBytes);
+    });
+
+    for (int band = 0; band < bandCount; band++) {
+        if (!succeeded[band]) {
+            SkCodecPrintf("Failed to decode restart intervals in parallel.\n");
+            return false;
+        }
+    }
+    return true;
+}
+
 /*
  * Performs the jpeg decode
  */
@@ -576,6 +897,10 @@ SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo,
         return fDecoderMgr->returnFailure("setOutputColorSpace", kInvalidConversion);
     }
 
+    if (this->decodeInParallel(dstInfo, dst, dstRowBytes, options)) {
+        return kSuccess;
+    }
+
     if (!jpeg_start_decompress(dinfo)) {
         return fDecoderMgr->returnFailure("startDecompress", kInvalidInput);
     }
@@ -664,8 +989,7 @@ SkSampler* SkJpegCodec::getSampler(bool createIfNecessary) {
     return fSwizzler.get();
 }
 
-SkCodec::Result SkJpegCodec::onStartScanlineDecode(const SkImageInfo& dstInfo,
-        const Options& options, SkPMColor ctable[], int* ctableCount) {
+SkCodec::Result SkJpegCodec::startDecode(const SkImageInfo& dstInfo, const Options& options) {
     // Set the jump location for libjpeg errors
     if (setjmp(fDecoderMgr->getJmpBuf())) {
         SkCodecPrintf("setjmp: Error from libjpeg\n");
@@ -690,6 +1014,16 @@ SkCodec::Result SkJpegCodec::onStartScanlineDecode(const SkImageInfo& dstInfo,
         uint32_t startX = options.fSubset->x();
         uint32_t width = options.fSubset->width();
 
+        // Fancy upsampling treats the edges of the crop like the edges of the image.  When the
+        // chroma is subsampled horizontally, ask for a pixel more on either side where there is
+        // one, so the edges of the subset come out as they would in a full decode.
+        jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+        if (dinfo->max_h_samp_factor > 1) {
+            uint32_t right = SkTMin(startX + width + 1, dinfo->output_width);
+            startX = startX > 0 ? startX - 1 : 0;
+            width = right - startX;
+        }
+
         // libjpeg-turbo may need to align startX to a multiple of the IDCT
         // block size.  If this is the case, it will decrease the value of
         // startX to the appropriate alignment and also increase the value
@@ -733,6 +1067,151 @@ SkCodec::Result SkJpegCodec::onStartScanlineDecode(const SkImageInfo& dstInfo,
     return kSuccess;
 }
 
+SkCodec::Result SkJpegCodec::onStartScanlineDecode(const SkImageInfo& dstInfo,
+        const Options& options, SkPMColor ctable[], int* ctableCount) {
+    return this->startDecode(dstInfo, options);
+}
+
+SkCodec::Result SkJpegCodec::onStartIncrementalDecode(const SkImageInfo& dstInfo,
+        void* dst, size_t rowBytes, const Options& options, SkPMColor*, int*) {
+    // In buffered-image mode, jpeg_start_decompress() returns without reading any scans, and
+    // we can show each scan as it arrives.  Cropping would have to be redone for each output
+    // pass, so subsets wait for all of the scans, as before.
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    fBufferedImage = !options.fSubset && jpeg_has_multiple_scans(dinfo);
+    dinfo->buffered_image = fBufferedImage;
+
+    const Result result = this->startDecode(dstInfo, options);
+    if (kSuccess != result) {
+        return result;
+    }
+
+    fIncrementalDst = dst;
+    fIncrementalRowBytes = rowBytes;
+    fCompletedScan = 0;
+    fInOutputPass = false;
+    fOutputRow = 0;
+    fRowsDecoded = 0;
+    if (fBufferedImage) {
+        fDecoderMgr->srcMgr()->setSuspending();
+    }
+    if (options.fSubset) {
+        fFirstRow = options.fSubset->top();
+        fLastRow = options.fSubset->bottom() - 1;
+    } else {
+        fFirstRow = 0;
+        fLastRow = dstInfo.height() - 1;
+    }
+    return kSuccess;
+}
+
+SkCodec::Result SkJpegCodec::onIncrementalDecode(int* rowsDecoded) {
+    if (fBufferedImage) {
+        return this->incrementalDecodeScans(rowsDecoded);
+    }
+
+    // The sampler may have been set up after we started, so check it now.
+    // onSkipScanlines() and readRows() each set their own jump location for libjpeg errors.
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    const int sampleY = fSwizzler ? fSwizzler->sampleY() : 1;
+    const int count = get_scaled_dimension(fLastRow - fFirstRow + 1, sampleY);
+    for (int y = 0; y < count; y++) {
+        // Skip everything up to the next row we want in one go.  libjpeg-turbo can then skip
+        // whole iMCU rows, only entropy decoding them.
+        const int srcY = fFirstRow + get_start_coord(sampleY) + y * sampleY;
+        const int skip = srcY - (int) dinfo->output_scanline;
+        void* dst = SkTAddOffset<void>(fIncrementalDst, y * fIncrementalRowBytes);
+        if ((skip > 0 && !this->onSkipScanlines(skip)) ||
+                1 != this->readRows(this->dstInfo(), dst, fIncrementalRowBytes, 1,
+                                    this->options())) {
+            if (rowsDecoded) {
+                *rowsDecoded = y;
+            }
+            // This allows us to skip calling jpeg_finish_decompress().
+            dinfo->output_scanline = dinfo->output_height;
+            return fDecoderMgr->returnFailure("Incomplete image data", kIncompleteInput);
+        }
+    }
+
+    // Like the scanline decoder, we leave any rows below the subset alone.
+    return kSuccess;
+}
+
+SkCodec::Result SkJpegCodec::incrementalDecodeScans(int* rowsDecoded) {
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    skjpeg_source_mgr* src = fDecoderMgr->srcMgr();
+    const int sampleY = fSwizzler ? fSwizzler->sampleY() : 1;
+    const int count = get_scaled_dimension(this->dstInfo().height(), sampleY);
+    while (true) {
+        // Set the jump location for libjpeg errors.  readRows() and onSkipScanlines() set
+        // their own, so this is done again after calling them.
+        if (setjmp(fDecoderMgr->getJmpBuf())) {
+            return fDecoderMgr->returnFailure("setjmp", kInvalidInput);
+        }
+
+        if (!fInOutputPass) {
+            // Take in all of the data we have, noting the last scan that is complete.
+            while (true) {
+                const int status = jpeg_consume_input(dinfo);
+                if (JPEG_SCAN_COMPLETED == status || JPEG_REACHED_EOI == status) {
+                    fCompletedScan = dinfo->input_scan_number;
+                }
+                if (JPEG_REACHED_EOI == status ||
+                        (JPEG_SUSPENDED == status && !src->readMoreData())) {
+                    break;
+                }
+            }
+
+            if (fCompletedScan <= dinfo->output_scan_number) {
+                // Nothing new to show.
+                if (rowsDecoded) {
+                    *rowsDecoded = fRowsDecoded;
+                }
+                return kIncompleteInput;
+            }
+
+            // Show the latest scan we have, skipping any that arrived in the meantime.
+            if (!jpeg_start_output(dinfo, fCompletedScan)) {
+                return fDecoderMgr->returnFailure("startOutput", kInvalidInput);
+            }
+            fInOutputPass = true;
+            fOutputRow = 0;
+        }
+
+        for (; fOutputRow < count; fOutputRow++) {
+            const int srcY = get_start_coord(sampleY) + fOutputRow * sampleY;
+            const int skip = srcY - (int) dinfo->output_scanline;
+            void* dst = SkTAddOffset<void>(fIncrementalDst, fOutputRow * fIncrementalRowBytes);
+            if ((skip > 0 && !this->onSkipScanlines(skip)) ||
+                    1 != this->readRows(this->dstInfo(), dst, fIncrementalRowBytes, 1,
+                                        this->options())) {
+                // The scan we are showing is complete, so this is an error, not a lack of data.
+                return fDecoderMgr->returnFailure("readRows", kInvalidInput);
+            }
+        }
+        fRowsDecoded = count;
+
+        if (setjmp(fDecoderMgr->getJmpBuf())) {
+            return fDecoderMgr->returnFailure("setjmp", kInvalidInput);
+        }
+
+        // This reads ahead to the start of the next scan.
+        while (!jpeg_finish_output(dinfo)) {
+            if (!src->readMoreData()) {
+                if (rowsDecoded) {
+                    *rowsDecoded = fRowsDecoded;
+                }
+                return kIncompleteInput;
+            }
+        }
+        fInOutputPass = false;
+
+        if (jpeg_input_complete(dinfo) && dinfo->output_scan_number == dinfo->input_scan_number) {
+            return kSuccess;
+        }
+    }
+}
+
 int SkJpegCodec::onGetScanlines(void* dst, int count, size_t dstRowBytes) {
     int rows = this->readRows(this->dstInfo(), dst, dstRowBytes, count, this->options());
     if (rows < count) {
@@ -107,6 +107,20 @@ private:
     void allocateStorage(const SkImageInfo& dstInfo);
     int readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, int count, const Options&);
 
+    /*
+     * Decodes images with restart markers in horizontal bands, in parallel.
+     * Returns false if the image cannot be split up this way, or if any band fails to decode,
+     * in which case the caller should decode serially.
+     */
+    bool decodeInParallel(const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes,
+                          const Options&);
+
+    /*
+     * Shared setup for scanline and incremental decodes.  Starts decompressing, and asks
+     * libjpeg-turbo to skip the MCUs left and right of options.fSubset, if any.
+     */
+    Result startDecode(const SkImageInfo& dstInfo, const Options& options);
+
     /*
      * Scanline decoding.
      */
@@ -116,6 +130,18 @@ private:
     int onGetScanlines(void* dst, int count, size_t rowBytes) override;
     bool onSkipScanlines(int count) override;
 
+    /*
+     * Incremental decoding.  Only the rows in the subset (and of those, only the rows the
+     * sampler keeps) are decoded; the rest are skipped without running the IDCT.
+     *
+     * Progressive images (without a subset) are decoded in libjpeg's buffered-image mode
+     * instead, which redraws the whole image each time another scan has arrived.
+     */
+    Result onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+            const Options&, SkPMColor* ctable, int* ctableCount) override;
+    Result onIncrementalDecode(int* rowsDecoded) override;
+    Result incrementalDecodeScans(int* rowsDecoded);
+
     std::unique_ptr<JpegDecoderMgr>    fDecoderMgr;
 
     // We will save the state of the decompress struct after reading the header.
@@ -134,6 +160,19 @@ private:
 
     std::unique_ptr<SkSwizzler>        fSwizzler;
 
+    // Where an incremental decode writes, and which rows of the scaled image it covers.
+    void*                              fIncrementalDst;
+    size_t                             fIncrementalRowBytes;
+    int                                fFirstRow;
+    int                                fLastRow;
+
+    // State of a buffered-image incremental decode.
+    bool                               fBufferedImage;
+    int                                fCompletedScan;  // last scan with all of its data in
+    bool                               fInOutputPass;   // jpeg_finish_output() not done yet
+    int                                fOutputRow;      // next row of this pass to write
+    int                                fRowsDecoded;    // rows written by any pass
+
     typedef SkCodec INHERITED;
 };
 
@@ -23,6 +23,11 @@ static void sk_init_source(j_decompress_ptr dinfo) {
  */
 static boolean sk_fill_input_buffer(j_decompress_ptr dinfo) {
     skjpeg_source_mgr* src = (skjpeg_source_mgr*) dinfo->src;
+    if (src->fSuspending) {
+        // Suspend.  The caller will append more data with readMoreData().
+        return false;
+    }
+
     size_t bytes = src->fStream->read(src->fBuffer, skjpeg_source_mgr::kBufferSize);
 
     // libjpeg is still happy with a less than full read, as long as the result is non-zero
@@ -44,6 +49,13 @@ static void sk_skip_input_data(j_decompress_ptr dinfo, long numBytes) {
 
     if (bytes > src->bytes_in_buffer) {
         size_t bytesToSkip = bytes - src->bytes_in_buffer;
+        if (src->fSuspending) {
+            // The stream may not have all of these yet.  Skip the rest when it does.
+            src->fBytesToSkip += bytesToSkip - src->fStream->skip(bytesToSkip);
+            src->next_input_byte += src->bytes_in_buffer;
+            src->bytes_in_buffer = 0;
+            return;
+        }
         if (bytesToSkip != src->fStream->skip(bytesToSkip)) {
             SkCodecPrintf("Failure to skip.\n");
             dinfo->err->error_exit((j_common_ptr) dinfo);
@@ -75,6 +87,9 @@ static void sk_term_source(j_decompress_ptr dinfo)
  */
 skjpeg_source_mgr::skjpeg_source_mgr(SkStream* stream)
     : fStream(stream)
+    , fSuspending(false)
+    , fSuspendedCapacity(0)
+    , fBytesToSkip(0)
 {
     init_source = sk_init_source;
     fill_input_buffer = sk_fill_input_buffer;
@@ -83,6 +98,43 @@ skjpeg_source_mgr::skjpeg_source_mgr(SkStream* stream)
     term_source = sk_term_source;
 }
 
+void skjpeg_source_mgr::setSuspending() {
+    if (fSuspending) {
+        return;
+    }
+
+    // Move what is left of fBuffer, so that readMoreData() only has one buffer to deal with.
+    fSuspending = true;
+    fSuspendedCapacity = bytes_in_buffer + kBufferSize;
+    fSuspendedData.reset(fSuspendedCapacity);
+    memcpy(fSuspendedData.get(), next_input_byte, bytes_in_buffer);
+    next_input_byte = (const JOCTET*) fSuspendedData.get();
+}
+
+bool skjpeg_source_mgr::readMoreData() {
+    SkASSERT(fSuspending);
+    if (fBytesToSkip > 0) {
+        const size_t skipped = fStream->skip(fBytesToSkip);
+        fBytesToSkip -= skipped;
+        if (fBytesToSkip > 0) {
+            return skipped > 0;
+        }
+    }
+
+    // Keep the unconsumed input, since libjpeg may need to go over it again.
+    const size_t unread = bytes_in_buffer;
+    memmove(fSuspendedData.get(), next_input_byte, unread);
+    if (unread + kBufferSize > fSuspendedCapacity) {
+        fSuspendedCapacity = unread + kBufferSize;
+        fSuspendedData.realloc(fSuspendedCapacity);
+    }
+
+    const size_t bytes = fStream->read(fSuspendedData.get() + unread, kBufferSize);
+    next_input_byte = (const JOCTET*) fSuspendedData.get();
+    bytes_in_buffer = unread + bytes;
+    return bytes > 0;
+}
+
 /*
  * Call longjmp to continue execution on an error
  */
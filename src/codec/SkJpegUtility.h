@@ -10,6 +10,7 @@
 #define SkJpegUtility_codec_DEFINED
 
 #include "SkStream.h"
+#include "SkTemplates.h"
 
 #include <setjmp.h>
 // stdio is needed for jpeglib
@@ -38,6 +39,18 @@ void skjpeg_err_exit(j_common_ptr cinfo);
 struct skjpeg_source_mgr : jpeg_source_mgr {
     skjpeg_source_mgr(SkStream* stream);
 
+    /*
+     * Makes this a suspending data source.  When it runs out of data, libjpeg returns to
+     * the caller, which may call readMoreData() and then retry once the stream has more.
+     */
+    void setSuspending();
+
+    /*
+     * Appends more of the stream to the input libjpeg has not consumed yet.  Only valid for
+     * a suspending source.  Returns false if the stream has nothing more for now.
+     */
+    bool readMoreData();
+
     SkStream* fStream; // unowned
     enum {
         // TODO (msarett): Experiment with different buffer sizes.
@@ -45,6 +58,14 @@ struct skjpeg_source_mgr : jpeg_source_mgr {
         kBufferSize = 1024
     };
     uint8_t fBuffer[kBufferSize];
+
+    // When libjpeg suspends, it backs up to the last point where it saved its state, so a
+    // suspending source keeps all of the unconsumed input around rather than refilling fBuffer.
+    bool                   fSuspending;
+    SkAutoTMalloc<uint8_t> fSuspendedData;
+    size_t                 fSuspendedCapacity;
+    // Bytes libjpeg asked to skip that the stream did not have yet.
+    size_t                 fBytesToSkip;
 };
 
 #endif
@@ -10,6 +10,7 @@
 #include "SkColorPriv.h"
 #include "SkColorSpace.h"
 #include "SkColorSpacePriv.h"
+#include "SkColorSpace_XYZ.h"
 #include "SkColorTable.h"
 #include "SkMath.h"
 #include "SkOpts.h"
@@ -441,14 +442,33 @@ static SkColorSpaceXform::ColorFormat png_select_xform_format(const SkEncodedInf
         } else if (SkEncodedInfo::kRGB_Color == info.color()) {
             return SkColorSpaceXform::kRGB_U16_BE_ColorFormat;
         }
+    } else if (SkEncodedInfo::kRGB_Color == info.color()) {
+        return SkColorSpaceXform::kRGB_888_ColorFormat;
     }
 
     return SkColorSpaceXform::kRGBA_8888_ColorFormat;
 }
 
+// SkColorSpaceXform can load 8-bit RGB directly, but only through its pipeline.  When the
+// destination gamma is a table, its RGBA_8888 path is faster, even counting the swizzle.
+static bool png_xform_rgb_888_directly(const SkImageInfo& dstInfo) {
+    const SkColorSpace* dstSpace = dstInfo.colorSpace();
+    if (!dstSpace || SkColorSpace_Base::Type::kXYZ != as_CSB(dstSpace)->type()) {
+        return true;
+    }
+
+    switch (static_cast<const SkColorSpace_XYZ*>(dstSpace)->gammaNamed()) {
+        case kLinear_SkGammaNamed:
+        case kSRGB_SkGammaNamed:
+        case k2Dot2Curve_SkGammaNamed:
+            return true;
+        default:
+            return false;
+    }
+}
+
 void SkPngCodec::applyXformRow(void* dst, const void* src) {
-    const SkColorSpaceXform::ColorFormat srcColorFormat =
-            png_select_xform_format(this->getEncodedInfo());
+    const SkColorSpaceXform::ColorFormat srcColorFormat = fXformSrcColorFormat;
     switch (fXformMode) {
         case kSwizzleOnly_XformMode:
             fSwizzler->swizzle(dst, (const uint8_t*) src);
@@ -1058,6 +1078,7 @@ SkPngCodec::SkPngCodec(const SkEncodedInfo& encodedInfo, const SkImageInfo& imag
     , fInfo_ptr(info_ptr)
     , fColorXformSrcRow(nullptr)
     , fBitDepth(bitDepth)
+    , fXformSrcColorFormat(SkColorSpaceXform::kRGBA_8888_ColorFormat)
 #ifdef SK_GOOGLE3_PNG_HACK
     , fNeedsToRereadHeader(true)
 #endif
@@ -1098,11 +1119,13 @@ bool SkPngCodec::initializeXforms(const SkImageInfo& dstInfo, const Options& opt
     }
 
     // If SkColorSpaceXform directly supports the encoded PNG format, we should skip format
-    // conversion in the swizzler (or skip swizzling altogether).
+    // conversion in the swizzler (or skip swizzling altogether).  The xform then loads,
+    // converts, premultiplies and stores each row in a single pass.
     bool skipFormatConversion = false;
     switch (this->getEncodedInfo().color()) {
         case SkEncodedInfo::kRGB_Color:
-            if (this->getEncodedInfo().bitsPerComponent() != 16) {
+            if (8 == this->getEncodedInfo().bitsPerComponent() &&
+                !png_xform_rgb_888_directly(dstInfo)) {
                 break;
             }
 
@@ -1113,6 +1136,8 @@ bool SkPngCodec::initializeXforms(const SkImageInfo& dstInfo, const Options& opt
         default:
             break;
     }
+    fXformSrcColorFormat = skipFormatConversion ? png_select_xform_format(this->getEncodedInfo())
+                                                : SkColorSpaceXform::kRGBA_8888_ColorFormat;
     if (skipFormatConversion && !options.fSubset) {
         fXformMode = kColorOnly_XformMode;
         return true;
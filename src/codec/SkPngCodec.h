@@ -128,6 +128,7 @@ private:
     virtual Result decode(int* rowsDecoded) = 0;
 
     XformMode                      fXformMode;
+    SkColorSpaceXform::ColorFormat fXformSrcColorFormat;   // What the swizzler hands the xform.
     SkColorSpaceXform::ColorFormat fXformColorFormat;
     SkAlphaType                    fXformAlphaType;
     int                            fXformWidth;
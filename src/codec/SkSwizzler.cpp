@@ -41,6 +41,17 @@ static void sample2(void* dst, const uint8_t* src, int width, int bpp, int delta
     }
 }
 
+static void sample3(void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+    src += offset;
+    uint8_t* dst8 = (uint8_t*) dst;
+    for (int x = 0; x < width; x++) {
+        memcpy(dst8, src, 3);
+        dst8 += 3;
+        src += deltaSrc;
+    }
+}
+
 static void sample4(void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
         const SkPMColor ctable[]) {
     src += offset;
@@ -296,6 +307,17 @@ static void swizzle_index_to_n32_skipZ(
     }
 }
 
+static void fast_swizzle_index_to_n32(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::index8_to_8888((uint32_t*) dst, src + offset, width, ctable);
+}
+
 static void swizzle_index_to_565(
       void* SK_RESTRICT dstRow, const uint8_t* SK_RESTRICT src, int dstWidth,
       int bytesPerPixel, int deltaSrc, int offset, const SkPMColor ctable[]) {
@@ -562,6 +584,17 @@ static void swizzle_rgb16_to_rgba(
     }
 }
 
+static void fast_swizzle_rgb16_to_rgba(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGB16_to_RGB1((uint32_t*) dst, src + offset, width);
+}
+
 static void swizzle_rgb16_to_bgra(
         void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
         const SkPMColor ctable[]) {
@@ -577,6 +610,17 @@ static void swizzle_rgb16_to_bgra(
     }
 }
 
+static void fast_swizzle_rgb16_to_bgra(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGB16_to_BGR1((uint32_t*) dst, src + offset, width);
+}
+
 static void swizzle_rgb16_to_565(
         void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
         const SkPMColor ctable[]) {
@@ -607,6 +651,17 @@ static void swizzle_rgba16_to_rgba_unpremul(
     }
 }
 
+static void fast_swizzle_rgba16_to_rgba_unpremul(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGBA16_to_RGBA((uint32_t*) dst, src + offset, width);
+}
+
 static void swizzle_rgba16_to_rgba_premul(
         void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
         const SkPMColor ctable[]) {
@@ -622,6 +677,17 @@ static void swizzle_rgba16_to_rgba_premul(
     }
 }
 
+static void fast_swizzle_rgba16_to_rgba_premul(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGBA16_to_rgbA((uint32_t*) dst, src + offset, width);
+}
+
 static void swizzle_rgba16_to_bgra_unpremul(
         void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
         const SkPMColor ctable[]) {
@@ -637,6 +703,17 @@ static void swizzle_rgba16_to_bgra_unpremul(
     }
 }
 
+static void fast_swizzle_rgba16_to_bgra_unpremul(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGBA16_to_BGRA((uint32_t*) dst, src + offset, width);
+}
+
 static void swizzle_rgba16_to_bgra_premul(
         void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
         const SkPMColor ctable[]) {
@@ -652,6 +729,17 @@ static void swizzle_rgba16_to_bgra_premul(
     }
 }
 
+static void fast_swizzle_rgba16_to_bgra_premul(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGBA16_to_bgrA((uint32_t*) dst, src + offset, width);
+}
+
 // kCMYK
 //
 // CMYK is stored as four bytes per pixel.
@@ -865,9 +953,15 @@ SkSwizzler* SkSwizzler::CreateSwizzler(const SkEncodedInfo& encodedInfo,
                 break;
             case SkEncodedInfo::kRGB_Color:
                 // We have a png that remains in its original format.
-                SkASSERT(16 == encodedInfo.bitsPerComponent());
-                srcBPP = 6;
-                proc = &sample6;
+                SkASSERT(16 == encodedInfo.bitsPerComponent() ||
+                          8 == encodedInfo.bitsPerComponent());
+                if (8 == encodedInfo.bitsPerComponent()) {
+                    srcBPP = 3;
+                    proc = &sample3;
+                } else {
+                    srcBPP = 6;
+                    proc = &sample6;
+                }
                 fastProc = &copy;
                 break;
             default:
@@ -985,6 +1079,7 @@ SkSwizzler* SkSwizzler::CreateSwizzler(const SkEncodedInfo& encodedInfo,
                                     proc = &swizzle_index_to_n32_skipZ;
                                 } else {
                                     proc = &swizzle_index_to_n32;
+                                    fastProc = &fast_swizzle_index_to_n32;
                                 }
                                 break;
                             case kRGB_565_SkColorType:
@@ -1007,6 +1102,7 @@ SkSwizzler* SkSwizzler::CreateSwizzler(const SkEncodedInfo& encodedInfo,
                     case kRGBA_8888_SkColorType:
                         if (16 == encodedInfo.bitsPerComponent()) {
                             proc = &swizzle_rgb16_to_rgba;
+                            fastProc = &fast_swizzle_rgb16_to_rgba;
                             break;
                         }
 
@@ -1017,6 +1113,7 @@ SkSwizzler* SkSwizzler::CreateSwizzler(const SkEncodedInfo& encodedInfo,
                     case kBGRA_8888_SkColorType:
                         if (16 == encodedInfo.bitsPerComponent()) {
                             proc = &swizzle_rgb16_to_bgra;
+                            fastProc = &fast_swizzle_rgb16_to_bgra;
                             break;
                         }
 
@@ -1042,6 +1139,8 @@ SkSwizzler* SkSwizzler::CreateSwizzler(const SkEncodedInfo& encodedInfo,
                         if (16 == encodedInfo.bitsPerComponent()) {
                             proc = premultiply ? &swizzle_rgba16_to_rgba_premul :
                                                  &swizzle_rgba16_to_rgba_unpremul;
+                            fastProc = premultiply ? &fast_swizzle_rgba16_to_rgba_premul :
+                                                     &fast_swizzle_rgba16_to_rgba_unpremul;
                             break;
                         }
 
@@ -1069,6 +1168,8 @@ SkSwizzler* SkSwizzler::CreateSwizzler(const SkEncodedInfo& encodedInfo,
                         if (16 == encodedInfo.bitsPerComponent()) {
                             proc = premultiply ? &swizzle_rgba16_to_bgra_premul :
                                                  &swizzle_rgba16_to_bgra_unpremul;
+                            fastProc = premultiply ? &fast_swizzle_rgba16_to_bgra_premul :
+                                                     &fast_swizzle_rgba16_to_bgra_unpremul;
                             break;
                         }
 
@@ -1239,6 +1340,7 @@ SkSwizzler::SkSwizzler(RowProc fastProc, RowProc proc, const SkPMColor* ctable,
     , fSampleX(1)
     , fSrcBPP(srcBPP)
     , fDstBPP(dstBPP)
+    , fGather(false)
 {}
 
 int SkSwizzler::onSetSampleX(int sampleX) {
@@ -1250,13 +1352,13 @@ int SkSwizzler::onSetSampleX(int sampleX) {
     fSwizzleWidth = get_scaled_dimension(fSrcWidth, sampleX);
     fAllocatedWidth = get_scaled_dimension(fDstWidth, sampleX);
 
-    // The optimized swizzler functions do not support sampling.  Sampled swizzles
-    // are already fast because they skip pixels.  We haven't seen a situation
-    // where speeding up sampling has a significant impact on total decode time.
-    if (1 == fSampleX && fFastProc) {
-        fActualProc = fFastProc;
-    } else {
-        fActualProc = fSlowProc;
+    // The optimized swizzler functions do not support sampling themselves.  Instead we
+    // gather the sampled pixels into a packed row and run the optimized function on that.
+    // Gathering is all that copy() would have to do, so it can gather straight into dst.
+    fActualProc = fFastProc ? fFastProc : fSlowProc;
+    fGather = fFastProc && 1 != fSampleX;
+    if (fGather && &copy != fFastProc) {
+        fGatheredRow.reset(fSwizzleWidth * fSrcBPP);
     }
 
     return fAllocatedWidth;
@@ -1264,6 +1366,18 @@ int SkSwizzler::onSetSampleX(int sampleX) {
 
 void SkSwizzler::swizzle(void* dst, const uint8_t* SK_RESTRICT src) {
     SkASSERT(nullptr != dst && nullptr != src);
-    fActualProc(SkTAddOffset<void>(dst, fDstOffsetBytes), src, fSwizzleWidth, fSrcBPP,
-            fSampleX * fSrcBPP, fSrcOffsetUnits, fColorTable);
+    dst = SkTAddOffset<void>(dst, fDstOffsetBytes);
+    if (fGather) {
+        // Only formats with whole bytes per pixel have optimized functions.
+        const bool copying = &copy == fFastProc;
+        uint8_t* packed = copying ? (uint8_t*) dst : fGatheredRow.get();
+        SkOpts::gather_pixels(packed, src + fSrcOffsetUnits, fSwizzleWidth, fSrcBPP,
+                              fSampleX * fSrcBPP);
+        if (!copying) {
+            fActualProc(dst, packed, fSwizzleWidth, fSrcBPP, fSrcBPP, 0, fColorTable);
+        }
+        return;
+    }
+    fActualProc(dst, src, fSwizzleWidth, fSrcBPP, fSampleX * fSrcBPP, fSrcOffsetUnits,
+            fColorTable);
 }
@@ -12,6 +12,7 @@
 #include "SkColor.h"
 #include "SkImageInfo.h"
 #include "SkSampler.h"
+#include "SkTemplates.h"
 
 class SkSwizzler : public SkSampler {
 public:
@@ -207,6 +208,11 @@ private:
                                           //     fBPP is bitsPerPixel
     const int           fDstBPP;          // Bytes per pixel for the destination color type
 
+    // When sampling with fFastProc, we first gather the sampled pixels into fGatheredRow, so
+    // fFastProc can run on them as if they were a full row.
+    bool                    fGather;
+    SkAutoTMalloc<uint8_t>  fGatheredRow;
+
     SkSwizzler(RowProc fastProc, RowProc proc, const SkPMColor* ctable, int srcOffset,
             int srcWidth, int dstOffset, int dstWidth, int srcBPP, int dstBPP);
 
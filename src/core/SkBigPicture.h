@@ -56,6 +56,9 @@ public:
 // Used by GrRecordReplaceDraw
     const SkBBoxHierarchy* bbh() const { return fBBH.get(); }
     const SkRecord*     record() const { return fRecord.get(); }
+// Used by SkPictureRecorder::beginRecordingDamage()
+    int drawableCount() const;
+    SkPicture const* const* drawablePicts() const;
 
 private:
     struct Analysis {
@@ -68,9 +71,8 @@ private:
     };
 
     int numSlowPaths() const override;
+    bool hasBBH() const override { return fBBH != nullptr; }
     const Analysis& analysis() const;
-    int drawableCount() const;
-    SkPicture const* const* drawablePicts() const;
 
     const SkRect                         fCullRect;
     const size_t                         fApproxBytesUsedBySubPictures;
@@ -133,6 +133,7 @@ private:
     friend class SkDeviceFilteredPaint;
 
     friend class SkSurface_Raster;
+    friend class SkThreadedBMPDevice;  // to copy fBitmap and draw through a wrapped device
 
     // used to change the backend's pixels (and possibly config/rowbytes)
     // but cannot change the width/height, so there should be no change to
@@ -422,6 +422,38 @@ void SkRectClipBlitter::blitMask(const SkMask& mask, const SkIRect& clip) {
     }
 }
 
+void SkRectClipBlitter::blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) {
+    if (fClipRect.contains(x, y) && fClipRect.contains(x + 1, y)) {
+        // Forwarded as is, in case the real blitter specializes it.
+        fBlitter->blitAntiH2(x, y, a0, a1);
+    } else {
+        this->INHERITED::blitAntiH2(x, y, a0, a1);
+    }
+}
+
+void SkRectClipBlitter::blitAntiV2(int x, int y, U8CPU a0, U8CPU a1) {
+    const bool in0 = fClipRect.contains(x, y),
+               in1 = fClipRect.contains(x, y + 1);
+    if (in0 && in1) {
+        fBlitter->blitAntiV2(x, y, a0, a1);
+        return;
+    }
+    if (!in0 && !in1) {
+        return;
+    }
+    // Blitters may blend differently in blitAntiH2/V2 than in blitAntiH, so keep the surviving
+    // pixel on that path by pairing it with a zero-coverage neighbor on the same row.
+    const int    py = in0 ? y : y + 1;
+    const U8CPU  a  = in0 ? a0 : a1;
+    if (fClipRect.contains(x + 1, py)) {
+        fBlitter->blitAntiH2(x, py, a, 0);
+    } else if (fClipRect.contains(x - 1, py)) {
+        fBlitter->blitAntiH2(x - 1, py, 0, a);
+    } else {
+        this->INHERITED::blitAntiV2(x, y, a0, a1);
+    }
+}
+
 const SkPixmap* SkRectClipBlitter::justAnOpaqueColor(uint32_t* value) {
     return fBlitter->justAnOpaqueColor(value);
 }
@@ -190,6 +190,8 @@ public:
     void blitRect(int x, int y, int width, int height) override;
     virtual void blitAntiRect(int x, int y, int width, int height,
                      SkAlpha leftAlpha, SkAlpha rightAlpha) override;
+    void blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) override;
+    void blitAntiV2(int x, int y, U8CPU a0, U8CPU a1) override;
     void blitMask(const SkMask&, const SkIRect& clip) override;
     const SkPixmap* justAnOpaqueColor(uint32_t* value) override;
 
@@ -204,6 +206,8 @@ public:
 private:
     SkBlitter*  fBlitter;
     SkIRect     fClipRect;
+
+    typedef SkBlitter INHERITED;
 };
 
 /** Wraps another (real) blitter, and ensures that the real blitter is only
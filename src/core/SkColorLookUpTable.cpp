@@ -8,6 +8,10 @@
 #include "SkColorLookUpTable.h"
 #include "SkFloatingPoint.h"
 
+int SkColorLookUpTable::inputChannels() const {
+    return fInputChannels;
+}
+
 void SkColorLookUpTable::interp(float* dst, const float* src) const {
     if (fInputChannels == 3) {
         interp3D(dst, src);
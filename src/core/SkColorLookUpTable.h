@@ -33,7 +33,8 @@ public:
      */
     void interp(float* dst, const float* src) const;
 
-    int inputChannels() const { return fInputChannels; }
+    // Out of line so SkRasterPipeline_opts.h can call it from any SkOpts tier.
+    int inputChannels() const;
 
     int outputChannels() const { return kOutputChannels; }
     
@@ -1105,6 +1105,7 @@ bool SkColorSpaceXform_XYZ<kCSM>
     }
 
     if (kRGBA_F32_ColorFormat == dstColorFormat ||
+        kRGB_888_ColorFormat == srcColorFormat ||
         kRGBA_U16_BE_ColorFormat == srcColorFormat ||
         kRGB_U16_BE_ColorFormat == srcColorFormat)
     {
@@ -1206,6 +1207,20 @@ bool SkColorSpaceXform_XYZ<kCSM>
 
             pipeline.append(SkRasterPipeline::swap_rb);
             break;
+        case kRGB_888_ColorFormat:
+            switch (fSrcGamma) {
+                case kLinear_SrcGamma:
+                    pipeline.append(SkRasterPipeline::load_rgb_888, &src);
+                    break;
+                default:
+                    loadTables.fSrc = src;
+                    loadTables.fR = fSrcGammaTables[0];
+                    loadTables.fG = fSrcGammaTables[1];
+                    loadTables.fB = fSrcGammaTables[2];
+                    pipeline.append(SkRasterPipeline::load_tables_rgb_888, &loadTables);
+                    break;
+            }
+            break;
         case kRGBA_U16_BE_ColorFormat:
             switch (fSrcGamma) {
                 case kLinear_SrcGamma:
@@ -28,6 +28,9 @@ bool SkColorSpaceXform_A2B::onApply(ColorFormat dstFormat, void* dst, ColorForma
         case kRGBA_8888_ColorFormat:
             pipeline.append(SkRasterPipeline::load_8888, &src);
             break;
+        case kRGB_888_ColorFormat:
+            pipeline.append(SkRasterPipeline::load_rgb_888, &src);
+            break;
         case kRGBA_U16_BE_ColorFormat:
             pipeline.append(SkRasterPipeline::load_u16_be, &src);
             break;
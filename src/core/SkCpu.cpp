@@ -58,6 +58,15 @@
             if (abcd[1] & (1<<5)) { features |= SkCpu::AVX2; }
             if (abcd[1] & (1<<3)) { features |= SkCpu::BMI1; }
             if (abcd[1] & (1<<8)) { features |= SkCpu::BMI2; }
+
+            // AVX-512 also needs the OS to save the opmask and upper ZMM registers.
+            if ((xgetbv(0) & 0xe0) == 0xe0) {
+                if (abcd[1] & (1<<16)) { features |= SkCpu::AVX512F;  }
+                if (abcd[1] & (1<<17)) { features |= SkCpu::AVX512DQ; }
+                if (abcd[1] & (1<<28)) { features |= SkCpu::AVX512CD; }
+                if (abcd[1] & (1<<30)) { features |= SkCpu::AVX512BW; }
+                if (abcd[1] & (1u<<31)) { features |= SkCpu::AVX512VL; }
+            }
         }
         return features;
     }
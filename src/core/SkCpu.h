@@ -25,8 +25,17 @@ struct SkCpu {
         BMI1  = 1 << 10,
         BMI2  = 1 << 11,
 
+        AVX512F  = 1 << 12,
+        AVX512DQ = 1 << 13,
+        AVX512CD = 1 << 14,
+        AVX512BW = 1 << 15,
+        AVX512VL = 1 << 16,
+
         // Handy alias for all the cool Haswell+ instructions.
         HSW = AVX2 | BMI1 | BMI2 | F16C | FMA,
+
+        // And for the AVX-512 subsets available on Skylake-SP (Xeon) and later.
+        SKX = AVX512F | AVX512DQ | AVX512CD | AVX512BW | AVX512VL | HSW,
     };
     enum {
         NEON     = 1 << 0,
@@ -72,6 +81,9 @@ inline bool SkCpu::Supports(uint32_t mask) {
     #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
     features |= AVX2;
     #endif
+    #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SKX
+    features |= AVX512F | AVX512DQ | AVX512CD | AVX512BW | AVX512VL;
+    #endif
     // FMA doesn't fit neatly into this total ordering.
     // It's available on Haswell+ just like AVX2, but it's technically a different bit.
     // TODO: circle back on this if we find ourselves limited by lack of compile-time FMA
@@ -44,6 +44,18 @@
 // See SkFindAndPlaceGlyph.h for more details.
 void FixGCC49Arm64Bug(int v) { }
 
+/** Returns blitter, wrapped in clipper if bounds is not null, so that nothing is written outside
+    of bounds.  Unlike clipping, this does not change how the geometry itself is rasterized.
+ */
+static SkBlitter* clip_to_blit_bounds(const SkIRect* bounds, SkBlitter* blitter,
+                                      SkRectClipBlitter* clipper) {
+    if (nullptr == bounds) {
+        return blitter;
+    }
+    clipper->init(blitter, *bounds);
+    return clipper;
+}
+
 /** Helper for allocating small blitters on the stack.
  */
 class SkAutoBlitterChoose : SkNoncopyable {
@@ -55,6 +67,12 @@ public:
                         const SkPaint& paint, bool drawCoverage = false) {
         fBlitter = SkBlitter::Choose(dst, matrix, paint, &fAllocator, drawCoverage);
     }
+    // Also restricts the blitter to draw.fBlitBounds, if any.
+    SkAutoBlitterChoose(const SkDraw& draw, const SkMatrix& matrix,
+                        const SkPaint& paint, bool drawCoverage = false) {
+        fBlitter = nullptr;
+        this->choose(draw, matrix, paint, drawCoverage);
+    }
 
     SkBlitter*  operator->() { return fBlitter; }
     SkBlitter*  get() const { return fBlitter; }
@@ -64,11 +82,17 @@ public:
         SkASSERT(!fBlitter);
         fBlitter = SkBlitter::Choose(dst, matrix, paint, &fAllocator, drawCoverage);
     }
+    void choose(const SkDraw& draw, const SkMatrix& matrix,
+                const SkPaint& paint, bool drawCoverage = false) {
+        this->choose(draw.fDst, matrix, paint, drawCoverage);
+        fBlitter = clip_to_blit_bounds(draw.fBlitBounds, fBlitter, &fBoundsClipper);
+    }
 
 private:
     // Owned by fAllocator, which will handle the delete.
     SkBlitter*          fBlitter;
     SkTBlitterAllocator fAllocator;
+    SkRectClipBlitter   fBoundsClipper;
 };
 #define SkAutoBlitterChoose(...) SK_REQUIRE_LOCAL_VAR(SkAutoBlitterChoose)
 
@@ -275,7 +299,10 @@ void SkDraw::drawPaint(const SkPaint& paint) const {
 
             SkRegion::Iterator iter(fRC->bwRgn());
             while (!iter.done()) {
-                CallBitmapXferProc(fDst, iter.rect(), proc, procData);
+                SkIRect r = iter.rect();
+                if (!fBlitBounds || r.intersect(*fBlitBounds)) {
+                    CallBitmapXferProc(fDst, r, proc, procData);
+                }
                 iter.next();
             }
             return;
@@ -283,7 +310,7 @@ void SkDraw::drawPaint(const SkPaint& paint) const {
     }
 
     // normal case: use a blitter
-    SkAutoBlitterChoose blitter(fDst, *fMatrix, paint);
+    SkAutoBlitterChoose blitter(*this, *fMatrix, paint);
     SkScan::FillIRect(devRect, *fRC, blitter.get());
 }
 
@@ -294,6 +321,8 @@ struct PtProcRec {
     const SkPaint*  fPaint;
     const SkRegion* fClip;
     const SkRasterClip* fRC;
+    // Callers that write straight to the pixels must stay inside these too, if set.
+    const SkIRect* fBlitBounds = nullptr;
 
     // computed values
     SkFixed fRadius;
@@ -327,7 +356,10 @@ static void bw_pt_rect_16_hair_proc(const PtProcRec& rec,
                                     const SkPoint devPts[], int count,
                                     SkBlitter* blitter) {
     SkASSERT(rec.fRC->isRect());
-    const SkIRect& r = rec.fRC->getBounds();
+    SkIRect r = rec.fRC->getBounds();
+    if (rec.fBlitBounds && !r.intersect(*rec.fBlitBounds)) {
+        return;
+    }
     uint32_t value;
     const SkPixmap* dst = blitter->justAnOpaqueColor(&value);
     SkASSERT(dst);
@@ -348,7 +380,10 @@ static void bw_pt_rect_32_hair_proc(const PtProcRec& rec,
                                     const SkPoint devPts[], int count,
                                     SkBlitter* blitter) {
     SkASSERT(rec.fRC->isRect());
-    const SkIRect& r = rec.fRC->getBounds();
+    SkIRect r = rec.fRC->getBounds();
+    if (rec.fBlitBounds && !r.intersect(*rec.fBlitBounds)) {
+        return;
+    }
     uint32_t value;
     const SkPixmap* dst = blitter->justAnOpaqueColor(&value);
     SkASSERT(dst);
@@ -557,11 +592,12 @@ void SkDraw::drawPoints(SkCanvas::PointMode mode, size_t count,
 
     PtProcRec rec;
     if (!forceUseDevice && rec.init(mode, paint, fMatrix, fRC)) {
-        SkAutoBlitterChoose blitter(fDst, *fMatrix, paint);
+        SkAutoBlitterChoose blitter(*this, *fMatrix, paint);
 
         SkPoint             devPts[MAX_DEV_PTS];
         const SkMatrix*     matrix = fMatrix;
         SkBlitter*          bltr = blitter.get();
+        rec.fBlitBounds = fBlitBounds;
         PtProcRec::Proc     proc = rec.chooseProc(&bltr);
         // we have to back up subsequent passes if we're in polygon mode
         const size_t backup = (SkCanvas::kPolygon_PointMode == mode);
@@ -862,6 +898,18 @@ void SkDraw::drawRect(const SkRect& prePaintRect, const SkPaint& paint,
         const SkRasterClip& clip = looper.getRC();
         SkBlitter*          blitter = blitterStorage.get();
 
+        SkIRect             localBlitBounds;
+        SkRectClipBlitter   boundsClipper;
+        if (fBlitBounds) {
+            SkRect r;
+            looper.mapRect(&r, SkRect::Make(*fBlitBounds));
+            r.round(&localBlitBounds);
+            if (!localBlitBounds.intersect(clip.getBounds())) {
+                continue;
+            }
+            blitter = clip_to_blit_bounds(&localBlitBounds, blitter, &boundsClipper);
+        }
+
         // we want to "fill" if we are kFill or kStrokeAndFill, since in the latter
         // case we are also hairline (if we've gotten to here), which devolves to
         // effectively just kFill
@@ -907,7 +955,7 @@ void SkDraw::drawDevMask(const SkMask& srcM, const SkPaint& paint) const {
     }
     SkAutoMaskFreeImage ami(dstM.fImage);
 
-    SkAutoBlitterChoose blitterChooser(fDst, *fMatrix, paint);
+    SkAutoBlitterChoose blitterChooser(*this, *fMatrix, paint);
     SkBlitter* blitter = blitterChooser.get();
 
     SkAAClipBlitterWrapper wrapper;
@@ -985,7 +1033,7 @@ void SkDraw::drawRRect(const SkRRect& rrect, const SkPaint& paint) const {
         // Transform the rrect into device space.
         SkRRect devRRect;
         if (rrect.transform(*fMatrix, &devRRect)) {
-            SkAutoBlitterChoose blitter(fDst, *fMatrix, paint);
+            SkAutoBlitterChoose blitter(*this, *fMatrix, paint);
             if (paint.getMaskFilter()->filterRRect(devRRect, *fMatrix, *fRC, blitter.get())) {
                 return; // filterRRect() called the blitter, so we're done
             }
@@ -1039,7 +1087,7 @@ void SkDraw::drawDevPath(const SkPath& devPath, const SkPaint& paint, bool drawC
     SkBlitter* blitter = nullptr;
     SkAutoBlitterChoose blitterStorage;
     if (nullptr == customBlitter) {
-        blitterStorage.choose(fDst, *fMatrix, paint, drawCoverage);
+        blitterStorage.choose(*this, *fMatrix, paint, drawCoverage);
         blitter = blitterStorage.get();
     } else {
         blitter = customBlitter;
@@ -1328,8 +1376,9 @@ void SkDraw::drawBitmap(const SkBitmap& bitmap, const SkMatrix& prematrix,
             // blitter will be owned by the allocator.
             SkBlitter* blitter = SkBlitter::ChooseSprite(fDst, *paint, pmap, ix, iy, &allocator);
             if (blitter) {
+                SkRectClipBlitter boundsClipper;
                 SkScan::FillIRect(SkIRect::MakeXYWH(ix, iy, pmap.width(), pmap.height()),
-                                  *fRC, blitter);
+                                  *fRC, clip_to_blit_bounds(fBlitBounds, blitter, &boundsClipper));
                 return;
             }
             // if !blitter, then we fall-through to the slower case
@@ -1385,7 +1434,9 @@ void SkDraw::drawSprite(const SkBitmap& bitmap, int x, int y, const SkPaint& ori
         // blitter will be owned by the allocator.
         SkBlitter* blitter = SkBlitter::ChooseSprite(fDst, paint, pmap, x, y, &allocator);
         if (blitter) {
-            SkScan::FillIRect(bounds, *fRC, blitter);
+            SkRectClipBlitter boundsClipper;
+            SkScan::FillIRect(bounds, *fRC,
+                              clip_to_blit_bounds(fBlitBounds, blitter, &boundsClipper));
             return;
         }
     }
@@ -1612,7 +1663,7 @@ void SkDraw::drawText(const char text[], size_t byteLength,
     SkAutoGlyphCache cache(paint, &fDevice->surfaceProps(), this->scalerContextFlags(), fMatrix);
 
     // The Blitter Choose needs to be live while using the blitter below.
-    SkAutoBlitterChoose    blitterChooser(fDst, *fMatrix, paint);
+    SkAutoBlitterChoose    blitterChooser(*this, *fMatrix, paint);
     SkAAClipBlitterWrapper wrapper(*fRC, blitterChooser.get());
     DrawOneGlyph           drawOneGlyph(*this, paint, cache.get(), wrapper.getBlitter());
 
@@ -1694,7 +1745,7 @@ void SkDraw::drawPosText(const char text[], size_t byteLength,
     SkAutoGlyphCache cache(paint, &fDevice->surfaceProps(), this->scalerContextFlags(), fMatrix);
 
     // The Blitter Choose needs to be live while using the blitter below.
-    SkAutoBlitterChoose    blitterChooser(fDst, *fMatrix, paint);
+    SkAutoBlitterChoose    blitterChooser(*this, *fMatrix, paint);
     SkAAClipBlitterWrapper wrapper(*fRC, blitterChooser.get());
     DrawOneGlyph           drawOneGlyph(*this, paint, cache.get(), wrapper.getBlitter());
     SkPaint::Align         textAlignment = paint.getTextAlign();
@@ -1943,6 +1994,9 @@ void SkDraw::drawVertices(SkCanvas::VertexMode vmode, int count,
     if (blitter->isNullBlitter()) {
         return;
     }
+    // The shader context is reset on blitter itself, so clip to fBlitBounds separately.
+    SkRectClipBlitter boundsClipper;
+    SkBlitter* triBlitter = clip_to_blit_bounds(fBlitBounds, blitter.get(), &boundsClipper);
 
     // setup our state and function pointer for iterating triangles
     VertState       state(count, indices, indexCount);
@@ -1970,7 +2024,7 @@ void SkDraw::drawVertices(SkCanvas::VertexMode vmode, int count,
             SkPoint tmp[] = {
                 devVerts[state.f0], devVerts[state.f1], devVerts[state.f2]
             };
-            SkScan::FillTriangle(tmp, *fRC, blitter.get());
+            SkScan::FillTriangle(tmp, *fRC, triBlitter);
             triShader->bindSetupData(NULL);
         }
     } else {
@@ -1981,7 +2035,7 @@ void SkDraw::drawVertices(SkCanvas::VertexMode vmode, int count,
             SkPoint array[] = {
                 devVerts[state.f0], devVerts[state.f1], devVerts[state.f2], devVerts[state.f0]
             };
-            hairProc(array, 4, clip, blitter.get());
+            hairProc(array, 4, clip, triBlitter);
         }
     }
 }
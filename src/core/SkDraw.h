@@ -152,6 +152,9 @@ public:
 
     const SkClipStack* fClipStack;  // optional, may be null
     SkBaseDevice*   fDevice;        // optional, may be null
+    // optional, may be null: if set, pixels outside these bounds are left untouched, while
+    // antialiasing, mask filters, etc. are still computed against fRC.
+    const SkIRect*  fBlitBounds;
 
 #ifdef SK_DEBUG
     void validate() const;
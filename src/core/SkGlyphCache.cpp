@@ -10,6 +10,7 @@
 #include "SkGraphics.h"
 #include "SkOnce.h"
 #include "SkPath.h"
+#include "SkTLS.h"
 #include "SkTemplates.h"
 #include "SkTraceMemoryDump.h"
 #include "SkTypeface.h"
@@ -449,10 +450,96 @@ int SkGlyphCache_Globals::setCacheCountLimit(int newCount) {
 }
 
 void SkGlyphCache_Globals::purgeAll() {
+    fPurgeGeneration.fetch_add(1, std::memory_order_relaxed);
     SkAutoExclusive ac(fLock);
     this->internalPurge(fTotalMemoryUsed);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+/*  Each thread holds on to the few strikes it attached most recently, so the common pattern of
+    detaching and reattaching the same strikes over and over never takes the global lock.
+
+    Like any detached strike, these are invisible to other threads and to the budget.  They go
+    back to the global list when pushed out by a newer strike, when they grow too large, or when
+    the thread exits.  When any thread purges the whole cache, each thread drops its strikes the
+    next time it looks at them.
+*/
+static const int    kThreadCacheCount    = 4;
+static const size_t kThreadCacheMaxBytes = 256 * 1024;    // per strike
+
+struct ThreadCaches {
+    SkGlyphCache* fCaches[kThreadCacheCount];   // most recently attached first
+    int           fCount;
+    int32_t       fPurgeGeneration;
+};
+
+static void* create_thread_caches() {
+    ThreadCaches* caches = new ThreadCaches;
+    caches->fCount = 0;
+    caches->fPurgeGeneration = get_globals().getPurgeGeneration();
+    return caches;
+}
+
+static void delete_thread_caches(void* ptr) {
+    ThreadCaches* caches = static_cast<ThreadCaches*>(ptr);
+    for (int i = 0; i < caches->fCount; i++) {
+        get_globals().attachCacheToHead(caches->fCaches[i]);
+    }
+    delete caches;
+}
+
+static ThreadCaches* get_thread_caches() {
+    ThreadCaches* caches =
+        static_cast<ThreadCaches*>(SkTLS::Get(create_thread_caches, delete_thread_caches));
+
+    const int32_t generation = get_globals().getPurgeGeneration();
+    if (caches->fPurgeGeneration != generation) {
+        for (int i = 0; i < caches->fCount; i++) {
+            SkGlyphCache_Globals::DeleteDetachedCache(caches->fCaches[i]);
+        }
+        caches->fCount = 0;
+        caches->fPurgeGeneration = generation;
+    }
+    return caches;
+}
+
+// Returns a strike matching desc that this thread was holding on to, or nullptr.
+static SkGlyphCache* detach_thread_cache(const SkDescriptor& desc) {
+    ThreadCaches* caches = get_thread_caches();
+    for (int i = 0; i < caches->fCount; i++) {
+        SkGlyphCache* cache = caches->fCaches[i];
+        if (cache->getDescriptor() == desc) {
+            memmove(&caches->fCaches[i], &caches->fCaches[i + 1],
+                    (caches->fCount - i - 1) * sizeof(SkGlyphCache*));
+            caches->fCount -= 1;
+            return cache;
+        }
+    }
+    return nullptr;
+}
+
+static void attach_thread_cache(SkGlyphCache* cache) {
+    // Big strikes go straight back where the budget can see them.
+    if (cache->getMemoryUsed() > kThreadCacheMaxBytes) {
+        get_globals().attachCacheToHead(cache);
+        return;
+    }
+
+    ThreadCaches* caches = get_thread_caches();
+    SkGlyphCache* oldest = nullptr;
+    if (caches->fCount == kThreadCacheCount) {
+        oldest = caches->fCaches[--caches->fCount];
+    }
+    memmove(&caches->fCaches[1], &caches->fCaches[0], caches->fCount * sizeof(SkGlyphCache*));
+    caches->fCaches[0] = cache;
+    caches->fCount += 1;
+
+    if (oldest) {
+        get_globals().attachCacheToHead(oldest);
+    }
+}
+
 /*  This guy calls the visitor from within the mutext lock, so the visitor
     cannot:
     - take too much time
@@ -482,6 +569,15 @@ SkGlyphCache* SkGlyphCache::VisitCache(SkTypeface* typeface,
     SkGlyphCache_Globals& globals = get_globals();
     SkGlyphCache*         cache;
 
+    // Try the strikes this thread is holding on to first, which needs no lock.
+    if ((cache = detach_thread_cache(*desc))) {
+        if (!proc(cache, context)) {
+            attach_thread_cache(cache);
+            cache = nullptr;
+        }
+        return cache;
+    }
+
     {
         SkAutoExclusive ac(globals.fLock);
 
@@ -508,6 +604,7 @@ SkGlyphCache* SkGlyphCache::VisitCache(SkTypeface* typeface,
         std::unique_ptr<SkScalerContext> ctx = typeface->createScalerContext(effects, desc, true);
         if (!ctx) {
             get_globals().purgeAll();
+            get_thread_caches();    // Drops this thread's strikes right away too.
             ctx = typeface->createScalerContext(effects, desc, false);
             SkASSERT(ctx);
         }
@@ -517,7 +614,7 @@ SkGlyphCache* SkGlyphCache::VisitCache(SkTypeface* typeface,
     AutoValidate av(cache);
 
     if (!proc(cache, context)) {   // need to reattach
-        globals.attachCacheToHead(cache);
+        attach_thread_cache(cache);
         cache = nullptr;
     }
     return cache;
@@ -527,7 +624,7 @@ void SkGlyphCache::AttachCache(SkGlyphCache* cache) {
     SkASSERT(cache);
     SkASSERT(cache->fNext == nullptr);
 
-    get_globals().attachCacheToHead(cache);
+    attach_thread_cache(cache);
 }
 
 static void dump_visitor(const SkGlyphCache& cache, void* context) {
@@ -13,6 +13,8 @@
 #include "SkSpinlock.h"
 #include "SkTLS.h"
 
+#include <atomic>
+
 #ifndef SK_DEFAULT_FONT_CACHE_COUNT_LIMIT
     #define SK_DEFAULT_FONT_CACHE_COUNT_LIMIT   2048
 #endif
@@ -31,6 +33,7 @@ public:
         fCacheSizeLimit = SK_DEFAULT_FONT_CACHE_LIMIT;
         fCacheCount = 0;
         fCacheCountLimit = SK_DEFAULT_FONT_CACHE_COUNT_LIMIT;
+        fPurgeGeneration = 0;
     }
 
     ~SkGlyphCache_Globals() {
@@ -64,9 +67,17 @@ public:
 
     void purgeAll(); // does not change budget
 
+    // Bumped by purgeAll(), so threads know to drop the strikes they're holding on to.
+    int32_t getPurgeGeneration() const {
+        return fPurgeGeneration.load(std::memory_order_relaxed);
+    }
+
     // call when a glyphcache is available for caching (i.e. not in use)
     void attachCacheToHead(SkGlyphCache*);
 
+    // for strikes that were detached and will never be reattached
+    static void DeleteDetachedCache(SkGlyphCache* cache) { delete cache; }
+
     // can only be called when the mutex is already held
     void internalDetachCache(SkGlyphCache*);
     void internalAttachCacheToHead(SkGlyphCache*);
@@ -77,6 +88,7 @@ private:
     size_t  fCacheSizeLimit;
     int32_t fCacheCountLimit;
     int32_t fCacheCount;
+    std::atomic<int32_t> fPurgeGeneration;
 
     // Checkout budgets, modulated by the specified min-bytes-needed-to-purge,
     // and attempt to purge caches to match.
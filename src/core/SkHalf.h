@@ -114,4 +114,25 @@ static inline Sk8h SkFloatToHalf_finite_ftz(const Sk8f& fs) {
 #endif
 }
 
+static inline Sk16f SkHalfToFloat_finite_ftz(const Sk16h& hs) {
+#if !defined(SKNX_NO_SIMD) && SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SKX
+    return _mm512_cvtph_ps(_mm256_inserti128_si256(_mm256_castsi128_si256(hs.fLo.fVec),
+                                                   hs.fHi.fVec, 1));
+#else
+    return SkNx_join(SkHalfToFloat_finite_ftz(hs.fLo),
+                     SkHalfToFloat_finite_ftz(hs.fHi));
+#endif
+}
+
+static inline Sk16h SkFloatToHalf_finite_ftz(const Sk16f& fs) {
+#if !defined(SKNX_NO_SIMD) && SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SKX
+    __m256i hs = _mm512_cvtps_ph(fs.fVec, _MM_FROUND_CUR_DIRECTION);
+    return { Sk8h(_mm256_castsi256_si128(hs)), Sk8h(_mm256_extracti128_si256(hs, 1)) };
+#else
+    Sk8f lo, hi;
+    SkNx_split(fs, &lo, &hi);
+    return { SkFloatToHalf_finite_ftz(lo), SkFloatToHalf_finite_ftz(hi) };
+#endif
+}
+
 #endif
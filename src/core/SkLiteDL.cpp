@@ -12,7 +12,9 @@
 #include "SkLiteDL.h"
 #include "SkMath.h"
 #include "SkPicture.h"
+#include "SkPixmap.h"
 #include "SkRSXform.h"
+#include "SkTaskGroup.h"
 #include "SkTextBlob.h"
 
 #ifndef SKLITEDL_PAGE
@@ -42,6 +44,11 @@ static D* pod(T* op, size_t offset = 0) {
     return SkTAddOffset<D>(op+1, offset);
 }
 
+// Bounds for ops we can't or don't bother to bound more tightly than "everything".
+static const SkRect kUnbounded = {
+    SK_ScalarNegativeInfinity, SK_ScalarNegativeInfinity, SK_ScalarInfinity, SK_ScalarInfinity,
+};
+
 // Pre-cache lazy non-threadsafe fields on SkPath and/or SkMatrix.
 static void make_threadsafe(SkPath* path, SkMatrix* matrix) {
     if (path)   { path->updateBoundsCache(); }
@@ -65,6 +72,9 @@ namespace {
     enum class Type : uint8_t { TYPES(M) };
 #undef M
 
+    // Everything from DrawPaint on draws; everything before it only changes state.
+    static bool is_draw(uint32_t type) { return type >= (uint32_t)Type::DrawPaint; }
+
     struct Op {
         void makeThreadsafe() {}
 
@@ -89,6 +99,10 @@ namespace {
     struct Save final : Op {
         static const auto kType = Type::Save;
         void draw(SkCanvas* c, const SkMatrix&) { c->save(); }
+
+        // Once restored, how many ops and bytes until just past the matching Restore.
+        uint32_t blockOps   = 0;
+        uint32_t blockBytes = 0;
     };
     struct Restore final : Op {
         static const auto kType = Type::Restore;
@@ -564,9 +578,69 @@ void* SkLiteDL::push(size_t pod, Args&&... args) {
     new (op) T{ std::forward<Args>(args)... };
     op->type = (uint32_t)T::kType;
     op->skip = skip;
+
+    // The previous op's bounds are final now that bound() has had its chance to tighten them.
+    if (!fOpBounds.isEmpty()) {
+        fRecordStates.top().fDrawn.join(fOpBounds.top());
+    }
+
+    // Every draw is at least bounded by the clip.  Draw calls may bound() it more tightly.
+    // Restoring a layer draws too.  Other state ops touch nothing.
+    SkRect bounds = SkRect::MakeEmpty();
+    if (is_draw((uint32_t)T::kType) || T::kType == ::Type::SaveLayer) {
+        const RecordState& state = fRecordStates.top();
+        bounds = state.fClipped && !state.fUnbounded ? state.fClip : kUnbounded;
+    }
+    *fOpBounds.append() = bounds;
     return op+1;
 }
 
+void SkLiteDL::resetRecordState() {
+    fOpBounds.rewind();
+    fRecordStates.rewind();
+    *fRecordStates.append() = { SkMatrix::I(), SkRect::MakeEmpty(), false, false,
+                                  -1, 0, SkRect::MakeEmpty() };
+    fBandable = true;
+}
+
+void SkLiteDL::narrowClip(const SkRect& bounds, SkClipOp op) {
+    RecordState& state = fRecordStates.top();
+    if (op == SkClipOp::kDifference) {
+        return;     // Can only shrink the clip, so the old bounds are still good.
+    }
+    if (op != SkClipOp::kIntersect) {
+        state.fClipped = false;
+        fBandable      = false;  // The clip can grow, letting a band draw into its neighbors.
+        return;
+    }
+    if (state.fMatrix.hasPerspective()) {
+        return;
+    }
+    SkRect clip;
+    state.fMatrix.mapRect(&clip, bounds);
+    if (!state.fClipped) {
+        state.fClip    = clip;
+        state.fClipped = true;
+    } else if (!state.fClip.intersect(clip)) {
+        state.fClip.setEmpty();
+    }
+}
+
+void SkLiteDL::bound(const SkRect& bounds, const SkPaint* paint) {
+    const RecordState& state = fRecordStates.top();
+    if (state.fUnbounded || state.fMatrix.hasPerspective()
+                         || (paint && !paint->canComputeFastBounds())) {
+        return;     // Stick with what push() recorded.
+    }
+    SkRect storage, device;
+    state.fMatrix.mapRect(&device, paint ? paint->computeFastBounds(bounds, &storage) : bounds);
+    if (state.fClipped) {
+        // If this fails the draw is clipped out entirely; the unclipped bounds are still correct.
+        (void)device.intersect(state.fClip);
+    }
+    fOpBounds.top() = device;
+}
+
 template <typename Fn, typename... Args>
 inline void SkLiteDL::map(const Fn fns[], Args... args) {
     auto end = fBytes.get() + fUsed;
@@ -584,32 +658,86 @@ inline void SkLiteDL::map(const Fn fns[], Args... args) {
 #ifdef SK_SUPPORT_LEGACY_DRAWFILTER
 void SkLiteDL::setDrawFilter(SkDrawFilter* df) {
     this->push<SetDrawFilter>(0, df);
+    fBandable = false;  // Draw filters can change how far a draw reaches, and aren't threadsafe.
 }
 #endif
 
-void SkLiteDL::   save() { this->push   <Save>(0); }
-void SkLiteDL::restore() { this->push<Restore>(0); }
+void SkLiteDL::save() {
+    size_t offset = fUsed;
+    this->push<Save>(0);
+    RecordState state = fRecordStates.top();
+    state.fSaveOp     = fOpBounds.count() - 1;
+    state.fSaveOffset = offset;
+    state.fDrawn      = SkRect::MakeEmpty();
+    fRecordStates.push(state);
+}
+void SkLiteDL::restore() {
+    this->push<Restore>(0);
+    if (fRecordStates.count() > 1) {
+        const RecordState& state = fRecordStates.top();
+        const SkRect drawn = state.fDrawn;
+        if (state.fSaveOp >= 0) {
+            // Bound the whole block in the Save's slot, so drawBanded() can skip it in one go.
+            fOpBounds[state.fSaveOp] = drawn;
+
+            auto save = (Save*)(fBytes.get() + state.fSaveOffset);
+            save->blockOps   = SkToU32(fOpBounds.count() - state.fSaveOp);
+            save->blockBytes = SkToU32(fUsed - state.fSaveOffset);
+        }
+        fRecordStates.pop();
+        fRecordStates.top().fDrawn.join(drawn);
+    }
+}
 void SkLiteDL::saveLayer(const SkRect* bounds, const SkPaint* paint,
                          const SkImageFilter* backdrop, SkCanvas::SaveLayerFlags flags) {
     this->push<SaveLayer>(0, bounds, paint, backdrop, flags);
+    RecordState state = fRecordStates.top();
+    state.fSaveOp = -1;     // A layer's restore draws, so we can't skip past it.
+    state.fDrawn  = SkRect::MakeEmpty();
+    if (paint && paint->getImageFilter()) {
+        state.fUnbounded = true;
+    }
+    if (backdrop) {
+        fBandable = false;  // A backdrop would read pixels other bands are writing.
+    }
+    fRecordStates.push(state);
 }
 
-void SkLiteDL::   concat(const SkMatrix& matrix)   { this->push   <Concat>(0, matrix); }
-void SkLiteDL::setMatrix(const SkMatrix& matrix)   { this->push<SetMatrix>(0, matrix); }
-void SkLiteDL::translate(SkScalar dx, SkScalar dy) { this->push<Translate>(0, dx, dy); }
+void SkLiteDL::concat(const SkMatrix& matrix) {
+    this->push<Concat>(0, matrix);
+    fRecordStates.top().fMatrix.preConcat(matrix);
+}
+void SkLiteDL::setMatrix(const SkMatrix& matrix) {
+    this->push<SetMatrix>(0, matrix);
+    fRecordStates.top().fMatrix = matrix;
+}
+void SkLiteDL::translate(SkScalar dx, SkScalar dy) {
+    this->push<Translate>(0, dx, dy);
+    fRecordStates.top().fMatrix.preTranslate(dx, dy);
+}
 void SkLiteDL::translateZ(SkScalar dz) { this->push<TranslateZ>(0, dz); }
 
 void SkLiteDL::clipPath(const SkPath& path, SkClipOp op, bool aa) {
     this->push<ClipPath>(0, path, op, aa);
+    if (!path.isInverseFillType()) {
+        this->narrowClip(path.getBounds(), op);
+    }
 }
 void SkLiteDL::clipRect(const SkRect& rect, SkClipOp op, bool aa) {
     this->push<ClipRect>(0, rect, op, aa);
+    this->narrowClip(rect, op);
 }
 void SkLiteDL::clipRRect(const SkRRect& rrect, SkClipOp op, bool aa) {
     this->push<ClipRRect>(0, rrect, op, aa);
+    this->narrowClip(rrect.getBounds(), op);
 }
 void SkLiteDL::clipRegion(const SkRegion& region, SkClipOp op) {
+    // Regions are in device space, which we don't know while recording.
     this->push<ClipRegion>(0, region, op);
+    if (op != SkClipOp::kDifference && op != SkClipOp::kIntersect) {
+        fRecordStates.top().fClipped = false;
+        fBandable = false;  // As in narrowClip(), the clip can grow past a band.
+    }
 }
 
 void SkLiteDL::drawPaint(const SkPaint& paint) {
@@ -617,31 +745,41 @@ void SkLiteDL::drawPaint(const SkPaint& paint) {
 }
 void SkLiteDL::drawPath(const SkPath& path, const SkPaint& paint) {
     this->push<DrawPath>(0, path, paint);
+    if (!path.isInverseFillType()) {
+        this->bound(path.getBounds(), &paint);
+    }
 }
 void SkLiteDL::drawRect(const SkRect& rect, const SkPaint& paint) {
     this->push<DrawRect>(0, rect, paint);
+    this->bound(rect, &paint);
 }
 void SkLiteDL::drawRegion(const SkRegion& region, const SkPaint& paint) {
     this->push<DrawRegion>(0, region, paint);
+    this->bound(SkRect::Make(region.getBounds()), &paint);
 }
 void SkLiteDL::drawOval(const SkRect& oval, const SkPaint& paint) {
     this->push<DrawOval>(0, oval, paint);
+    this->bound(oval, &paint);
 }
 void SkLiteDL::drawArc(const SkRect& oval, SkScalar startAngle, SkScalar sweepAngle, bool useCenter,
                        const SkPaint& paint) {
     this->push<DrawArc>(0, oval, startAngle, sweepAngle, useCenter, paint);
+    this->bound(oval, &paint);
 }
 void SkLiteDL::drawRRect(const SkRRect& rrect, const SkPaint& paint) {
     this->push<DrawRRect>(0, rrect, paint);
+    this->bound(rrect.getBounds(), &paint);
 }
 void SkLiteDL::drawDRRect(const SkRRect& outer, const SkRRect& inner, const SkPaint& paint) {
     this->push<DrawDRRect>(0, outer, inner, paint);
+    this->bound(outer.getBounds(), &paint);
 }
 
 void SkLiteDL::drawAnnotation(const SkRect& rect, const char* key, SkData* value) {
     size_t bytes = strlen(key)+1;
     void* pod = this->push<DrawAnnotation>(bytes, rect, value);
     copy_v(pod, key,bytes);
+    this->bound(rect, nullptr);
 }
 void SkLiteDL::drawDrawable(SkDrawable* drawable, const SkMatrix* matrix) {
     this->push<DrawDrawable>(0, drawable, matrix);
@@ -649,6 +787,11 @@ void SkLiteDL::drawDrawable(SkDrawable* drawable, const SkMatrix* matrix) {
 void SkLiteDL::drawPicture(const SkPicture* picture,
                            const SkMatrix* matrix, const SkPaint* paint) {
     this->push<DrawPicture>(0, picture, matrix, paint);
+    SkRect bounds = picture->cullRect();
+    if (matrix) {
+        matrix->mapRect(&bounds);
+    }
+    this->bound(bounds, paint);
 }
 void SkLiteDL::drawShadowedPicture(const SkPicture* picture, const SkMatrix* matrix,
                                    const SkPaint* paint, const SkShadowParams& params) {
@@ -656,15 +799,19 @@ void SkLiteDL::drawShadowedPicture(const SkPicture* picture, const SkMatrix* mat
 }
 
 void SkLiteDL::drawImage(sk_sp<const SkImage> image, SkScalar x, SkScalar y, const SkPaint* paint) {
+    SkRect bounds = SkRect::MakeXYWH(x, y, image->width(), image->height());
     this->push<DrawImage>(0, std::move(image), x,y, paint);
+    this->bound(bounds, paint);
 }
 void SkLiteDL::drawImageNine(sk_sp<const SkImage> image, const SkIRect& center,
                              const SkRect& dst, const SkPaint* paint) {
     this->push<DrawImageNine>(0, std::move(image), center, dst, paint);
+    this->bound(dst, paint);
 }
 void SkLiteDL::drawImageRect(sk_sp<const SkImage> image, const SkRect* src, const SkRect& dst,
                              const SkPaint* paint, SkCanvas::SrcRectConstraint constraint) {
     this->push<DrawImageRect>(0, std::move(image), src, dst, paint, constraint);
+    this->bound(dst, paint);
 }
 void SkLiteDL::drawImageLattice(sk_sp<const SkImage> image, const SkCanvas::Lattice& lattice,
                                 const SkRect& dst, const SkPaint* paint) {
@@ -677,6 +824,7 @@ void SkLiteDL::drawImageLattice(sk_sp<const SkImage> image, const SkCanvas::Latt
     copy_v(pod, lattice.fXDivs, xs,
                 lattice.fYDivs, ys,
                 lattice.fFlags, fs);
+    this->bound(dst, paint);
 }
 
 void SkLiteDL::drawText(const void* text, size_t bytes,
@@ -709,6 +857,7 @@ void SkLiteDL::drawTextRSXform(const void* text, size_t bytes,
 }
 void SkLiteDL::drawTextBlob(const SkTextBlob* blob, SkScalar x, SkScalar y, const SkPaint& paint) {
     this->push<DrawTextBlob>(0, blob, x,y, paint);
+    this->bound(blob->bounds().makeOffset(x, y), &paint);
 }
 
 void SkLiteDL::drawPatch(const SkPoint points[12], const SkColor colors[4], const SkPoint texs[4],
@@ -779,7 +928,9 @@ SkRect SkLiteDL::onGetBounds() {
     return fBounds;
 }
 
-SkLiteDL:: SkLiteDL(SkRect bounds) : fUsed(0), fReserved(0), fBounds(bounds) {}
+SkLiteDL:: SkLiteDL(SkRect bounds) : fUsed(0), fReserved(0), fBounds(bounds) {
+    this->resetRecordState();
+}
 
 SkLiteDL::~SkLiteDL() {
     this->reset(SkRect::MakeEmpty());
@@ -796,6 +947,78 @@ void SkLiteDL::reset(SkRect bounds) {
     // Leave fBytes and fReserved alone.
     fUsed   = 0;
     fBounds = bounds;
+    this->resetRecordState();
+}
+
+void SkLiteDL::drawBanded(const SkPixmap& dst, const SkMatrix* matrix, int bands) {
+    if (bands <= 0) {
+        bands = SkTPin(dst.height() / 128, 1, 16);
+    }
+    bands = SkTMin(bands, dst.height());
+
+    if (bands <= 1 || !fBandable) {
+        SkBitmap bitmap;
+        if (bitmap.installPixels(dst)) {
+            SkCanvas canvas(bitmap);
+            this->draw(&canvas, matrix);
+        }
+        return;
+    }
+
+    // Snaps drawables to pictures and warms up lazy fields, so bands can share our ops.
+    this->makeThreadsafe();
+
+    // Find the pixels each draw can touch once up front, so bands only need to compare rects.
+    // We outset by a pixel to be safe with anti-aliasing and hairlines.
+    const SkMatrix& original = matrix ? *matrix : SkMatrix::I();
+    const SkRect bounds = SkRect::Make(dst.bounds());
+    SkAutoTMalloc<SkIRect> touched(fOpBounds.count());
+    for (int i = 0; i < fOpBounds.count(); i++) {
+        SkRect device = kUnbounded;
+        if (!original.hasPerspective()) {
+            original.mapRect(&device, fOpBounds[i]);
+        }
+        if (!device.isFinite()) {
+            touched[i] = SkIRect::MakeLargest();
+            continue;
+        }
+        device.outset(1, 1);
+        touched[i] = device.intersect(bounds) ? device.roundOut() : SkIRect::MakeEmpty();
+    }
+
+    SkTaskGroup().batch(bands, [&](int band) {
+        SkIRect rows = SkIRect::MakeLTRB(0,            dst.height() * (band+0) / bands,
+                                         dst.width(),  dst.height() * (band+1) / bands);
+        SkBitmap bitmap;
+        if (!bitmap.installPixels(dst)) {
+            return;
+        }
+        // Drawing into all of dst clipped to our band keeps every pixel's device coordinates,
+        // so clips and matrices replay as usual.  Antialiased edges along a band's seam may
+        // still differ slightly from draw(), e.g. where coverage is computed per band.
+        SkCanvas canvas(bitmap);
+        canvas.clipRect(SkRect::Make(rows));
+        canvas.concat(original);
+        const SkMatrix& total = canvas.getTotalMatrix();
+
+        auto end = fBytes.get() + fUsed;
+        int i = 0;
+        for (uint8_t* ptr = fBytes.get(); ptr < end; ) {
+            auto op = (Op*)ptr;
+            bool touches = SkIRect::Intersects(touched[i], rows);
+            if (op->type == (uint32_t)::Type::Save && ((Save*)op)->blockOps && !touches) {
+                // Nothing between here and the matching restore touches this band.
+                i   += ((Save*)op)->blockOps;
+                ptr += ((Save*)op)->blockBytes;
+                continue;
+            }
+            if (!is_draw(op->type) || touches) {
+                draw_fns[op->type](op, &canvas, total);
+            }
+            i   += 1;
+            ptr += op->skip;
+        }
+    });
 }
 
 void SkLiteDL::drawAsLayer(SkCanvas* canvas, const SkMatrix* matrix, const SkPaint* paint) {
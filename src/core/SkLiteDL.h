@@ -15,6 +15,8 @@
 #include "SkRect.h"
 #include "SkTDArray.h"
 
+class SkPixmap;
+
 class SkLiteDL final : public SkDrawable {
 public:
     static sk_sp<SkLiteDL> New(SkRect);
@@ -34,6 +36,18 @@ public:
     //   canvas->restore();
     void drawAsLayer(SkCanvas*, const SkMatrix*, const SkPaint*);
 
+    // Draws as if...
+    //   SkBitmap bitmap;
+    //   bitmap.installPixels(dst);
+    //   SkCanvas canvas(bitmap);
+    //   this->draw(&canvas, matrix);
+    // ... but splits dst into horizontal bands played back on SkTaskGroup threads at once.
+    // Each band skips the draws that don't touch it.  bands <= 0 picks a count from dst's height.
+    // Edges crossing a seam between bands are clipped there, so pixels along the seams may differ
+    // slightly from a single draw(), just as when drawing in tiles.
+    // This calls makeThreadsafe(), so nothing else may be using this SkLiteDL at the same time.
+    void drawBanded(const SkPixmap& dst, const SkMatrix* matrix = nullptr, int bands = 0);
+
     void save();
     void saveLayer(const SkRect*, const SkPaint*, const SkImageFilter*, SkCanvas::SaveLayerFlags);
     void restore();
@@ -100,10 +114,29 @@ private:
     template <typename Fn, typename... Args>
     void map(const Fn[], Args...);
 
+    // Recording-time state, tracked so we can bound each op for drawBanded().
+    // fMatrix is relative to the matrix we're drawn with, as for SetMatrix.
+    struct RecordState {
+        SkMatrix fMatrix;
+        SkRect   fClip;
+        bool     fClipped;      // If false, fClip is meaningless.
+        bool     fUnbounded;    // Inside a layer with an image filter, which can move our draws.
+        int      fSaveOp;       // Index of the Save op that pushed this state, or -1.
+        size_t   fSaveOffset;   // Where that Save op lives in fBytes.
+        SkRect   fDrawn;        // Union of the final bounds of this state's ops so far.
+    };
+    void resetRecordState();
+    void narrowClip(const SkRect& bounds, SkClipOp);
+    void bound(const SkRect& bounds, const SkPaint*);
+
     SkAutoTMalloc<uint8_t> fBytes;
     size_t                 fUsed;
     size_t                 fReserved;
     SkRect                 fBounds;
+
+    SkTDArray<SkRect>      fOpBounds;   // One per op.  Non-finite means unbounded.
+    SkTDArray<RecordState> fRecordStates;
+    bool                   fBandable;   // False if bands might race, e.g. on a backdrop.
 };
 
 #endif//SkLiteDL_DEFINED
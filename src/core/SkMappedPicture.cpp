@@ -0,0 +1,83 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkMappedPicture.h"
+#include "SkPictureData.h"
+#include "SkPicturePlayback.h"
+#include "SkPictureRecord.h"
+#include "SkRTree.h"
+#include "SkReadBuffer.h"
+
+// Counts ops by skipping from one to the next, without reading their arguments.
+// See SkPicturePlayback::ReadOpAndSize().
+static int count_ops(const SkData* opData) {
+    SkReadBuffer reader(opData->data(), opData->size());
+    int count = 0;
+    while (!reader.eof()) {
+        const size_t start = reader.offset();
+        const uint32_t temp = reader.readUInt();
+        if ((uint8_t)temp == temp) {
+            // Very old .skps don't record op sizes, so we can't count any further.
+            return count + 1;
+        }
+        uint32_t size = temp & MASK_24;  // The op is in the top 8 bits.
+        if (MASK_24 == size) {
+            size = reader.readUInt();
+        }
+        const size_t read = reader.offset() - start;
+        if (size < read || size > reader.size() - start) {
+            break;
+        }
+        reader.skip(size - read);
+        count++;
+    }
+    return count;
+}
+
+SkMappedPicture::SkMappedPicture(const SkRect& cull, std::unique_ptr<const SkPictureData> data)
+    : fCullRect(cull)
+    , fData(std::move(data))
+    , fOpCount(count_ops(fData->opData().get())) {
+    if (const int count = fData->opIndexCount()) {
+        SkAutoTMalloc<SkRect> bounds(count);
+        for (int i = 0; i < count; i++) {
+            bounds[i] = fData->opIndex()[i].fBounds;
+        }
+        // A zero-height cull (e.g. a picture of only a horizontal hairline) has no aspect ratio.
+        const SkScalar aspectRatio = fCullRect.height() > 0
+                                   ? fCullRect.width() / fCullRect.height() : 1;
+        sk_sp<SkRTree> rtree(new SkRTree(aspectRatio));
+        rtree->insert(bounds, count);
+        fBBH = std::move(rtree);
+    }
+}
+
+SkMappedPicture::~SkMappedPicture() {}
+
+void SkMappedPicture::playback(SkCanvas* canvas, AbortCallback* callback) const {
+    SkASSERT(canvas);
+    SkPicturePlayback playback(fData.get());
+
+    // If the query contains the whole picture, don't bother with the BBH.
+    if (fBBH && !canvas->getLocalClipBounds().contains(fCullRect)) {
+        SkTDArray<int> ops;
+        fBBH->search(canvas->getLocalClipBounds(), &ops);
+        playback.draw(canvas, callback, ops.begin(), ops.count());
+    } else {
+        playback.draw(canvas, callback, nullptr);
+    }
+}
+
+bool SkMappedPicture::willPlayBackBitmaps() const {
+    return fData->containsBitmaps();
+}
+
+size_t SkMappedPicture::approximateBytesUsed() const {
+    size_t bytes = sizeof(*this) + sizeof(SkPictureData) + fData->opData()->size();
+    if (fBBH) { bytes += fBBH->bytesUsed(); }
+    return bytes;
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMappedPicture_DEFINED
+#define SkMappedPicture_DEFINED
+
+#include "SkPicture.h"
+#include "SkRect.h"
+
+class SkBBoxHierarchy;
+class SkPictureData;
+
+// An SkPicture that plays back directly from serialized SkPictureData,
+// typically read in place from a memory mapped .skp by SkPicture::MakeFromMappedData().
+// If the picture was serialized with an op index, it is played back through a BBH
+// built from that index, so only the ops visible in the canvas' clip are read.
+class SkMappedPicture final : public SkPicture {
+public:
+    SkMappedPicture(const SkRect& cull, std::unique_ptr<const SkPictureData>);
+    ~SkMappedPicture() override;
+
+// SkPicture overrides
+    void playback(SkCanvas*, AbortCallback*) const override;
+    SkRect cullRect() const override { return fCullRect; }
+    bool willPlayBackBitmaps() const override;
+    int approximateOpCount() const override { return fOpCount; }
+    size_t approximateBytesUsed() const override;
+
+private:
+    int numSlowPaths() const override { return 0; }
+    bool hasBBH() const override { return fBBH != nullptr; }
+
+    const SkRect                         fCullRect;
+    std::unique_ptr<const SkPictureData> fData;
+    int                                  fOpCount;
+    sk_sp<const SkBBoxHierarchy>         fBBH;
+};
+
+#endif//SkMappedPicture_DEFINED
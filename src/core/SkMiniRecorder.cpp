@@ -30,8 +30,12 @@ public:
 template <typename T>
 class SkMiniPicture final : public SkPicture {
 public:
-    SkMiniPicture(SkRect cull, T* op) : fCull(cull) {
-        memcpy(&fOp, op, sizeof(fOp));  // We take ownership of op's guts.
+    SkMiniPicture(SkRect cull, T* op, SkTLazy<SkPaint>* paint)
+        : fCull(cull)
+        , fPaint(std::move(*paint->get())) {
+        memcpy(&fOp, op, sizeof(fOp));  // We take ownership of op's guts, and its paint.
+        fOp.paint = SharedPaint(&fPaint);
+        paint->reset();
     }
 
     void playback(SkCanvas* c, AbortCallback*) const override {
@@ -49,8 +53,9 @@ public:
     }
 
 private:
-    SkRect fCull;
-    T      fOp;
+    SkRect  fCull;
+    SkPaint fPaint;
+    T       fOp;
 };
 
 
@@ -71,15 +76,15 @@ SkMiniRecorder::~SkMiniRecorder() {
     return true
 
 bool SkMiniRecorder::drawRect(const SkRect& rect, const SkPaint& paint) {
-    TRY_TO_STORE(DrawRect, paint, rect);
+    TRY_TO_STORE(DrawRect, SharedPaint(fPaint.set(paint)), rect);
 }
 
 bool SkMiniRecorder::drawPath(const SkPath& path, const SkPaint& paint) {
-    TRY_TO_STORE(DrawPath, paint, path);
+    TRY_TO_STORE(DrawPath, SharedPaint(fPaint.set(paint)), path);
 }
 
 bool SkMiniRecorder::drawTextBlob(const SkTextBlob* b, SkScalar x, SkScalar y, const SkPaint& p) {
-    TRY_TO_STORE(DrawTextBlob, p, sk_ref_sp(b), x, y);
+    TRY_TO_STORE(DrawTextBlob, SharedPaint(fPaint.set(p)), sk_ref_sp(b), x, y);
 }
 #undef TRY_TO_STORE
 
@@ -88,7 +93,8 @@ sk_sp<SkPicture> SkMiniRecorder::detachAsPicture(const SkRect& cull) {
 #define CASE(Type)              \
     case State::k##Type:        \
         fState = State::kEmpty; \
-        return sk_make_sp<SkMiniPicture<Type>>(cull, reinterpret_cast<Type*>(fBuffer.get()))
+        return sk_make_sp<SkMiniPicture<Type>>(cull, reinterpret_cast<Type*>(fBuffer.get()), \
+                                               &fPaint)
 
     static SkOnce once;
     static SkPicture* empty;
@@ -113,6 +119,7 @@ void SkMiniRecorder::flushAndReset(SkCanvas* canvas) {
         Type* op = reinterpret_cast<Type*>(fBuffer.get());          \
         SkRecords::Draw(canvas, nullptr, nullptr, 0, nullptr)(*op); \
         op->~Type();                                                \
+        fPaint.reset();                                             \
     } return
 
     switch (fState) {
@@ -9,16 +9,61 @@
 #include "SkCanvasPriv.h"
 #include "SkMultiPictureDraw.h"
 #include "SkPicture.h"
+#include "SkSurfaceProps.h"
 #include "SkTaskGroup.h"
 
-void SkMultiPictureDraw::DrawData::draw() {
-    fCanvas->drawPicture(fPicture, &fMatrix, fPaint);
+// Bands shorter than this aren't worth a task of their own.
+static const int kMinBandHeight = 64;
+
+void SkMultiPictureDraw::DrawData::draw(SkCanvas* canvas) const {
+    canvas->drawPicture(fPicture, &fMatrix, fPaint);
+}
+
+bool SkMultiPictureDraw::DrawData::makeBands(SkTArray<std::unique_ptr<SkCanvas>>* bands) const {
+    // We can only reproduce a rectangular clip on each band's canvas.
+    if (!fCanvas->isClipRect()) {
+        return false;
+    }
+    const SkIRect clip = fCanvas->getDeviceClipBounds();
+    if (clip.isEmpty()) {
+        return true;    // Nothing to draw.
+    }
+
+    // Make sure we own the pixels (e.g. copy-on-write a surface) before writing to them directly.
+    fCanvas->predrawNotify();
+
+    SkImageInfo info;
+    size_t rowBytes;
+    SkIPoint origin;
+    void* pixels = fCanvas->accessTopLayerPixels(&info, &rowBytes, &origin);
+    // A non-zero origin means we're in a layer, where the clip and matrix are harder to follow.
+    if (!pixels || !origin.isZero()) {
+        return false;
+    }
+
+    SkBitmap bitmap;
+    if (!bitmap.installPixels(info, pixels, rowBytes)) {
+        return false;
+    }
+    SkSurfaceProps props(0, kUnknown_SkPixelGeometry);
+    fCanvas->getProps(&props);
+
+    const int bandHeight = (clip.height() + fBandCount - 1) / fBandCount;
+    for (int top = clip.fTop; top < clip.fBottom; top += bandHeight) {
+        std::unique_ptr<SkCanvas> band(new SkCanvas(bitmap, props));
+        band->clipRect(SkRect::Make(SkIRect::MakeLTRB(clip.fLeft, top, clip.fRight,
+                                                      SkTMin(top + bandHeight, clip.fBottom))));
+        band->setMatrix(fCanvas->getTotalMatrix());
+        bands->push_back(std::move(band));
+    }
+    return true;
 }
 
 void SkMultiPictureDraw::DrawData::init(SkCanvas* canvas, const SkPicture* picture,
                                         const SkMatrix* matrix, const SkPaint* paint) {
     fPicture = SkRef(picture);
     fCanvas = canvas;
+    fBandCount = 0;
     if (matrix) {
         fMatrix = *matrix;
     } else {
@@ -66,6 +111,30 @@ void SkMultiPictureDraw::add(SkCanvas* canvas,
     array.append()->init(canvas, picture, matrix, paint);
 }
 
+void SkMultiPictureDraw::addBanded(SkCanvas* canvas,
+                                   const SkPicture* picture,
+                                   const SkMatrix* matrix,
+                                   const SkPaint* paint,
+                                   int bandCount) {
+    if (nullptr == canvas || nullptr == picture) {
+        SkDEBUGFAIL("parameters to SkMultiPictureDraw::addBanded should be non-nullptr");
+        return;
+    }
+    if (canvas->getGrContext()) {
+        this->add(canvas, picture, matrix, paint);
+        return;
+    }
+
+    const int height = canvas->getBaseLayerSize().height();
+    if (bandCount <= 0) {
+        bandCount = (height + kMinBandHeight - 1) / kMinBandHeight;
+    }
+
+    DrawData* data = fThreadSafeDrawData.append();
+    data->init(canvas, picture, matrix, paint);
+    data->fBandCount = SkTPin(bandCount, 1, SkTMax(height, 1));
+}
+
 class AutoMPDReset : SkNoncopyable {
     SkMultiPictureDraw* fMPD;
 public:
@@ -78,13 +147,32 @@ public:
 void SkMultiPictureDraw::draw(bool flush) {
     AutoMPDReset mpdreset(this);
 
-#ifdef FORCE_SINGLE_THREAD_DRAWING_FOR_TESTING
+    // Each task draws one picture, either into its own canvas or into one band of it.
+    struct Task {
+        SkCanvas*       fCanvas;
+        const DrawData* fData;
+    };
+    SkTDArray<Task> tasks;
+    SkTArray<std::unique_ptr<SkCanvas>> bands;
     for (int i = 0; i < fThreadSafeDrawData.count(); ++i) {
-        fThreadSafeDrawData[i].draw();
+        const DrawData& data = fThreadSafeDrawData[i];
+        const int firstBand = bands.count();
+        if (data.fBandCount > 0 && data.makeBands(&bands)) {
+            for (int j = firstBand; j < bands.count(); ++j) {
+                *tasks.append() = { bands[j].get(), &data };
+            }
+        } else {
+            *tasks.append() = { data.fCanvas, &data };
+        }
+    }
+
+#ifdef FORCE_SINGLE_THREAD_DRAWING_FOR_TESTING
+    for (int i = 0; i < tasks.count(); ++i) {
+        tasks[i].fData->draw(tasks[i].fCanvas);
     }
 #else
-    SkTaskGroup().batch(fThreadSafeDrawData.count(), [&](int i) {
-        fThreadSafeDrawData[i].draw();
+    SkTaskGroup().batch(tasks.count(), [&](int i) {
+        tasks[i].fData->draw(tasks[i].fCanvas);
     });
 #endif
 
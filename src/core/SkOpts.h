@@ -54,21 +54,40 @@ namespace SkOpts {
                         grayA_to_RGBA,         // i.e. expand to color channels
                         grayA_to_rgbA,         // i.e. expand to color channels and premultiply
                         inverted_CMYK_to_RGB1, // i.e. convert color space
-                        inverted_CMYK_to_BGR1; // i.e. convert color space
+                        inverted_CMYK_to_BGR1, // i.e. convert color space
+                        RGB16_to_RGB1,         // i.e. narrow 16-bit channels and insert an opaque alpha
+                        RGB16_to_BGR1,         // i.e. narrow, swap RB, and insert an opaque alpha
+                        RGBA16_to_RGBA,        // i.e. narrow (big-endian) 16-bit channels to 8-bit
+                        RGBA16_to_BGRA,        // i.e. narrow and swap RB
+                        RGBA16_to_rgbA,        // i.e. narrow and premultiply
+                        RGBA16_to_bgrA;        // i.e. narrow, swap RB, and premultiply
+
+    // Look up each 8-bit index in a 256 entry table of 8888 colors.
+    extern void (*index8_to_8888)(uint32_t dst[], const uint8_t src[], int count,
+                                  const uint32_t table[]);
+
+    // Pack count pixels of bpp bytes each, found every stride bytes in src, into dst.
+    extern void (*gather_pixels)(void* dst, const uint8_t* src, int count, int bpp, int stride);
 
     // Blend ndst src pixels over dst, where both src and dst point to sRGB pixels (RGBA or BGRA).
     // If nsrc < ndst, we loop over src to create a pattern.
     extern void (*srcover_srgb_srgb)(uint32_t* dst, const uint32_t* src, int ndst, int nsrc);
 
+    // Applies PNG filter type 0-4 (None, Sub, Up, Average, Paeth) to len bytes of row, given the
+    // previous unfiltered row, and returns libpng's cost heuristic for the filtered bytes.
+    extern uint32_t (*png_filter_row)(int filter, uint8_t* dst, const uint8_t* row,
+                                      const uint8_t* prev, int len, int bytesPerPixel);
+
     // The fastest high quality 32-bit hash we can provide on this platform.
     extern uint32_t (*hash_fn)(const void*, size_t, uint32_t seed);
     static inline uint32_t hash(const void* data, size_t bytes, uint32_t seed=0) {
         return hash_fn(data, bytes, seed);
     }
 
-    extern void (*run_pipeline)(size_t, size_t, const SkRasterPipeline::Stage*, int);
+    extern void (*run_pipeline)(size_t, size_t, const SkRasterPipeline::Stage*, int,
+                                bool allowLowp);
     extern std::function<void(size_t, size_t)>
-    (*compile_pipeline)(const SkRasterPipeline::Stage*, int);
+    (*compile_pipeline)(const SkRasterPipeline::Stage*, int, bool allowLowp);
 
     extern void (*convolve_vertically)(const SkConvolutionFilter1D::ConvolutionFixed* filter_values,
                                        int filter_length, unsigned char* const* source_data_rows,
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkNx.h"
+#include "SkPackedRTree.h"
+
+SkPackedRTree::SkPackedRTree() : fLevels(0), fRootBounds(SkRect::MakeEmpty()) {}
+
+SkRect SkPackedRTree::getRootBound() const {
+    return fRootBounds;
+}
+
+SkRect SkPackedRTree::Bounds(const Node& node) {
+    SkRect bounds = { SK_FloatInfinity, SK_FloatInfinity,
+                      SK_FloatNegativeInfinity, SK_FloatNegativeInfinity };
+    for (int i = 0; i < kChildren; i++) {
+        // Missing children are inside out, so they won't affect the bounds.
+        bounds.fLeft   = SkTMin(bounds.fLeft,   node.fLeft  [i]);
+        bounds.fTop    = SkTMin(bounds.fTop,    node.fTop   [i]);
+        bounds.fRight  = SkTMax(bounds.fRight,  node.fRight [i]);
+        bounds.fBottom = SkTMax(bounds.fBottom, node.fBottom[i]);
+    }
+    return bounds;
+}
+
+static void set_child(float* left, float* top, float* right, float* bottom, const SkRect* r) {
+    if (r) {
+        *left   = r->fLeft;
+        *top    = r->fTop;
+        *right  = r->fRight;
+        *bottom = r->fBottom;
+    } else {
+        *left   = *top    = SK_FloatInfinity;
+        *right  = *bottom = SK_FloatNegativeInfinity;
+    }
+}
+
+void SkPackedRTree::insert(const SkRect boundsArray[], int N) {
+    SkASSERT(0 == fOps.count());
+
+    for (int i = 0; i < N; i++) {
+        if (!boundsArray[i].isEmpty()) {
+            fOps.push(i);
+        }
+    }
+    if (fOps.isEmpty()) {
+        return;
+    }
+
+    // Count the nodes in each level, from the leaves up to the root.
+    int counts[kMaxLevels];
+    int n = fOps.count();
+    do {
+        SkASSERT(fLevels < kMaxLevels);
+        n = (n + kChildren - 1) / kChildren;
+        counts[fLevels++] = n;
+    } while (n > 1);
+
+    int total = 0;
+    for (int level = fLevels - 1; level >= 0; level--) {
+        fLevelStart[level] = total;
+        total += counts[level];
+    }
+    fNodes.setCount(total);
+
+    // The leaves hold the boxes themselves...
+    for (int i = 0; i < counts[0]; i++) {
+        Node& node = fNodes[fLevelStart[0] + i];
+        for (int j = 0; j < kChildren; j++) {
+            const int child = i * kChildren + j;
+            set_child(&node.fLeft[j], &node.fTop[j], &node.fRight[j], &node.fBottom[j],
+                      child < fOps.count() ? &boundsArray[fOps[child]] : nullptr);
+        }
+    }
+    // ... and every other node the bounds of its children.
+    for (int level = 1; level < fLevels; level++) {
+        for (int i = 0; i < counts[level]; i++) {
+            Node& node = fNodes[fLevelStart[level] + i];
+            for (int j = 0; j < kChildren; j++) {
+                const int child = i * kChildren + j;
+                SkRect bounds;
+                if (child < counts[level - 1]) {
+                    bounds = Bounds(fNodes[fLevelStart[level - 1] + child]);
+                }
+                set_child(&node.fLeft[j], &node.fTop[j], &node.fRight[j], &node.fBottom[j],
+                          child < counts[level - 1] ? &bounds : nullptr);
+            }
+        }
+    }
+    fRootBounds = Bounds(fNodes[0]);
+}
+
+void SkPackedRTree::search(const SkRect& query, SkTDArray<int>* results) const {
+    if (fOps.isEmpty() || !SkRect::Intersects(fRootBounds, query)) {
+        return;
+    }
+
+    const Sk4f queryLeft  (query.fLeft),
+               queryTop   (query.fTop),
+               queryRight (query.fRight),
+               queryBottom(query.fBottom);
+
+    // Children are pushed last to first, so we visit them, and find boxes, in order.
+    struct Entry { int fLevel, fNode; };
+    Entry stack[kMaxLevels * (kChildren - 1) + 1];
+    int depth = 0;
+    stack[depth++] = { fLevels - 1, 0 };
+
+    while (depth > 0) {
+        const Entry entry = stack[--depth];
+        const Node& node = fNodes[fLevelStart[entry.fLevel] + entry.fNode];
+
+        // Same as SkRect::Intersects(), for all children at once.
+        Sk4f hits = (Sk4f::Max(Sk4f::Load(node.fLeft), queryLeft) <
+                     Sk4f::Min(Sk4f::Load(node.fRight), queryRight)).thenElse(1.0f, 0.0f)
+                  * (Sk4f::Max(Sk4f::Load(node.fTop), queryTop) <
+                     Sk4f::Min(Sk4f::Load(node.fBottom), queryBottom)).thenElse(1.0f, 0.0f);
+        if (!(hits > 0.0f).anyTrue()) {
+            continue;
+        }
+
+        const int firstChild = entry.fNode * kChildren;
+        if (0 == entry.fLevel) {
+            for (int j = 0; j < kChildren; j++) {
+                if (hits[j] > 0.0f) {
+                    results->push(fOps[firstChild + j]);
+                }
+            }
+        } else {
+            for (int j = kChildren - 1; j >= 0; j--) {
+                if (hits[j] > 0.0f) {
+                    SkASSERT(depth < (int)SK_ARRAY_COUNT(stack));
+                    stack[depth++] = { entry.fLevel - 1, firstChild + j };
+                }
+            }
+        }
+    }
+}
+
+size_t SkPackedRTree::bytesUsed() const {
+    return sizeof(SkPackedRTree)
+         + fNodes.reserved() * sizeof(Node)
+         + fOps.reserved()   * sizeof(int);
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPackedRTree_DEFINED
+#define SkPackedRTree_DEFINED
+
+#include "SkBBoxHierarchy.h"
+#include "SkRect.h"
+
+/**
+ * An R-Tree bulk-loaded bottom up into one flat array of nodes, each node holding the bounds of
+ * up to four children in struct-of-arrays form so they can all be tested against a query at once.
+ *
+ * Like SkRTree, we don't sort: consecutive boxes are grouped together, which works well for the
+ * mostly x,y-ordered draws we're given.  Because of that grouping, the children of the i-th node
+ * of one level are nodes 4i through 4i+3 of the level below, so the tree needs no child pointers.
+ * Nodes are stored breadth-first, root first, and search() walks them with a small fixed stack.
+ */
+class SkPackedRTree : public SkBBoxHierarchy {
+public:
+    SkPackedRTree();
+
+    void insert(const SkRect[], int N) override;
+    void search(const SkRect& query, SkTDArray<int>* results) const override;
+    size_t bytesUsed() const override;
+    SkRect getRootBound() const override;
+
+    // Methods and constants below here are only public for tests.
+
+    // Return the depth of the tree structure.
+    int getDepth() const { return fLevels; }
+    // Insertion count, not counting empty boxes.
+    int getCount() const { return fOps.count(); }
+
+    static const int kChildren  = 4,
+                     kMaxLevels = 16;  // Enough for SK_MaxS32 boxes.
+
+private:
+    // The bounds of up to kChildren children.  Missing children have bounds that never intersect.
+    struct Node {
+        float fLeft  [kChildren],
+              fTop   [kChildren],
+              fRight [kChildren],
+              fBottom[kChildren];
+    };
+
+    static SkRect Bounds(const Node&);
+
+    SkTDArray<Node> fNodes;
+    SkTDArray<int>  fOps;                     // The box index of each leaf child.
+    int             fLevelStart[kMaxLevels];  // Where each level starts in fNodes; 0 is the leaves.
+    int             fLevels;
+    SkRect          fRootBounds;
+
+    typedef SkBBoxHierarchy INHERITED;
+};
+
+#endif
@@ -2101,6 +2101,34 @@ size_t SkPath::readFromMemory(const void* storage, size_t length) {
     return buffer.pos();
 }
 
+size_t SkPathPriv::SerializedSize(const void* storage, size_t length) {
+    // This mirrors SkPath::readFromMemory() and SkPathRef::CreateFromBuffer().
+    SkRBuffer buffer(storage, length);
+
+    int32_t packed;
+    if (!buffer.readS32(&packed)) {
+        return 0;
+    }
+    unsigned version = packed & 0xFF;
+    if (version >= SkPath::kPathPrivLastMoveToIndex_Version && !buffer.read(nullptr, 4)) {
+        return 0;
+    }
+
+    int32_t verbCount, pointCount, conicCount;
+    if (!buffer.read(nullptr, 8) ||  // SkPathRef's packed fields and generation ID.
+        !buffer.readS32(&verbCount)  || verbCount  < 0 ||
+        !buffer.readS32(&pointCount) || pointCount < 0 ||
+        !buffer.readS32(&conicCount) || conicCount < 0 ||
+        !buffer.read(nullptr, verbCount) ||
+        !buffer.read(nullptr, (size_t)pointCount * sizeof(SkPoint)) ||
+        !buffer.read(nullptr, (size_t)conicCount * sizeof(SkScalar)) ||
+        !buffer.read(nullptr, sizeof(SkRect)) ||
+        !buffer.skipToAlign4()) {
+        return 0;
+    }
+    return buffer.pos();
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "SkStringUtils.h"
@@ -99,6 +99,12 @@ public:
     static void CreateDrawArcPath(SkPath* path, const SkRect& oval, SkScalar startAngle,
                                   SkScalar sweepAngle, bool useCenter, bool isFillNoPathEffect);
 
+    /**
+     *  Returns the number of bytes SkPath::readFromMemory() would read from storage, without
+     *  actually reading the path, or 0 if storage does not hold a complete serialized path.
+     */
+    static size_t SerializedSize(const void* storage, size_t length);
+
     /**
      * Returns a pointer to the verb data. Note that the verbs are stored backwards in memory and
      * thus the returned pointer is the last verb.
@@ -8,12 +8,15 @@
 #include "SkAtomics.h"
 #include "SkImageDeserializer.h"
 #include "SkImageGenerator.h"
+#include "SkMappedPicture.h"
 #include "SkMessageBus.h"
 #include "SkPicture.h"
 #include "SkPictureData.h"
 #include "SkPicturePlayback.h"
 #include "SkPictureRecord.h"
 #include "SkPictureRecorder.h"
+#include "SkRecordDraw.h"
+#include "SkRecorder.h"
 
 #if defined(SK_DISALLOW_CROSSPROCESS_PICTUREIMAGEFILTERS) || \
     defined(SK_ENABLE_PICTURE_IO_SECURITY_PRECAUTIONS)
@@ -165,14 +168,26 @@ sk_sp<SkPicture> SkPicture::MakeFromData(const SkData* data, SkImageDeserializer
     return MakeFromStream(&stream, factory, nullptr);
 }
 
+sk_sp<SkPicture> SkPicture::MakeFromMappedData(sk_sp<SkData> data,
+                                               SkImageDeserializer* factory) {
+    if (!data) {
+        return nullptr;
+    }
+    SkMemoryStream stream(data);
+    return MakeFromStream(&stream, factory, nullptr, data.get());
+}
+
 sk_sp<SkPicture> SkPicture::MakeFromStream(SkStream* stream, SkImageDeserializer* factory,
-                                           SkTypefacePlayback* typefaces) {
+                                           SkTypefacePlayback* typefaces, const SkData* mapped) {
     SkPictInfo info;
     if (!InternalOnly_StreamIsSKP(stream, &info) || !stream->readBool()) {
         return nullptr;
     }
     std::unique_ptr<SkPictureData> data(
-            SkPictureData::CreateFromStream(stream, info, factory, typefaces));
+            SkPictureData::CreateFromStream(stream, info, factory, typefaces, mapped));
+    if (mapped) {
+        return data ? sk_make_sp<SkMappedPicture>(info.fCullRect, std::move(data)) : nullptr;
+    }
     return Forwardport(info, data.get(), nullptr);
 }
 
@@ -185,11 +200,28 @@ sk_sp<SkPicture> SkPicture::MakeFromBuffer(SkReadBuffer& buffer) {
     return Forwardport(info, data.get(), &buffer);
 }
 
-SkPictureData* SkPicture::backport() const {
+SkPictureData* SkPicture::backport(bool withOpIndex) const {
     SkPictInfo info = this->createHeader();
     SkPictureRecord rec(SkISize::Make(info.fCullRect.width(), info.fCullRect.height()), 0/*flags*/);
     rec.beginRecording();
+    if (withOpIndex) {
+        // Record into an SkRecord first, to find the bounds of each op,
+        // then note where each of those ops lands as we play them into rec.
+        SkRecord record;
+        SkRecorder recorder(&record, info.fCullRect);
+        this->playback(&recorder);
+
+        SkAutoTMalloc<SkRect> bounds(record.count());
+        SkRecordFillBounds(info.fCullRect, record, bounds);
+
+        SkRecords::Draw draw(&rec, nullptr, nullptr, 0);
+        for (int i = 0; i < record.count(); i++) {
+            rec.addOpIndexEntry(bounds[i]);
+            record.visit(i, draw);
+        }
+    } else {
         this->playback(&rec);
+    }
     rec.endRecording();
     return new SkPictureData(rec, info);
 }
@@ -208,7 +240,7 @@ void SkPicture::serialize(SkWStream* stream,
                           SkPixelSerializer* pixelSerializer,
                           SkRefCntSet* typefaceSet) const {
     SkPictInfo info = this->createHeader();
-    std::unique_ptr<SkPictureData> data(this->backport());
+    std::unique_ptr<SkPictureData> data(this->backport(this->hasBBH()));
 
     stream->write(&info, sizeof(info));
     if (data) {
@@ -17,7 +17,7 @@
 // N.B. This name is slightly historical: hunting season is now open for SkImages too.
 struct SkBitmapHunter {
     // Some ops have a paint, some have an optional paint.  Either way, get back a pointer.
-    static const SkPaint* AsPtr(const SkPaint& p) { return &p; }
+    static const SkPaint* AsPtr(const SkRecords::SharedPaint& p) { return p.get(); }
     static const SkPaint* AsPtr(const SkRecords::Optional<SkPaint>& p) { return p; }
 
     // Main entry for visitor:
@@ -69,7 +69,7 @@ private:
 // TODO: might be nicer to have operator() return an int (the number of slow paths) ?
 struct SkPathCounter {
     // Some ops have a paint, some have an optional paint.  Either way, get back a pointer.
-    static const SkPaint* AsPtr(const SkPaint& p) { return &p; }
+    static const SkPaint* AsPtr(const SkRecords::SharedPaint& p) { return p.get(); }
     static const SkPaint* AsPtr(const SkRecords::Optional<SkPaint>& p) { return p; }
 
     SkPathCounter() : fNumSlowPathsAndDashEffects(0) {}
@@ -88,12 +88,12 @@ struct SkPathCounter {
     }
 
     void operator()(const SkRecords::DrawPoints& op) {
-        this->checkPaint(&op.paint);
-        const SkPathEffect* effect = op.paint.getPathEffect();
+        this->checkPaint(op.paint.get());
+        const SkPathEffect* effect = op.paint->getPathEffect();
         if (effect) {
             SkPathEffect::DashInfo info;
             SkPathEffect::DashType dashType = effect->asADash(&info);
-            if (2 == op.count && SkPaint::kRound_Cap != op.paint.getStrokeCap() &&
+            if (2 == op.count && SkPaint::kRound_Cap != op.paint->getStrokeCap() &&
                 SkPathEffect::kDash_DashType == dashType && 2 == info.fCount) {
                 fNumSlowPathsAndDashEffects--;
             }
@@ -101,12 +101,12 @@ struct SkPathCounter {
     }
 
     void operator()(const SkRecords::DrawPath& op) {
-        this->checkPaint(&op.paint);
-        if (op.paint.isAntiAlias() && !op.path.isConvex()) {
-            SkPaint::Style paintStyle = op.paint.getStyle();
+        this->checkPaint(op.paint.get());
+        if (op.paint->isAntiAlias() && !op.path.isConvex()) {
+            SkPaint::Style paintStyle = op.paint->getStyle();
             const SkRect& pathBounds = op.path.getBounds();
             if (SkPaint::kStroke_Style == paintStyle &&
-                0 == op.paint.getStrokeWidth()) {
+                0 == op.paint->getStrokeWidth()) {
                 // AA hairline concave path is not slow.
             } else if (SkPaint::kFill_Style == paintStyle && pathBounds.width() < 64.f &&
                        pathBounds.height() < 64.f && !op.path.isVolatile()) {
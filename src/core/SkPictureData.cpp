@@ -9,6 +9,7 @@
 
 #include "SkAutoMalloc.h"
 #include "SkImageGenerator.h"
+#include "SkPathPriv.h"
 #include "SkPictureData.h"
 #include "SkPictureRecord.h"
 #include "SkReadBuffer.h"
@@ -43,6 +44,9 @@ SkPictureData::SkPictureData(const SkPictureRecord& record,
     this->init();
 
     fOpData = record.opData();
+    if (record.fOpIndex.count() > 0) {
+        fOpIndex = SkData::MakeWithCopy(record.fOpIndex.begin(), record.fOpIndex.bytes());
+    }
 
     fContentInfo.set(record.fContentInfo);
 
@@ -106,6 +110,9 @@ void SkPictureData::init() {
     fTextBlobCount = 0;
     fImageRefs = nullptr;
     fImageCount = 0;
+    fBitmapImageRefs = nullptr;
+    fBitmapImageCount = 0;
+    fLazyImages = false;
     fFactoryPlayback = nullptr;
 }
 
@@ -129,13 +136,32 @@ SkPictureData::~SkPictureData() {
     delete[] fTextBlobRefs;
 
     for (int i = 0; i < fImageCount; i++) {
-        fImageRefs[i]->unref();
+        SkSafeUnref(fImageRefs[i]);  // Lazy images may never have been read.
     }
     delete[] fImageRefs;
 
     delete fFactoryPlayback;
 }
 
+void SkPictureData::readLazyPath(int index) const {
+    const uint8_t* storage = (const uint8_t*)fLazyPaths[index];
+    const size_t length = fBufferData->bytes() + fBufferData->size() - storage;
+    if (0 == fPaths[index].readFromMemory(storage, length)) {
+        fPaths[index].reset();
+    }
+    fPaths[index].updateBoundsCache();
+}
+
+void SkPictureData::readLazyImage(int index) const {
+    const uint8_t* storage = (const uint8_t*)fLazyImageData[index];
+    if (!storage) {
+        return;  // Already read.
+    }
+    SkReadBuffer buffer(storage, fBufferData->bytes() + fBufferData->size() - storage);
+    buffer.setVersion(fInfo.getVersion());
+    fImageRefs[index] = buffer.readImage().release();
+}
+
 bool SkPictureData::containsBitmaps() const {
     if (fBitmapImageCount > 0 || fImageCount > 0) {
         return true;
@@ -255,13 +281,31 @@ void SkPictureData::flattenToBuffer(SkWriteBuffer& buffer) const {
     }
 }
 
+// Pads the stream so that the payload of the next tag starts on a 4-byte boundary.
+static void write_padding_for_next_tag(SkWStream* stream) {
+    const size_t written = stream->bytesWritten(),
+                 padding = SkAlign4(written) - written;
+    if (padding > 0) {
+        write_tag_size(stream, SK_PICT_PADDING_TAG, SkToU32(padding));
+        const char zeros[4] = { 0, 0, 0, 0 };
+        stream->write(zeros, padding);
+    }
+}
+
 void SkPictureData::serialize(SkWStream* stream,
                               SkPixelSerializer* pixelSerializer,
                               SkRefCntSet* topLevelTypeFaceSet) const {
     // This can happen at pretty much any time, so might as well do it first.
+    write_padding_for_next_tag(stream);
     write_tag_size(stream, SK_PICT_READER_TAG, fOpData->size());
     stream->write(fOpData->bytes(), fOpData->size());
 
+    if (fOpIndex) {
+        write_padding_for_next_tag(stream);
+        write_tag_size(stream, SK_PICT_OP_INDEX_TAG, this->opIndexCount());
+        stream->write(fOpIndex->data(), fOpIndex->size());
+    }
+
     // We serialize all typefaces into the typeface section of the top-level picture.
     SkRefCntSet localTypefaceSet;
     SkRefCntSet* typefaceSet = topLevelTypeFaceSet ? topLevelTypeFaceSet : &localTypefaceSet;
@@ -295,6 +339,7 @@ void SkPictureData::serialize(SkWStream* stream,
     }
 
     // Write the buffer.
+    write_padding_for_next_tag(stream);
     write_tag_size(stream, SK_PICT_BUFFER_SIZE_TAG, buffer.bytesWritten());
     buffer.writeToStream(stream);
 
@@ -357,11 +402,25 @@ static uint32_t pictInfoFlagsToReadBufferFlags(uint32_t pictInfoFlags) {
     return rbMask;
 }
 
+// Returns the next size bytes of the stream, which is reading from mapped, and skips them.
+// The bytes are read as 32-bit values, so they're only referred to in place if they're aligned.
+static sk_sp<SkData> subset_mapped_data(const SkData* mapped, SkStream* stream, size_t size) {
+    const size_t offset = stream->getPosition();
+    if (offset > mapped->size() || size > mapped->size() - offset || stream->skip(size) != size) {
+        return nullptr;
+    }
+    if (SkIsAlign4((uintptr_t)mapped->bytes() + offset)) {
+        return SkData::MakeSubset(mapped, offset, size);
+    }
+    return SkData::MakeWithCopy(mapped->bytes() + offset, size);
+}
+
 bool SkPictureData::parseStreamTag(SkStream* stream,
                                    uint32_t tag,
                                    uint32_t size,
                                    SkImageDeserializer* factory,
-                                   SkTypefacePlayback* topLevelTFPlayback) {
+                                   SkTypefacePlayback* topLevelTFPlayback,
+                                   const SkData* mapped) {
     /*
      *  By the time we encounter BUFFER_SIZE_TAG, we need to have already seen
      *  its dependents: FACTORY_TAG and TYPEFACE_TAG. These two are not required
@@ -376,11 +435,43 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
     switch (tag) {
         case SK_PICT_READER_TAG:
             SkASSERT(nullptr == fOpData);
-            fOpData = SkData::MakeFromStream(stream, size);
+            fOpData = mapped ? subset_mapped_data(mapped, stream, size)
+                             : SkData::MakeFromStream(stream, size);
             if (!fOpData) {
                 return false;
             }
             break;
+        case SK_PICT_OP_INDEX_TAG: {
+            if (size > SIZE_MAX / sizeof(OpIndexEntry)) {
+                return false;
+            }
+            const size_t bytes = size * sizeof(OpIndexEntry);
+            if (!mapped) {
+                // Forwardport() re-records the picture, so there's no use for the index.
+                if (stream->skip(bytes) != bytes) {
+                    return false;
+                }
+                break;
+            }
+            fOpIndex = subset_mapped_data(mapped, stream, bytes);
+            if (!fOpIndex || !fOpData) {
+                return false;
+            }
+            // Make sure each entry's ops lie within the op data, after the previous entry's.
+            uint32_t offset = 0;
+            for (int i = 0; i < this->opIndexCount(); i++) {
+                const uint32_t next = this->opIndex()[i].fOffset;
+                if (next < offset || next > fOpData->size() || !SkIsAlign4(next)) {
+                    return false;
+                }
+                offset = next;
+            }
+        } break;
+        case SK_PICT_PADDING_TAG:
+            if (stream->skip(size) != size) {
+                return false;
+            }
+            break;
         case SK_PICT_FACTORY_TAG: {
             SkASSERT(!haveBuffer);
             size = stream->readU32();
@@ -413,7 +504,8 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             fPictureCount = 0;
             fPictureRefs = new const SkPicture* [size];
             for (uint32_t i = 0; i < size; i++) {
-                fPictureRefs[i] = SkPicture::MakeFromStream(stream, factory, topLevelTFPlayback).release();
+                fPictureRefs[i] = SkPicture::MakeFromStream(stream, factory, topLevelTFPlayback,
+                                                            mapped).release();
                 if (!fPictureRefs[i]) {
                     return false;
                 }
@@ -421,13 +513,25 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             }
         } break;
         case SK_PICT_BUFFER_SIZE_TAG: {
-            SkAutoMalloc storage(size);
-            if (stream->read(storage.get(), size) != size) {
-                return false;
+            SkAutoMalloc storage;
+            const void* bytes;
+            if (mapped) {
+                // Keep the buffer around so that paths can be read from it later.
+                fBufferData = subset_mapped_data(mapped, stream, size);
+                if (!fBufferData) {
+                    return false;
+                }
+                bytes = fBufferData->data();
+            } else {
+                storage.reset(size);
+                if (stream->read(storage.get(), size) != size) {
+                    return false;
+                }
+                bytes = storage.get();
             }
 
             /* Should we use SkValidatingReadBuffer instead? */
-            SkReadBuffer buffer(storage.get(), size);
+            SkReadBuffer buffer(bytes, size);
             buffer.setFlags(pictInfoFlagsToReadBufferFlags(fInfo.fFlags));
             buffer.setVersion(fInfo.getVersion());
 
@@ -436,6 +540,8 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             }
             fFactoryPlayback->setupBuffer(buffer);
             buffer.setImageDeserializer(factory);
+            // Lazy images are read with the default deserializer, since factory may not outlive us.
+            fLazyImages = fBufferData && !factory;
 
             if (fTFPlayback.count() > 0) {
                 // .skp files <= v43 have typefaces serialized with each sub picture.
@@ -479,6 +585,18 @@ static const SkDrawable* create_drawable_from_buffer(SkReadBuffer& buffer) {
     return (SkDrawable*) buffer.readFlattenable(SkFlattenable::kSkDrawable_Type);
 }
 
+// Returns the number of bytes SkReadBuffer::readImage() will read for an encoded image
+// at storage, or 0 if storage doesn't hold an encoded image (e.g. it holds raw pixels).
+static size_t encoded_image_size(const void* storage, size_t length) {
+    const uint32_t* header = (const uint32_t*)storage;  // width, height, encoded size
+    if (length < 3 * sizeof(uint32_t) || header[2] <= 1 || header[2] > length) {
+        return 0;
+    }
+    // The encoded data is padded to 4 bytes, and followed by the subset's origin.
+    const size_t size = 3 * sizeof(uint32_t) + SkAlign4(header[2]) + 2 * sizeof(int32_t);
+    return size <= length ? size : 0;
+}
+
 template <typename T>
 bool new_array_from_buffer(SkReadBuffer& buffer, uint32_t inCount,
                            const T*** array, int* outCount, const T* (*factory)(SkReadBuffer&)) {
@@ -538,9 +656,27 @@ bool SkPictureData::parseBufferTag(SkReadBuffer& buffer, uint32_t tag, uint32_t
         case SK_PICT_PATH_BUFFER_TAG:
             if (size > 0) {
                 const int count = buffer.readInt();
+                if (!buffer.validate(count >= 0)) {
+                    return false;
+                }
                 fPaths.reset(count);
-                for (int i = 0; i < count; i++) {
-                    buffer.readPath(&fPaths[i]);
+                if (fBufferData) {
+                    // Just note where each path is.  readLazyPath() will read it when it's drawn.
+                    fLazyPaths.setCount(count);
+                    fLazyPathOnce.reset(new SkOnce[count]);
+                    for (int i = 0; i < count; i++) {
+                        const void* storage = buffer.skip(0);
+                        size_t pathSize = SkPathPriv::SerializedSize(storage,
+                                                                     buffer.size() - buffer.offset());
+                        if (!buffer.validate(pathSize > 0)) {
+                            return false;
+                        }
+                        fLazyPaths[i] = buffer.skip(pathSize);
+                    }
+                } else {
+                    for (int i = 0; i < count; i++) {
+                        buffer.readPath(&fPaths[i]);
+                    }
                 }
             } break;
         case SK_PICT_TEXTBLOB_BUFFER_TAG:
@@ -550,8 +686,32 @@ bool SkPictureData::parseBufferTag(SkReadBuffer& buffer, uint32_t tag, uint32_t
             }
             break;
         case SK_PICT_IMAGE_BUFFER_TAG:
-            if (!new_array_from_buffer(buffer, size, &fImageRefs, &fImageCount,
-                                       create_image_from_buffer)) {
+            if (fLazyImages) {
+                if (!buffer.validate(0 == fImageCount && nullptr == fImageRefs &&
+                                     SkTFitsIn<int>(size))) {
+                    return false;
+                }
+                // Just note where each encoded image is.  readLazyImage() reads it when it's
+                // drawn.  Anything else is read now.
+                fImageCount = size;
+                fImageRefs = new const SkImage* [fImageCount]();
+                fLazyImageData.setCount(fImageCount);
+                fLazyImageOnce.reset(new SkOnce[fImageCount]);
+                for (int i = 0; i < fImageCount; i++) {
+                    const void* storage = buffer.skip(0);
+                    size_t imageSize = encoded_image_size(storage, buffer.size() - buffer.offset());
+                    if (imageSize > 0) {
+                        fLazyImageData[i] = buffer.skip(imageSize);
+                    } else {
+                        fLazyImageData[i] = nullptr;
+                        fImageRefs[i] = create_image_from_buffer(buffer);
+                        if (!fImageRefs[i]) {
+                            return false;
+                        }
+                    }
+                }
+            } else if (!new_array_from_buffer(buffer, size, &fImageRefs, &fImageCount,
+                                              create_image_from_buffer)) {
                 return false;
             }
             break;
@@ -586,13 +746,14 @@ bool SkPictureData::parseBufferTag(SkReadBuffer& buffer, uint32_t tag, uint32_t
 SkPictureData* SkPictureData::CreateFromStream(SkStream* stream,
                                                const SkPictInfo& info,
                                                SkImageDeserializer* factory,
-                                               SkTypefacePlayback* topLevelTFPlayback) {
+                                               SkTypefacePlayback* topLevelTFPlayback,
+                                               const SkData* mapped) {
     std::unique_ptr<SkPictureData> data(new SkPictureData(info));
     if (!topLevelTFPlayback) {
         topLevelTFPlayback = &data->fTFPlayback;
     }
 
-    if (!data->parseStream(stream, factory, topLevelTFPlayback)) {
+    if (!data->parseStream(stream, factory, topLevelTFPlayback, mapped)) {
         return nullptr;
     }
     return data.release();
@@ -611,7 +772,8 @@ SkPictureData* SkPictureData::CreateFromBuffer(SkReadBuffer& buffer,
 
 bool SkPictureData::parseStream(SkStream* stream,
                                 SkImageDeserializer* factory,
-                                SkTypefacePlayback* topLevelTFPlayback) {
+                                SkTypefacePlayback* topLevelTFPlayback,
+                                const SkData* mapped) {
     for (;;) {
         uint32_t tag = stream->readU32();
         if (SK_PICT_EOF_TAG == tag) {
@@ -619,7 +781,7 @@ bool SkPictureData::parseStream(SkStream* stream,
         }
 
         uint32_t size = stream->readU32();
-        if (!this->parseStreamTag(stream, tag, size, factory, topLevelTFPlayback)) {
+        if (!this->parseStreamTag(stream, tag, size, factory, topLevelTFPlayback, mapped)) {
             return false; // we're invalid
         }
     }
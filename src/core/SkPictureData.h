@@ -10,6 +10,7 @@
 
 #include "SkBitmap.h"
 #include "SkDrawable.h"
+#include "SkOnce.h"
 #include "SkPicture.h"
 #include "SkPictureContentInfo.h"
 #include "SkPictureFlat.h"
@@ -70,6 +71,14 @@ public:
 #define SK_PICT_TEXTBLOB_BUFFER_TAG SkSetFourByteTag('b', 'l', 'o', 'b')
 #define SK_PICT_IMAGE_BUFFER_TAG    SkSetFourByteTag('i', 'm', 'a', 'g')
 
+// Pictures recorded with a BBH are serialized with the bounds of each op, and where it starts
+// in the READER tag's op data, so that readers can play back only the ops they need.
+#define SK_PICT_OP_INDEX_TAG   SkSetFourByteTag('o', 'i', 'd', 'x')
+
+// Skipped when reading.  Pads the next tag's payload to a 4-byte boundary, so that it
+// can be read in place from mapped memory.
+#define SK_PICT_PADDING_TAG SkSetFourByteTag('p', 'a', 'd', ' ')
+
 // Always write this guy last (with no length field afterwards)
 #define SK_PICT_EOF_TAG     SkSetFourByteTag('e', 'o', 'f', ' ')
 
@@ -77,10 +86,13 @@ class SkPictureData {
 public:
     SkPictureData(const SkPictureRecord& record, const SkPictInfo&);
     // Does not affect ownership of SkStream.
+    // If mapped is not null, the stream reads from it, and the SkPictureData will refer to
+    // its ops, op index, paths and images in place rather than copying them.
     static SkPictureData* CreateFromStream(SkStream*,
                                            const SkPictInfo&,
                                            SkImageDeserializer*,
-                                           SkTypefacePlayback*);
+                                           SkTypefacePlayback*,
+                                           const SkData* mapped = nullptr);
     static SkPictureData* CreateFromBuffer(SkReadBuffer&, const SkPictInfo&);
 
     virtual ~SkPictureData();
@@ -96,11 +108,27 @@ public:
 
     const sk_sp<SkData>& opData() const { return fOpData; }
 
+    // One entry per op in the SkRecord the picture was serialized from.  The ops that entry i
+    // turned into span from its fOffset up to entry i+1's fOffset (or the end of opData()).
+    struct OpIndexEntry {
+        uint32_t fOffset;
+        SkRect   fBounds;
+    };
+
+    // Null unless the picture has a BBH, and either is being serialized or was read from mapped
+    // data.
+    const OpIndexEntry* opIndex() const {
+        return fOpIndex ? (const OpIndexEntry*)fOpIndex->data() : nullptr;
+    }
+    int opIndexCount() const {
+        return fOpIndex ? SkToInt(fOpIndex->size() / sizeof(OpIndexEntry)) : 0;
+    }
+
 protected:
     explicit SkPictureData(const SkPictInfo& info);
 
     // Does not affect ownership of SkStream.
-    bool parseStream(SkStream*, SkImageDeserializer*, SkTypefacePlayback*);
+    bool parseStream(SkStream*, SkImageDeserializer*, SkTypefacePlayback*, const SkData* mapped);
     bool parseBuffer(SkReadBuffer& buffer);
 
 public:
@@ -111,12 +139,24 @@ public:
 
     const SkImage* getImage(SkReadBuffer* reader) const {
         const int index = reader->readInt();
-        return reader->validateIndex(index, fImageCount) ? fImageRefs[index] : nullptr;
+        if (!reader->validateIndex(index, fImageCount)) {
+            return nullptr;
+        }
+        if (fLazyImageOnce) {
+            fLazyImageOnce[index]([this, index] { this->readLazyImage(index); });
+        }
+        return fImageRefs[index];
     }
 
     const SkPath& getPath(SkReadBuffer* reader) const {
         const int index = reader->readInt() - 1;
-        return reader->validateIndex(index, fPaths.count()) ? fPaths[index] : fEmptyPath;
+        if (!reader->validateIndex(index, fPaths.count())) {
+            return fEmptyPath;
+        }
+        if (fLazyPathOnce) {
+            fLazyPathOnce[index]([this, index] { this->readLazyPath(index); });
+        }
+        return fPaths[index];
     }
 
     const SkPicture* getPicture(SkReadBuffer* reader) const {
@@ -167,14 +207,27 @@ private:
     // these help us with reading/writing
     // Does not affect ownership of SkStream.
     bool parseStreamTag(SkStream*, uint32_t tag, uint32_t size,
-                        SkImageDeserializer*, SkTypefacePlayback*);
+                        SkImageDeserializer*, SkTypefacePlayback*, const SkData* mapped);
     bool parseBufferTag(SkReadBuffer&, uint32_t tag, uint32_t size);
     void flattenToBuffer(SkWriteBuffer&) const;
 
     SkTArray<SkPaint>  fPaints;
-    SkTArray<SkPath>   fPaths;
+    mutable SkTArray<SkPath> fPaths;
+
+    // When parsing mapped data, paths are left in fBufferData until they are first drawn.
+    void readLazyPath(int index) const;
+    sk_sp<SkData>             fBufferData;
+    SkTDArray<const void*>    fLazyPaths;
+    std::unique_ptr<SkOnce[]> fLazyPathOnce;
+
+    // Likewise for encoded images, unless they need a custom SkImageDeserializer.
+    void readLazyImage(int index) const;
+    bool                      fLazyImages;
+    SkTDArray<const void*>    fLazyImageData;
+    std::unique_ptr<SkOnce[]> fLazyImageOnce;
 
     sk_sp<SkData>   fOpData;    // opcodes and parameters
+    sk_sp<SkData>   fOpIndex;   // OpIndexEntry array
 
     const SkPath    fEmptyPath;
     const SkBitmap  fEmptyBitmap;
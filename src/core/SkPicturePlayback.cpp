@@ -121,6 +121,52 @@ void SkPicturePlayback::draw(SkCanvas* canvas,
     }
 }
 
+void SkPicturePlayback::draw(SkCanvas* canvas,
+                             SkPicture::AbortCallback* callback,
+                             const int opIndexEntries[], int count) {
+    AutoResetOpID aroi(this);
+    SkASSERT(0 == fCurOffset);
+
+    const SkPictureData::OpIndexEntry* opIndex = fPictureData->opIndex();
+    const int opIndexCount = fPictureData->opIndexCount();
+    SkReadBuffer reader(fPictureData->opData()->bytes(), fPictureData->opData()->size());
+
+    // Record this, so we can concat w/ it if we encounter a setMatrix()
+    SkMatrix initialMatrix = canvas->getTotalMatrix();
+
+    SkAutoCanvasRestore acr(canvas, false);
+
+    for (int i = 0; i < count; i++) {
+        const int entry = opIndexEntries[i];
+        SkASSERT(entry >= 0 && entry < opIndexCount);
+        const size_t start = opIndex[entry].fOffset,
+                     stop  = entry + 1 < opIndexCount ? opIndex[entry + 1].fOffset
+                                                      : reader.size();
+
+        // A clip that came up empty may already have skipped us past start.
+        if (start > reader.offset()) {
+            reader.skip(start - reader.offset());
+        }
+        while (reader.offset() < stop && !reader.eof()) {
+            if (callback && callback->abort()) {
+                return;
+            }
+
+            fCurOffset = reader.offset();
+            uint32_t size;
+            DrawType op = ReadOpAndSize(&reader, &size);
+            if (!reader.validate(op > UNUSED && op <= LAST_DRAWTYPE_ENUM)) {
+                return;
+            }
+
+            this->handleOp(&reader, op, size, canvas, initialMatrix);
+        }
+        if (!reader.isValid()) {
+            return;
+        }
+    }
+}
+
 void SkPicturePlayback::handleOp(SkReadBuffer* reader,
                                  DrawType op,
                                  uint32_t size,
@@ -25,6 +25,9 @@ public:
 
     void draw(SkCanvas* canvas, SkPicture::AbortCallback*, SkReadBuffer* buffer);
 
+    // Plays back only the given entries of the picture data's op index, which must be sorted.
+    void draw(SkCanvas* canvas, SkPicture::AbortCallback*, const int opIndexEntries[], int count);
+
     // TODO: remove the curOp calls after cleaning up GrGatherDevice
     // Return the ID of the operation currently being executed when playing
     // back. 0 indicates no call is active.
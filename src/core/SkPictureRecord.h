@@ -71,6 +71,17 @@ public:
     void beginRecording();
     void endRecording();
 
+    // Notes that the ops recorded next come from an op with these bounds.  See OpIndexEntry.
+    void addOpIndexEntry(const SkRect& bounds) {
+        const uint32_t offset = SkToU32(fWriter.bytesWritten());
+        if (!fOpIndex.isEmpty() && fOpIndex.top().fOffset == offset) {
+            // The last op didn't record anything, so its entry is no use.
+            fOpIndex.top().fBounds = bounds;
+        } else {
+            *fOpIndex.append() = { offset, bounds };
+        }
+    }
+
 protected:
     void addNoOp();
 
@@ -273,6 +284,8 @@ private:
     SkTDArray<SkDrawable*>       fDrawableRefs;
     SkTDArray<const SkTextBlob*> fTextBlobRefs;
 
+    SkTDArray<SkPictureData::OpIndexEntry> fOpIndex;
+
     uint32_t fRecordFlags;
     int      fInitialSaveCount;
 
@@ -15,8 +15,194 @@
 #include "SkRecordOpts.h"
 #include "SkRecordedDrawable.h"
 #include "SkRecorder.h"
+#include "SkRecords.h"
+#include "SkRegion.h"
+#include "SkTArray.h"
 #include "SkTypes.h"
 
+// beginRecordingDamage() lays a picture out as a run of top-level groups, each Save, a non-AA
+// intersect clip to a region, a DrawPicture, and a Restore.  Each group is one earlier recording
+// (or a merge of a few), its clip cut down to the part of its damage that no later recording has
+// covered.  To update the picture we cut the new damage out of each group's clip, drop groups
+// left empty, and record the caller's draws as a new group.  The surviving groups' pictures are
+// shared by reference, each with its own BBH, so the only ops recorded are the caller's and four
+// per group, and only the top level's BBH, over those few ops, is built from scratch.
+//
+// Groups would pile up one per update, so whenever a group has at least half as many ops as the
+// group before it, we merge the two, dropping draws that no longer reach either clip.  Each group
+// then has more than twice the ops of the next, so there are only logarithmically many, and any
+// given op is copied only a logarithmic number of times over the picture's updates.
+//
+// Pictures we can't split up like that are treated as one big group.
+
+namespace {
+    struct Group {
+        sk_sp<const SkPicture> fPicture;
+        SkRegion               fRegion;  // What the group's clip lets through.
+    };
+
+    struct OpType {
+        template <typename T>
+        SkRecords::Type operator()(const T&) { return T::kType; }
+    };
+
+    struct IsDrawOp {
+        template <typename T>
+        bool operator()(const T&) { return SkToBool(T::kTags & SkRecords::kDraw_Tag); }
+    };
+
+    // If the op is a non-AA intersect clip to exactly some region, sets that region.
+    struct ClipRegion {
+        SkRegion* fRegion;
+
+        bool operator()(const SkRecords::ClipRect& op) {
+            if (op.opAA.op() != SkClipOp::kIntersect || op.opAA.aa()) {
+                return false;
+            }
+            const SkIRect rect = op.rect.round();
+            if (SkRect::Make(rect) != op.rect) {
+                return false;
+            }
+            fRegion->setRect(rect);
+            return true;
+        }
+        bool operator()(const SkRecords::ClipPath& op) {
+            if (op.opAA.op() != SkClipOp::kIntersect || op.opAA.aa()) {
+                return false;
+            }
+            fRegion->setPath(op.path, SkRegion(op.path.getBounds().roundOut()));
+            SkPath boundary;
+            fRegion->getBoundaryPath(&boundary);
+            return boundary == op.path;
+        }
+        template <typename T>
+        bool operator()(const T&) { return false; }
+    };
+
+    // If the op draws a picture as-is, sets that picture.
+    struct PlainPicture {
+        sk_sp<const SkPicture>* fPicture;
+
+        bool operator()(const SkRecords::DrawPicture& op) {
+            if (op.paint || !op.matrix.isIdentity()) {
+                return false;
+            }
+            *fPicture = op.picture;
+            return true;
+        }
+        template <typename T>
+        bool operator()(const T&) { return false; }
+    };
+}
+
+static int skip_noops(const SkRecord& record, int i) {
+    while (i < record.count() && record.visit(i, OpType()) == SkRecords::NoOp_Type) {
+        i++;
+    }
+    return i;
+}
+
+static bool find_groups(const SkPicture& picture, SkTArray<Group>* groups) {
+    const SkBigPicture* big = picture.asSkBigPicture();
+    if (!big) {
+        return false;
+    }
+    const SkRecord& record = *big->record();
+    for (int i = skip_noops(record, 0); i < record.count(); i = skip_noops(record, i + 1)) {
+        if (record.visit(i, OpType()) != SkRecords::Save_Type) {
+            return false;
+        }
+        Group group;
+        i = skip_noops(record, i + 1);
+        if (i == record.count() || !record.visit(i, ClipRegion{&group.fRegion})) {
+            return false;
+        }
+        i = skip_noops(record, i + 1);
+        if (i == record.count() || !record.visit(i, PlainPicture{&group.fPicture})) {
+            return false;
+        }
+        i = skip_noops(record, i + 1);
+        if (i == record.count() || record.visit(i, OpType()) != SkRecords::Restore_Type) {
+            return false;
+        }
+        groups->push_back(std::move(group));
+    }
+    return true;
+}
+
+static void clip_to_region(SkCanvas* canvas, const SkRegion& region) {
+    SkPath boundary;
+    region.getBoundaryPath(&boundary);
+    canvas->clipPath(boundary, SkClipOp::kIntersect, false);
+}
+
+// Draws the group's picture, clipped to its region, skipping draws that don't reach the region.
+static void draw_live_ops(SkCanvas* canvas, const Group& group) {
+    canvas->save();
+    clip_to_region(canvas, group.fRegion);
+    if (const SkBigPicture* big = group.fPicture->asSkBigPicture()) {
+        const SkRecord& record = *big->record();
+        SkAutoTMalloc<SkRect> bounds(record.count());
+        SkRecordFillBounds(big->cullRect(), record, bounds);
+
+        SkRecords::Draw draw(canvas, big->drawablePicts(), nullptr, big->drawableCount());
+        for (int i = 0; i < record.count(); i++) {
+            // Pad by a pixel for anti-aliasing, as the clip may land mid-pixel when drawn.
+            const bool reaches = !bounds[i].isEmpty() &&
+                                 group.fRegion.intersects(bounds[i].makeOutset(1, 1).roundOut());
+            if (!reaches) {
+                // A Save's bounds cover its whole block, so skip to its Restore.
+                const SkRecords::Type type = record.visit(i, OpType());
+                if (type == SkRecords::Save_Type || type == SkRecords::SaveLayer_Type) {
+                    for (int depth = 1; depth > 0 && i + 1 < record.count(); ) {
+                        switch (record.visit(++i, OpType())) {
+                            case SkRecords::Save_Type:
+                            case SkRecords::SaveLayer_Type: depth++; break;
+                            case SkRecords::Restore_Type:   depth--; break;
+                            default: break;
+                        }
+                    }
+                    continue;
+                }
+                if (record.visit(i, IsDrawOp())) {
+                    continue;
+                }
+            }
+            record.visit(i, draw);
+        }
+    } else {
+        group.fPicture->playback(canvas);
+    }
+    canvas->restore();
+}
+
+static Group merge_groups(const Group& older, const Group& newer, SkBBHFactory* bbhFactory) {
+    Group merged;
+    merged.fRegion.op(older.fRegion, newer.fRegion, SkRegion::kUnion_Op);
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(SkRect::Make(merged.fRegion.getBounds()),
+                                               bbhFactory);
+    draw_live_ops(canvas, older);
+    draw_live_ops(canvas, newer);
+    merged.fPicture = recorder.finishRecordingAsPicture();
+    return merged;
+}
+
+struct SkPictureRecorder::Damage {
+    bool                   fRecording;  // True between beginRecordingDamage() and finishing.
+    SkTArray<Group>        fGroups;     // Earlier recordings still showing, oldest first.
+    SkIRect                fRect;       // Where the new recording shows.
+    SkRect                 fCullRect;   // For the whole picture.
+    sk_sp<SkBBoxHierarchy> fBBH;        // Likewise.
+
+    // The groups of the last picture we finished, so updating it again needn't parse them back.
+    uint32_t               fPictureID;
+    SkTArray<Group>        fPictureGroups;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
 SkPictureRecorder::SkPictureRecorder() {
     fActivelyRecording = false;
     fRecorder.reset(new SkRecorder(nullptr, SkRect::MakeWH(0, 0), &fMiniRecorder));
@@ -27,6 +213,9 @@ SkPictureRecorder::~SkPictureRecorder() {}
 SkCanvas* SkPictureRecorder::beginRecording(const SkRect& cullRect,
                                             SkBBHFactory* bbhFactory /* = nullptr */,
                                             uint32_t recordFlags /* = 0 */) {
+    if (fDamage) {
+        fDamage->fRecording = false;
+    }
     fCullRect = cullRect;
     fFlags = recordFlags;
 
@@ -46,11 +235,81 @@ SkCanvas* SkPictureRecorder::beginRecording(const SkRect& cullRect,
     return this->getRecordingCanvas();
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+SkCanvas* SkPictureRecorder::beginRecordingDamage(const SkPicture& previous,
+                                                  const SkRect& damage,
+                                                  SkBBHFactory* bbhFactory /* = nullptr */,
+                                                  uint32_t recordFlags /* = 0 */) {
+    if (!fDamage) {
+        fDamage.reset(new Damage);
+        fDamage->fPictureID = 0;
+    }
+    Damage* state = fDamage.get();
+    state->fGroups.reset();
+    state->fRect = damage.roundOut();
+    state->fCullRect = previous.cullRect();
+    state->fCullRect.join(damage);
+    state->fBBH.reset(bbhFactory ? (*bbhFactory)(state->fCullRect) : nullptr);
+
+    SkTArray<Group> groups;
+    if (state->fPictureID == previous.uniqueID()) {
+        groups = state->fPictureGroups;
+    } else if (!find_groups(previous, &groups)) {
+        groups.reset();
+        groups.push_back({sk_ref_sp(&previous), SkRegion(previous.cullRect().roundOut())});
+    }
+
+    for (Group& group : groups) {
+        if (!group.fRegion.op(state->fRect, SkRegion::kDifference_Op)) {
+            continue;  // All damaged.
+        }
+        state->fGroups.push_back(std::move(group));
+
+        SkTArray<Group>& kept = state->fGroups;
+        while (kept.count() >= 2 && kept.fromBack(1).fPicture->approximateOpCount() <=
+                                    kept.fromBack(0).fPicture->approximateOpCount() * 2) {
+            Group merged = merge_groups(kept.fromBack(1), kept.fromBack(0), bbhFactory);
+            kept.pop_back();
+            kept.back() = std::move(merged);
+        }
+    }
+
+    SkCanvas* canvas = this->beginRecording(SkRect::Make(state->fRect), bbhFactory, recordFlags);
+    state->fRecording = true;
+    return canvas;
+}
+
+void SkPictureRecorder::finishRecordingDamage() {
+    Damage* damage = fDamage.get();
+    damage->fRecording = false;
+    sk_sp<SkPicture> picture = this->finishRecordingAsPicture();
+
+    // Lay out the groups, always recording the picture by reference.
+    this->beginRecording(damage->fCullRect);
+    fBBH = std::move(damage->fBBH);
+    if (picture->approximateOpCount() > 0) {
+        damage->fGroups.push_back({std::move(picture), SkRegion(damage->fRect)});
+    }
+    for (const Group& group : damage->fGroups) {
+        fRecorder->save();
+        clip_to_region(fRecorder.get(), group.fRegion);
+        fRecorder->onDrawPicture(group.fPicture.get(), nullptr, nullptr);
+        fRecorder->restore();
+    }
+    damage->fPictureID = 0;  // Set once the picture is made.
+    damage->fPictureGroups.swap(&damage->fGroups);
+}
+
 SkCanvas* SkPictureRecorder::getRecordingCanvas() {
     return fActivelyRecording ? fRecorder.get() : nullptr;
 }
 
 sk_sp<SkPicture> SkPictureRecorder::finishRecordingAsPicture(uint32_t finishFlags) {
+    const bool damage = fDamage && fDamage->fRecording;
+    if (damage) {
+        this->finishRecordingDamage();
+    }
     fActivelyRecording = false;
     fRecorder->restoreToCount(1);  // If we were missing any restores, add them now.
 
@@ -63,6 +322,9 @@ sk_sp<SkPicture> SkPictureRecorder::finishRecordingAsPicture(uint32_t finishFlag
 
     // TODO: delay as much of this work until just before first playback?
     SkRecordOptimize(fRecord.get());
+    if (fFlags & kOptimizeDrawOrder_RecordFlag) {
+        SkRecordOptimizeDrawOrder(fRecord.get(), fCullRect);
+    }
 
     if (fRecord->count() == 0) {
         if (finishFlags & kReturnNullForEmpty_FinishFlag) {
@@ -91,13 +353,21 @@ sk_sp<SkPicture> SkPictureRecorder::finishRecordingAsPicture(uint32_t finishFlag
     for (int i = 0; pictList && i < pictList->count(); i++) {
         subPictureBytes += SkPictureUtils::ApproximateBytesUsed(pictList->begin()[i]);
     }
-    return sk_make_sp<SkBigPicture>(fCullRect, fRecord.release(), pictList, fBBH.release(),
-                                    subPictureBytes);
+    sk_sp<SkPicture> picture = sk_make_sp<SkBigPicture>(fCullRect, fRecord.release(), pictList,
+                                                        fBBH.release(), subPictureBytes);
+    if (damage) {
+        fDamage->fPictureID = picture->uniqueID();
+    }
+    return picture;
 }
 
 sk_sp<SkPicture> SkPictureRecorder::finishRecordingAsPictureWithCull(const SkRect& cullRect,
                                                                      uint32_t finishFlags) {
-    fCullRect = cullRect;
+    if (fDamage && fDamage->fRecording) {
+        fDamage->fCullRect = cullRect;
+    } else {
+        fCullRect = cullRect;
+    }
     return this->finishRecordingAsPicture(finishFlags);
 }
 
@@ -118,11 +388,17 @@ void SkPictureRecorder::partialReplay(SkCanvas* canvas) const {
 }
 
 sk_sp<SkDrawable> SkPictureRecorder::finishRecordingAsDrawable(uint32_t finishFlags) {
+    if (fDamage && fDamage->fRecording) {
+        this->finishRecordingDamage();
+    }
     fActivelyRecording = false;
     fRecorder->flushMiniRecorder();
     fRecorder->restoreToCount(1);  // If we were missing any restores, add them now.
 
     SkRecordOptimize(fRecord.get());
+    if (fFlags & kOptimizeDrawOrder_RecordFlag) {
+        SkRecordOptimizeDrawOrder(fRecord.get(), fCullRect);
+    }
 
     if (fRecord->count() == 0) {
         if (finishFlags & kReturnNullForEmpty_FinishFlag) {
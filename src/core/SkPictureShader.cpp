@@ -10,12 +10,17 @@
 #include "SkBitmap.h"
 #include "SkBitmapProcShader.h"
 #include "SkCanvas.h"
+#include "SkColorSpace.h"
+#include "SkGraphics.h"
 #include "SkImage.h"
 #include "SkImageShader.h"
 #include "SkMatrixUtils.h"
+#include "SkMutex.h"
+#include "SkPersistentCache.h"
 #include "SkPicture.h"
 #include "SkReadBuffer.h"
 #include "SkResourceCache.h"
+#include "SkStream.h"
 
 #if SK_SUPPORT_GPU
 #include "GrContext.h"
@@ -64,9 +69,10 @@ private:
 };
 
 struct BitmapShaderRec : public SkResourceCache::Rec {
-    BitmapShaderRec(const BitmapShaderKey& key, SkShader* tileShader)
+    BitmapShaderRec(const BitmapShaderKey& key, SkShader* tileShader, size_t bitmapBytes)
         : fKey(key)
-        , fShader(SkRef(tileShader)) {}
+        , fShader(SkRef(tileShader))
+        , fBitmapBytes(bitmapBytes) {}
 
     BitmapShaderKey fKey;
     sk_sp<SkShader> fShader;
@@ -74,8 +80,9 @@ struct BitmapShaderRec : public SkResourceCache::Rec {
 
     const Key& getKey() const override { return fKey; }
     size_t bytesUsed() const override {
-        // Just the record overhead -- the actual pixels are accounted by SkImageCacherator.
-        return sizeof(fKey) + sizeof(SkImageShader);
+        // The pixels of tiles drawn from the picture on demand are accounted by
+        // SkImageCacherator.  Tiles from the persistent cache hold their own, fBitmapBytes.
+        return sizeof(fKey) + sizeof(SkImageShader) + fBitmapBytes;
     }
     const char* getCategory() const override { return "bitmap-shader"; }
     SkDiscardableMemory* diagnostic_only_getDiscardable() const override { return nullptr; }
@@ -94,21 +101,60 @@ struct BitmapShaderRec : public SkResourceCache::Rec {
 
 } // namespace
 
+// The persistent tile cache is ref'd here rather than held in an sk_sp to avoid a static destructor.
+SK_DECLARE_STATIC_MUTEX(gTileCacheMutex);
+static SkPersistentCache* gTileCache = nullptr;
+
+void SkGraphics::SetPictureShaderTileCache(sk_sp<SkPersistentCache> cache) {
+    SkAutoMutexAcquire lock(gTileCacheMutex);
+    SkSafeUnref(gTileCache);
+    gTileCache = cache.release();
+}
+
+static sk_sp<SkPersistentCache> tile_cache() {
+    SkAutoMutexAcquire lock(gTileCacheMutex);
+    return sk_ref_sp(gTileCache);
+}
+
+// Tiles are stored as tightly packed N32 premul pixels.  Their size is part of the key.
+static sk_sp<SkImage> load_tile(SkPersistentCache* cache, const SkData& key,
+                                const SkImageInfo& info) {
+    sk_sp<SkData> pixels = cache->load(key);
+    if (!pixels || pixels->size() != info.getSafeSize(info.minRowBytes())) {
+        return nullptr;
+    }
+    return SkImage::MakeRasterData(info, std::move(pixels), info.minRowBytes());
+}
+
+static sk_sp<SkImage> store_tile(SkPersistentCache* cache, const SkData& key,
+                                 const SkImageInfo& info, const SkImage* tile) {
+    sk_sp<SkData> pixels = SkData::MakeUninitialized(info.getSafeSize(info.minRowBytes()));
+    if (!tile->readPixels(info, pixels->writable_data(), info.minRowBytes(), 0, 0)) {
+        return nullptr;
+    }
+    cache->store(key, *pixels);
+    return SkImage::MakeRasterData(info, std::move(pixels), info.minRowBytes());
+}
+
 SkPictureShader::SkPictureShader(sk_sp<SkPicture> picture, TileMode tmx, TileMode tmy,
-                                 const SkMatrix* localMatrix, const SkRect* tile)
+                                 const SkMatrix* localMatrix, const SkRect* tile,
+                                 sk_sp<SkPersistentCache> tileCache)
     : INHERITED(localMatrix)
     , fPicture(std::move(picture))
     , fTile(tile ? *tile : fPicture->cullRect())
     , fTmx(tmx)
-    , fTmy(tmy) {
+    , fTmy(tmy)
+    , fTileCache(std::move(tileCache)) {
 }
 
 sk_sp<SkShader> SkPictureShader::Make(sk_sp<SkPicture> picture, TileMode tmx, TileMode tmy,
-                                      const SkMatrix* localMatrix, const SkRect* tile) {
+                                      const SkMatrix* localMatrix, const SkRect* tile,
+                                      sk_sp<SkPersistentCache> tileCache) {
     if (!picture || picture->cullRect().isEmpty() || (tile && tile->isEmpty())) {
         return SkShader::MakeEmptyShader();
     }
-    return sk_sp<SkShader>(new SkPictureShader(std::move(picture), tmx, tmy, localMatrix, tile));
+    return sk_sp<SkShader>(new SkPictureShader(std::move(picture), tmx, tmy, localMatrix, tile,
+                                               std::move(tileCache)));
 }
 
 sk_sp<SkFlattenable> SkPictureShader::CreateProc(SkReadBuffer& buffer) {
@@ -221,27 +267,73 @@ sk_sp<SkShader> SkPictureShader::refBitmapShader(const SkMatrix& viewMatrix, con
                         this->getLocalMatrix());
 
     if (!SkResourceCache::Find(key, BitmapShaderRec::Visitor, &tileShader)) {
-        SkMatrix tileMatrix;
-        tileMatrix.setRectToRect(fTile, SkRect::MakeIWH(tileSize.width(), tileSize.height()),
-                                 SkMatrix::kFill_ScaleToFit);
-
-        sk_sp<SkImage> tileImage(
-            SkImage::MakeFromPicture(fPicture, tileSize, &tileMatrix, nullptr,
-                                     SkImage::BitDepth::kU8, sk_ref_sp(dstColorSpace)));
+        const SkImageInfo tileInfo = SkImageInfo::MakeN32Premul(tileSize.width(),
+                                                                tileSize.height(),
+                                                                sk_ref_sp(dstColorSpace));
+        sk_sp<SkPersistentCache> persistentCache = fTileCache ? fTileCache : tile_cache();
+        sk_sp<SkData> persistentKey;
+        sk_sp<SkImage> tileImage;
+        size_t bitmapBytes = 0;
+
+        if (persistentCache) {
+            persistentKey = this->persistentKey(tileSize, dstColorSpace);
+            tileImage = load_tile(persistentCache.get(), *persistentKey, tileInfo);
+        }
         if (!tileImage) {
-            return nullptr;
+            SkMatrix tileMatrix;
+            tileMatrix.setRectToRect(fTile, SkRect::MakeIWH(tileSize.width(), tileSize.height()),
+                                     SkMatrix::kFill_ScaleToFit);
+
+            tileImage = SkImage::MakeFromPicture(fPicture, tileSize, &tileMatrix, nullptr,
+                                                 SkImage::BitDepth::kU8,
+                                                 sk_ref_sp(dstColorSpace));
+            if (!tileImage) {
+                return nullptr;
+            }
+            if (persistentCache) {
+                // Draw the tile now to store it.  We keep those pixels rather than the picture.
+                if (sk_sp<SkImage> stored = store_tile(persistentCache.get(), *persistentKey,
+                                                       tileInfo, tileImage.get())) {
+                    tileImage = std::move(stored);
+                }
+            }
+        }
+        if (!tileImage->isLazyGenerated()) {
+            bitmapBytes = tileInfo.getSafeSize(tileInfo.minRowBytes());
         }
 
         SkMatrix shaderMatrix = this->getLocalMatrix();
         shaderMatrix.preScale(1 / tileScale.width(), 1 / tileScale.height());
         tileShader = tileImage->makeShader(fTmx, fTmy, &shaderMatrix);
 
-        SkResourceCache::Add(new BitmapShaderRec(key, tileShader.get()));
+        SkResourceCache::Add(new BitmapShaderRec(key, tileShader.get(), bitmapBytes));
     }
 
     return tileShader;
 }
 
+sk_sp<SkData> SkPictureShader::persistentKey(const SkISize& tileSize,
+                                             SkColorSpace* dstColorSpace) const {
+    fContentHashOnce([this] {
+        SkMD5 md5;
+        fPicture->serialize(&md5);
+        md5.finish(fContentHash);
+    });
+
+    static const uint32_t kVersion = 1;  // Bump this if the tile format or drawing changes.
+    SkDynamicMemoryWStream key;
+    key.write32(kVersion);
+    key.write(fContentHash.data, sizeof(fContentHash.data));
+    key.write(&fTile, sizeof(fTile));
+    key.write32(tileSize.width());
+    key.write32(tileSize.height());
+    if (dstColorSpace) {
+        sk_sp<SkData> colorSpace = dstColorSpace->serialize();
+        key.write(colorSpace->data(), colorSpace->size());
+    }
+    return key.detachAsData();
+}
+
 size_t SkPictureShader::onContextSize(const ContextRec&) const {
     return sizeof(PictureShaderContext);
 }
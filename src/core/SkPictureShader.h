@@ -8,6 +8,9 @@
 #ifndef SkPictureShader_DEFINED
 #define SkPictureShader_DEFINED
 
+#include "SkMD5.h"
+#include "SkOnce.h"
+#include "SkPersistentCache.h"
 #include "SkShader.h"
 
 class SkBitmap;
@@ -21,8 +24,10 @@ class SkPicture;
  */
 class SkPictureShader : public SkShader {
 public:
+    // If tileCache is set, tiles are kept there instead of in SkGraphics' picture shader tile
+    // cache.  It isn't flattened.
     static sk_sp<SkShader> Make(sk_sp<SkPicture>, TileMode, TileMode, const SkMatrix*,
-                                const SkRect*);
+                                const SkRect*, sk_sp<SkPersistentCache> tileCache = nullptr);
 
     SK_TO_STRING_OVERRIDE()
     SK_DECLARE_PUBLIC_FLATTENABLE_DESERIALIZATION_PROCS(SkPictureShader)
@@ -38,15 +43,23 @@ protected:
     Context* onCreateContext(const ContextRec&, void* storage) const override;
 
 private:
-    SkPictureShader(sk_sp<SkPicture>, TileMode, TileMode, const SkMatrix*, const SkRect*);
+    SkPictureShader(sk_sp<SkPicture>, TileMode, TileMode, const SkMatrix*, const SkRect*,
+                    sk_sp<SkPersistentCache> tileCache);
 
     sk_sp<SkShader> refBitmapShader(const SkMatrix&, const SkMatrix* localMatrix,
                                     SkColorSpace* dstColorSpace,
                                     const int maxTextureSize = 0) const;
 
+    // Our key in the persistent tile cache, from the picture's contents rather than its ID.
+    sk_sp<SkData> persistentKey(const SkISize& tileSize, SkColorSpace* dstColorSpace) const;
+
     sk_sp<SkPicture>    fPicture;
     SkRect              fTile;
     TileMode            fTmx, fTmy;
+    sk_sp<SkPersistentCache> fTileCache;
+
+    mutable SkOnce          fContentHashOnce;
+    mutable SkMD5::Digest   fContentHash;
 
     class PictureShaderContext : public SkShader::Context {
     public:
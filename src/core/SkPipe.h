@@ -77,6 +77,36 @@ private:
     std::unique_ptr<Impl> fImpl;
 };
 
+/**
+ *  Records frames on the calling thread and plays them back into a canvas on a reader thread.
+ *
+ *  The two threads share a fixed-size ring buffer, so recording only stalls when the reader falls
+ *  a whole ring behind.  The serializer and deserializer live as long as the player, so images,
+ *  pictures, typefaces, paths and flattenable factories are only sent the first time they're seen.
+ */
+class SkPipeAsyncPlayer {
+public:
+    // dst is only touched by the reader thread, and must outlive the player.
+    SkPipeAsyncPlayer(SkCanvas* dst, size_t ringBytes = 1 << 20);
+
+    // Plays back every frame that was ended, then stops the reader thread.
+    ~SkPipeAsyncPlayer();
+
+    // Only configure these before the first beginFrame().
+    SkPipeSerializer* serializer();
+    SkPipeDeserializer* deserializer();
+
+    SkCanvas* beginFrame(const SkRect& cullBounds);
+    void endFrame();
+
+    // Blocks until every ended frame has been played back.
+    void flush();
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> fImpl;
+};
+
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
 class SkTypefaceSerializer {
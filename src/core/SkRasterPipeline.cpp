@@ -8,7 +8,7 @@
 #include "SkOpts.h"
 #include "SkRasterPipeline.h"
 
-SkRasterPipeline::SkRasterPipeline() {}
+SkRasterPipeline::SkRasterPipeline(bool allowLowp) : fAllowLowp(allowLowp) {}
 
 void SkRasterPipeline::append(StockStage stage, void* ctx) {
     SkASSERT(stage != from_srgb);
@@ -22,7 +22,7 @@ void SkRasterPipeline::extend(const SkRasterPipeline& src) {
 
 void SkRasterPipeline::run(size_t x, size_t n) const {
     if (!fStages.empty()) {
-        SkOpts::run_pipeline(x,n, fStages.data(), SkToInt(fStages.size()));
+        SkOpts::run_pipeline(x,n, fStages.data(), SkToInt(fStages.size()), fAllowLowp);
     }
 }
 
@@ -32,7 +32,7 @@ std::function<void(size_t, size_t)> SkRasterPipeline::compile() const {
         return fn;
     }
 #endif
-    return SkOpts::compile_pipeline(fStages.data(), SkToInt(fStages.size()));
+    return SkOpts::compile_pipeline(fStages.data(), SkToInt(fStages.size()), fAllowLowp);
 }
 
 void SkRasterPipeline::dump() const {
@@ -69,6 +69,7 @@
     M(load_565)  M(store_565)                                    \
     M(load_f16)  M(store_f16)                                    \
     M(load_8888) M(store_8888)                                   \
+    M(load_rgb_888) M(load_tables_rgb_888)                       \
     M(load_u16_be) M(load_rgb_u16_be) M(store_u16_be)            \
     M(load_tables_u16_be) M(load_tables_rgb_u16_be)              \
     M(load_tables) M(store_tables)                               \
@@ -99,7 +100,10 @@
 
 class SkRasterPipeline {
 public:
-    SkRasterPipeline();
+    // When allowLowp is true (the default), pipelines whose stages all have 16-bit fixed point
+    // forms run that way, on CPUs where SkOpts supports it.  Benchmarks and tests may pass false
+    // to compare with float.
+    explicit SkRasterPipeline(bool allowLowp = true);
 
     enum StockStage {
     #define M(stage) stage,
@@ -133,6 +137,7 @@ private:
     std::function<void(size_t, size_t)> jit() const;
 
     std::vector<Stage> fStages;
+    bool               fAllowLowp;
 };
 
 #endif//SkRasterPipeline_DEFINED
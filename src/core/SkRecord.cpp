@@ -13,6 +13,15 @@ SkRecord::~SkRecord() {
     for (int i = 0; i < this->count(); i++) {
         this->mutate(i, destroyer);
     }
+    for (SkPaint* paint : fPaints) {
+        paint->~SkPaint();
+    }
+}
+
+const SkPaint* SkRecord::copyPaint(const SkPaint& paint) {
+    SkPaint* copy = new (this->alloc<SkPaint>()) SkPaint(paint);
+    fPaints.push(copy);
+    return copy;
 }
 
 void SkRecord::grow() {
@@ -29,6 +38,7 @@ size_t SkRecord::bytesUsed() const {
     if (fReserved > kInlineRecords) {
         bytes += fReserved * sizeof(Record);
     }
+    bytes += fPaints.reserved() * sizeof(SkPaint*);
     return bytes;
 }
 
@@ -40,3 +50,14 @@ void SkRecord::defrag() {
                                    [](Record op) { return op.type() == SkRecords::NoOp_Type; });
     fCount = noops - fRecords.get();
 }
+
+void SkRecord::move(int from, int to) {
+    SkASSERT(0 <= from && from < fCount);
+    SkASSERT(0 <= to   && to   < fCount);
+    Record* records = fRecords.get();
+    if (from > to) {
+        std::rotate(records + to, records + from, records + from + 1);
+    } else {
+        std::rotate(records + from, records + from + 1, records + to + 1);
+    }
+}
@@ -9,6 +9,7 @@
 #define SkRecord_DEFINED
 
 #include "SkRecords.h"
+#include "SkTDArray.h"
 #include "SkTLogic.h"
 #include "SkTemplates.h"
 #include "SkVarAlloc.h"
@@ -67,6 +68,10 @@ public:
         return (T*)fAlloc.alloc(sizeof(T) * count);
     }
 
+    // Copy paint into this SkRecord, to be shared by any commands that want it (see SharedPaint).
+    // The copy lives until the SkRecord is destroyed.  Throws on failure.
+    const SkPaint* copyPaint(const SkPaint& paint);
+
     // Add a new command of type T to the end of this SkRecord.
     // You are expected to placement new an object of type T onto this pointer.
     template <typename T>
@@ -111,6 +116,10 @@ public:
     // May change count() and the indices of ops, but preserves their order.
     void defrag();
 
+    // Move the command at index from to index to, shifting the commands in between by one.
+    // Changes the indices of those ops, but preserves the order of all but the moved one.
+    void move(int from, int to);
+
 private:
     // An SkRecord is structured as an array of pointers into a big chunk of memory where
     // records representing each canvas draw call are stored:
@@ -193,6 +202,9 @@ private:
     // chunks, returning a stable handle to that data for later retrieval.
     SkVarAlloc fAlloc;
     char fInlineAlloc[1 << kInlineAllocLgBytes];
+
+    // The paints from copyPaint(), which live in fAlloc but need their destructors called.
+    SkTDArray<SkPaint*> fPaints;
 };
 
 #endif//SkRecord_DEFINED
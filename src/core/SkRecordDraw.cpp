@@ -405,19 +405,19 @@ private:
     Bounds bounds(const DrawPaint&) const { return fCurrentClipBounds; }
     Bounds bounds(const NoOp&)  const { return Bounds::MakeEmpty(); }    // NoOps don't draw.
 
-    Bounds bounds(const DrawRect& op) const { return this->adjustAndMap(op.rect, &op.paint); }
+    Bounds bounds(const DrawRect& op) const { return this->adjustAndMap(op.rect, op.paint.get()); }
     Bounds bounds(const DrawRegion& op) const {
         SkRect rect = SkRect::Make(op.region.getBounds());
-        return this->adjustAndMap(rect, &op.paint);
+        return this->adjustAndMap(rect, op.paint.get());
     }
-    Bounds bounds(const DrawOval& op) const { return this->adjustAndMap(op.oval, &op.paint); }
+    Bounds bounds(const DrawOval& op) const { return this->adjustAndMap(op.oval, op.paint.get()); }
     // Tighter arc bounds?
-    Bounds bounds(const DrawArc& op) const { return this->adjustAndMap(op.oval, &op.paint); }
+    Bounds bounds(const DrawArc& op) const { return this->adjustAndMap(op.oval, op.paint.get()); }
     Bounds bounds(const DrawRRect& op) const {
-        return this->adjustAndMap(op.rrect.rect(), &op.paint);
+        return this->adjustAndMap(op.rrect.rect(), op.paint.get());
     }
     Bounds bounds(const DrawDRRect& op) const {
-        return this->adjustAndMap(op.outer.rect(), &op.paint);
+        return this->adjustAndMap(op.outer.rect(), op.paint.get());
     }
     Bounds bounds(const DrawImage& op) const {
         const SkImage* image = op.image.get();
@@ -435,28 +435,29 @@ private:
         return this->adjustAndMap(op.dst, op.paint);
     }
     Bounds bounds(const DrawPath& op) const {
-        return op.path.isInverseFillType() ? fCurrentClipBounds
-                                           : this->adjustAndMap(op.path.getBounds(), &op.paint);
+        return op.path.isInverseFillType()
+                ? fCurrentClipBounds
+                : this->adjustAndMap(op.path.getBounds(), op.paint.get());
     }
     Bounds bounds(const DrawPoints& op) const {
         SkRect dst;
         dst.set(op.pts, op.count);
 
         // Pad the bounding box a little to make sure hairline points' bounds aren't empty.
-        SkScalar stroke = SkMaxScalar(op.paint.getStrokeWidth(), 0.01f);
+        SkScalar stroke = SkMaxScalar(op.paint->getStrokeWidth(), 0.01f);
         dst.outset(stroke/2, stroke/2);
 
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint.get());
     }
     Bounds bounds(const DrawPatch& op) const {
         SkRect dst;
         dst.set(op.cubics, SkPatchUtils::kNumCtrlPts);
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint.get());
     }
     Bounds bounds(const DrawVertices& op) const {
         SkRect dst;
         dst.set(op.vertices, op.vertexCount);
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint.get());
     }
 
     Bounds bounds(const DrawAtlas& op) const {
@@ -482,7 +483,7 @@ private:
     }
 
     Bounds bounds(const DrawPosText& op) const {
-        const int N = op.paint.countText(op.text, op.byteLength);
+        const int N = op.paint->countText(op.text, op.byteLength);
         if (N == 0) {
             return Bounds::MakeEmpty();
         }
@@ -490,10 +491,10 @@ private:
         SkRect dst;
         dst.set(op.pos, N);
         AdjustTextForFontMetrics(&dst, op.paint);
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint.get());
     }
     Bounds bounds(const DrawPosTextH& op) const {
-        const int N = op.paint.countText(op.text, op.byteLength);
+        const int N = op.paint->countText(op.text, op.byteLength);
         if (N == 0) {
             return Bounds::MakeEmpty();
         }
@@ -505,7 +506,7 @@ private:
         }
         SkRect dst = { left, op.y, right, op.y };
         AdjustTextForFontMetrics(&dst, op.paint);
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint.get());
     }
     Bounds bounds(const DrawTextOnPath& op) const {
         SkRect dst = op.path.getBounds();
@@ -520,7 +521,7 @@ private:
         SkASSERT(pad.fRight > pad.fBottom);
         dst.outset(pad.fRight, pad.fRight);
 
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint.get());
     }
 
     Bounds bounds(const DrawTextRSXform& op) const {
@@ -534,7 +535,7 @@ private:
     Bounds bounds(const DrawTextBlob& op) const {
         SkRect dst = op.blob->bounds();
         dst.offset(op.x, op.y);
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint.get());
     }
 
     Bounds bounds(const DrawDrawable& op) const {
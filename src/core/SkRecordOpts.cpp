@@ -7,9 +7,11 @@
 
 #include "SkRecordOpts.h"
 
+#include "SkRecordDraw.h"
 #include "SkRecordPattern.h"
 #include "SkRecords.h"
 #include "SkTDArray.h"
+#include <algorithm>
 
 using namespace SkRecords;
 
@@ -194,7 +196,7 @@ struct SaveLayerDrawRestoreNooper {
 
         // A SaveLayer's bounds field is just a hint, so we should be free to ignore it.
         SkPaint* layerPaint = match->first<SaveLayer>()->paint;
-        SkPaint* drawPaint = match->second<SkPaint>();
+        const SkPaint* drawPaint = match->second<const SkPaint>();
 
         if (nullptr == layerPaint && effectively_srcover(drawPaint)) {
             // There wasn't really any point to this SaveLayer at all.
@@ -207,9 +209,12 @@ struct SaveLayerDrawRestoreNooper {
             return false;
         }
 
-        if (!fold_opacity_layer_color_to_paint(layerPaint, false /*isSaveLayer*/, drawPaint)) {
+        // The draw's paint may be shared with other draws, so we fold into a copy.
+        SkPaint folded(*drawPaint);
+        if (!fold_opacity_layer_color_to_paint(layerPaint, false /*isSaveLayer*/, &folded)) {
             return false;
         }
+        record->mutate(begin+1, SetPaint{record, folded});
 
         return KillSaveLayerAndRestore(record, begin);
     }
@@ -219,6 +224,21 @@ struct SaveLayerDrawRestoreNooper {
         record->replace<NoOp>(saveLayerIndex+2);  // Restore
         return true;
     }
+
+    // Replaces the paint of a draw that has one.
+    struct SetPaint {
+        SkRecord*      fRecord;
+        const SkPaint& fPaint;
+
+        template <typename T>
+        SK_WHEN(T::kTags & kDraw_Tag, void) operator()(T* draw) { this->set(&draw->paint); }
+        void operator()(DrawDrawable*) { SkASSERT(false); }
+        template <typename T>
+        SK_WHEN(!(T::kTags & kDraw_Tag), void) operator()(T*) { SkASSERT(false); }
+
+        void set(Optional<SkPaint>* paint) { **paint = fPaint; }
+        void set(SharedPaint* paint) { *paint = SharedPaint(fRecord->copyPaint(fPaint)); }
+    };
 };
 void SkRecordNoopSaveLayerDrawRestores(SkRecord* record) {
     SaveLayerDrawRestoreNooper pass;
@@ -282,6 +302,202 @@ void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord* record) {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Of two non-AA intersect ClipRects in a row, one inside the other, the outer one does nothing.
+// (Rounding to pixels keeps the inner rect inside the outer one.  Not so with anti-aliasing,
+// where clipping twice to the same edge multiplies its coverage.)
+struct RedundantClipRectNooper {
+    typedef Pattern<Is<ClipRect>,
+                    Greedy<Is<NoOp>>,
+                    Is<ClipRect>>
+        Match;
+
+    bool onMatch(SkRecord* record, Match* match, int begin, int end) {
+        const ClipRect* first  = match->first<ClipRect>();
+        const ClipRect* second = match->third<ClipRect>();
+        if (first->opAA.op()  != SkClipOp::kIntersect || first->opAA.aa() ||
+            second->opAA.op() != SkClipOp::kIntersect || second->opAA.aa()) {
+            return false;
+        }
+
+        if (first->rect.contains(second->rect)) {
+            record->replace<NoOp>(begin);
+            return true;
+        }
+        if (second->rect.contains(first->rect)) {
+            record->replace<NoOp>(end-1);
+            return true;
+        }
+        return false;
+    }
+};
+void SkRecordNoopRedundantClipRects(SkRecord* record) {
+    RedundantClipRectNooper pass;
+    while (apply(&pass, record));
+}
+
+// Draws that may swap places are grouped by their type and the shader and image they draw with.
+struct DrawKey {
+    bool            fMovable;
+    SkRecords::Type fType;
+    const void*     fShader;
+    const void*     fImage;
+
+    bool operator==(const DrawKey& o) const {
+        return fMovable && o.fMovable
+            && fType == o.fType && fShader == o.fShader && fImage == o.fImage;
+    }
+};
+
+struct KeyForDraw {
+    template <typename T>
+    SK_WHEN(T::kTags & kDraw_Tag, DrawKey) operator()(T* draw) {
+        IsDraw isDraw;
+        isDraw(draw);
+        const SkPaint* paint = isDraw.get();
+        return { true, T::kType, paint ? paint->getShader() : nullptr, Image(*draw) };
+    }
+
+    // Anything that isn't a draw changes state that later draws depend on, so stays put.
+    // Drawables may do the same, so we leave them alone too.
+    DrawKey operator()(DrawDrawable*) { return { false, DrawDrawable::kType, nullptr, nullptr }; }
+
+    template <typename T>
+    SK_WHEN(!(T::kTags & kDraw_Tag), DrawKey) operator()(T*) {
+        return { false, T::kType, nullptr, nullptr };
+    }
+
+    template <typename T>
+    static const void* Image(const T&) { return nullptr; }
+    static const void* Image(const DrawImage&        draw) { return draw.image.get(); }
+    static const void* Image(const DrawImageRect&    draw) { return draw.image.get(); }
+    static const void* Image(const DrawImageNine&    draw) { return draw.image.get(); }
+    static const void* Image(const DrawImageLattice& draw) { return draw.image.get(); }
+    static const void* Image(const DrawAtlas&        draw) { return draw.atlas.get(); }
+};
+
+template <typename T>
+static void move_element(T array[], int from, int to) {
+    SkASSERT(to < from);
+    std::rotate(array + to, array + from, array + from + 1);
+}
+
+void SkRecordReorderDraws(SkRecord* record, const SkRect& cullRect) {
+    // How far ahead we'll look for a draw to pull up next to a similar one.
+    static const int kLookahead = 32;
+
+    record->defrag();
+    const int count = record->count();
+
+    SkAutoTMalloc<SkRect> bounds(count);
+    SkRecordFillBounds(cullRect, *record, bounds);
+
+    // Pad each draw's bounds by a pixel so draws that only share an anti-aliased edge pixel
+    // still count as overlapping.  Draws whose pixels don't overlap can be drawn in any order.
+    SkAutoTMalloc<DrawKey> keys(count);
+    SkAutoTMalloc<SkIRect> pixels(count);
+    for (int i = 0; i < count; i++) {
+        keys[i] = record->mutate(i, KeyForDraw());
+        pixels[i] = bounds[i].isEmpty() ? SkIRect::MakeEmpty()
+                                        : bounds[i].makeOutset(1, 1).roundOut();
+    }
+
+    // Runs of consecutive draws all see the same matrix and clip.  Within each run, follow
+    // each draw with the next draw like it that can move up past the draws in between.
+    // Any other op ends the run, even the one right after draw i.
+    for (int i = 0; i + 1 < count; i++) {
+        if (!keys[i].fMovable || !keys[i+1].fMovable || keys[i+1] == keys[i]) {
+            continue;
+        }
+        const int limit = SkTMin(count, i + 1 + kLookahead);
+        for (int j = i + 2; j < limit && keys[j].fMovable; j++) {
+            if (!(keys[j] == keys[i])) {
+                continue;
+            }
+            bool blocked = false;
+            for (int k = i + 1; k < j && !blocked; k++) {
+                blocked = SkIRect::Intersects(pixels[j], pixels[k]);
+            }
+            if (!blocked) {
+                record->move(j, i+1);
+                move_element(keys.get(),   j, i+1);
+                move_element(pixels.get(), j, i+1);
+                break;
+            }
+        }
+    }
+}
+
+// Points and line segments in one DrawPoints draw independently of each other, so a run of
+// DrawPoints with the same mode and paint can draw as one, so long as nothing in the paint
+// draws the whole batch at once (image filters, loopers) or treats two points specially (dashes).
+static bool can_merge_points(const DrawPoints& draw) {
+    if (draw.mode == SkCanvas::kPolygon_PointMode) {
+        return false;
+    }
+    if (draw.mode == SkCanvas::kLines_PointMode && (draw.count & 1)) {
+        return false;  // The odd point out would pair up with the next draw's first.
+    }
+    return !draw.paint->getPathEffect()
+        && !draw.paint->getLooper()
+        && !draw.paint->getImageFilter();
+}
+
+void SkRecordMergeDrawPoints(SkRecord* record) {
+    for (int i = 0; i < record->count(); i++) {
+        Is<DrawPoints> first;
+        if (!record->mutate(i, first) || !can_merge_points(*first.get())) {
+            continue;
+        }
+        DrawPoints* merged = first.get();
+
+        size_t total = merged->count;
+        int end = i + 1;
+        for (; end < record->count(); end++) {
+            Is<NoOp> noop;
+            Is<DrawPoints> next;
+            if (record->mutate(end, noop)) {
+                continue;
+            }
+            if (!record->mutate(end, next) ||
+                next.get()->mode != merged->mode ||
+                !(*next.get()->paint == *merged->paint) ||
+                !can_merge_points(*next.get())) {
+                break;
+            }
+            total += next.get()->count;
+        }
+        if (total == merged->count) {
+            continue;
+        }
+
+        SkPoint* pts = record->alloc<SkPoint>(total);
+        memcpy(pts, merged->pts, merged->count * sizeof(SkPoint));
+        size_t n = merged->count;
+        for (int j = i + 1; j < end; j++) {
+            Is<DrawPoints> next;
+            if (record->mutate(j, next)) {
+                memcpy(pts + n, next.get()->pts, next.get()->count * sizeof(SkPoint));
+                n += next.get()->count;
+                record->replace<NoOp>(j);
+            }
+        }
+        SkASSERT(n == total);
+        merged->pts   = pts;
+        merged->count = SkToUInt(total);
+        i = end - 1;
+    }
+}
+
+void SkRecordOptimizeDrawOrder(SkRecord* record, const SkRect& cullRect) {
+    SkRecordNoopRedundantClipRects(record);
+    SkRecordReorderDraws(record, cullRect);
+    SkRecordMergeDrawPoints(record);
+
+    record->defrag();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
 void SkRecordOptimize(SkRecord* record) {
     // This might be useful  as a first pass in the future if we want to weed
     // out junk for other optimization passes.  Right now, nothing needs it,
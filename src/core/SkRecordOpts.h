@@ -24,6 +24,21 @@ void SkRecordNoopSaveLayerDrawRestores(SkRecord*);
 // the alpha of the first SaveLayer to the second SaveLayer.
 void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord*);
 
+// Turns the outer of two nested non-AA intersect ClipRects in a row into a no-op.
+void SkRecordNoopRedundantClipRects(SkRecord*);
+
+// Within runs of draws that share a matrix and clip, moves draws up next to earlier ones with the
+// same type, shader and image, as long as they don't overlap anything they move past.  Overlap is
+// judged from the bounds SkRecordFillBounds() finds, so playback at the recorded scale or larger
+// is pixel-identical.
+void SkRecordReorderDraws(SkRecord*, const SkRect& cullRect);
+
+// Merges runs of DrawPoints with the same mode and paint into one DrawPoints where that's safe.
+void SkRecordMergeDrawPoints(SkRecord*);
+
+// Optional, and more expensive than SkRecordOptimize(): runs the three passes above, in order.
+void SkRecordOptimizeDrawOrder(SkRecord*, const SkRect& cullRect);
+
 // Experimental optimizers
 void SkRecordOptimize2(SkRecord*);
 
@@ -39,12 +39,13 @@ private:
     type* fPtr;
 };
 
-// Matches any command that draws, and stores its paint.
+// Matches any command that draws, and stores its paint.  That paint may be shared with other
+// draws, so it's read-only.
 class IsDraw {
 public:
     IsDraw() : fPaint(nullptr) {}
 
-    typedef SkPaint type;
+    typedef const SkPaint type;
     type* get() { return fPaint; }
 
     template <typename T>
@@ -67,8 +68,8 @@ public:
 
 private:
     // Abstracts away whether the paint is always part of the command or optional.
-    template <typename T> static T* AsPtr(SkRecords::Optional<T>& x) { return x; }
-    template <typename T> static T* AsPtr(T& x) { return &x; }
+    static type* AsPtr(SkRecords::Optional<SkPaint>& x) { return x; }
+    static type* AsPtr(const SkRecords::SharedPaint& x) { return x.get(); }
 
     type* fPaint;
 };
@@ -63,6 +63,16 @@ void SkRecorder::forgetRecord() {
     fDrawableList.reset(nullptr);
     fApproxBytesUsedBySubPictures = 0;
     fRecord = nullptr;
+    fPaints.reset();
+}
+
+SkRecords::SharedPaint SkRecorder::share(const SkPaint& paint) {
+    if (const SkPaint** shared = fPaints.find(paint)) {
+        return SkRecords::SharedPaint(*shared);
+    }
+    const SkPaint* copy = fRecord->copyPaint(paint);
+    fPaints.set(copy);
+    return SkRecords::SharedPaint(copy);
 }
 
 // To make appending to fRecord a little less verbose.
@@ -130,40 +140,40 @@ void SkRecorder::flushMiniRecorder() {
 }
 
 void SkRecorder::onDrawPaint(const SkPaint& paint) {
-    APPEND(DrawPaint, paint);
+    APPEND(DrawPaint, this->share(paint));
 }
 
 void SkRecorder::onDrawPoints(PointMode mode,
                               size_t count,
                               const SkPoint pts[],
                               const SkPaint& paint) {
-    APPEND(DrawPoints, paint, mode, SkToUInt(count), this->copy(pts, count));
+    APPEND(DrawPoints, this->share(paint), mode, SkToUInt(count), this->copy(pts, count));
 }
 
 void SkRecorder::onDrawRect(const SkRect& rect, const SkPaint& paint) {
     TRY_MINIRECORDER(drawRect, rect, paint);
-    APPEND(DrawRect, paint, rect);
+    APPEND(DrawRect, this->share(paint), rect);
 }
 
 void SkRecorder::onDrawRegion(const SkRegion& region, const SkPaint& paint) {
-    APPEND(DrawRegion, paint, region);
+    APPEND(DrawRegion, this->share(paint), region);
 }
 
 void SkRecorder::onDrawOval(const SkRect& oval, const SkPaint& paint) {
-    APPEND(DrawOval, paint, oval);
+    APPEND(DrawOval, this->share(paint), oval);
 }
 
 void SkRecorder::onDrawArc(const SkRect& oval, SkScalar startAngle, SkScalar sweepAngle,
                            bool useCenter, const SkPaint& paint) {
-    APPEND(DrawArc, paint, oval, startAngle, sweepAngle, useCenter);
+    APPEND(DrawArc, this->share(paint), oval, startAngle, sweepAngle, useCenter);
 }
 
 void SkRecorder::onDrawRRect(const SkRRect& rrect, const SkPaint& paint) {
-    APPEND(DrawRRect, paint, rrect);
+    APPEND(DrawRRect, this->share(paint), rrect);
 }
 
 void SkRecorder::onDrawDRRect(const SkRRect& outer, const SkRRect& inner, const SkPaint& paint) {
-    APPEND(DrawDRRect, paint, outer, inner);
+    APPEND(DrawDRRect, this->share(paint), outer, inner);
 }
 
 void SkRecorder::onDrawDrawable(SkDrawable* drawable, const SkMatrix* matrix) {
@@ -181,7 +191,7 @@ void SkRecorder::onDrawDrawable(SkDrawable* drawable, const SkMatrix* matrix) {
 
 void SkRecorder::onDrawPath(const SkPath& path, const SkPaint& paint) {
     TRY_MINIRECORDER(drawPath, path, paint);
-    APPEND(DrawPath, paint, path);
+    APPEND(DrawPath, this->share(paint), path);
 }
 
 void SkRecorder::onDrawBitmap(const SkBitmap& bitmap,
@@ -249,14 +259,14 @@ void SkRecorder::onDrawImageLattice(const SkImage* image, const Lattice& lattice
 void SkRecorder::onDrawText(const void* text, size_t byteLength,
                             SkScalar x, SkScalar y, const SkPaint& paint) {
     APPEND(DrawText,
-           paint, this->copy((const char*)text, byteLength), byteLength, x, y);
+           this->share(paint), this->copy((const char*)text, byteLength), byteLength, x, y);
 }
 
 void SkRecorder::onDrawPosText(const void* text, size_t byteLength,
                                const SkPoint pos[], const SkPaint& paint) {
     const int points = paint.countText(text, byteLength);
     APPEND(DrawPosText,
-           paint,
+           this->share(paint),
            this->copy((const char*)text, byteLength),
            byteLength,
            this->copy(pos, points));
@@ -266,7 +276,7 @@ void SkRecorder::onDrawPosTextH(const void* text, size_t byteLength,
                                 const SkScalar xpos[], SkScalar constY, const SkPaint& paint) {
     const int points = paint.countText(text, byteLength);
     APPEND(DrawPosTextH,
-           paint,
+           this->share(paint),
            this->copy((const char*)text, byteLength),
            SkToUInt(byteLength),
            constY,
@@ -276,7 +286,7 @@ void SkRecorder::onDrawPosTextH(const void* text, size_t byteLength,
 void SkRecorder::onDrawTextOnPath(const void* text, size_t byteLength, const SkPath& path,
                                   const SkMatrix* matrix, const SkPaint& paint) {
     APPEND(DrawTextOnPath,
-           paint,
+           this->share(paint),
            this->copy((const char*)text, byteLength),
            byteLength,
            path,
@@ -286,7 +296,7 @@ void SkRecorder::onDrawTextOnPath(const void* text, size_t byteLength, const SkP
 void SkRecorder::onDrawTextRSXform(const void* text, size_t byteLength, const SkRSXform xform[],
                                    const SkRect* cull, const SkPaint& paint) {
     APPEND(DrawTextRSXform,
-           paint,
+           this->share(paint),
            this->copy((const char*)text, byteLength),
            byteLength,
            this->copy(xform, paint.countText(text, byteLength)),
@@ -296,7 +306,7 @@ void SkRecorder::onDrawTextRSXform(const void* text, size_t byteLength, const Sk
 void SkRecorder::onDrawTextBlob(const SkTextBlob* blob, SkScalar x, SkScalar y,
                                 const SkPaint& paint) {
     TRY_MINIRECORDER(drawTextBlob, blob, x, y, paint);
-    APPEND(DrawTextBlob, paint, sk_ref_sp(blob), x, y);
+    APPEND(DrawTextBlob, this->share(paint), sk_ref_sp(blob), x, y);
 }
 
 void SkRecorder::onDrawPicture(const SkPicture* pic, const SkMatrix* matrix, const SkPaint* paint) {
@@ -332,7 +342,7 @@ void SkRecorder::onDrawVertices(VertexMode vmode,
                                 const SkPoint texs[], const SkColor colors[],
                                 SkBlendMode bmode,
                                 const uint16_t indices[], int indexCount, const SkPaint& paint) {
-    APPEND(DrawVertices, paint,
+    APPEND(DrawVertices, this->share(paint),
                          vmode,
                          vertexCount,
                          this->copy(vertices, vertexCount),
@@ -346,7 +356,7 @@ void SkRecorder::onDrawVertices(VertexMode vmode,
 void SkRecorder::onDrawPatch(const SkPoint cubics[12], const SkColor colors[4],
                              const SkPoint texCoords[4], SkBlendMode bmode,
                              const SkPaint& paint) {
-    APPEND(DrawPatch, paint,
+    APPEND(DrawPatch, this->share(paint),
            cubics ? this->copy(cubics, SkPatchUtils::kNumCtrlPts) : nullptr,
            colors ? this->copy(colors, SkPatchUtils::kNumCorners) : nullptr,
            texCoords ? this->copy(texCoords, SkPatchUtils::kNumCorners) : nullptr,
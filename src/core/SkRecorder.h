@@ -14,6 +14,7 @@
 #include "SkRecord.h"
 #include "SkRecords.h"
 #include "SkTDArray.h"
+#include "SkTHash.h"
 
 class SkBBHFactory;
 
@@ -164,10 +165,19 @@ private:
     template <typename T>
     T* copy(const T[], size_t count);
 
+    // Returns fRecord's copy of paint, sharing it with earlier draws that used an equal paint.
+    SkRecords::SharedPaint share(const SkPaint&);
+
+    struct PaintTraits {
+        static const SkPaint& GetKey(const SkPaint* paint) { return *paint; }
+        static uint32_t Hash(const SkPaint& paint) { return paint.getHash(); }
+    };
+
     DrawPictureMode fDrawPictureMode;
     size_t fApproxBytesUsedBySubPictures;
     SkRecord* fRecord;
     std::unique_ptr<SkDrawableList> fDrawableList;
+    SkTHashTable<const SkPaint*, SkPaint, PaintTraits> fPaints;  // The paints in fRecord.
 
     SkMiniRecorder* fMiniRecorder;
 };
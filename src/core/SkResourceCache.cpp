@@ -8,11 +8,13 @@
 #include "SkMessageBus.h"
 #include "SkMipMap.h"
 #include "SkMutex.h"
+#include "SkOnce.h"
 #include "SkOpts.h"
 #include "SkPixelRef.h"
 #include "SkResourceCache.h"
 #include "SkTraceMemoryDump.h"
 
+#include <atomic>
 #include <stddef.h>
 #include <stdlib.h>
 
@@ -75,6 +77,7 @@ void SkResourceCache::init() {
     fTotalBytesUsed = 0;
     fCount = 0;
     fSingleAllocationByteLimit = 0;
+    fDiscardableCountLimit = SK_DISCARDABLEMEMORY_SCALEDIMAGECACHE_COUNT_LIMIT;
     fAllocator = nullptr;
 
     // One of these should be explicit set by the caller after we return.
@@ -309,7 +312,7 @@ void SkResourceCache::purgeAsNeeded(bool forcePurge) {
     int    countLimit;
 
     if (fDiscardableFactory) {
-        countLimit = SK_DISCARDABLEMEMORY_SCALEDIMAGECACHE_COUNT_LIMIT;
+        countLimit = fDiscardableCountLimit;
         byteLimit = SK_MaxU32;  // no limit based on bytes
     } else {
         countLimit = SK_MaxS32; // no limit based on count
@@ -550,91 +553,241 @@ void SkResourceCache::checkMessages() {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-SK_DECLARE_STATIC_MUTEX(gMutex);
-static SkResourceCache* gResourceCache = nullptr;
+#ifndef SK_RESOURCE_CACHE_SHARD_COUNT
+    #define SK_RESOURCE_CACHE_SHARD_COUNT   8
+#endif
+
+/**
+ *  The global cache splits its keys by hash across several SkResourceCaches, each guarded by its
+ *  own mutex, so threads finding and adding different keys rarely wait on each other.
+ *
+ *  The shards share one byte budget.  Each shard is allowed the whole budget on its own, and keeps
+ *  its own LRU list.  When the shards together go over budget, we purge the oldest entries of the
+ *  shard we just added to, then move on to the next shard if that wasn't enough.  We never hold
+ *  more than one shard's mutex at a time.
+ *
+ *  When backed by discardable memory we limit the count of entries instead of bytes, so each shard
+ *  just gets an even share of that limit.
+ */
+class SkResourceCache::GlobalCache {
+public:
+    static GlobalCache* Get() {
+        static SkOnce once;
+        static GlobalCache* cache;
+        once([] { cache = new GlobalCache; });
+        return cache;
+    }
+
+    bool find(const Key& key, FindVisitor visitor, void* context) {
+        AutoShard shard(this, ShardIndex(key));
+        return shard->find(key, visitor, context);
+    }
+
+    void add(Rec* rec) {
+        const int index = ShardIndex(rec->getKey());
+        {
+            AutoShard shard(this, index);
+            shard->add(rec);
+        }
+        this->purgeAsNeeded(index);
+    }
+
+    void visitAll(Visitor visitor, void* context) {
+        for (int i = 0; i < kShardCount; i++) {
+            AutoShard shard(this, i);
+            shard->visitAll(visitor, context);
+        }
+    }
+
+    void purgeAll() {
+        for (int i = 0; i < kShardCount; i++) {
+            AutoShard shard(this, i);
+            shard->purgeAll();
+        }
+    }
+
+    size_t getTotalBytesUsed() const { return fTotalBytesUsed.load(); }
+    size_t getTotalByteLimit() const { return fTotalByteLimit.load(); }
+
+    size_t setTotalByteLimit(size_t newLimit) {
+        for (int i = 0; i < kShardCount; i++) {
+            AutoShard shard(this, i);
+            shard->setTotalByteLimit(newLimit);
+        }
+        size_t prevLimit = fTotalByteLimit.exchange(newLimit);
+        if (newLimit < prevLimit) {
+            this->purgeAsNeeded(0);
+        }
+        return prevLimit;
+    }
+
+    size_t setSingleAllocationByteLimit(size_t newLimit) {
+        size_t prevLimit = 0;
+        for (int i = 0; i < kShardCount; i++) {
+            AutoShard shard(this, i);
+            prevLimit = shard->setSingleAllocationByteLimit(newLimit);
+        }
+        return prevLimit;
+    }
+
+    // Settings are the same in every shard, so the rest of these just ask the first one.
+    size_t getSingleAllocationByteLimit() {
+        AutoShard shard(this, 0);
+        return shard->getSingleAllocationByteLimit();
+    }
+    size_t getEffectiveSingleAllocationByteLimit() {
+        AutoShard shard(this, 0);
+        return shard->getEffectiveSingleAllocationByteLimit();
+    }
+    DiscardableFactory discardableFactory() {
+        AutoShard shard(this, 0);
+        return shard->discardableFactory();
+    }
+    SkBitmap::Allocator* allocator() {
+        AutoShard shard(this, 0);
+        return shard->allocator();
+    }
+    SkCachedData* newCachedData(size_t bytes) {
+        AutoShard shard(this, 0);
+        return shard->newCachedData(bytes);
+    }
+
+    void dump() {
+        for (int i = 0; i < kShardCount; i++) {
+            AutoShard shard(this, i);
+            shard->dump();
+        }
+    }
+
+private:
+    static const int kShardCount = SK_RESOURCE_CACHE_SHARD_COUNT;
+
+    struct Shard {
+        SkMutex          fMutex;
+        SkResourceCache* fCache;
+    };
+
+    // Locks a shard, and when done folds any change in its bytes used into fTotalBytesUsed.
+    class AutoShard : SkNoncopyable {
+    public:
+        AutoShard(GlobalCache* global, int index)
+            : fGlobal(global)
+            , fShard(global->fShards[index])
+            , fLock(fShard.fMutex)
+            , fBytesUsed(fShard.fCache->getTotalBytesUsed()) {}
+
+        ~AutoShard() {
+            // Unsigned wraparound makes this right even if the shard shrank.
+            fGlobal->fTotalBytesUsed += fShard.fCache->getTotalBytesUsed() - fBytesUsed;
+        }
 
-/** Must hold gMutex when calling. */
-static SkResourceCache* get_cache() {
-    // gMutex is always held when this is called, so we don't need to be fancy in here.
-    gMutex.assertHeld();
-    if (nullptr == gResourceCache) {
+        SkResourceCache* operator->() const { return fShard.fCache; }
+
+    private:
+        GlobalCache*        fGlobal;
+        Shard&              fShard;
+        SkAutoMutexAcquire  fLock;
+        size_t              fBytesUsed;
+    };
+
+    GlobalCache() : fTotalBytesUsed(0) {
+        for (Shard& shard : fShards) {
 #ifdef SK_USE_DISCARDABLE_SCALEDIMAGECACHE
-        gResourceCache = new SkResourceCache(SkDiscardableMemory::Create);
+            shard.fCache = new SkResourceCache(SkDiscardableMemory::Create);
+            shard.fCache->fDiscardableCountLimit =
+                    SkTMax(1, SK_DISCARDABLEMEMORY_SCALEDIMAGECACHE_COUNT_LIMIT / kShardCount);
 #else
-        gResourceCache = new SkResourceCache(SK_DEFAULT_IMAGE_CACHE_LIMIT);
+            shard.fCache = new SkResourceCache(SK_DEFAULT_IMAGE_CACHE_LIMIT);
 #endif
+        }
+        fDiscardable = fShards[0].fCache->discardableFactory() != nullptr;
+        fTotalByteLimit = fShards[0].fCache->getTotalByteLimit();
     }
-    return gResourceCache;
-}
+
+    static int ShardIndex(const Key& key) {
+        // Use the top bits of the hash to pick a shard.  Each shard's hash table uses the bottom.
+        return SkToInt(((uint64_t)key.hash() * kShardCount) >> 32);
+    }
+
+    void purgeAsNeeded(int firstShard) {
+        if (fDiscardable) {
+            return;     // Each shard already limits its own count.
+        }
+        for (int i = 0; i < kShardCount; i++) {
+            const size_t used  = fTotalBytesUsed.load(),
+                         limit = fTotalByteLimit.load();
+            if (used < limit) {
+                return;
+            }
+            AutoShard shard(this, (firstShard + i) % kShardCount);
+            size_t bytesToFree = used - limit + 1;
+            while (shard->fTail && bytesToFree > 0) {
+                bytesToFree -= SkTMin(bytesToFree, shard->fTail->bytesUsed());
+                shard->remove(shard->fTail);
+            }
+        }
+    }
+
+    Shard               fShards[kShardCount];
+    std::atomic<size_t> fTotalBytesUsed;
+    std::atomic<size_t> fTotalByteLimit;
+    bool                fDiscardable;
+};
 
 size_t SkResourceCache::GetTotalBytesUsed() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->getTotalBytesUsed();
+    return GlobalCache::Get()->getTotalBytesUsed();
 }
 
 size_t SkResourceCache::GetTotalByteLimit() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->getTotalByteLimit();
+    return GlobalCache::Get()->getTotalByteLimit();
 }
 
 size_t SkResourceCache::SetTotalByteLimit(size_t newLimit) {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->setTotalByteLimit(newLimit);
+    return GlobalCache::Get()->setTotalByteLimit(newLimit);
 }
 
 SkResourceCache::DiscardableFactory SkResourceCache::GetDiscardableFactory() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->discardableFactory();
+    return GlobalCache::Get()->discardableFactory();
 }
 
 SkBitmap::Allocator* SkResourceCache::GetAllocator() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->allocator();
+    return GlobalCache::Get()->allocator();
 }
 
 SkCachedData* SkResourceCache::NewCachedData(size_t bytes) {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->newCachedData(bytes);
+    return GlobalCache::Get()->newCachedData(bytes);
 }
 
 void SkResourceCache::Dump() {
-    SkAutoMutexAcquire am(gMutex);
-    get_cache()->dump();
+    GlobalCache::Get()->dump();
 }
 
 size_t SkResourceCache::SetSingleAllocationByteLimit(size_t size) {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->setSingleAllocationByteLimit(size);
+    return GlobalCache::Get()->setSingleAllocationByteLimit(size);
 }
 
 size_t SkResourceCache::GetSingleAllocationByteLimit() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->getSingleAllocationByteLimit();
+    return GlobalCache::Get()->getSingleAllocationByteLimit();
 }
 
 size_t SkResourceCache::GetEffectiveSingleAllocationByteLimit() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->getEffectiveSingleAllocationByteLimit();
+    return GlobalCache::Get()->getEffectiveSingleAllocationByteLimit();
 }
 
 void SkResourceCache::PurgeAll() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->purgeAll();
+    GlobalCache::Get()->purgeAll();
 }
 
 bool SkResourceCache::Find(const Key& key, FindVisitor visitor, void* context) {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->find(key, visitor, context);
+    return GlobalCache::Get()->find(key, visitor, context);
 }
 
 void SkResourceCache::Add(Rec* rec) {
-    SkAutoMutexAcquire am(gMutex);
-    get_cache()->add(rec);
+    GlobalCache::Get()->add(rec);
 }
 
 void SkResourceCache::VisitAll(Visitor visitor, void* context) {
-    SkAutoMutexAcquire am(gMutex);
-    get_cache()->visitAll(visitor, context);
+    GlobalCache::Get()->visitAll(visitor, context);
 }
 
 void SkResourceCache::PostPurgeSharedID(uint64_t sharedID) {
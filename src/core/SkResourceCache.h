@@ -25,6 +25,8 @@ class SkTraceMemoryDump;
  *
  *  As a convenience, a global instance is also defined, which can be safely
  *  access across threads via the static methods (e.g. FindAndLock, etc.).
+ *  To keep threads from contending, the global instance is split by key hash
+ *  into several shards, each with its own lock and LRU list, sharing one budget.
  */
 class SkResourceCache {
 public:
@@ -263,6 +265,10 @@ private:
     size_t  fTotalByteLimit;
     size_t  fSingleAllocationByteLimit;
     int     fCount;
+    int     fDiscardableCountLimit;
+
+    // The sharded global instance behind the static methods.
+    class GlobalCache;
 
     SkMessageBus<PurgeSharedIDMessage>::Inbox fPurgeSharedIDInbox;
 
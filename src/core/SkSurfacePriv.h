@@ -8,8 +8,12 @@
 #ifndef SkSurfacePriv_DEFINED
 #define SkSurfacePriv_DEFINED
 
+#include "SkRefCnt.h"
 #include "SkSurfaceProps.h"
 
+class SkSurface;
+struct SkImageInfo;
+
 static inline SkSurfaceProps SkSurfacePropsCopyOrDefault(const SkSurfaceProps* props) {
     if (props) {
         return *props;
@@ -22,4 +26,12 @@ static inline SkPixelGeometry SkSurfacePropsDefaultPixelGeometry() {
     return SkSurfaceProps(SkSurfaceProps::kLegacyFontHost_InitType).pixelGeometry();
 }
 
+/**
+ *  Like SkSurface::MakeRaster(), but the surface's canvas records its draws and rasterizes them
+ *  in parallel on SkTaskGroup, split into tileCount horizontal tiles (see SkThreadedBMPDevice).
+ *  Pass tileCount <= 0 to have the device pick one from the height. Output matches MakeRaster().
+ */
+sk_sp<SkSurface> SkMakeThreadedRasterSurface(const SkImageInfo&, int tileCount,
+                                             const SkSurfaceProps* = nullptr);
+
 #endif
@@ -0,0 +1,320 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkThreadedBMPDevice.h"
+
+#include "SkData.h"
+#include "SkDraw.h"
+#include "SkPath.h"
+#include "SkRRect.h"
+#include "SkSpecialImage.h"
+#include "SkSurface.h"
+#include "SkSurfacePriv.h"
+#include "SkTaskGroup.h"
+
+// Rows per tile when the caller lets us choose the tile count.
+static const int kDefaultTileHeight = 128;
+
+// Bounds the memory held by copied paints, paths and pixels between flushes.
+static const int kMaxQueuedDraws = 4096;
+
+static int default_tile_count(int height) {
+    return SkTMax(1, (height + kDefaultTileHeight - 1) / kDefaultTileHeight);
+}
+
+// Draws are deferred, so we must not keep a reference to pixels the caller may change later.
+static SkBitmap snap_bitmap(const SkBitmap& bitmap) {
+    if (bitmap.isImmutable() || !bitmap.getPixels()) {
+        return bitmap;
+    }
+    SkBitmap copy;
+    if (!bitmap.copyTo(&copy)) {
+        return bitmap;
+    }
+    copy.setImmutable();
+    return copy;
+}
+
+static sk_sp<SkData> copy_or_null(const void* src, size_t size) {
+    return src ? SkData::MakeWithCopy(src, size) : nullptr;
+}
+
+template <typename T>
+static const T* data_or_null(const sk_sp<SkData>& data) {
+    return data ? static_cast<const T*>(data->data()) : nullptr;
+}
+
+SkThreadedBMPDevice::SkThreadedBMPDevice(const SkBitmap& bitmap,
+                                         const SkSurfaceProps& surfaceProps,
+                                         int tileCount)
+    : INHERITED(bitmap, surfaceProps)
+    , fBitmap(bitmap)
+    , fDevice(new SkBitmapDevice(bitmap, surfaceProps))
+{
+    fBitmap.lockPixels();
+    const int height = SkTMax(1, bitmap.height());
+    fTileCount = SkTPin(tileCount > 0 ? tileCount : default_tile_count(height), 1, height);
+    fTileHeight = (height + fTileCount - 1) / fTileCount;
+    fTileCount = (height + fTileHeight - 1) / fTileHeight;
+}
+
+SkThreadedBMPDevice::~SkThreadedBMPDevice() {
+    this->flush();
+}
+
+SkIRect SkThreadedBMPDevice::tileBounds(int tileIndex) const {
+    return SkIRect::MakeLTRB(0, tileIndex * fTileHeight,
+                             fBitmap.width(), SkTMin((tileIndex + 1) * fTileHeight,
+                                                     fBitmap.height()));
+}
+
+void SkThreadedBMPDevice::recordDraw(const SkDraw& draw, const SkRect* localBounds,
+                                     const SkPaint* paint, DrawFn&& fn) {
+    SkIRect devBounds = draw.fRC->getBounds();
+    if (localBounds && (!paint || paint->canComputeFastBounds())) {
+        SkRect storage;
+        const SkRect& fastBounds = paint ? paint->computeFastBounds(*localBounds, &storage)
+                                         : *localBounds;
+        SkRect mapped;
+        draw.fMatrix->mapRect(&mapped, fastBounds);
+        // Outset by a pixel to cover antialiasing and hairlines.
+        devBounds = mapped.roundOut().makeOutset(1, 1);
+    }
+    this->recordDraw(draw, devBounds, std::move(fn));
+}
+
+void SkThreadedBMPDevice::recordDraw(const SkDraw& draw, const SkIRect& devBounds, DrawFn&& fn) {
+    SkIRect bounds = draw.fRC->getBounds();
+    if (!bounds.intersect(devBounds)) {
+        return;
+    }
+
+    DrawElement& element = fQueue.push_back();
+    element.fMatrix = *draw.fMatrix;
+    element.fRC     = *draw.fRC;
+    element.fBounds = bounds;
+    element.fDrawFn = std::move(fn);
+
+    if (fQueue.count() >= kMaxQueuedDraws) {
+        this->flush();
+    }
+}
+
+void SkThreadedBMPDevice::drawTile(int tileIndex) {
+    const SkIRect tile = this->tileBounds(tileIndex);
+
+    SkPixmap dst;
+    SkAssertResult(fBitmap.peekPixels(&dst));
+
+    for (const DrawElement& element : fQueue) {
+        if (!SkIRect::Intersects(element.fBounds, tile)) {
+            continue;
+        }
+        // Rasterize against the full clip and only restrict the writes to the tile:
+        // intersecting the clip with the tile would change antialiasing and mask filters.
+        SkDraw draw;
+        draw.fDst        = dst;
+        draw.fMatrix     = &element.fMatrix;
+        draw.fRC         = &element.fRC;
+        draw.fClipStack  = nullptr;
+        draw.fDevice     = fDevice.get();
+        draw.fBlitBounds = &tile;
+        element.fDrawFn(fDevice.get(), draw);
+    }
+}
+
+void SkThreadedBMPDevice::flush() {
+    if (fQueue.empty()) {
+        return;
+    }
+    if (fBitmap.getPixels()) {
+        SkTaskGroup().batch(fTileCount, [this](int i) { this->drawTile(i); });
+        fBitmap.notifyPixelsChanged();
+    }
+    fQueue.reset();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SkThreadedBMPDevice::drawPaint(const SkDraw& draw, const SkPaint& paint) {
+    this->recordDraw(draw, nullptr, nullptr, [=](SkBitmapDevice* device, const SkDraw& d) {
+        device->drawPaint(d, paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawPoints(const SkDraw& draw, SkCanvas::PointMode mode, size_t count,
+                                     const SkPoint pts[], const SkPaint& paint) {
+    // Points are always stroked, whatever the paint's style, so outset for that here.
+    SkRect bounds, storage;
+    bounds.set(pts, SkToInt(count));
+    const SkRect* strokeBounds = paint.canComputeFastBounds()
+                               ? &paint.computeFastStrokeBounds(bounds, &storage) : nullptr;
+    sk_sp<SkData> points = SkData::MakeWithCopy(pts, count * sizeof(SkPoint));
+    this->recordDraw(draw, strokeBounds, nullptr, [=](SkBitmapDevice* device, const SkDraw& d) {
+        device->drawPoints(d, mode, count, data_or_null<SkPoint>(points), paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawRect(const SkDraw& draw, const SkRect& r, const SkPaint& paint) {
+    this->recordDraw(draw, &r, &paint, [=](SkBitmapDevice* device, const SkDraw& d) {
+        device->drawRect(d, r, paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawOval(const SkDraw& draw, const SkRect& oval, const SkPaint& paint) {
+    this->recordDraw(draw, &oval, &paint, [=](SkBitmapDevice* device, const SkDraw& d) {
+        device->drawOval(d, oval, paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawRRect(const SkDraw& draw, const SkRRect& rrect,
+                                    const SkPaint& paint) {
+    this->recordDraw(draw, &rrect.getBounds(), &paint,
+                     [=](SkBitmapDevice* device, const SkDraw& d) {
+        device->drawRRect(d, rrect, paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawPath(const SkDraw& draw, const SkPath& path, const SkPaint& paint,
+                                   const SkMatrix* prePathMatrix, bool) {
+    // The path is shared by every tile, so it must not be modified in place.
+    const SkRect* bounds = path.isInverseFillType() || prePathMatrix ? nullptr
+                                                                     : &path.getBounds();
+    const bool hasPreMatrix = prePathMatrix != nullptr;
+    const SkMatrix preMatrix = hasPreMatrix ? *prePathMatrix : SkMatrix::I();
+    this->recordDraw(draw, bounds, &paint, [=](SkBitmapDevice* device, const SkDraw& d) {
+        device->drawPath(d, path, paint, hasPreMatrix ? &preMatrix : nullptr, false);
+    });
+}
+
+void SkThreadedBMPDevice::drawBitmap(const SkDraw& draw, const SkBitmap& bitmap,
+                                     const SkMatrix& matrix, const SkPaint& paint) {
+    SkRect bounds;
+    matrix.mapRect(&bounds, SkRect::Make(bitmap.bounds()));
+    const SkBitmap snap = snap_bitmap(bitmap);
+    this->recordDraw(draw, &bounds, &paint, [=](SkBitmapDevice* device, const SkDraw& d) {
+        device->drawBitmap(d, snap, matrix, paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawSprite(const SkDraw& draw, const SkBitmap& bitmap,
+                                     int x, int y, const SkPaint& paint) {
+    // Sprites ignore the matrix, so their bounds are already in device space.
+    const SkIRect bounds = SkIRect::MakeXYWH(x, y, bitmap.width(), bitmap.height());
+    const SkBitmap snap = snap_bitmap(bitmap);
+    this->recordDraw(draw, bounds, [=](SkBitmapDevice* device, const SkDraw& d) {
+        device->drawSprite(d, snap, x, y, paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawBitmapRect(const SkDraw& draw, const SkBitmap& bitmap,
+                                         const SkRect* src, const SkRect& dst,
+                                         const SkPaint& paint,
+                                         SkCanvas::SrcRectConstraint constraint) {
+    const bool hasSrc = src != nullptr;
+    const SkRect srcRect = hasSrc ? *src : SkRect::MakeEmpty();
+    const SkBitmap snap = snap_bitmap(bitmap);
+    this->recordDraw(draw, &dst, &paint, [=](SkBitmapDevice* device, const SkDraw& d) {
+        device->drawBitmapRect(d, snap, hasSrc ? &srcRect : nullptr, dst, paint, constraint);
+    });
+}
+
+void SkThreadedBMPDevice::drawText(const SkDraw& draw, const void* text, size_t len,
+                                   SkScalar x, SkScalar y, const SkPaint& paint) {
+    sk_sp<SkData> bytes = SkData::MakeWithCopy(text, len);
+    this->recordDraw(draw, nullptr, nullptr, [=](SkBitmapDevice* device, const SkDraw& d) {
+        device->drawText(d, bytes->data(), len, x, y, paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawPosText(const SkDraw& draw, const void* text, size_t len,
+                                      const SkScalar pos[], int scalarsPerPos,
+                                      const SkPoint& offset, const SkPaint& paint) {
+    sk_sp<SkData> bytes = SkData::MakeWithCopy(text, len);
+    const int glyphCount = paint.countText(text, len);
+    sk_sp<SkData> positions = SkData::MakeWithCopy(pos,
+                                                   glyphCount * scalarsPerPos * sizeof(SkScalar));
+    this->recordDraw(draw, nullptr, nullptr, [=](SkBitmapDevice* device, const SkDraw& d) {
+        device->drawPosText(d, bytes->data(), len, data_or_null<SkScalar>(positions),
+                            scalarsPerPos, offset, paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawVertices(const SkDraw& draw, SkCanvas::VertexMode vmode,
+                                       int vertexCount, const SkPoint verts[],
+                                       const SkPoint texs[], const SkColor colors[],
+                                       SkBlendMode bmode, const uint16_t indices[],
+                                       int indexCount, const SkPaint& paint) {
+    SkRect bounds;
+    bounds.set(verts, vertexCount);
+    sk_sp<SkData> vertData  = copy_or_null(verts,   vertexCount * sizeof(SkPoint));
+    sk_sp<SkData> texData   = copy_or_null(texs,    vertexCount * sizeof(SkPoint));
+    sk_sp<SkData> colorData = copy_or_null(colors,  vertexCount * sizeof(SkColor));
+    sk_sp<SkData> indexData = copy_or_null(indices, indexCount  * sizeof(uint16_t));
+    this->recordDraw(draw, &bounds, &paint, [=](SkBitmapDevice* device, const SkDraw& d) {
+        device->drawVertices(d, vmode, vertexCount, data_or_null<SkPoint>(vertData),
+                             data_or_null<SkPoint>(texData), data_or_null<SkColor>(colorData),
+                             bmode, data_or_null<uint16_t>(indexData), indexCount, paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawDevice(const SkDraw& draw, SkBaseDevice* device,
+                                     int x, int y, const SkPaint& paint) {
+    SkASSERT(!paint.getImageFilter());
+    // Layers are only drawn back once, as they are restored.  drawSprite() copies the layer's
+    // pixels for the deferred draw, so the layer may go away before the tiles are drawn.
+    this->drawSprite(draw, static_cast<SkBitmapDevice*>(device)->fBitmap, x, y, paint);
+}
+
+void SkThreadedBMPDevice::drawSpecial(const SkDraw& draw, SkSpecialImage* srcImg, int x, int y,
+                                      const SkPaint& paint) {
+    // Image filters run right here on the calling thread, and may read from this device.
+    this->flush();
+    INHERITED::drawSpecial(draw, srcImg, x, y, paint);
+}
+
+sk_sp<SkSpecialImage> SkThreadedBMPDevice::snapSpecial() {
+    this->flush();
+    return INHERITED::snapSpecial();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool SkThreadedBMPDevice::onReadPixels(const SkImageInfo& dstInfo, void* dstPixels,
+                                       size_t dstRowBytes, int x, int y) {
+    this->flush();
+    return INHERITED::onReadPixels(dstInfo, dstPixels, dstRowBytes, x, y);
+}
+
+bool SkThreadedBMPDevice::onWritePixels(const SkImageInfo& srcInfo, const void* srcPixels,
+                                        size_t srcRowBytes, int x, int y) {
+    this->flush();
+    return INHERITED::onWritePixels(srcInfo, srcPixels, srcRowBytes, x, y);
+}
+
+bool SkThreadedBMPDevice::onPeekPixels(SkPixmap* pmap) {
+    this->flush();
+    return INHERITED::onPeekPixels(pmap);
+}
+
+bool SkThreadedBMPDevice::onAccessPixels(SkPixmap* pmap) {
+    this->flush();
+    return INHERITED::onAccessPixels(pmap);
+}
+
+void SkThreadedBMPDevice::replaceBitmapBackendForRasterSurface(const SkBitmap& bm) {
+    this->flush();
+    INHERITED::replaceBitmapBackendForRasterSurface(bm);
+    fBitmap = bm;
+    fBitmap.lockPixels();
+    fDevice.reset(new SkBitmapDevice(bm, this->surfaceProps()));
+}
+
+sk_sp<SkSurface> SkThreadedBMPDevice::makeSurface(const SkImageInfo& info,
+                                                  const SkSurfaceProps& props) {
+    return SkMakeThreadedRasterSurface(info, 0, &props);
+}
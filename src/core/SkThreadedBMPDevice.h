@@ -0,0 +1,100 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkThreadedBMPDevice_DEFINED
+#define SkThreadedBMPDevice_DEFINED
+
+#include "SkBitmapDevice.h"
+#include "SkMatrix.h"
+#include "SkRasterClip.h"
+#include "SkTArray.h"
+
+#include <functional>
+
+/**
+ *  A raster device that defers its draws and rasterizes them in parallel.
+ *
+ *  The device is split into horizontal tiles.  Each draw is recorded along with a snapshot of
+ *  its matrix and clip, and the device-space bounds it may touch.  On flush(), every tile
+ *  replays, in order, the draws that intersect it on SkTaskGroup, with SkDraw::fBlitBounds
+ *  limiting its writes to that tile.  Since each pixel is still produced by the same SkDraw
+ *  code with the same inputs, the results match SkBitmapDevice exactly.
+ *
+ *  Anything that reads the pixels (readPixels, peekPixels, snapshots, ...) flushes first.
+ *  Layers created by saveLayer() are plain SkBitmapDevices.
+ */
+class SkThreadedBMPDevice : public SkBitmapDevice {
+public:
+    // Pass tileCount <= 0 to pick a tile count from the height of the bitmap.
+    SkThreadedBMPDevice(const SkBitmap& bitmap, const SkSurfaceProps& surfaceProps,
+                        int tileCount = 0);
+    ~SkThreadedBMPDevice() override;
+
+    int tileCount() const { return fTileCount; }
+
+protected:
+    void drawPaint(const SkDraw&, const SkPaint& paint) override;
+    void drawPoints(const SkDraw&, SkCanvas::PointMode mode, size_t count,
+                    const SkPoint[], const SkPaint& paint) override;
+    void drawRect(const SkDraw&, const SkRect& r, const SkPaint& paint) override;
+    void drawOval(const SkDraw&, const SkRect& oval, const SkPaint& paint) override;
+    void drawRRect(const SkDraw&, const SkRRect& rr, const SkPaint& paint) override;
+    void drawPath(const SkDraw&, const SkPath&, const SkPaint&, const SkMatrix* prePathMatrix,
+                  bool pathIsMutable) override;
+    void drawBitmap(const SkDraw&, const SkBitmap&, const SkMatrix&, const SkPaint&) override;
+    void drawSprite(const SkDraw&, const SkBitmap&, int x, int y, const SkPaint&) override;
+    void drawBitmapRect(const SkDraw&, const SkBitmap&, const SkRect*, const SkRect&,
+                        const SkPaint&, SkCanvas::SrcRectConstraint) override;
+    void drawText(const SkDraw&, const void* text, size_t len, SkScalar x, SkScalar y,
+                  const SkPaint&) override;
+    void drawPosText(const SkDraw&, const void* text, size_t len, const SkScalar pos[],
+                     int scalarsPerPos, const SkPoint& offset, const SkPaint& paint) override;
+    void drawVertices(const SkDraw&, SkCanvas::VertexMode, int vertexCount, const SkPoint verts[],
+                      const SkPoint texs[], const SkColor colors[], SkBlendMode,
+                      const uint16_t indices[], int indexCount, const SkPaint&) override;
+    void drawDevice(const SkDraw&, SkBaseDevice*, int x, int y, const SkPaint&) override;
+    void drawSpecial(const SkDraw&, SkSpecialImage*, int x, int y, const SkPaint&) override;
+
+    sk_sp<SkSpecialImage> snapSpecial() override;
+
+    bool onReadPixels(const SkImageInfo&, void*, size_t, int x, int y) override;
+    bool onWritePixels(const SkImageInfo&, const void*, size_t, int, int) override;
+    bool onPeekPixels(SkPixmap*) override;
+    bool onAccessPixels(SkPixmap*) override;
+
+private:
+    // Replays one recorded draw through the wrapped SkBitmapDevice.
+    typedef std::function<void(SkBitmapDevice*, const SkDraw&)> DrawFn;
+
+    struct DrawElement {
+        SkMatrix     fMatrix;
+        SkRasterClip fRC;
+        SkIRect      fBounds;   // device-space pixels this draw may touch
+        DrawFn       fDrawFn;
+    };
+
+    void flush() override;
+    void replaceBitmapBackendForRasterSurface(const SkBitmap&) override;
+    sk_sp<SkSurface> makeSurface(const SkImageInfo&, const SkSurfaceProps&) override;
+
+    // Queues fn to run on every tile the draw may touch.  Without localBounds (or when the
+    // paint's effects make them unknowable) the whole clip is assumed.
+    void recordDraw(const SkDraw&, const SkRect* localBounds, const SkPaint*, DrawFn&& fn);
+    void recordDraw(const SkDraw&, const SkIRect& devBounds, DrawFn&& fn);
+    void drawTile(int tileIndex);
+    SkIRect tileBounds(int tileIndex) const;
+
+    SkBitmap                    fBitmap;
+    std::unique_ptr<SkBitmapDevice> fDevice;  // does the actual drawing on each tile
+    int                         fTileCount;
+    int                         fTileHeight;
+    SkTArray<DrawElement>       fQueue;
+
+    typedef SkBitmapDevice INHERITED;
+};
+
+#endif // SkThreadedBMPDevice_DEFINED
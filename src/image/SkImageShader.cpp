@@ -272,7 +272,7 @@ bool SkImageShader::onAppendStages(SkRasterPipeline* p, SkColorSpace* dst, SkAre
     auto ctx = scratch->make<SkImageShaderContext>();
     ctx->state   = std::move(state);  // Extend lifetime to match the pipeline's.
     ctx->pixels  = pm.addr();
-    ctx->ctable  = pm.ctable();
+    ctx->ctable  = pm.ctable() ? pm.ctable()->readColors() : nullptr;
     ctx->color4f = SkColor4f_from_SkColor(paint.getColor(), dst);
     ctx->stride  = pm.rowBytesAsPixels();
     ctx->width   = (float)pm.width();
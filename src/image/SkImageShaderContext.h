@@ -19,19 +19,19 @@
 struct SkImageShaderContext {
     std::unique_ptr<SkBitmapController::State> state;
 
-    const void*   pixels;
-    SkColorTable* ctable;
-    SkColor4f     color4f;
-    int           stride;
-    float         width;
-    float         height;
-    float         matrix[9];
-    float         x[8];
-    float         y[8];
-    float         fx[8];
-    float         fy[8];
-    float         scalex[8];
-    float         scaley[8];
+    const void*      pixels;
+    const SkPMColor* ctable;
+    SkColor4f        color4f;
+    int              stride;
+    float            width;
+    float            height;
+    float            matrix[9];
+    float            x[16];
+    float            y[16];
+    float            fx[16];
+    float            fy[16];
+    float            scalex[16];
+    float            scaley[16];
 };
 
 #endif//SkImageShaderContext_DEFINED
@@ -10,6 +10,8 @@
 #include "SkCanvas.h"
 #include "SkDevice.h"
 #include "SkMallocPixelRef.h"
+#include "SkSurfacePriv.h"
+#include "SkThreadedBMPDevice.h"
 
 static const size_t kIgnoreRowBytesValue = (size_t)~0;
 
@@ -22,6 +24,12 @@ public:
                      const SkSurfaceProps*);
     SkSurface_Raster(sk_sp<SkPixelRef>, const SkSurfaceProps*);
 
+    // Draw through an SkThreadedBMPDevice split into tileCount tiles (<= 0 lets it choose).
+    void setThreaded(int tileCount) {
+        fThreaded = true;
+        fTileCount = tileCount;
+    }
+
     SkCanvas* onNewCanvas() override;
     sk_sp<SkSurface> onNewSurface(const SkImageInfo&) override;
     sk_sp<SkImage> onNewImageSnapshot(SkBudgeted) override;
@@ -30,9 +38,18 @@ public:
     void onRestoreBackingMutability() override;
 
 private:
+    // Threaded canvases defer their draws; call this before touching fBitmap directly.
+    void flushPendingDraws() {
+        if (fThreaded) {
+            this->getCachedCanvas()->flush();
+        }
+    }
+
     SkBitmap    fBitmap;
     size_t      fRowBytes;
     bool        fWeOwnThePixels;
+    bool        fThreaded = false;
+    int         fTileCount = 0;
 
     typedef SkSurface_Base INHERITED;
 };
@@ -119,18 +136,30 @@ SkSurface_Raster::SkSurface_Raster(sk_sp<SkPixelRef> pr, const SkSurfaceProps* p
     fWeOwnThePixels = true;
 }
 
-SkCanvas* SkSurface_Raster::onNewCanvas() { return new SkCanvas(fBitmap, this->props()); }
+SkCanvas* SkSurface_Raster::onNewCanvas() {
+    if (fThreaded) {
+        sk_sp<SkBaseDevice> device(new SkThreadedBMPDevice(fBitmap, this->props(), fTileCount));
+        return new SkCanvas(device.get());
+    }
+    return new SkCanvas(fBitmap, this->props());
+}
 
 sk_sp<SkSurface> SkSurface_Raster::onNewSurface(const SkImageInfo& info) {
+    if (fThreaded) {
+        return SkMakeThreadedRasterSurface(info, fTileCount, &this->props());
+    }
     return SkSurface::MakeRaster(info, &this->props());
 }
 
 void SkSurface_Raster::onDraw(SkCanvas* canvas, SkScalar x, SkScalar y,
                               const SkPaint* paint) {
+    this->flushPendingDraws();
     canvas->drawBitmap(fBitmap, x, y, paint);
 }
 
 sk_sp<SkImage> SkSurface_Raster::onNewImageSnapshot(SkBudgeted) {
+    this->flushPendingDraws();
+
     SkCopyPixelsMode cpm = kIfMutable_SkCopyPixelsMode;
     if (fWeOwnThePixels) {
         // SkImage_raster requires these pixels are immutable for its full lifetime.
@@ -218,3 +247,18 @@ sk_sp<SkSurface> SkSurface::MakeRaster(const SkImageInfo& info, size_t rowBytes,
     }
     return sk_make_sp<SkSurface_Raster>(std::move(pr), props);
 }
+
+sk_sp<SkSurface> SkMakeThreadedRasterSurface(const SkImageInfo& info, int tileCount,
+                                             const SkSurfaceProps* props) {
+    if (!SkSurface_Raster::Valid(info)) {
+        return nullptr;
+    }
+
+    sk_sp<SkPixelRef> pr(SkMallocPixelRef::NewZeroed(info, 0, nullptr));
+    if (!pr) {
+        return nullptr;
+    }
+    sk_sp<SkSurface_Raster> surface = sk_make_sp<SkSurface_Raster>(std::move(pr), props);
+    surface->setThreaded(tileCount);
+    return surface;
+}
@@ -20,6 +20,11 @@ struct SkEncodeOptions {
     };
 
     PremulBehavior fPremulBehavior = PremulBehavior::kLegacy;
+
+    // PNG only.  Filter and compress bands of rows in parallel on SkTaskGroup.  The result is a
+    // valid png that decodes to the same pixels, but it will not be byte-for-byte identical to a
+    // serial encode, and it may be slightly larger.
+    bool fParallel = false;
 };
 
 #ifdef SK_HAS_JPEG_LIBRARY
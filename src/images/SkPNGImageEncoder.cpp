@@ -13,13 +13,16 @@
 #include "SkColorPriv.h"
 #include "SkDither.h"
 #include "SkMath.h"
+#include "SkOpts.h"
 #include "SkStream.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 #include "SkUnPreMultiply.h"
 #include "SkUtils.h"
 #include "transform_scanline.h"
 
 #include "png.h"
+#include "zlib.h"
 
 // Suppress most PNG warnings when calling image decode functions.
 static const bool c_suppressPNGImageDecoderWarnings = true;
@@ -161,7 +164,7 @@ static inline int pack_palette(SkColorTable* ctable, png_color* SK_RESTRICT pale
     return numWithAlpha;
 }
 
-static bool do_encode(SkWStream*, const SkPixmap&, int, int, png_color_8&);
+static bool do_encode(SkWStream*, const SkPixmap&, int, int, png_color_8&, const SkEncodeOptions&);
 
 bool SkEncodeImageAsPNG(SkWStream* stream, const SkPixmap& src, const SkEncodeOptions& opts) {
     SkASSERT(!src.colorSpace() || src.colorSpace()->gammaCloseToSRGB() ||
@@ -263,7 +266,7 @@ bool SkEncodeImageAsPNG(SkWStream* stream, const SkPixmap& src, const SkEncodeOp
         // or 4 bit indices.
     }
 
-    return do_encode(stream, pixmap, pngColorType, bitDepth, sig_bit);
+    return do_encode(stream, pixmap, pngColorType, bitDepth, sig_bit, opts);
 }
 
 static int num_components(int pngColorType) {
@@ -281,8 +284,181 @@ static int num_components(int pngColorType) {
     }
 }
 
+// Parallel encodes split the image into bands of about this many bytes.
+static constexpr size_t kParallelBandBytes = 128 * 1024;
+
+struct PngBand {
+    int                    fTop;
+    int                    fBottom;
+    // Each row's filter type, followed by the filtered row.
+    SkAutoTMalloc<uint8_t> fFiltered;
+    size_t                 fFilteredSize;
+    uLong                  fAdler;
+    SkAutoTMalloc<uint8_t> fCompressed;
+    size_t                 fCompressedSize;
+    bool                   fSucceeded;
+};
+
+static void filter_band(PngBand* band, const SkPixmap& pixmap, transform_scanline_proc proc,
+                        int transformBytesPerPixel, int pngBytesPerPixel, bool useFilters) {
+    const int width = pixmap.width();
+    const size_t rowBytes = width * pngBytesPerPixel;
+    const int srcBytesPerPixel = SkColorTypeBytesPerPixel(pixmap.colorType());
+
+    // Rows are filtered against the unfiltered row above them, so we keep the last two around.
+    SkAutoTMalloc<uint8_t> storage(2 * width * transformBytesPerPixel + 2 * rowBytes);
+    uint8_t* curr = storage.get();
+    uint8_t* prev = curr + width * transformBytesPerPixel;
+    uint8_t* best = prev + width * transformBytesPerPixel;
+    uint8_t* trial = best + rowBytes;
+
+    auto transform = [&](uint8_t* dst, int y) {
+        proc((char*) dst, (const char*) pixmap.addr(0, y), width, srcBytesPerPixel, nullptr);
+        if (transformBytesPerPixel != pngBytesPerPixel) {
+            // Drop the filler (the opaque alpha of F16) that libpng would strip for us.
+            for (int x = 0; x < width; x++) {
+                memmove(dst + x * pngBytesPerPixel, dst + x * transformBytesPerPixel,
+                        pngBytesPerPixel);
+            }
+        }
+    };
+
+    if (band->fTop > 0) {
+        transform(prev, band->fTop - 1);
+    } else {
+        sk_bzero(prev, rowBytes);
+    }
+
+    band->fFilteredSize = (band->fBottom - band->fTop) * (rowBytes + 1);
+    band->fFiltered.reset(band->fFilteredSize);
+    uint8_t* dst = band->fFiltered.get();
+    for (int y = band->fTop; y < band->fBottom; y++) {
+        transform(curr, y);
+
+        // Like libpng, pick the filter that minimizes the sum of the (signed) filtered bytes.
+        int bestFilter = 0;
+        uint32_t bestCost = SkOpts::png_filter_row(0, best, curr, prev, rowBytes,
+                                                   pngBytesPerPixel);
+        for (int filter = 1; useFilters && filter <= 4; filter++) {
+            uint32_t cost = SkOpts::png_filter_row(filter, trial, curr, prev, rowBytes,
+                                                   pngBytesPerPixel);
+            if (cost < bestCost) {
+                bestFilter = filter;
+                bestCost = cost;
+                SkTSwap(best, trial);
+            }
+        }
+
+        *dst++ = bestFilter;
+        memcpy(dst, best, rowBytes);
+        dst += rowBytes;
+        SkTSwap(curr, prev);
+    }
+    band->fAdler = adler32(adler32(0, nullptr, 0), band->fFiltered.get(), band->fFilteredSize);
+}
+
+// Each band is compressed as raw deflate data, primed with the end of the previous band so that
+// matches can still reach back across the seam.  All but the last band end with a sync flush,
+// which byte-aligns their output, so the bands can simply be concatenated into one zlib stream.
+static void compress_band(PngBand* band, const PngBand* prevBand, bool first, bool last,
+                          int strategy) {
+    band->fSucceeded = false;
+
+    z_stream zstream;
+    sk_bzero(&zstream, sizeof(zstream));
+    if (Z_OK != deflateInit2(&zstream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS,
+                             8, strategy)) {
+        return;
+    }
+
+    if (prevBand) {
+        const size_t dictSize = SkTMin(prevBand->fFilteredSize, (size_t) 1 << MAX_WBITS);
+        deflateSetDictionary(&zstream,
+                             prevBand->fFiltered.get() + prevBand->fFilteredSize - dictSize,
+                             dictSize);
+    }
+
+    // Leave room for the zlib header and adler32 trailer, and for the sync flush marker.
+    const size_t headerSize = first ? 2 : 0;
+    const size_t trailerSize = last ? 4 : 0;
+    const size_t bound = deflateBound(&zstream, band->fFilteredSize) + 16;
+    band->fCompressed.reset(headerSize + bound + trailerSize);
+
+    zstream.next_in = band->fFiltered.get();
+    zstream.avail_in = band->fFilteredSize;
+    zstream.next_out = band->fCompressed.get() + headerSize;
+    zstream.avail_out = bound;
+    const int result = deflate(&zstream, last ? Z_FINISH : Z_SYNC_FLUSH);
+    band->fSucceeded = last ? Z_STREAM_END == result
+                            : Z_OK == result && 0 == zstream.avail_in && zstream.avail_out > 0;
+    band->fCompressedSize = headerSize + (bound - zstream.avail_out) + trailerSize;
+    deflateEnd(&zstream);
+}
+
+/*  Writes the image data as IDAT chunks, filtering and compressing bands of rows in parallel.
+    Returns false without writing anything if the image is too small to split up, or if
+    compression fails.
+*/
+static bool write_rows_in_parallel(png_structp png_ptr, const SkPixmap& pixmap,
+                                   transform_scanline_proc proc, int transformBytesPerPixel,
+                                   int pngBytesPerPixel, bool useFilters) {
+    const size_t rowBytes = pixmap.width() * pngBytesPerPixel + 1;
+    const int bandHeight = SkTMax<int>(1, kParallelBandBytes / rowBytes);
+    const int bandCount = (pixmap.height() + bandHeight - 1) / bandHeight;
+    if (bandCount < 2) {
+        return false;
+    }
+
+    SkAutoTArray<PngBand> bands(bandCount);
+    for (int i = 0; i < bandCount; i++) {
+        bands[i].fTop = i * bandHeight;
+        bands[i].fBottom = SkTMin(pixmap.height(), (i + 1) * bandHeight);
+    }
+
+    SkTaskGroup().batch(bandCount, [&](int i) {
+        filter_band(&bands[i], pixmap, proc, transformBytesPerPixel, pngBytesPerPixel,
+                    useFilters);
+    });
+
+    // Match libpng's choice of strategy.
+    const int strategy = useFilters ? Z_FILTERED : Z_DEFAULT_STRATEGY;
+    SkTaskGroup().batch(bandCount, [&](int i) {
+        compress_band(&bands[i], i > 0 ? &bands[i - 1] : nullptr, 0 == i, bandCount - 1 == i,
+                      strategy);
+    });
+
+    uLong adler = bands[0].fAdler;
+    for (int i = 0; i < bandCount; i++) {
+        if (!bands[i].fSucceeded) {
+            return false;
+        }
+        if (i > 0) {
+            adler = adler32_combine(adler, bands[i].fAdler, bands[i].fFilteredSize);
+        }
+    }
+
+    // A zlib header for a 32K window and the default compression level.
+    uint8_t* header = bands[0].fCompressed.get();
+    header[0] = 0x78;
+    header[1] = 0x9C;
+
+    PngBand& lastBand = bands[bandCount - 1];
+    uint8_t* trailer = lastBand.fCompressed.get() + lastBand.fCompressedSize - 4;
+    trailer[0] = (adler >> 24) & 0xFF;
+    trailer[1] = (adler >> 16) & 0xFF;
+    trailer[2] = (adler >>  8) & 0xFF;
+    trailer[3] = (adler >>  0) & 0xFF;
+
+    for (int i = 0; i < bandCount; i++) {
+        png_write_chunk(png_ptr, (png_const_bytep) "IDAT", bands[i].fCompressed.get(),
+                        bands[i].fCompressedSize);
+    }
+    return true;
+}
+
 static bool do_encode(SkWStream* stream, const SkPixmap& pixmap,
-                      int pngColorType, int bitDepth, png_color_8& sig_bit) {
+                      int pngColorType, int bitDepth, png_color_8& sig_bit,
+                      const SkEncodeOptions& opts) {
     png_structp png_ptr;
     png_infop info_ptr;
 
@@ -344,10 +520,22 @@ static bool do_encode(SkWStream* stream, const SkPixmap& pixmap,
         pngBytesPerPixel = 8;
     }
 
+    transform_scanline_proc proc = choose_proc(pixmap.info());
+    if (opts.fParallel) {
+        // libpng doesn't filter palette images, or images with fewer than 8 bits per pixel.
+        const bool useFilters = PNG_COLOR_TYPE_PALETTE != pngColorType;
+        const int filteredBytesPerPixel = num_components(pngColorType) * (bitDepth / 8);
+        if (write_rows_in_parallel(png_ptr, pixmap, proc, pngBytesPerPixel,
+                                   filteredBytesPerPixel, useFilters)) {
+            png_write_chunk(png_ptr, (png_const_bytep) "IEND", nullptr, 0);
+            png_destroy_write_struct(&png_ptr, &info_ptr);
+            return true;
+        }
+    }
+
     SkAutoSTMalloc<1024, char> rowStorage(pixmap.width() * pngBytesPerPixel);
     char* storage = rowStorage.get();
     const char* srcImage = (const char*)pixmap.addr();
-    transform_scanline_proc proc = choose_proc(pixmap.info());
     for (int y = 0; y < pixmap.height(); y++) {
         png_bytep row_ptr = (png_bytep)storage;
         proc(storage, srcImage, pixmap.width(), SkColorTypeBytesPerPixel(pixmap.colorType()),
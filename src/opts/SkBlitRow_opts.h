@@ -29,6 +29,27 @@ void blit_row_color32(SkPMColor* dst, const SkPMColor* src, int count, SkPMColor
     invA += invA >> 7;
     SkASSERT(invA < 256);  // We've should have already handled alpha == 0 externally.
 
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SKX
+    // The same math as the Sk4px code below, 16 pixels at a time.
+    const __m512i zeros = _mm512_setzero_si512(),
+                  colorHighAndRound_x32 = _mm512_add_epi16(
+                          _mm512_unpacklo_epi8(zeros, _mm512_set1_epi32(color)),
+                          _mm512_set1_epi16(128)),
+                  invA_x32 = _mm512_set1_epi16(invA);
+    auto blend = [&](__m512i px) {
+        return _mm512_srli_epi16(_mm512_add_epi16(_mm512_mullo_epi16(px, invA_x32),
+                                                  colorHighAndRound_x32), 8);
+    };
+    while (count >= 16) {
+        __m512i s = _mm512_loadu_si512(src);
+        _mm512_storeu_si512(dst, _mm512_packus_epi16(blend(_mm512_unpacklo_epi8(s, zeros)),
+                                                     blend(_mm512_unpackhi_epi8(s, zeros))));
+        src   += 16;
+        dst   += 16;
+        count -= 16;
+    }
+#endif
+
     Sk16h colorHighAndRound = Sk4px::DupPMColor(color).widenHi() + Sk16h(128);
     Sk16b invA_16x(invA);
 
@@ -67,7 +67,110 @@ static inline __m128i mullo_epi32(__m128i a, __m128i b) {
     auto result = mullo_epi32(sum, scale); \
     result = _mm_add_epi32(result, half); \
     *dptr = repack(result);
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SKX
+// Works on four rows at a time, keeping each row's sums in its own 128-bit lane.
+// The math is exactly that of STORE_SUMS, so results match the single row path bit for bit.
+template<BlurDirection srcDirection, BlurDirection dstDirection>
+static int box_blur_quad(const SkPMColor** src, int srcStride, const SkIRect& srcBounds,
+                         SkPMColor** dst, int kernelSize,
+                         int leftOffset, int rightOffset, int width, int height) {
+    // Load 1 pixel from each of 4 adjacent rows.
+    auto load_4_pixels = [&](const SkPMColor* s) {
+        __m128i px;
+        if (srcDirection == BlurDirection::kX) {
+            px = _mm_setr_epi32(s[0], s[srcStride], s[2*srcStride], s[3*srcStride]);
+        } else {
+            px = _mm_loadu_si128((const __m128i*)s);
+        }
+        return _mm512_cvtepu8_epi32(px);
+    };
+    auto store_4_pixels = [&](SkPMColor* d, __m512i sum, __m512i scale, __m512i half) {
+        __m512i result = _mm512_add_epi32(_mm512_mullo_epi32(sum, scale), half);
+        __m128i px = _mm512_cvtepi32_epi8(_mm512_srli_epi32(result, 24));
+        if (dstDirection == BlurDirection::kX) {
+            d[0*width] = _mm_extract_epi32(px, 0);
+            d[1*width] = _mm_extract_epi32(px, 1);
+            d[2*width] = _mm_extract_epi32(px, 2);
+            d[3*width] = _mm_extract_epi32(px, 3);
+        } else {
+            _mm_storeu_si128((__m128i*)d, px);
+        }
+    };
+    int left = srcBounds.fLeft;
+    int right = srcBounds.fRight;
+    int top = srcBounds.fTop;
+    int bottom = srcBounds.fBottom;
+    int incrementStart = SkMax32(left - rightOffset - 1, left - right);
+    int incrementEnd = SkMax32(right - rightOffset - 1, 0);
+    int decrementStart = SkMin32(left + leftOffset, width);
+    int decrementEnd = SkMin32(right + leftOffset, width);
+    const int srcStrideX = srcDirection == BlurDirection::kX ? 1 : srcStride;
+    const int dstStrideX = dstDirection == BlurDirection::kX ? 1 : height;
+    const int srcStrideY = srcDirection == BlurDirection::kX ? srcStride : 1;
+    const int dstStrideY = dstDirection == BlurDirection::kX ? width : 1;
+    const __m512i scale = _mm512_set1_epi32((1 << 24) / kernelSize);
+    const __m512i half = _mm512_set1_epi32(1 << 23);
+
+    for (; bottom - top >= 4; top += 4) {
+        __m512i sum = _mm512_setzero_si512();
+        const SkPMColor* lptr = *src;
+        const SkPMColor* rptr = *src;
+        SkPMColor* dptr = *dst;
+        int x;
+        for (x = incrementStart; x < 0; ++x) {
+            sum = _mm512_add_epi32(sum, load_4_pixels(rptr));
+            rptr += srcStrideX;
+        }
+        // Clear to zero when sampling to the left our domain. "sum" is zero here because we
+        // initialized it above, and the preceeding loop has no effect in this case.
+        for (x = 0; x < incrementStart; ++x) {
+            store_4_pixels(dptr, sum, scale, half);
+            dptr += dstStrideX;
+        }
+        for (; x < decrementStart && x < incrementEnd; ++x) {
+            store_4_pixels(dptr, sum, scale, half);
+            dptr += dstStrideX;
+            sum = _mm512_add_epi32(sum, load_4_pixels(rptr));
+            rptr += srcStrideX;
+        }
+        for (x = decrementStart; x < incrementEnd; ++x) {
+            store_4_pixels(dptr, sum, scale, half);
+            dptr += dstStrideX;
+            sum = _mm512_add_epi32(sum, load_4_pixels(rptr));
+            rptr += srcStrideX;
+            sum = _mm512_sub_epi32(sum, load_4_pixels(lptr));
+            lptr += srcStrideX;
+        }
+        for (x = incrementEnd; x < decrementStart; ++x) {
+            store_4_pixels(dptr, sum, scale, half);
+            dptr += dstStrideX;
+        }
+        for (; x < decrementEnd; ++x) {
+            store_4_pixels(dptr, sum, scale, half);
+            dptr += dstStrideX;
+            sum = _mm512_sub_epi32(sum, load_4_pixels(lptr));
+            lptr += srcStrideX;
+        }
+        // Clear to zero when sampling to the right of our domain. "sum" is zero here because we
+        // added on then subtracted off all of the pixels, leaving zero.
+        for (; x < width; ++x) {
+            store_4_pixels(dptr, sum, scale, half);
+            dptr += dstStrideX;
+        }
+        *src += srcStrideY * 4;
+        *dst += dstStrideY * 4;
+    }
+    return top;
+}
+
+#define DOUBLE_ROW_OPTIMIZATION \
+    top = box_blur_quad<srcDirection, dstDirection>(&src, srcStride, srcBounds, &dst, \
+                                                    kernelSize, leftOffset, rightOffset, \
+                                                    width, height);
+#else
 #define DOUBLE_ROW_OPTIMIZATION
+#endif
 
 #elif defined(SK_ARM_HAS_NEON)
 
@@ -104,10 +207,10 @@ static int box_blur_double(const SkPMColor** src, int srcStride, const SkIRect&
             return vld1_u8((uint8_t*)s);
         }
     };
-    int left = srcBounds.left();
-    int right = srcBounds.right();
-    int top = srcBounds.top();
-    int bottom = srcBounds.bottom();
+    int left = srcBounds.fLeft;
+    int right = srcBounds.fRight;
+    int top = srcBounds.fTop;
+    int bottom = srcBounds.fBottom;
     int incrementStart = SkMax32(left - rightOffset - 1, left - right);
     int incrementEnd = SkMax32(right - rightOffset - 1, 0);
     int decrementStart = SkMin32(left + leftOffset, width);
@@ -226,10 +329,10 @@ static inline uint16x4_t expand(SkPMColor p) {
 template<BlurDirection srcDirection, BlurDirection dstDirection>
 static void box_blur(const SkPMColor* src, int srcStride, const SkIRect& srcBounds, SkPMColor* dst,
                      int kernelSize, int leftOffset, int rightOffset, int width, int height) {
-    int left = srcBounds.left();
-    int right = srcBounds.right();
-    int top = srcBounds.top();
-    int bottom = srcBounds.bottom();
+    int left = srcBounds.fLeft;
+    int right = srcBounds.fRight;
+    int top = srcBounds.fTop;
+    int bottom = srcBounds.fBottom;
     int incrementStart = SkMax32(left - rightOffset - 1, left - right);
     int incrementEnd = SkMax32(right - rightOffset - 1, 0);
     int decrementStart = SkMin32(left + leftOffset, width);
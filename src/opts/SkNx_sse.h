@@ -713,6 +713,293 @@ public:
 
 #endif
 
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SKX
+
+    // AVX-512 comparisons produce a bit per lane in a __mmask16.  We expand those back out to
+    // all-on or all-off lanes so Sk16f, Sk16i, and Sk16u behave just like their narrower cousins.
+
+    template <>
+    class SkNx<16, int32_t> {
+    public:
+        AI SkNx(const __m512i& vec) : fVec(vec) {}
+
+        AI SkNx() {}
+        AI SkNx(int32_t v) : fVec(_mm512_set1_epi32(v)) {}
+        AI SkNx(int32_t a, int32_t b, int32_t c, int32_t d,
+                int32_t e, int32_t f, int32_t g, int32_t h,
+                int32_t i, int32_t j, int32_t k, int32_t l,
+                int32_t m, int32_t n, int32_t o, int32_t p)
+            : fVec(_mm512_setr_epi32(a,b,c,d, e,f,g,h, i,j,k,l, m,n,o,p)) {}
+
+        AI static SkNx Load(const void* ptr) { return _mm512_loadu_si512(ptr); }
+        AI void store(void* ptr) const { _mm512_storeu_si512(ptr, fVec); }
+
+        AI SkNx operator + (const SkNx& o) const { return _mm512_add_epi32(fVec, o.fVec); }
+        AI SkNx operator - (const SkNx& o) const { return _mm512_sub_epi32(fVec, o.fVec); }
+        AI SkNx operator * (const SkNx& o) const { return _mm512_mullo_epi32(fVec, o.fVec); }
+
+        AI SkNx operator & (const SkNx& o) const { return _mm512_and_si512(fVec, o.fVec); }
+        AI SkNx operator | (const SkNx& o) const { return _mm512_or_si512(fVec, o.fVec); }
+        AI SkNx operator ^ (const SkNx& o) const { return _mm512_xor_si512(fVec, o.fVec); }
+
+        AI SkNx operator << (int bits) const { return _mm512_slli_epi32(fVec, bits); }
+        AI SkNx operator >> (int bits) const { return _mm512_srai_epi32(fVec, bits); }
+
+        AI SkNx operator == (const SkNx& o) const {
+            return _mm512_movm_epi32(_mm512_cmpeq_epi32_mask(fVec, o.fVec));
+        }
+        AI SkNx operator  < (const SkNx& o) const {
+            return _mm512_movm_epi32(_mm512_cmplt_epi32_mask(fVec, o.fVec));
+        }
+        AI SkNx operator  > (const SkNx& o) const {
+            return _mm512_movm_epi32(_mm512_cmpgt_epi32_mask(fVec, o.fVec));
+        }
+
+        AI static SkNx Min(const SkNx& a, const SkNx& b) { return _mm512_min_epi32(a.fVec, b.fVec); }
+        AI static SkNx Max(const SkNx& a, const SkNx& b) { return _mm512_max_epi32(a.fVec, b.fVec); }
+
+        AI int32_t operator[](int k) const {
+            SkASSERT(0 <= k && k < 16);
+            union { __m512i v; int32_t is[16]; } pun = {fVec};
+            return pun.is[k&15];
+        }
+
+        AI SkNx thenElse(const SkNx& t, const SkNx& e) const {
+            return _mm512_mask_blend_epi32(_mm512_movepi32_mask(fVec), e.fVec, t.fVec);
+        }
+
+        __m512i fVec;
+    };
+
+    template <>
+    class SkNx<16, uint32_t> {
+    public:
+        AI SkNx(const __m512i& vec) : fVec(vec) {}
+
+        AI SkNx() {}
+        AI SkNx(uint32_t v) : fVec(_mm512_set1_epi32(v)) {}
+        AI SkNx(uint32_t a, uint32_t b, uint32_t c, uint32_t d,
+                uint32_t e, uint32_t f, uint32_t g, uint32_t h,
+                uint32_t i, uint32_t j, uint32_t k, uint32_t l,
+                uint32_t m, uint32_t n, uint32_t o, uint32_t p)
+            : fVec(_mm512_setr_epi32(a,b,c,d, e,f,g,h, i,j,k,l, m,n,o,p)) {}
+
+        AI static SkNx Load(const void* ptr) { return _mm512_loadu_si512(ptr); }
+        AI void store(void* ptr) const { _mm512_storeu_si512(ptr, fVec); }
+
+        AI SkNx operator + (const SkNx& o) const { return _mm512_add_epi32(fVec, o.fVec); }
+        AI SkNx operator - (const SkNx& o) const { return _mm512_sub_epi32(fVec, o.fVec); }
+        AI SkNx operator * (const SkNx& o) const { return _mm512_mullo_epi32(fVec, o.fVec); }
+
+        AI SkNx operator & (const SkNx& o) const { return _mm512_and_si512(fVec, o.fVec); }
+        AI SkNx operator | (const SkNx& o) const { return _mm512_or_si512(fVec, o.fVec); }
+        AI SkNx operator ^ (const SkNx& o) const { return _mm512_xor_si512(fVec, o.fVec); }
+
+        AI SkNx operator << (int bits) const { return _mm512_slli_epi32(fVec, bits); }
+        AI SkNx operator >> (int bits) const { return _mm512_srli_epi32(fVec, bits); }
+
+        AI SkNx operator == (const SkNx& o) const {
+            return _mm512_movm_epi32(_mm512_cmpeq_epu32_mask(fVec, o.fVec));
+        }
+        AI SkNx operator  < (const SkNx& o) const {
+            return _mm512_movm_epi32(_mm512_cmplt_epu32_mask(fVec, o.fVec));
+        }
+        AI SkNx operator  > (const SkNx& o) const {
+            return _mm512_movm_epi32(_mm512_cmpgt_epu32_mask(fVec, o.fVec));
+        }
+
+        AI static SkNx Min(const SkNx& a, const SkNx& b) { return _mm512_min_epu32(a.fVec, b.fVec); }
+        AI static SkNx Max(const SkNx& a, const SkNx& b) { return _mm512_max_epu32(a.fVec, b.fVec); }
+
+        AI uint32_t operator[](int k) const {
+            SkASSERT(0 <= k && k < 16);
+            union { __m512i v; uint32_t us[16]; } pun = {fVec};
+            return pun.us[k&15];
+        }
+
+        AI SkNx thenElse(const SkNx& t, const SkNx& e) const {
+            return _mm512_mask_blend_epi32(_mm512_movepi32_mask(fVec), e.fVec, t.fVec);
+        }
+
+        __m512i fVec;
+    };
+
+    // _mm512_unpack{lo,hi}_pd() auto-casting to and from __m512d.
+    AI static __m512 unpacklo_pd(__m512 x, __m512 y) {
+        return _mm512_castpd_ps(_mm512_unpacklo_pd(_mm512_castps_pd(x), _mm512_castps_pd(y)));
+    }
+    AI static __m512 unpackhi_pd(__m512 x, __m512 y) {
+        return _mm512_castpd_ps(_mm512_unpackhi_pd(_mm512_castps_pd(x), _mm512_castps_pd(y)));
+    }
+
+    template <>
+    class SkNx<16, float> {
+    public:
+        AI SkNx(const __m512& vec) : fVec(vec) {}
+
+        AI SkNx() {}
+        AI SkNx(float val) : fVec(_mm512_set1_ps(val)) {}
+        AI SkNx(float a, float b, float c, float d,
+                float e, float f, float g, float h,
+                float i, float j, float k, float l,
+                float m, float n, float o, float p)
+            : fVec(_mm512_setr_ps(a,b,c,d, e,f,g,h, i,j,k,l, m,n,o,p)) {}
+
+        AI static SkNx Load(const void* ptr) { return _mm512_loadu_ps((const float*)ptr); }
+        AI void store(void* ptr) const { _mm512_storeu_ps((float*)ptr, fVec); }
+
+        // Lane k of the vectors below is pixels k, 4+k, 8+k, 12+k (or their r,g,b,a) mixed up
+        // in the same way a 4x4 transpose would.  This permute is its own inverse and puts
+        // each channel's 16 values back into pixel order.
+        AI static __m512 Transpose4x4Lanes(__m512 v) {
+            return _mm512_permutexvar_ps(_mm512_setr_epi32(0,4,8,12, 1,5,9,13,
+                                                           2,6,10,14, 3,7,11,15), v);
+        }
+
+        AI static void Load4(const void* ptr, SkNx* r, SkNx* g, SkNx* b, SkNx* a) {
+            __m512 _0 = _mm512_loadu_ps((const float*)ptr + 0*16),  // rgba, pixels  0-3
+                   _1 = _mm512_loadu_ps((const float*)ptr + 1*16),  //       pixels  4-7
+                   _2 = _mm512_loadu_ps((const float*)ptr + 2*16),  //       pixels  8-11
+                   _3 = _mm512_loadu_ps((const float*)ptr + 3*16);  //       pixels 12-15
+
+            __m512 rg01 = _mm512_unpacklo_ps(_0, _1),  // r0 r4 g0 g4 | r1 r5 g1 g5 | ...
+                   ba01 = _mm512_unpackhi_ps(_0, _1),  // b0 b4 a0 a4 | ...
+                   rg23 = _mm512_unpacklo_ps(_2, _3),  // r8 r12 g8 g12 | ...
+                   ba23 = _mm512_unpackhi_ps(_2, _3);  // b8 b12 a8 a12 | ...
+
+            *r = Transpose4x4Lanes(unpacklo_pd(rg01, rg23));  // r0 r4 r8 r12 | r1 ... ~~> r0..r15
+            *g = Transpose4x4Lanes(unpackhi_pd(rg01, rg23));
+            *b = Transpose4x4Lanes(unpacklo_pd(ba01, ba23));
+            *a = Transpose4x4Lanes(unpackhi_pd(ba01, ba23));
+        }
+        AI static void Store4(void* ptr,
+                              const SkNx& r, const SkNx& g, const SkNx& b, const SkNx& a) {
+            __m512 R = Transpose4x4Lanes(r.fVec),  // r0 r4 r8 r12 | r1 r5 r9 r13 | ...
+                   G = Transpose4x4Lanes(g.fVec),
+                   B = Transpose4x4Lanes(b.fVec),
+                   A = Transpose4x4Lanes(a.fVec);
+
+            __m512 rg01 = _mm512_unpacklo_ps(R, G),  // r0 g0 r4 g4    | r1 ...
+                   rg23 = _mm512_unpackhi_ps(R, G),  // r8 g8 r12 g12  | r9 ...
+                   ba01 = _mm512_unpacklo_ps(B, A),  // b0 a0 b4 a4    | b1 ...
+                   ba23 = _mm512_unpackhi_ps(B, A);  // b8 a8 b12 a12  | b9 ...
+
+            _mm512_storeu_ps((float*)ptr + 0*16, unpacklo_pd(rg01, ba01));  // pixels  0-3
+            _mm512_storeu_ps((float*)ptr + 1*16, unpackhi_pd(rg01, ba01));  // pixels  4-7
+            _mm512_storeu_ps((float*)ptr + 2*16, unpacklo_pd(rg23, ba23));  // pixels  8-11
+            _mm512_storeu_ps((float*)ptr + 3*16, unpackhi_pd(rg23, ba23));  // pixels 12-15
+        }
+
+        AI SkNx operator+(const SkNx& o) const { return _mm512_add_ps(fVec, o.fVec); }
+        AI SkNx operator-(const SkNx& o) const { return _mm512_sub_ps(fVec, o.fVec); }
+        AI SkNx operator*(const SkNx& o) const { return _mm512_mul_ps(fVec, o.fVec); }
+        AI SkNx operator/(const SkNx& o) const { return _mm512_div_ps(fVec, o.fVec); }
+
+        AI SkNx operator==(const SkNx& o) const { return Expand(_mm512_cmp_ps_mask(fVec, o.fVec, _CMP_EQ_OQ )); }
+        AI SkNx operator!=(const SkNx& o) const { return Expand(_mm512_cmp_ps_mask(fVec, o.fVec, _CMP_NEQ_OQ)); }
+        AI SkNx operator <(const SkNx& o) const { return Expand(_mm512_cmp_ps_mask(fVec, o.fVec, _CMP_LT_OQ )); }
+        AI SkNx operator >(const SkNx& o) const { return Expand(_mm512_cmp_ps_mask(fVec, o.fVec, _CMP_GT_OQ )); }
+        AI SkNx operator<=(const SkNx& o) const { return Expand(_mm512_cmp_ps_mask(fVec, o.fVec, _CMP_LE_OQ )); }
+        AI SkNx operator>=(const SkNx& o) const { return Expand(_mm512_cmp_ps_mask(fVec, o.fVec, _CMP_GE_OQ )); }
+
+        AI static SkNx Min(const SkNx& l, const SkNx& r) { return _mm512_min_ps(l.fVec, r.fVec); }
+        AI static SkNx Max(const SkNx& l, const SkNx& r) { return _mm512_max_ps(l.fVec, r.fVec); }
+
+        AI SkNx   sqrt() const { return _mm512_sqrt_ps   (fVec); }
+        AI SkNx  rsqrt() const { return _mm512_rsqrt14_ps(fVec); }
+        AI SkNx invert() const { return _mm512_rcp14_ps  (fVec); }
+
+        AI SkNx abs() const { return _mm512_abs_ps(fVec); }
+        AI SkNx floor() const {
+            return _mm512_roundscale_ps(fVec, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+        }
+
+        AI float operator[](int k) const {
+            SkASSERT(0 <= k && k < 16);
+            union { __m512 v; float fs[16]; } pun = {fVec};
+            return pun.fs[k&15];
+        }
+
+        AI bool allTrue() const { return 0xffff == _mm512_movepi32_mask(_mm512_castps_si512(fVec)); }
+        AI bool anyTrue() const { return 0x0000 != _mm512_movepi32_mask(_mm512_castps_si512(fVec)); }
+
+        AI SkNx thenElse(const SkNx& t, const SkNx& e) const {
+            return _mm512_mask_blend_ps(_mm512_movepi32_mask(_mm512_castps_si512(fVec)),
+                                        e.fVec, t.fVec);
+        }
+
+        __m512 fVec;
+
+    private:
+        AI static __m512 Expand(__mmask16 m) { return _mm512_castsi512_ps(_mm512_movm_epi32(m)); }
+    };
+
+    AI static void SkNx_split(const Sk16f& v, Sk8f* lo, Sk8f* hi) {
+        *lo = _mm512_castps512_ps256(v.fVec);
+        *hi = _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(v.fVec), 1));
+    }
+
+    AI static Sk16f SkNx_join(const Sk8f& lo, const Sk8f& hi) {
+        return _mm512_castpd_ps(_mm512_insertf64x4(_mm512_castpd256_pd512(_mm256_castps_pd(lo.fVec)),
+                                                   _mm256_castps_pd(hi.fVec), 1));
+    }
+
+    AI static Sk16f SkNx_fma(const Sk16f& a, const Sk16f& b, const Sk16f& c) {
+        return _mm512_fmadd_ps(a.fVec, b.fVec, c.fVec);
+    }
+
+    // Sk16h is still a pair of Sk8h (Sk4px depends on that), so we join and split it here.
+    AI static __m256i join_16h(const Sk16h& v) {
+        return _mm256_inserti128_si256(_mm256_castsi128_si256(v.fLo.fVec), v.fHi.fVec, 1);
+    }
+    AI static Sk16h split_16h(const __m256i& v) {
+        return { Sk8h(_mm256_castsi256_si128(v)), Sk8h(_mm256_extracti128_si256(v, 1)) };
+    }
+
+    template<> AI /*static*/ Sk16i SkNx_cast<int>(const Sk16b& src) {
+        return _mm512_cvtepu8_epi32(src.fVec);
+    }
+
+    template<> AI /*static*/ Sk16f SkNx_cast<float>(const Sk16b& src) {
+        return _mm512_cvtepi32_ps(SkNx_cast<int>(src).fVec);
+    }
+
+    template<> AI /*static*/ Sk16i SkNx_cast<int>(const Sk16h& src) {
+        return _mm512_cvtepu16_epi32(join_16h(src));
+    }
+
+    template<> AI /*static*/ Sk16f SkNx_cast<float>(const Sk16h& src) {
+        return _mm512_cvtepi32_ps(SkNx_cast<int>(src).fVec);
+    }
+
+    template<> AI /*static*/ Sk16f SkNx_cast<float>(const Sk16i& src) {
+        return _mm512_cvtepi32_ps(src.fVec);
+    }
+
+    template<> AI /*static*/ Sk16i SkNx_cast<int>(const Sk16f& src) {
+        return _mm512_cvttps_epi32(src.fVec);
+    }
+
+    template<> AI /*static*/ Sk16i SkNx_cast<int>(const Sk16u& src) {
+        return src.fVec;
+    }
+
+    template<> AI /*static*/ Sk16h SkNx_cast<uint16_t>(const Sk16i& src) {
+        // Saturate like _mm_packus_epi32() does.
+        return split_16h(_mm512_cvtusepi32_epi16(_mm512_max_epi32(src.fVec,
+                                                                  _mm512_setzero_si512())));
+    }
+
+    template<> AI /*static*/ Sk16h SkNx_cast<uint16_t>(const Sk16f& src) {
+        return SkNx_cast<uint16_t>(SkNx_cast<int>(src));
+    }
+
+    template<> AI /*static*/ Sk16b SkNx_cast<uint8_t>(const Sk16i& src) {
+        return _mm512_cvtusepi32_epi8(_mm512_max_epi32(src.fVec, _mm512_setzero_si512()));
+    }
+
+#endif
+
 template<> AI /*static*/ Sk4f SkNx_cast<float, int32_t>(const Sk4i& src) {
     return _mm_cvtepi32_ps(src.fVec);
 }
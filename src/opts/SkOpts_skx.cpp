@@ -0,0 +1,52 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkSafe_math.h"   // Keep this first.
+
+// Please note carefully.
+// It is not safe for _opts.h files included here to use STL types, for the
+// same reason we just had to include SkSafe_math.h: STL types are templated,
+// defined in headers, but not in anonymous namespaces.  It's very easy to
+// cause ODR violations with these types and AVX+ code generation.
+//
+// The same goes for any inline helper shared with other translation units
+// (SkColorTable::readColors(), SkTMin(), SkIRect::left(), ...): the linker may
+// keep this file's AVX-512 copy for everyone.  So only include _opts.h files
+// here whose helpers are all static or in anonymous namespaces, and check
+// `nm -C` on this object for new weak symbols after touching them.
+// That's why we leave compile_pipeline alone here: it returns an std::function.
+
+#include "SkOpts.h"
+#define SK_OPTS_NS skx
+#include "SkBlitRow_opts.h"
+#include "SkBlurImageFilter_opts.h"
+#include "SkRasterPipeline_opts.h"
+#include "SkSwizzler_opts.h"
+
+#if defined(_INC_MATH) && !defined(INC_MATH_IS_SAFE_NOW)
+    #error We have included ucrt\math.h without protecting it against ODR violation.
+#endif
+
+namespace SkOpts {
+    void Init_skx() {
+        box_blur_xx      = skx::box_blur_xx;
+        box_blur_xy      = skx::box_blur_xy;
+        box_blur_yx      = skx::box_blur_yx;
+        blit_row_color32 = skx::blit_row_color32;
+        run_pipeline     = skx::run_pipeline;
+
+        RGBA_to_BGRA     = skx::RGBA_to_BGRA;
+        RGBA_to_rgbA     = skx::RGBA_to_rgbA;
+        RGBA_to_bgrA     = skx::RGBA_to_bgrA;
+        RGBA16_to_RGBA   = skx::RGBA16_to_RGBA;
+        RGBA16_to_BGRA   = skx::RGBA16_to_BGRA;
+        RGBA16_to_rgbA   = skx::RGBA16_to_rgbA;
+        RGBA16_to_bgrA   = skx::RGBA16_to_bgrA;
+        index8_to_8888   = skx::index8_to_8888;
+        gather_pixels    = skx::gather_pixels;
+    }
+}
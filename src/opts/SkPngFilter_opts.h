@@ -0,0 +1,137 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPngFilter_opts_DEFINED
+#define SkPngFilter_opts_DEFINED
+
+#include "SkTypes.h"
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    #include <emmintrin.h>
+#endif
+
+namespace SK_OPTS_NS {
+
+// PNG filters predict each byte x from the byte to its left (a), the byte above (b),
+// and the byte above and to the left (c).  When encoding, these all come from the unfiltered
+// rows, so unlike decoding, every byte can be filtered independently.
+
+static inline uint8_t png_paeth(int a, int b, int c) {
+    int pa = SkTAbs(b - c),
+        pb = SkTAbs(a - c),
+        pc = SkTAbs(a + b - 2*c);
+    return (pa <= pb && pa <= pc) ? a : (pb <= pc) ? b : c;
+}
+
+static inline uint8_t png_filter_byte(int filter, int x, int a, int b, int c) {
+    switch (filter) {
+        case 1:  return x - a;
+        case 2:  return x - b;
+        case 3:  return x - ((a + b) >> 1);
+        case 4:  return x - png_paeth(a, b, c);
+        default: return x;
+    }
+}
+
+// libpng picks the filter whose output has the smallest sum of bytes, taken as signed.
+static inline uint32_t png_filter_cost(uint8_t v) {
+    return v < 128 ? v : 256 - v;
+}
+
+static uint32_t png_filter_row_portable(int filter, uint8_t* dst, const uint8_t* row,
+                                        const uint8_t* prev, int i, int len, int bpp) {
+    uint32_t sum = 0;
+    for (; i < len; i++) {
+        int a = i >= bpp ? row[i - bpp] : 0,
+            c = i >= bpp ? prev[i - bpp] : 0;
+        dst[i] = png_filter_byte(filter, row[i], a, prev[i], c);
+        sum += png_filter_cost(dst[i]);
+    }
+    return sum;
+}
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+
+static inline __m128i png_paeth(__m128i a8, __m128i b8, __m128i c8) {
+    // Paeth needs 9 bits of precision, so work in two halves of 16-bit lanes.
+    auto paeth = [](__m128i a, __m128i b, __m128i c) {
+        __m128i pa = _mm_sub_epi16(b, c),
+                pb = _mm_sub_epi16(a, c),
+                pc = _mm_add_epi16(pa, pb);
+        pa = _mm_max_epi16(pa, _mm_sub_epi16(_mm_setzero_si128(), pa));
+        pb = _mm_max_epi16(pb, _mm_sub_epi16(_mm_setzero_si128(), pb));
+        pc = _mm_max_epi16(pc, _mm_sub_epi16(_mm_setzero_si128(), pc));
+
+        // (pa <= pb && pa <= pc) ? a : (pb <= pc) ? b : c
+        __m128i use_a = _mm_andnot_si128(_mm_or_si128(_mm_cmpgt_epi16(pa, pb),
+                                                      _mm_cmpgt_epi16(pa, pc)),
+                                         _mm_set1_epi16(-1)),
+                use_b = _mm_andnot_si128(_mm_cmpgt_epi16(pb, pc), _mm_set1_epi16(-1));
+        __m128i bc = _mm_or_si128(_mm_and_si128(use_b, b), _mm_andnot_si128(use_b, c));
+        return _mm_or_si128(_mm_and_si128(use_a, a), _mm_andnot_si128(use_a, bc));
+    };
+
+    const __m128i zero = _mm_setzero_si128();
+    __m128i lo = paeth(_mm_unpacklo_epi8(a8, zero),
+                       _mm_unpacklo_epi8(b8, zero),
+                       _mm_unpacklo_epi8(c8, zero)),
+            hi = paeth(_mm_unpackhi_epi8(a8, zero),
+                       _mm_unpackhi_epi8(b8, zero),
+                       _mm_unpackhi_epi8(c8, zero));
+    return _mm_packus_epi16(lo, hi);
+}
+
+static uint32_t png_filter_row(int filter, uint8_t* dst, const uint8_t* row, const uint8_t* prev,
+                               int len, int bpp) {
+    // The first pixel has no left neighbor.
+    const int start = SkTMin(bpp, len);
+    uint32_t sum = png_filter_row_portable(filter, dst, row, prev, 0, start, bpp);
+
+    const __m128i zero = _mm_setzero_si128();
+    __m128i sums = zero;
+    int i = start;
+    for (; i + 16 <= len; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(row + i)),
+                a = _mm_loadu_si128((const __m128i*)(row + i - bpp)),
+                b = _mm_loadu_si128((const __m128i*)(prev + i)),
+                c = _mm_loadu_si128((const __m128i*)(prev + i - bpp));
+
+        __m128i v;
+        switch (filter) {
+            case 1: v = _mm_sub_epi8(x, a); break;
+            case 2: v = _mm_sub_epi8(x, b); break;
+            case 3: {
+                // _mm_avg_epu8() rounds up, but PNG wants (a+b)>>1.
+                __m128i avg = _mm_sub_epi8(_mm_avg_epu8(a, b),
+                                           _mm_and_si128(_mm_xor_si128(a, b), _mm_set1_epi8(1)));
+                v = _mm_sub_epi8(x, avg);
+            } break;
+            case 4: v = _mm_sub_epi8(x, png_paeth(a, b, c)); break;
+            default: v = x; break;
+        }
+        _mm_storeu_si128((__m128i*)(dst + i), v);
+
+        // min(v, -v) treats each byte as signed and takes its magnitude.
+        sums = _mm_add_epi64(sums, _mm_sad_epu8(_mm_min_epu8(v, _mm_sub_epi8(zero, v)), zero));
+    }
+    sum += _mm_cvtsi128_si32(sums) + _mm_cvtsi128_si32(_mm_srli_si128(sums, 8));
+
+    return sum + png_filter_row_portable(filter, dst, row, prev, i, len, bpp);
+}
+
+#else
+
+static uint32_t png_filter_row(int filter, uint8_t* dst, const uint8_t* row, const uint8_t* prev,
+                               int len, int bpp) {
+    return png_filter_row_portable(filter, dst, row, prev, 0, len, bpp);
+}
+
+#endif
+
+}  // namespace SK_OPTS_NS
+
+#endif//SkPngFilter_opts_DEFINED
@@ -22,7 +22,9 @@
 
 namespace {
 
-#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SKX
+    static constexpr int N = 16;
+#elif SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
     static constexpr int N = 8;
 #else
     static constexpr int N = 4;
@@ -55,6 +57,8 @@ namespace {
 
 }  // namespace
 
+// This file is compiled into AVX-512 code in SkOpts_skx.cpp, so stages read their contexts'
+// fields directly (e.g. SkPM4f::fVec) rather than through inline accessors, which aren't TU-local.
 #define SI static inline
 
 // Basically, return *(*ptr)++, maybe faster than the compiler can do it.
@@ -148,14 +152,22 @@ SI void SK_VECTORCALL just_return(size_t, void**, SkNf, SkNf, SkNf, SkNf,
 template <typename T>
 SI SkNx<N,T> load(size_t tail, const T* src) {
     if (tail) {
-        T buf[8] = {0};
+        T buf[16] = {0};
         switch (tail & (N-1)) {
-            case 7: buf[6] = src[6];
-            case 6: buf[5] = src[5];
-            case 5: buf[4] = src[4];
-            case 4: buf[3] = src[3];
-            case 3: buf[2] = src[2];
-            case 2: buf[1] = src[1];
+            case 15: buf[14] = src[14];
+            case 14: buf[13] = src[13];
+            case 13: buf[12] = src[12];
+            case 12: buf[11] = src[11];
+            case 11: buf[10] = src[10];
+            case 10: buf[ 9] = src[ 9];
+            case  9: buf[ 8] = src[ 8];
+            case  8: buf[ 7] = src[ 7];
+            case  7: buf[ 6] = src[ 6];
+            case  6: buf[ 5] = src[ 5];
+            case  5: buf[ 4] = src[ 4];
+            case  4: buf[ 3] = src[ 3];
+            case  3: buf[ 2] = src[ 2];
+            case  2: buf[ 1] = src[ 1];
         }
         buf[0] = src[0];
         return SkNx<N,T>::Load(buf);
@@ -165,19 +177,27 @@ SI SkNx<N,T> load(size_t tail, const T* src) {
 template <typename T>
 SI SkNx<N,T> gather(size_t tail, const T* src, const SkNi& offset) {
     if (tail) {
-        T buf[8] = {0};
+        T buf[16] = {0};
         switch (tail & (N-1)) {
-            case 7: buf[6] = src[offset[6]];
-            case 6: buf[5] = src[offset[5]];
-            case 5: buf[4] = src[offset[4]];
-            case 4: buf[3] = src[offset[3]];
-            case 3: buf[2] = src[offset[2]];
-            case 2: buf[1] = src[offset[1]];
+            case 15: buf[14] = src[offset[14]];
+            case 14: buf[13] = src[offset[13]];
+            case 13: buf[12] = src[offset[12]];
+            case 12: buf[11] = src[offset[11]];
+            case 11: buf[10] = src[offset[10]];
+            case 10: buf[ 9] = src[offset[ 9]];
+            case  9: buf[ 8] = src[offset[ 8]];
+            case  8: buf[ 7] = src[offset[ 7]];
+            case  7: buf[ 6] = src[offset[ 6]];
+            case  6: buf[ 5] = src[offset[ 5]];
+            case  5: buf[ 4] = src[offset[ 4]];
+            case  4: buf[ 3] = src[offset[ 3]];
+            case  3: buf[ 2] = src[offset[ 2]];
+            case  2: buf[ 1] = src[offset[ 1]];
         }
         buf[0] = src[offset[0]];
         return SkNx<N,T>::Load(buf);
     }
-    T buf[8];
+    T buf[N];
     for (size_t i = 0; i < N; i++) {
         buf[i] = src[offset[i]];
     }
@@ -187,12 +207,20 @@ template <typename T>
 SI void store(size_t tail, const SkNx<N,T>& v, T* dst) {
     if (tail) {
         switch (tail & (N-1)) {
-            case 7: dst[6] = v[6];
-            case 6: dst[5] = v[5];
-            case 5: dst[4] = v[4];
-            case 4: dst[3] = v[3];
-            case 3: dst[2] = v[2];
-            case 2: dst[1] = v[1];
+            case 15: dst[14] = v[14];
+            case 14: dst[13] = v[13];
+            case 13: dst[12] = v[12];
+            case 12: dst[11] = v[11];
+            case 11: dst[10] = v[10];
+            case 10: dst[ 9] = v[ 9];
+            case  9: dst[ 8] = v[ 8];
+            case  8: dst[ 7] = v[ 7];
+            case  7: dst[ 6] = v[ 6];
+            case  6: dst[ 5] = v[ 5];
+            case  5: dst[ 4] = v[ 4];
+            case  4: dst[ 3] = v[ 3];
+            case  3: dst[ 2] = v[ 2];
+            case  2: dst[ 1] = v[ 1];
         }
         dst[0] = v[0];
         return;
@@ -200,7 +228,45 @@ SI void store(size_t tail, const SkNx<N,T>& v, T* dst) {
     v.store(dst);
 }
 
-#if !defined(SKNX_NO_SIMD) && SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+#if !defined(SKNX_NO_SIMD) && SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SKX
+    // AVX-512 masks are just bits, and masked-off lanes never fault.
+    SI __mmask16 mask(size_t tail) {
+        return tail ? (__mmask16)((1u << tail) - 1)
+                    : (__mmask16)0xffff;  // remember, tail == 0 ~~> load all N
+    }
+
+    SI SkNi load(size_t tail, const  int32_t* src) {
+        return tail ? _mm512_maskz_loadu_epi32(mask(tail), src)
+                    : SkNi::Load(src);
+    }
+    SI SkNu load(size_t tail, const uint32_t* src) {
+        return tail ? _mm512_maskz_loadu_epi32(mask(tail), src)
+                    : SkNu::Load(src);
+    }
+    SI SkNf load(size_t tail, const float* src) {
+        return tail ? _mm512_maskz_loadu_ps(mask(tail), src)
+                    : SkNf::Load(src);
+    }
+    SI SkNi gather(size_t tail, const  int32_t* src, const SkNi& offset) {
+        return _mm512_mask_i32gather_epi32(SkNi(0).fVec, mask(tail), offset.fVec, src, 4);
+    }
+    SI SkNu gather(size_t tail, const uint32_t* src, const SkNi& offset) {
+        return _mm512_mask_i32gather_epi32(SkNi(0).fVec, mask(tail), offset.fVec, src, 4);
+    }
+    SI SkNf gather(size_t tail, const float* src, const SkNi& offset) {
+        return _mm512_mask_i32gather_ps(SkNf(0).fVec, mask(tail), offset.fVec, src, 4);
+    }
+
+    SI void store(size_t tail, const SkNi& v,  int32_t* dst) {
+        _mm512_mask_storeu_epi32(dst, mask(tail), v.fVec);
+    }
+    SI void store(size_t tail, const SkNu& v, uint32_t* dst) {
+        _mm512_mask_storeu_epi32(dst, mask(tail), v.fVec);
+    }
+    SI void store(size_t tail, const SkNf& v, float* dst) {
+        _mm512_mask_storeu_ps(dst, mask(tail), v.fVec);
+    }
+#elif !defined(SKNX_NO_SIMD) && SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
     SI __m256i mask(size_t tail) {
         static const int masks[][8] = {
             {~0,~0,~0,~0, ~0,~0,~0,~0 },  // remember, tail == 0 ~~> load all N
@@ -434,10 +500,10 @@ STAGE(to_2dot2) {
 
 // The default shader produces a constant color (from the SkPaint).
 STAGE_CTX(constant_color, const SkPM4f*) {
-    r = ctx->r();
-    g = ctx->g();
-    b = ctx->b();
-    a = ctx->a();
+    r = ctx->fVec[SkPM4f::R];
+    g = ctx->fVec[SkPM4f::G];
+    b = ctx->fVec[SkPM4f::B];
+    a = ctx->fVec[SkPM4f::A];
 }
 
 // Set up registers with values relevant to shaders.
@@ -586,6 +652,54 @@ STAGE_CTX(store_8888, uint32_t**) {
     store(tail, byte(r,0)|byte(g,1)|byte(b,2)|byte(a,3), (int*)ptr);
 }
 
+#if !defined(SKNX_NO_SIMD) && SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSSE3
+    // Reads exactly the 12 bytes of 4 packed RGB pixels and spreads them out to opaque 8888.
+    SI __m128i rgb_888_to_8888_x4(const uint8_t* src) {
+        int hi;
+        memcpy(&hi, src + 8, 4);
+        auto rgb = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i*)src),
+                                      _mm_cvtsi32_si128(hi));
+        return _mm_or_si128(_mm_shuffle_epi8(rgb, _mm_setr_epi8(0,1,2,-1, 3,4,5,-1,
+                                                                6,7,8,-1, 9,10,11,-1)),
+                            _mm_set1_epi32(0xff000000));
+    }
+#endif
+
+// Packed 3-byte RGB, widened to opaque 8888 so it can share the 8888 unpacking.
+SI SkNu load_rgb_888(size_t tail, const uint8_t* ptr) {
+    const uint8_t* src = ptr;
+    uint8_t buf[N*3];
+    if (tail) {
+        memcpy(buf, src, tail*3);
+        memset(buf + tail*3, 0, (N-tail)*3);
+        src = buf;
+    }
+
+#if !defined(SKNX_NO_SIMD) && SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SKX
+    auto lo = _mm256_inserti128_si256(_mm256_castsi128_si256(rgb_888_to_8888_x4(src +  0)),
+                                      rgb_888_to_8888_x4(src + 12), 1),
+         hi = _mm256_inserti128_si256(_mm256_castsi128_si256(rgb_888_to_8888_x4(src + 24)),
+                                      rgb_888_to_8888_x4(src + 36), 1);
+    return _mm512_inserti64x4(_mm512_castsi256_si512(lo), hi, 1);
+#elif !defined(SKNX_NO_SIMD) && SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(rgb_888_to_8888_x4(src +  0)),
+                                   rgb_888_to_8888_x4(src + 12), 1);
+#elif !defined(SKNX_NO_SIMD) && SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSSE3
+    return rgb_888_to_8888_x4(src);
+#else
+    uint32_t px[N];
+    for (int i = 0; i < N; i++) {
+        px[i] = 0xff000000 | src[3*i+2] << 16 | src[3*i+1] << 8 | src[3*i+0];
+    }
+    return SkNu::Load(px);
+#endif
+}
+
+STAGE_CTX(load_rgb_888, const uint8_t**) {
+    auto ptr = *ctx + 3*x;
+    from_8888(load_rgb_888(tail, ptr), &r, &g, &b, &a);
+}
+
 STAGE_CTX(load_u16_be, const uint64_t**) {
     auto ptr = *ctx + x;
     const void* src = ptr;
@@ -648,6 +762,17 @@ STAGE_CTX(load_tables, const LoadTablesContext*) {
     a = SkNf_from_byte(rgba >> 24);
 }
 
+STAGE_CTX(load_tables_rgb_888, const LoadTablesContext*) {
+    auto ptr = (const uint8_t*)ctx->fSrc + 3*x;
+
+    SkNu rgb = load_rgb_888(tail, ptr);
+    auto to_int = [](const SkNu& v) { return SkNi::Load(&v); };
+    r = gather(tail, ctx->fR, to_int((rgb >>  0) & 0xff));
+    g = gather(tail, ctx->fG, to_int((rgb >>  8) & 0xff));
+    b = gather(tail, ctx->fB, to_int((rgb >> 16) & 0xff));
+    a = 1.0f;
+}
+
 STAGE_CTX(load_tables_u16_be, const LoadTablesContext*) {
     auto ptr = (const uint64_t*)ctx->fSrc + x;
     const void* src = ptr;
@@ -830,21 +955,22 @@ STAGE_CTX(table_a, const SkTableTransferFn*) { a = table(a, *ctx); }
 
 STAGE_CTX(color_lookup_table, const SkColorLookUpTable*) {
     const SkColorLookUpTable* colorLUT = ctx;
-    SkASSERT(3 == colorLUT->inputChannels() || 4 == colorLUT->inputChannels());
-    SkASSERT(3 == colorLUT->outputChannels());
+    const int inputChannels = colorLUT->inputChannels();
+    SkASSERT(3 == inputChannels || 4 == inputChannels);
+    static_assert(3 == SkColorLookUpTable::kOutputChannels, "");
     float result[3][N];
     for (int i = 0; i < N; ++i) {
         const float in[4] = { r[i], g[i], b[i], a[i] };
         float out[3];
         colorLUT->interp(out, in);
-        for (int j = 0; j < colorLUT->outputChannels(); ++j) {
+        for (int j = 0; j < SkColorLookUpTable::kOutputChannels; ++j) {
             result[j][i] = out[j];
         }
     }
     r = SkNf::Load(result[0]);
     g = SkNf::Load(result[1]);
     b = SkNf::Load(result[2]);
-    if (4 == colorLUT->inputChannels()) {
+    if (4 == inputChannels) {
         // we must set the pixel to opaque, as the alpha channel was used
         // as input before this.
         a = 1.f;
@@ -1028,7 +1154,7 @@ STAGE_CTX(gather_i8, const SkImageShaderContext*) {
     SkNi offset = offset_and_ptr(&p, ctx, r, g);
 
     SkNi ix = SkNx_cast<int>(gather(tail, p, offset));
-    from_8888(gather(tail, ctx->ctable->readColors(), ix), &r, &g, &b, &a);
+    from_8888(gather(tail, ctx->ctable, ix), &r, &g, &b, &a);
 }
 STAGE_CTX(gather_g8, const SkImageShaderContext*) {
     const uint8_t* p;
@@ -1069,10 +1195,10 @@ STAGE_CTX(linear_gradient_2stops, const SkPM4f*) {
     SkPM4f c0 = ctx[0],
            dc = ctx[1];
 
-    r = SkNf_fma(t, dc.r(), c0.r());
-    g = SkNf_fma(t, dc.g(), c0.g());
-    b = SkNf_fma(t, dc.b(), c0.b());
-    a = SkNf_fma(t, dc.a(), c0.a());
+    r = SkNf_fma(t, dc.fVec[SkPM4f::R], c0.fVec[SkPM4f::R]);
+    g = SkNf_fma(t, dc.fVec[SkPM4f::G], c0.fVec[SkPM4f::G]);
+    b = SkNf_fma(t, dc.fVec[SkPM4f::B], c0.fVec[SkPM4f::B]);
+    a = SkNf_fma(t, dc.fVec[SkPM4f::A], c0.fVec[SkPM4f::A]);
 }
 
 STAGE_CTX(byte_tables, const void*) {
@@ -1085,6 +1211,323 @@ STAGE_CTX(byte_tables, const void*) {
     a = SkNf_from_byte(gather(tail, tables->a, SkNf_round(255.0f, a)));
 }
 
+// Pipelines that only shuffle 8-bit colors around (e.g. load_8888, srcover, store_8888) don't
+// need float precision.  When every stage has a form here, we run them instead on SkFixed15
+// values, [0,1] as [0x0000,0x8000], packed into 16-bit lanes: twice the pixels per register.
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSSE3 || defined(SK_ARM_HAS_NEON)
+    #define SK_RASTER_PIPELINE_HAS_LOWP
+#endif
+
+#if defined(SK_RASTER_PIPELINE_HAS_LOWP)
+namespace lowp {
+
+    static constexpr int kStride = 8;
+    using F = SkNx<kStride, uint16_t>;
+
+    using Fn = void(SK_VECTORCALL *)(size_t x_tail, void** p, F,F,F,F, F,F,F,F);
+    // x_tail works just like the float pipelines' x_tail, with kStride in place of N.
+
+    static const uint16_t kOne = 0x8000;
+
+    SI F from_byte(const F& v) { return (v << 7) + (v >> 1) + ((v + 1) >> 8); }  // SkFixed15::FromU8
+    SI F   to_byte(const F& v) { return (v - (v >> 8)) >> 7; }                   // SkFixed15::to_u8
+
+    SI F from_float(float f) {
+        f = f < 0.0f ? 0.0f : f > 1.0f ? 1.0f : f;   // Not SkTPin(), which isn't TU-local.
+        return (uint16_t)(f * kOne + 0.5f);
+    }
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSSE3
+    // Saturating, so that e.g. plus_ can't wrap around.  Values above kOne are clamped later.
+    SI F add(const F& x, const F& y) { return _mm_adds_epu16(x.fVec, y.fVec); }
+    SI F sub(const F& x, const F& y) { return _mm_subs_epu16(x.fVec, y.fVec); }
+    SI F mul(const F& x, const F& y) { return _mm_abs_epi16(_mm_mulhrs_epi16(x.fVec, y.fVec)); }
+
+    SI F load_bytes(const uint8_t* ptr) {
+        return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)ptr), _mm_setzero_si128());
+    }
+    SI void store_bytes(uint8_t* ptr, const F& v) {
+        _mm_storel_epi64((__m128i*)ptr, _mm_packus_epi16(v.fVec, v.fVec));
+    }
+
+    SI void load_8888_bytes(const uint32_t* ptr, F* r, F* g, F* b, F* a) {
+        auto _0123 = _mm_loadu_si128((const __m128i*)ptr + 0),
+             _4567 = _mm_loadu_si128((const __m128i*)ptr + 1);
+
+        auto _0415 = _mm_unpacklo_epi8(_0123, _4567),  // r04 g04 b04 a04  r15 g15 b15 a15
+             _2637 = _mm_unpackhi_epi8(_0123, _4567);  // r26 g26 b26 a26  r37 g37 b37 a37
+
+        auto _0246 = _mm_unpacklo_epi8(_0415, _2637),  // r0246 g0246 b0246 a0246
+             _1357 = _mm_unpackhi_epi8(_0415, _2637);  // r1357 g1357 b1357 a1357
+
+        auto rg = _mm_unpacklo_epi8(_0246, _1357),     // r01234567 g01234567
+             ba = _mm_unpackhi_epi8(_0246, _1357);     // b01234567 a01234567
+
+        auto zero = _mm_setzero_si128();
+        *r = _mm_unpacklo_epi8(rg, zero);
+        *g = _mm_unpackhi_epi8(rg, zero);
+        *b = _mm_unpacklo_epi8(ba, zero);
+        *a = _mm_unpackhi_epi8(ba, zero);
+    }
+    SI void store_8888_bytes(uint32_t* ptr, const F& r, const F& g, const F& b, const F& a) {
+        auto rg = _mm_packus_epi16(r.fVec, g.fVec),    // r01234567 g01234567
+             ba = _mm_packus_epi16(b.fVec, a.fVec);    // b01234567 a01234567
+
+        auto rg_01234567 = _mm_unpacklo_epi8(rg, _mm_srli_si128(rg, 8)),  // rg0 rg1 ... rg7
+             ba_01234567 = _mm_unpacklo_epi8(ba, _mm_srli_si128(ba, 8));
+
+        _mm_storeu_si128((__m128i*)ptr + 0, _mm_unpacklo_epi16(rg_01234567, ba_01234567));
+        _mm_storeu_si128((__m128i*)ptr + 1, _mm_unpackhi_epi16(rg_01234567, ba_01234567));
+    }
+#else
+    SI F add(const F& x, const F& y) { return vqaddq_u16(x.fVec, y.fVec); }
+    SI F sub(const F& x, const F& y) { return vqsubq_u16(x.fVec, y.fVec); }
+    SI F mul(const F& x, const F& y) {
+        // See SkFixed15.h for how this works.
+        int16x8_t X = vreinterpretq_s16_u16(x.fVec),
+                  Y = vreinterpretq_s16_u16(y.fVec);
+        return vsraq_n_u16(vreinterpretq_u16_s16(vabsq_s16(vqrdmulhq_s16(X, Y))),
+                           vandq_u16(x.fVec, y.fVec), 15);
+    }
+
+    SI F load_bytes(const uint8_t* ptr) { return vmovl_u8(vld1_u8(ptr)); }
+    SI void store_bytes(uint8_t* ptr, const F& v) { vst1_u8(ptr, vqmovn_u16(v.fVec)); }
+
+    SI void load_8888_bytes(const uint32_t* ptr, F* r, F* g, F* b, F* a) {
+        uint8x8x4_t rgba = vld4_u8((const uint8_t*)ptr);
+        *r = vmovl_u8(rgba.val[0]);
+        *g = vmovl_u8(rgba.val[1]);
+        *b = vmovl_u8(rgba.val[2]);
+        *a = vmovl_u8(rgba.val[3]);
+    }
+    SI void store_8888_bytes(uint32_t* ptr, const F& r, const F& g, const F& b, const F& a) {
+        uint8x8x4_t rgba = {{
+            vqmovn_u16(r.fVec),
+            vqmovn_u16(g.fVec),
+            vqmovn_u16(b.fVec),
+            vqmovn_u16(a.fVec),
+        }};
+        vst4_u8((uint8_t*)ptr, rgba);
+    }
+#endif
+
+    SI F inv(const F& x) { return sub(kOne, x); }
+    SI F lerp(const F& from, const F& to, const F& t) { return add(mul(to, t), mul(from, inv(t))); }
+
+    // Handle the n < kStride tails by going through a buffer on the stack.
+    template <typename T>
+    SI const T* load_tail(size_t tail, const T* src, T buf[kStride]) {
+        if (tail) {
+            memset(buf, 0, kStride*sizeof(T));
+            memcpy(buf, src, tail*sizeof(T));
+            return buf;
+        }
+        return src;
+    }
+    template <typename T>
+    SI void store_tail(size_t tail, const T buf[kStride], T* dst) {
+        if (tail) {
+            memcpy(dst, buf, tail*sizeof(T));
+        }
+    }
+
+    SI void SK_VECTORCALL next(size_t x_tail, void** p, F  r, F  g, F  b, F  a,
+                                                        F dr, F dg, F db, F da) {
+        auto next = (Fn)load_and_increment(&p);
+        next(x_tail,p, r,g,b,a, dr,dg,db,da);
+    }
+
+    SI void SK_VECTORCALL just_return(size_t, void**, F,F,F,F, F,F,F,F) {}
+
+#define LOWP_STAGE(name)                                                                 \
+    static SK_ALWAYS_INLINE void name##_kernel(size_t x, size_t tail,                    \
+                                               F&  r, F&  g, F&  b, F&  a,               \
+                                               F& dr, F& dg, F& db, F& da);              \
+    SI void SK_VECTORCALL name(size_t x_tail, void** p,                                  \
+                               F  r, F  g, F  b, F  a,                                   \
+                               F dr, F dg, F db, F da) {                                 \
+        name##_kernel(x_tail/kStride, x_tail%kStride, r,g,b,a, dr,dg,db,da);             \
+        next(x_tail,p, r,g,b,a, dr,dg,db,da);                                            \
+    }                                                                                    \
+    static SK_ALWAYS_INLINE void name##_kernel(size_t x, size_t tail,                    \
+                                               F&  r, F&  g, F&  b, F&  a,               \
+                                               F& dr, F& dg, F& db, F& da)
+
+#define LOWP_STAGE_CTX(name, Ctx)                                                        \
+    static SK_ALWAYS_INLINE void name##_kernel(Ctx ctx, size_t x, size_t tail,           \
+                                               F&  r, F&  g, F&  b, F&  a,               \
+                                               F& dr, F& dg, F& db, F& da);              \
+    SI void SK_VECTORCALL name(size_t x_tail, void** p,                                  \
+                               F  r, F  g, F  b, F  a,                                   \
+                               F dr, F dg, F db, F da) {                                 \
+        auto ctx = (Ctx)load_and_increment(&p);                                          \
+        name##_kernel(ctx, x_tail/kStride, x_tail%kStride, r,g,b,a, dr,dg,db,da);        \
+        next(x_tail,p, r,g,b,a, dr,dg,db,da);                                            \
+    }                                                                                    \
+    static SK_ALWAYS_INLINE void name##_kernel(Ctx ctx, size_t x, size_t tail,           \
+                                               F&  r, F&  g, F&  b, F&  a,               \
+                                               F& dr, F& dg, F& db, F& da)
+
+#define LOWP_RGBA_XFERMODE(name)                                                        \
+    static SK_ALWAYS_INLINE F name##_kernel(const F& s, const F& sa,                    \
+                                            const F& d, const F& da);                   \
+    SI void SK_VECTORCALL name(size_t x_tail, void** p,                                 \
+                               F  r, F  g, F  b, F  a,                                  \
+                               F dr, F dg, F db, F da) {                                \
+        r = name##_kernel(r,a,dr,da);                                                   \
+        g = name##_kernel(g,a,dg,da);                                                   \
+        b = name##_kernel(b,a,db,da);                                                   \
+        a = name##_kernel(a,a,da,da);                                                   \
+        next(x_tail,p, r,g,b,a, dr,dg,db,da);                                           \
+    }                                                                                   \
+    static SK_ALWAYS_INLINE F name##_kernel(const F& s, const F& sa,                    \
+                                            const F& d, const F& da)
+
+    LOWP_STAGE(move_src_dst) {
+        dr = r;
+        dg = g;
+        db = b;
+        da = a;
+    }
+    LOWP_STAGE(move_dst_src) {
+        r = dr;
+        g = dg;
+        b = db;
+        a = da;
+    }
+    LOWP_STAGE(swap) {
+        SkTSwap(r,dr);
+        SkTSwap(g,dg);
+        SkTSwap(b,db);
+        SkTSwap(a,da);
+    }
+    LOWP_STAGE(swap_rb) { SkTSwap(r,b); }
+
+    LOWP_STAGE(clamp_0) {}  // Our values are unsigned.
+    LOWP_STAGE(clamp_1) {
+        r = F::Min(r, kOne);
+        g = F::Min(g, kOne);
+        b = F::Min(b, kOne);
+        a = F::Min(a, kOne);
+    }
+    LOWP_STAGE(clamp_a) {
+        a = F::Min(a, kOne);
+        r = F::Min(r, a);
+        g = F::Min(g, a);
+        b = F::Min(b, a);
+    }
+
+    LOWP_STAGE(premul) {
+        r = mul(r, a);
+        g = mul(g, a);
+        b = mul(b, a);
+    }
+
+    LOWP_STAGE_CTX(constant_color, const SkPM4f*) {
+        r = from_float(ctx->fVec[SkPM4f::R]);
+        g = from_float(ctx->fVec[SkPM4f::G]);
+        b = from_float(ctx->fVec[SkPM4f::B]);
+        a = from_float(ctx->fVec[SkPM4f::A]);
+    }
+
+    LOWP_STAGE_CTX(scale_1_float, const float*) {
+        auto c = from_float(*ctx);
+        r = mul(r, c);
+        g = mul(g, c);
+        b = mul(b, c);
+        a = mul(a, c);
+    }
+    LOWP_STAGE_CTX(scale_u8, const uint8_t**) {
+        uint8_t buf[kStride];
+        auto c = from_byte(load_bytes(load_tail(tail, *ctx + x, buf)));
+        r = mul(r, c);
+        g = mul(g, c);
+        b = mul(b, c);
+        a = mul(a, c);
+    }
+    LOWP_STAGE_CTX(lerp_1_float, const float*) {
+        auto c = from_float(*ctx);
+        r = lerp(dr, r, c);
+        g = lerp(dg, g, c);
+        b = lerp(db, b, c);
+        a = lerp(da, a, c);
+    }
+    LOWP_STAGE_CTX(lerp_u8, const uint8_t**) {
+        uint8_t buf[kStride];
+        auto c = from_byte(load_bytes(load_tail(tail, *ctx + x, buf)));
+        r = lerp(dr, r, c);
+        g = lerp(dg, g, c);
+        b = lerp(db, b, c);
+        a = lerp(da, a, c);
+    }
+
+    LOWP_STAGE_CTX(load_a8, const uint8_t**) {
+        uint8_t buf[kStride];
+        r = g = b = 0;
+        a = from_byte(load_bytes(load_tail(tail, *ctx + x, buf)));
+    }
+    LOWP_STAGE_CTX(store_a8, uint8_t**) {
+        auto ptr = *ctx + x;
+        uint8_t buf[kStride];
+        store_bytes(tail ? buf : ptr, to_byte(a));
+        store_tail(tail, buf, ptr);
+    }
+
+    LOWP_STAGE_CTX(load_8888, const uint32_t**) {
+        uint32_t buf[kStride];
+        load_8888_bytes(load_tail(tail, *ctx + x, buf), &r, &g, &b, &a);
+        r = from_byte(r);
+        g = from_byte(g);
+        b = from_byte(b);
+        a = from_byte(a);
+    }
+    LOWP_STAGE_CTX(store_8888, uint32_t**) {
+        auto ptr = *ctx + x;
+        uint32_t buf[kStride];
+        store_8888_bytes(tail ? buf : ptr, to_byte(r), to_byte(g), to_byte(b), to_byte(a));
+        store_tail(tail, buf, ptr);
+    }
+
+    LOWP_RGBA_XFERMODE(clear)    { return 0; }
+    LOWP_RGBA_XFERMODE(srcatop)  { return add(mul(s, da), mul(d, inv(sa))); }
+    LOWP_RGBA_XFERMODE(srcin)    { return mul(s, da); }
+    LOWP_RGBA_XFERMODE(srcout)   { return mul(s, inv(da)); }
+    LOWP_RGBA_XFERMODE(srcover)  { return add(s, mul(d, inv(sa))); }
+    LOWP_RGBA_XFERMODE(dstatop)  { return srcatop_kernel(d,da,s,sa); }
+    LOWP_RGBA_XFERMODE(dstin)    { return srcin_kernel  (d,da,s,sa); }
+    LOWP_RGBA_XFERMODE(dstout)   { return srcout_kernel (d,da,s,sa); }
+    LOWP_RGBA_XFERMODE(dstover)  { return srcover_kernel(d,da,s,sa); }
+
+    LOWP_RGBA_XFERMODE(modulate) { return mul(s, d); }
+    LOWP_RGBA_XFERMODE(multiply) { return add(add(mul(s, inv(da)), mul(d, inv(sa))), mul(s, d)); }
+    LOWP_RGBA_XFERMODE(plus_)    { return add(s, d); }
+    LOWP_RGBA_XFERMODE(screen)   { return add(s, mul(d, inv(s))); }  // s + d - s*d
+    LOWP_RGBA_XFERMODE(xor_)     { return add(mul(s, inv(da)), mul(d, inv(sa))); }
+
+#undef LOWP_STAGE
+#undef LOWP_STAGE_CTX
+#undef LOWP_RGBA_XFERMODE
+
+    // Returns nullptr if this stage can't run in lowp.
+    SI Fn enum_to_Fn(SkRasterPipeline::StockStage st) {
+        switch (st) {
+        #define M(stage) case SkRasterPipeline::stage: return stage;
+            M(move_src_dst) M(move_dst_src) M(swap) M(swap_rb)
+            M(clamp_0) M(clamp_1) M(clamp_a) M(premul)
+            M(constant_color)
+            M(scale_1_float) M(scale_u8) M(lerp_1_float) M(lerp_u8)
+            M(load_a8) M(store_a8) M(load_8888) M(store_8888)
+            M(clear) M(srcatop) M(srcin) M(srcout) M(srcover)
+            M(dstatop) M(dstin) M(dstout) M(dstover)
+            M(modulate) M(multiply) M(plus_) M(screen) M(xor_)
+        #undef M
+            default: return nullptr;
+        }
+    }
+
+}  // namespace lowp
+#endif//defined(SK_RASTER_PIPELINE_HAS_LOWP)
+
 SI Fn enum_to_Fn(SkRasterPipeline::StockStage st) {
     switch (st) {
     #define M(stage) case SkRasterPipeline::stage: return stage;
@@ -1150,21 +1593,91 @@ namespace {
 
         void** fProgram;
     };
+
+#if defined(SK_RASTER_PIPELINE_HAS_LOWP)
+    // Returns false, leaving program untouched, if any stage has no lowp form.
+    static bool build_lowp_program(void** program,
+                                   const SkRasterPipeline::Stage* stages, int nstages) {
+        for (int i = 0; i < nstages; i++) {
+            if (!lowp::enum_to_Fn(stages[i].stage)) {
+                return false;
+            }
+        }
+        for (int i = 0; i < nstages; i++) {
+            *program++ = (void*)lowp::enum_to_Fn(stages[i].stage);
+            if (stages[i].ctx) {
+                *program++ = stages[i].ctx;
+            }
+        }
+        *program++ = (void*)lowp::just_return;
+        return true;
+    }
+
+    static void run_lowp_program(void** program, size_t x, size_t n) {
+        lowp::F u;
+
+        auto start = (lowp::Fn)load_and_increment(&program);
+        while (n >= lowp::kStride) {
+            start(x*lowp::kStride, program, u,u,u,u, u,u,u,u);
+            x += lowp::kStride;
+            n -= lowp::kStride;
+        }
+        if (n) {
+            start(x*lowp::kStride+n, program, u,u,u,u, u,u,u,u);
+        }
+    }
+
+    struct CompiledLowp {
+        CompiledLowp(void** program, int slots) {
+            fProgram = (void**)sk_malloc_throw(slots * sizeof(void*));
+            memcpy(fProgram, program, slots * sizeof(void*));
+            fSlots = slots;
+        }
+        ~CompiledLowp() { sk_free(fProgram); }
+
+        CompiledLowp(const CompiledLowp& o) : CompiledLowp(o.fProgram, o.fSlots) {}
+
+        void operator()(size_t x, size_t n) {
+            run_lowp_program(fProgram, x, n);
+        }
+
+        void** fProgram;
+        int    fSlots;
+    };
+#endif
 }
 
 namespace SK_OPTS_NS {
 
+    static const int kStackMax = 256;
+
     SI std::function<void(size_t, size_t)>
-    compile_pipeline(const SkRasterPipeline::Stage* stages, int nstages) {
+    compile_pipeline(const SkRasterPipeline::Stage* stages, int nstages, bool allowLowp) {
+    #if defined(SK_RASTER_PIPELINE_HAS_LOWP)
+        // Worst case is nstages stages with nstages context pointers, and just_return.
+        if (2*nstages+1 <= kStackMax && allowLowp) {
+            void* program[kStackMax];
+            if (build_lowp_program(program, stages, nstages)) {
+                int slots = 0;
+                while (program[slots++] != (void*)lowp::just_return);
+                return CompiledLowp{program, slots};
+            }
+        }
+    #endif
         return Compiled{stages,nstages};
     }
 
     SI void run_pipeline(size_t x, size_t n,
-                         const SkRasterPipeline::Stage* stages, int nstages) {
-        static const int kStackMax = 256;
+                         const SkRasterPipeline::Stage* stages, int nstages, bool allowLowp) {
         // Worst case is nstages stages with nstages context pointers, and just_return.
         if (2*nstages+1 <= kStackMax) {
             void* program[kStackMax];
+        #if defined(SK_RASTER_PIPELINE_HAS_LOWP)
+            if (allowLowp && build_lowp_program(program, stages, nstages)) {
+                run_lowp_program(program, x,n);
+                return;
+            }
+        #endif
             build_program(program, stages, nstages);
             run_program(program, x,n);
         } else {
@@ -1179,5 +1692,6 @@ namespace SK_OPTS_NS {
 #undef STAGE_CTX
 #undef RGBA_XFERMODE
 #undef RGB_XFERMODE
+#undef SK_RASTER_PIPELINE_HAS_LOWP
 
 #endif//SkRasterPipeline_opts_DEFINED
@@ -166,6 +166,81 @@ static void inverted_CMYK_to_BGR1_portable(uint32_t* dst, const void* vsrc, int
     }
 }
 
+// 16-bit channels are stored big-endian.  We keep the first, most significant byte of each.
+template <bool kSwapRB>
+static void RGB16_to_RGB1_portable_should_swapRB(uint32_t dst[], const void* vsrc, int count) {
+    const uint8_t* src = (const uint8_t*)vsrc;
+    for (int i = 0; i < count; i++) {
+        uint8_t r = src[0],
+                g = src[2],
+                b = src[4];
+        src += 6;
+        if (kSwapRB) {
+            SkTSwap(r, b);
+        }
+        dst[i] = (uint32_t)0xFF << 24
+               | (uint32_t)   b << 16
+               | (uint32_t)   g <<  8
+               | (uint32_t)   r <<  0;
+    }
+}
+
+template <bool kSwapRB>
+static void RGBA16_to_RGBA_portable_should_swapRB(uint32_t dst[], const void* vsrc, int count) {
+    const uint8_t* src = (const uint8_t*)vsrc;
+    for (int i = 0; i < count; i++) {
+        uint8_t r = src[0],
+                g = src[2],
+                b = src[4],
+                a = src[6];
+        src += 8;
+        if (kSwapRB) {
+            SkTSwap(r, b);
+        }
+        dst[i] = (uint32_t)a << 24
+               | (uint32_t)b << 16
+               | (uint32_t)g <<  8
+               | (uint32_t)r <<  0;
+    }
+}
+
+static void index8_to_8888_portable(uint32_t dst[], const uint8_t src[], int count,
+                                    const uint32_t table[]) {
+    for (int i = 0; i < count; i++) {
+        dst[i] = table[src[i]];
+    }
+}
+
+template <int kBPP>
+static void gather_pixels_portable(uint8_t* dst, const uint8_t* src, int count, int stride) {
+    // A fixed size lets the compiler turn each memcpy into a load and a store.
+    for (int i = 0; i < count; i++) {
+        memcpy(dst, src, kBPP);
+        dst += kBPP;
+        src += stride;
+    }
+}
+
+static void gather_pixels_portable(void* vdst, const uint8_t* src, int count, int bpp,
+                                   int stride) {
+    uint8_t* dst = (uint8_t*)vdst;
+    switch (bpp) {
+        case 1: gather_pixels_portable<1>(dst, src, count, stride); break;
+        case 2: gather_pixels_portable<2>(dst, src, count, stride); break;
+        case 3: gather_pixels_portable<3>(dst, src, count, stride); break;
+        case 4: gather_pixels_portable<4>(dst, src, count, stride); break;
+        case 6: gather_pixels_portable<6>(dst, src, count, stride); break;
+        case 8: gather_pixels_portable<8>(dst, src, count, stride); break;
+        default:
+            for (int i = 0; i < count; i++) {
+                memcpy(dst, src, bpp);
+                dst += bpp;
+                src += stride;
+            }
+            break;
+    }
+}
+
 #if defined(SK_ARM_HAS_NEON)
 
 // Rounded divide by 255, (x + 127) / 255
@@ -490,6 +565,62 @@ static void inverted_CMYK_to_BGR1(uint32_t dst[], const void* src, int count) {
     inverted_cmyk_to<kBGR1>(dst, src, count);
 }
 
+// Narrowing a little-endian load of a big-endian 16-bit channel keeps its most significant byte.
+template <bool kSwapRB>
+static void RGB16_to_RGB1_should_swapRB(uint32_t dst[], const void* vsrc, int count) {
+    const uint8_t* src = (const uint8_t*) vsrc;
+    while (count >= 8) {
+        // Load 8 pixels.
+        uint16x8x3_t rgb = vld3q_u16((const uint16_t*) src);
+
+        uint8x8x4_t rgba;
+        rgba.val[0] = vmovn_u16(rgb.val[kSwapRB ? 2 : 0]);
+        rgba.val[1] = vmovn_u16(rgb.val[1]);
+        rgba.val[2] = vmovn_u16(rgb.val[kSwapRB ? 0 : 2]);
+        rgba.val[3] = vdup_n_u8(0xFF);
+
+        // Store 8 pixels.
+        vst4_u8((uint8_t*) dst, rgba);
+        src += 8*6;
+        dst += 8;
+        count -= 8;
+    }
+
+    RGB16_to_RGB1_portable_should_swapRB<kSwapRB>(dst, src, count);
+}
+
+template <bool kSwapRB>
+static void RGBA16_to_RGBA_should_swapRB(uint32_t dst[], const void* vsrc, int count) {
+    const uint8_t* src = (const uint8_t*) vsrc;
+    while (count >= 8) {
+        // Load 8 pixels.
+        uint16x8x4_t rgba16 = vld4q_u16((const uint16_t*) src);
+
+        uint8x8x4_t rgba;
+        rgba.val[0] = vmovn_u16(rgba16.val[kSwapRB ? 2 : 0]);
+        rgba.val[1] = vmovn_u16(rgba16.val[1]);
+        rgba.val[2] = vmovn_u16(rgba16.val[kSwapRB ? 0 : 2]);
+        rgba.val[3] = vmovn_u16(rgba16.val[3]);
+
+        // Store 8 pixels.
+        vst4_u8((uint8_t*) dst, rgba);
+        src += 8*8;
+        dst += 8;
+        count -= 8;
+    }
+
+    RGBA16_to_RGBA_portable_should_swapRB<kSwapRB>(dst, src, count);
+}
+
+static void index8_to_8888(uint32_t dst[], const uint8_t src[], int count,
+                           const uint32_t table[]) {
+    index8_to_8888_portable(dst, src, count, table);
+}
+
+static void gather_pixels(void* dst, const uint8_t* src, int count, int bpp, int stride) {
+    gather_pixels_portable(dst, src, count, bpp, stride);
+}
+
 #elif SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSSE3
 
 // Scale a byte by another.
@@ -502,6 +633,15 @@ static __m128i scale(__m128i x, __m128i y) {
     return _mm_mulhi_epu16(_mm_add_epi16(_mm_mullo_epi16(x, y), _128), _257);
 }
 
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SKX
+// Same as above, 32 lanes at a time.
+static __m512i scale(__m512i x, __m512i y) {
+    const __m512i _128 = _mm512_set1_epi16(128);
+    const __m512i _257 = _mm512_set1_epi16(257);
+    return _mm512_mulhi_epu16(_mm512_add_epi16(_mm512_mullo_epi16(x, y), _128), _257);
+}
+#endif
+
 template <bool kSwapRB>
 static void premul_should_swapRB(uint32_t* dst, const void* vsrc, int count) {
     auto src = (const uint32_t*)vsrc;
@@ -539,6 +679,33 @@ static void premul_should_swapRB(uint32_t* dst, const void* vsrc, int count) {
         *hi = _mm_unpackhi_epi16(rg, ba);                         // RGBARGBA RGBARGBA
     };
 
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SKX
+    // With AVX-512 we skip the planar detour and work on 16-bit interlaced pixels directly,
+    // scaling each color by its pixel's alpha and alpha itself by 255, which leaves it unchanged.
+    const __m512i zeros  = _mm512_setzero_si512(),
+                  opaque = _mm512_set1_epi64(0x00FF000000000000),  // _ _ _ 255 in each pixel
+                  swapRB = _mm512_broadcast_i32x4(
+                          _mm_setr_epi8(2,1,0,3, 6,5,4,7, 10,9,8,11, 14,13,12,15));
+    auto premul = [&](__m512i px) {                               // r_g_b_a_ R_G_B_A_
+        __m512i a = _mm512_shufflehi_epi16(_mm512_shufflelo_epi16(px, 0xFF), 0xFF);
+        return scale(px, _mm512_or_si512(a, opaque));             // a_a_a_1_ A_A_A_1_
+    };
+
+    while (count >= 16) {
+        __m512i px = _mm512_loadu_si512(src);
+        if (kSwapRB) {
+            px = _mm512_shuffle_epi8(px, swapRB);
+        }
+        px = _mm512_packus_epi16(premul(_mm512_unpacklo_epi8(px, zeros)),
+                                 premul(_mm512_unpackhi_epi8(px, zeros)));
+        _mm512_storeu_si512(dst, px);
+
+        src += 16;
+        dst += 16;
+        count -= 16;
+    }
+#endif
+
     while (count >= 8) {
         __m128i lo = _mm_loadu_si128((const __m128i*) (src + 0)),
                 hi = _mm_loadu_si128((const __m128i*) (src + 4));
@@ -583,6 +750,19 @@ static void RGBA_to_BGRA(uint32_t* dst, const void* vsrc, int count) {
     auto src = (const uint32_t*)vsrc;
     const __m128i swapRB = _mm_setr_epi8(2,1,0,3, 6,5,4,7, 10,9,8,11, 14,13,12,15);
 
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SKX
+    const __m512i swapRB_x4 = _mm512_broadcast_i32x4(swapRB);
+    while (count >= 16) {
+        __m512i rgba = _mm512_loadu_si512(src);
+        __m512i bgra = _mm512_shuffle_epi8(rgba, swapRB_x4);
+        _mm512_storeu_si512(dst, bgra);
+
+        src += 16;
+        dst += 16;
+        count -= 16;
+    }
+#endif
+
     while (count >= 4) {
         __m128i rgba = _mm_loadu_si128((const __m128i*) src);
         __m128i bgra = _mm_shuffle_epi8(rgba, swapRB);
@@ -797,6 +977,125 @@ static void inverted_CMYK_to_BGR1(uint32_t dst[], const void* src, int count) {
     inverted_cmyk_to<kBGR1>(dst, src, count);
 }
 
+// 16-bit channels are stored big-endian.  We shuffle out the first, most significant byte of each.
+template <bool kSwapRB>
+static void RGB16_to_RGB1_should_swapRB(uint32_t dst[], const void* vsrc, int count) {
+    const uint8_t* src = (const uint8_t*) vsrc;
+
+    const __m128i alphaMask = _mm_set1_epi32(0xFF000000);
+    const uint8_t Z = 0xFF;  // _mm_shuffle_epi8() zeroes these bytes.
+    __m128i lo, hi;
+    if (kSwapRB) {
+        lo = _mm_setr_epi8(4,2,0,Z, 10,8,6,Z, Z,Z,Z,Z, Z,Z,Z,Z);
+        hi = _mm_setr_epi8(Z,Z,Z,Z, Z,Z,Z,Z, 8,6,4,Z, 14,12,10,Z);
+    } else {
+        lo = _mm_setr_epi8(0,2,4,Z, 6,8,10,Z, Z,Z,Z,Z, Z,Z,Z,Z);
+        hi = _mm_setr_epi8(Z,Z,Z,Z, Z,Z,Z,Z, 4,6,8,Z, 10,12,14,Z);
+    }
+
+    while (count >= 4) {
+        // Four pixels are 24 bytes.  The first load holds pixels 0 and 1, the second,
+        // starting 8 bytes in, holds pixels 2 and 3.
+        __m128i a = _mm_loadu_si128((const __m128i*) (src + 0)),
+                b = _mm_loadu_si128((const __m128i*) (src + 8));
+
+        __m128i rgba = _mm_or_si128(_mm_shuffle_epi8(a, lo), _mm_shuffle_epi8(b, hi));
+        _mm_storeu_si128((__m128i*) dst, _mm_or_si128(rgba, alphaMask));
+
+        src += 4*6;
+        dst += 4;
+        count -= 4;
+    }
+
+    RGB16_to_RGB1_portable_should_swapRB<kSwapRB>(dst, src, count);
+}
+
+template <bool kSwapRB>
+static void RGBA16_to_RGBA_should_swapRB(uint32_t dst[], const void* vsrc, int count) {
+    const uint8_t* src = (const uint8_t*) vsrc;
+
+    const uint8_t Z = 0xFF;  // _mm_shuffle_epi8() zeroes these bytes.
+    __m128i lo, hi;
+    if (kSwapRB) {
+        lo = _mm_setr_epi8(4,2,0,6, 12,10,8,14, Z,Z,Z,Z, Z,Z,Z,Z);
+        hi = _mm_setr_epi8(Z,Z,Z,Z, Z,Z,Z,Z, 4,2,0,6, 12,10,8,14);
+    } else {
+        lo = _mm_setr_epi8(0,2,4,6, 8,10,12,14, Z,Z,Z,Z, Z,Z,Z,Z);
+        hi = _mm_setr_epi8(Z,Z,Z,Z, Z,Z,Z,Z, 0,2,4,6, 8,10,12,14);
+    }
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SKX
+    // Each 128-bit lane narrows its two pixels into its low 8 bytes, then we pull those
+    // halves out of both vectors in order.
+    const __m512i narrow = _mm512_broadcast_i32x4(lo),
+                  halves = _mm512_setr_epi64(0,2,4,6, 8,10,12,14);
+    while (count >= 16) {
+        __m512i a = _mm512_shuffle_epi8(_mm512_loadu_si512(src +  0), narrow),
+                b = _mm512_shuffle_epi8(_mm512_loadu_si512(src + 64), narrow);
+        _mm512_storeu_si512(dst, _mm512_permutex2var_epi64(a, halves, b));
+
+        src += 16*8;
+        dst += 16;
+        count -= 16;
+    }
+#endif
+
+    while (count >= 4) {
+        __m128i a = _mm_loadu_si128((const __m128i*) (src +  0)),
+                b = _mm_loadu_si128((const __m128i*) (src + 16));
+
+        _mm_storeu_si128((__m128i*) dst, _mm_or_si128(_mm_shuffle_epi8(a, lo),
+                                                      _mm_shuffle_epi8(b, hi)));
+
+        src += 4*8;
+        dst += 4;
+        count -= 4;
+    }
+
+    RGBA16_to_RGBA_portable_should_swapRB<kSwapRB>(dst, src, count);
+}
+
+static void index8_to_8888(uint32_t dst[], const uint8_t src[], int count,
+                           const uint32_t table[]) {
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SKX
+    while (count >= 16) {
+        __m512i indices = _mm512_cvtepu8_epi32(_mm_loadu_si128((const __m128i*) src));
+        _mm512_storeu_si512(dst, _mm512_i32gather_epi32(indices, (const int*) table, 4));
+
+        src += 16;
+        dst += 16;
+        count -= 16;
+    }
+#endif
+    index8_to_8888_portable(dst, src, count, table);
+}
+
+static void gather_pixels(void* vdst, const uint8_t* src, int count, int bpp, int stride) {
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SKX
+    // Pixels of 4 and 8 bytes can be gathered whole, without reading past any of them.
+    if (4 == bpp || 8 == bpp) {
+        const __m512i offsets = _mm512_mullo_epi32(_mm512_set1_epi32(stride),
+                _mm512_setr_epi32(0,1,2,3, 4,5,6,7, 8,9,10,11, 12,13,14,15));
+        uint8_t* dst = (uint8_t*) vdst;
+        while (count >= 16) {
+            if (4 == bpp) {
+                _mm512_storeu_si512(dst, _mm512_i32gather_epi32(offsets, src, 1));
+            } else {
+                _mm512_storeu_si512(dst + 0,
+                        _mm512_i32gather_epi64(_mm512_castsi512_si256(offsets), src, 1));
+                _mm512_storeu_si512(dst + 64,
+                        _mm512_i32gather_epi64(_mm512_extracti64x4_epi64(offsets, 1), src, 1));
+            }
+            src += 16*stride;
+            dst += 16*bpp;
+            count -= 16;
+        }
+        vdst = dst;
+    }
+#endif
+    gather_pixels_portable(vdst, src, count, bpp, stride);
+}
+
 #else
 
 static void RGBA_to_rgbA(uint32_t* dst, const void* src, int count) {
@@ -839,8 +1138,54 @@ static void inverted_CMYK_to_BGR1(uint32_t dst[], const void* src, int count) {
     inverted_CMYK_to_BGR1_portable(dst, src, count);
 }
 
+template <bool kSwapRB>
+static void RGB16_to_RGB1_should_swapRB(uint32_t dst[], const void* src, int count) {
+    RGB16_to_RGB1_portable_should_swapRB<kSwapRB>(dst, src, count);
+}
+
+template <bool kSwapRB>
+static void RGBA16_to_RGBA_should_swapRB(uint32_t dst[], const void* src, int count) {
+    RGBA16_to_RGBA_portable_should_swapRB<kSwapRB>(dst, src, count);
+}
+
+static void index8_to_8888(uint32_t dst[], const uint8_t src[], int count,
+                           const uint32_t table[]) {
+    index8_to_8888_portable(dst, src, count, table);
+}
+
+static void gather_pixels(void* dst, const uint8_t* src, int count, int bpp, int stride) {
+    gather_pixels_portable(dst, src, count, bpp, stride);
+}
+
 #endif
 
+static void RGB16_to_RGB1(uint32_t dst[], const void* src, int count) {
+    RGB16_to_RGB1_should_swapRB<false>(dst, src, count);
+}
+
+static void RGB16_to_BGR1(uint32_t dst[], const void* src, int count) {
+    RGB16_to_RGB1_should_swapRB<true>(dst, src, count);
+}
+
+static void RGBA16_to_RGBA(uint32_t dst[], const void* src, int count) {
+    RGBA16_to_RGBA_should_swapRB<false>(dst, src, count);
+}
+
+static void RGBA16_to_BGRA(uint32_t dst[], const void* src, int count) {
+    RGBA16_to_RGBA_should_swapRB<true>(dst, src, count);
+}
+
+// Narrow, then premultiply in place while the row is still in cache.
+static void RGBA16_to_rgbA(uint32_t dst[], const void* src, int count) {
+    RGBA16_to_RGBA(dst, src, count);
+    RGBA_to_rgbA(dst, dst, count);
+}
+
+static void RGBA16_to_bgrA(uint32_t dst[], const void* src, int count) {
+    RGBA16_to_RGBA(dst, src, count);
+    RGBA_to_bgrA(dst, dst, count);
+}
+
 }
 
 #endif // SkSwizzler_opts_DEFINED
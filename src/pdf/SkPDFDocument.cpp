@@ -12,6 +12,7 @@
 #include "SkPDFDocument.h"
 #include "SkPDFUtils.h"
 #include "SkStream.h"
+#include "SkTaskGroup.h"
 
 SkPDFObjectSerializer::SkPDFObjectSerializer() : fBaseOffset(0), fNextToBeSerialized(0) {}
 
@@ -49,8 +50,30 @@ void SkPDFObjectSerializer::serializeHeader(SkWStream* wStream,
 #undef SKPDF_MAGIC
 
 // Serialize all objects in the fObjNumMap that have not yet been serialized;
-void SkPDFObjectSerializer::serializeObjects(SkWStream* wStream) {
+void SkPDFObjectSerializer::serializeObjects(SkWStream* wStream, bool parallel) {
     const SkTArray<sk_sp<SkPDFObject>>& objects = fObjNumMap.objects();
+    const int first = fNextToBeSerialized,
+              count = objects.count() - first;
+    if (parallel && count > 1) {
+        // Emitting an object is where deflating and image encoding happen, so emit
+        // each object into its own buffer on other threads, then write them in order.
+        std::unique_ptr<SkDynamicMemoryWStream[]> buffers(new SkDynamicMemoryWStream[count]);
+        SkTaskGroup().batch(count, [&](int i) {
+            objects[first + i]->emitObject(&buffers[i], fObjNumMap);
+        });
+        for (int i = 0; i < count; ++i) {
+            SkASSERT(fOffsets.count() == fNextToBeSerialized);
+            fOffsets.push(this->offset(wStream));
+            wStream->writeDecAsText(fNextToBeSerialized + 1);  // Skip object 0.
+            wStream->writeText(" 0 obj\n");
+            buffers[i].writeToStream(wStream);
+            wStream->writeText("\nendobj\n");
+            buffers[i].reset();
+            objects[fNextToBeSerialized]->drop();
+            ++fNextToBeSerialized;
+        }
+        return;
+    }
     while (fNextToBeSerialized < objects.count()) {
         SkPDFObject* object = objects[fNextToBeSerialized].get();
         int32_t index = fNextToBeSerialized + 1;  // Skip object 0.
@@ -190,7 +213,9 @@ SkPDFDocument::~SkPDFDocument() {
 
 void SkPDFDocument::serialize(const sk_sp<SkPDFObject>& object) {
     fObjectSerializer.addObjectRecursively(object);
-    fObjectSerializer.serializeObjects(this->getStream());
+    if (!fMetadata.fParallel) {
+        fObjectSerializer.serializeObjects(this->getStream());
+    }
 }
 
 SkCanvas* SkPDFDocument::onBeginPage(SkScalar width, SkScalar height,
@@ -236,7 +261,10 @@ void SkPDFDocument::onEndPage() {
     if (annotations->size() > 0) {
         page->insertObject("Annots", std::move(annotations));
     }
-    auto contentObject = sk_make_sp<SkPDFStream>(fPageDevice->content());
+    // When serializing in parallel, leave the page contents to be compressed in onClose().
+    auto contentObject = fMetadata.fParallel
+                       ? SkPDFStream::MakeDeferred(fPageDevice->content())
+                       : sk_make_sp<SkPDFStream>(fPageDevice->content());
     this->serialize(contentObject);
     page->insertObjRef("Contents", std::move(contentObject));
     fPageDevice->appendDestinations(fDests.get(), page.get());
@@ -423,9 +451,16 @@ void SkPDFDocument::onClose(SkWStream* stream) {
 
     // Build font subsetting info before calling addObjectRecursively().
     SkPDFCanon* canon = &fCanon;
-    fFonts.foreach([canon](SkPDFFont* p){ p->getFontSubset(canon); });
+    if (fMetadata.fParallel) {
+        // Every font already has its metrics in the canon, so getFontSubset() only reads it.
+        SkTDArray<SkPDFFont*> fonts;
+        fFonts.foreach([&fonts](SkPDFFont* p){ fonts.push(p); });
+        SkTaskGroup().batch(fonts.count(), [&](int i) { fonts[i]->getFontSubset(canon); });
+    } else {
+        fFonts.foreach([canon](SkPDFFont* p){ p->getFontSubset(canon); });
+    }
     fObjectSerializer.addObjectRecursively(docCatalog);
-    fObjectSerializer.serializeObjects(this->getStream());
+    fObjectSerializer.serializeObjects(this->getStream(), fMetadata.fParallel);
     fObjectSerializer.serializeFooter(this->getStream(), docCatalog, fID);
     this->reset();
 }
@@ -34,7 +34,7 @@ struct SkPDFObjectSerializer : SkNoncopyable {
     ~SkPDFObjectSerializer();
     void addObjectRecursively(const sk_sp<SkPDFObject>&);
     void serializeHeader(SkWStream*, const SkDocument::PDFMetadata&);
-    void serializeObjects(SkWStream*);
+    void serializeObjects(SkWStream*, bool parallel = false);
     void serializeFooter(SkWStream*, const sk_sp<SkPDFObject>, sk_sp<SkPDFObject>);
     int32_t offset(SkWStream*);
 };
@@ -64,6 +64,9 @@ public:
 
        It might go without saying that objects should not be changed
        after calling serialize, since those changes will be too late.
+
+       If the document is parallel, this only numbers the objects; they
+       are all serialized together when the document is closed.
      */
     void serialize(const sk_sp<SkPDFObject>&);
     SkPDFCanon* canon() { return &fCanon; }
@@ -506,18 +506,26 @@ void SkPDFSharedStream::addResources(
 
 ////////////////////////////////////////////////////////////////////////////////
 
-SkPDFStream:: SkPDFStream(sk_sp<SkData> data) {
+SkPDFStream:: SkPDFStream(sk_sp<SkData> data) : fDeferred(false) {
     this->setData(skstd::make_unique<SkMemoryStream>(std::move(data)));
 }
 
-SkPDFStream::SkPDFStream(std::unique_ptr<SkStreamAsset> stream) {
+SkPDFStream::SkPDFStream(std::unique_ptr<SkStreamAsset> stream) : fDeferred(false) {
     this->setData(std::move(stream));
 }
 
-SkPDFStream::SkPDFStream() {}
+SkPDFStream::SkPDFStream() : fDeferred(false) {}
 
 SkPDFStream::~SkPDFStream() {}
 
+sk_sp<SkPDFStream> SkPDFStream::MakeDeferred(std::unique_ptr<SkStreamAsset> stream) {
+    SkASSERT(stream && stream->hasLength());
+    sk_sp<SkPDFStream> pdfStream(new SkPDFStream);
+    pdfStream->fCompressedData = std::move(stream);
+    pdfStream->fDeferred = true;
+    return pdfStream;
+}
+
 void SkPDFStream::addResources(SkPDFObjNumMap* catalog) const {
     SkASSERT(fCompressedData);
     fDict.addResources(catalog);
@@ -528,28 +536,17 @@ void SkPDFStream::drop() {
     fDict.drop();
 }
 
-void SkPDFStream::emitObject(SkWStream* stream,
-                             const SkPDFObjNumMap& objNumMap) const {
-    SkASSERT(fCompressedData);
-    fDict.emitObject(stream, objNumMap);
-    // duplicate (a cheap operation) preserves const on fCompressedData.
-    std::unique_ptr<SkStreamAsset> dup(fCompressedData->duplicate());
-    SkASSERT(dup);
-    SkASSERT(dup->hasLength());
-    stream->writeText(" stream\n");
-    stream->writeStream(dup.get(), dup->getLength());
-    stream->writeText("\nendstream");
-}
-
-void SkPDFStream::setData(std::unique_ptr<SkStreamAsset> stream) {
-    SkASSERT(!fCompressedData);  // Only call this function once.
+// Compresses the stream if that makes it smaller, and adds the matching
+// Filter and Length entries to dict.
+static std::unique_ptr<SkStreamAsset> compress_stream(std::unique_ptr<SkStreamAsset> stream,
+                                                      SkPDFDict* dict) {
     SkASSERT(stream);
     // Code assumes that the stream starts at the beginning.
 
     #ifdef SK_PDF_LESS_COMPRESSION
-    fCompressedData = std::move(stream);
-    SkASSERT(fCompressedData && fCompressedData->hasLength());
-    fDict.insertInt("Length", fCompressedData->getLength());
+    SkASSERT(stream->hasLength());
+    dict->insertInt("Length", stream->getLength());
+    return stream;
     #else
 
     SkASSERT(stream->hasLength());
@@ -564,16 +561,47 @@ void SkPDFStream::setData(std::unique_ptr<SkStreamAsset> stream) {
 
     if (originalLength <= compressedLength + strlen("/Filter_/FlateDecode_")) {
         SkAssertResult(stream->rewind());
-        fCompressedData = std::move(stream);
-        fDict.insertInt("Length", originalLength);
-        return;
+        dict->insertInt("Length", originalLength);
+        return stream;
     }
-    fCompressedData.reset(compressedData.detachAsStream());
-    fDict.insertName("Filter", "FlateDecode");
-    fDict.insertInt("Length", compressedLength);
+    dict->insertName("Filter", "FlateDecode");
+    dict->insertInt("Length", compressedLength);
+    return std::unique_ptr<SkStreamAsset>(compressedData.detachAsStream());
     #endif
 }
 
+void SkPDFStream::emitObject(SkWStream* stream,
+                             const SkPDFObjNumMap& objNumMap) const {
+    SkASSERT(fCompressedData);
+    // duplicate (a cheap operation) preserves const on fCompressedData.
+    std::unique_ptr<SkStreamAsset> dup(fCompressedData->duplicate());
+    SkASSERT(dup);
+    if (fDeferred) {
+        // setData() would have put Filter and Length before anything else.
+        SkPDFDict lengthDict;
+        dup = compress_stream(std::move(dup), &lengthDict);
+        stream->writeText("<<");
+        lengthDict.emitAll(stream, objNumMap);
+        if (fDict.size() > 0) {
+            stream->writeText("\n");
+            fDict.emitAll(stream, objNumMap);
+        }
+        stream->writeText(">>");
+    } else {
+        fDict.emitObject(stream, objNumMap);
+    }
+    SkASSERT(dup->hasLength());
+    stream->writeText(" stream\n");
+    stream->writeStream(dup.get(), dup->getLength());
+    stream->writeText("\nendstream");
+}
+
+void SkPDFStream::setData(std::unique_ptr<SkStreamAsset> stream) {
+    SkASSERT(!fCompressedData);  // Only call this function once.
+    fCompressedData = compress_stream(std::move(stream), &fDict);
+    SkASSERT(fCompressedData && fCompressedData->hasLength());
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 bool SkPDFObjNumMap::addObject(SkPDFObject* obj) {
@@ -329,6 +329,12 @@ public:
     explicit SkPDFStream(std::unique_ptr<SkStreamAsset> stream);
     virtual ~SkPDFStream();
 
+    /** Create a PDF stream that keeps its data uncompressed until
+     *  emitObject() is called.  SkPDFDocument uses this to compress
+     *  many streams at once on different threads.  The emitted bytes
+     *  are the same as for an eagerly compressed stream. */
+    static sk_sp<SkPDFStream> MakeDeferred(std::unique_ptr<SkStreamAsset> stream);
+
     SkPDFDict* dict() { return &fDict; }
 
     // The SkPDFObject interface.
@@ -346,8 +352,9 @@ protected:
     void setData(std::unique_ptr<SkStreamAsset> stream);
 
 private:
-    std::unique_ptr<SkStreamAsset> fCompressedData;
+    std::unique_ptr<SkStreamAsset> fCompressedData;  // Uncompressed if fDeferred.
     SkPDFDict fDict;
+    bool fDeferred;
 
     typedef SkPDFDict INHERITED;
 };
@@ -0,0 +1,92 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkPicture.h"
+#include "SkPipe.h"
+#include "SkPipeRingBuffer.h"
+#include "SkThreadUtils.h"
+
+class SkPipeAsyncPlayer::Impl {
+public:
+    Impl(SkCanvas* dst, size_t ringBytes)
+        : fDst(dst)
+        , fRing(ringBytes)
+        , fThread(&Impl::ReaderLoop, this)
+    {}
+
+    static void ReaderLoop(void* ctx) {
+        Impl* self = (Impl*)ctx;
+        SkTDArray<char> frame;
+        for (;;) {
+            uint32_t flags = self->fRing.readChunk(&frame);
+            if (flags & SkPipeRingBuffer::kClose_ChunkFlag) {
+                return;
+            }
+            if (flags & SkPipeRingBuffer::kEndOfFrame_ChunkFlag) {
+                self->fDeserializer.playback(frame.begin(), frame.count(), self->fDst);
+                frame.rewind();
+                self->fFramesPlayed.fetch_add(1);
+                self->fPlayedWaiter.notify();
+            }
+        }
+    }
+
+    SkPipeSerializer    fSerializer;
+    SkPipeDeserializer  fDeserializer;
+    SkCanvas*           fDst;
+    SkPipeRingBuffer    fRing;
+    SkThread            fThread;
+    bool                fStarted = false;
+    bool                fInFrame = false;
+
+    int                 fFramesEnded = 0;   // only touched by the writer
+    std::atomic<int>    fFramesPlayed{0};
+    SkPipeWaiter        fPlayedWaiter;
+};
+
+SkPipeAsyncPlayer::SkPipeAsyncPlayer(SkCanvas* dst, size_t ringBytes)
+    : fImpl(new Impl(dst, ringBytes)) {}
+
+SkPipeAsyncPlayer::~SkPipeAsyncPlayer() {
+    if (fImpl->fInFrame) {
+        this->endFrame();
+    }
+    if (fImpl->fStarted) {
+        fImpl->fRing.close();
+        fImpl->fThread.join();
+    }
+}
+
+SkPipeSerializer* SkPipeAsyncPlayer::serializer() { return &fImpl->fSerializer; }
+SkPipeDeserializer* SkPipeAsyncPlayer::deserializer() { return &fImpl->fDeserializer; }
+
+SkCanvas* SkPipeAsyncPlayer::beginFrame(const SkRect& cull) {
+    SkASSERT(!fImpl->fInFrame);
+    if (!fImpl->fStarted) {
+        // Start lazily, so the deserializer can still be configured after construction.
+        SkAssertResult(fImpl->fThread.start());
+        fImpl->fStarted = true;
+    }
+    fImpl->fInFrame = true;
+    return fImpl->fSerializer.beginWrite(cull, &fImpl->fRing);
+}
+
+void SkPipeAsyncPlayer::endFrame() {
+    SkASSERT(fImpl->fInFrame);
+    fImpl->fSerializer.endWrite();
+    fImpl->fRing.endFrame();
+    fImpl->fFramesEnded += 1;
+    fImpl->fInFrame = false;
+}
+
+void SkPipeAsyncPlayer::flush() {
+    SkASSERT(!fImpl->fInFrame);
+    const int ended = fImpl->fFramesEnded;
+    Impl* impl = fImpl.get();
+    impl->fPlayedWaiter.waitUntil([impl, ended] { return impl->fFramesPlayed.load() == ended; });
+}
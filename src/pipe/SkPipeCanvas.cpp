@@ -206,6 +206,15 @@ public:
     }
 };
 
+// Paths are written once and then referenced by index.  Index 0 means the path follows inline.
+static void write_path(SkPipeWriter& writer, SkPipeDeduper* deduper, const SkPath& path) {
+    int index = deduper->findOrDefinePath(path);
+    writer.write32(index);
+    if (0 == index) {
+        writer.writePath(path);
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 SkPipeCanvas::SkPipeCanvas(const SkRect& cull, SkPipeDeduper* deduper, SkWStream* stream)
@@ -327,7 +336,7 @@ void SkPipeCanvas::onClipRRect(const SkRRect& rrect, SkClipOp op, ClipEdgeStyle
 void SkPipeCanvas::onClipPath(const SkPath& path, SkClipOp op, ClipEdgeStyle edgeStyle) {
     SkPipeWriter writer(this);
     writer.write32(pack_verb(SkPipeVerb::kClipPath, ((unsigned)op << 1) | edgeStyle));
-    writer.writePath(path);
+    write_path(writer, fDeduper, path);
 
     this->INHERITED::onClipPath(path, op, edgeStyle);
 }
@@ -431,7 +440,7 @@ void SkPipeCanvas::onDrawDRRect(const SkRRect& outer, const SkRRect& inner, cons
 void SkPipeCanvas::onDrawPath(const SkPath& path, const SkPaint& paint) {
     SkPipeWriter writer(this);
     writer.write32(pack_verb(SkPipeVerb::kDrawPath));
-    writer.writePath(path);
+    write_path(writer, fDeduper, path);
     write_paint(writer, paint, kGeometry_PaintUsage);
 }
 
@@ -651,7 +660,7 @@ void SkPipeCanvas::onDrawTextOnPath(const void* text, size_t byteLength, const S
         writer.write32(byteLength);
     }
     write_pad(&writer, text, byteLength);
-    writer.writePath(path);
+    write_path(writer, fDeduper, path);
     if (matrix) {
         write_sparse_matrix(&writer, *matrix);
     }
@@ -986,6 +995,37 @@ int SkPipeDeduper::findOrDefineFactory(SkFlattenable* flattenable) {
     return index;
 }
 
+int SkPipeDeduper::findOrDefinePath(const SkPath& path) {
+    if (path.isVolatile()) {
+        return 0;   // likely to change before we see it again, so don't bother caching it
+    }
+
+    const PathKey key = { path.getGenerationID(), (uint32_t)path.getFillType() };
+    int index = fPaths.find(key);
+    SkASSERT(index >= 0);
+    if (index) {
+        if (show_deduper_traffic) {
+            SkDebugf("  reusePath(%d)\n", index - 1);
+        }
+        return index;
+    }
+
+    // Once every slot is taken, this evicts the least recently used path, and the reader will
+    // replace it with this one.  kMaxPathDefinitions keeps index within extra's bits.
+    index = fPaths.add(key);
+    size_t prevWritten = fStream->bytesWritten();
+    {
+        SkPipeWriter writer(fStream, this);
+        writer.write32(pack_verb(SkPipeVerb::kDefinePath, index));
+        writer.writePath(path);
+    }
+    if (show_deduper_traffic) {
+        SkDebugf("  definePath(%d) %d\n",
+                 index - 1, SkToU32(fStream->bytesWritten() - prevWritten));
+    }
+    return index;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 #include "SkPipe.h"
 
@@ -11,7 +11,11 @@
 #include "SkDeduper.h"
 #include "SkImage.h"
 #include "SkNoDrawCanvas.h"
+#include "SkPath.h"
 #include "SkPipe.h"
+#include "SkPipeFormat.h"
+#include "SkTHash.h"
+#include "SkTInternalLList.h"
 #include "SkTypeface.h"
 #include "SkWriteBuffer.h"
 
@@ -20,24 +24,66 @@ class SkPipeWriter;
 
 template <typename T> class SkTIndexSet {
 public:
-    void reset() { fArray.reset(); }
+    void reset() { fMap.reset(); }
 
     // returns the found index or 0
     int find(const T& key) const {
-        const Rec* stop = fArray.end();
-        for (const Rec* curr = fArray.begin(); curr < stop; ++curr) {
-            if (key == curr->fKey) {
-                return curr->fIndex;
-            }
-        }
-        return 0;
+        const int* index = fMap.find(key);
+        return index ? *index : 0;
     }
 
     // returns the new index
     int add(const T& key) {
-        Rec* rec = fArray.append();
+        SkASSERT(!fMap.find(key));
+        return *fMap.set(key, fNextIndex++);
+    }
+
+private:
+    SkTHashMap<T, int> fMap;
+    int fNextIndex = 1;
+};
+
+// Like SkTIndexSet, but with only kMaxCount indices.  Once they're all taken, add() hands out
+// the index of the key found or added least recently, forgetting that key.
+template <typename T, int kMaxCount> class SkTLRUIndexSet {
+public:
+    void reset() {
+        while (Rec* rec = fLRU.head()) {
+            fLRU.remove(rec);
+        }
+        fMap.reset();
+        fCount = 0;
+    }
+
+    // returns the found index or 0, and marks it as the most recently used
+    int find(const T& key) {
+        Rec** rec = fMap.find(key);
+        if (!rec) {
+            return 0;
+        }
+        fLRU.remove(*rec);
+        fLRU.addToHead(*rec);
+        return (*rec)->fIndex;
+    }
+
+    // returns the new index, in [1, kMaxCount]
+    int add(const T& key) {
+        SkASSERT(!fMap.find(key));
+        Rec* rec;
+        if (fCount < kMaxCount) {
+            if (!fRecs) {
+                fRecs.reset(new Rec[kMaxCount]);
+            }
+            rec = &fRecs[fCount++];
+            rec->fIndex = fCount;
+        } else {
+            rec = fLRU.tail();
+            fLRU.remove(rec);
+            fMap.remove(rec->fKey);
+        }
         rec->fKey = key;
-        rec->fIndex = fNextIndex++;
+        fMap.set(key, rec);
+        fLRU.addToHead(rec);
         return rec->fIndex;
     }
 
@@ -45,10 +91,14 @@ private:
     struct Rec {
         T   fKey;
         int fIndex;
+
+        SK_DECLARE_INTERNAL_LLIST_INTERFACE(Rec);
     };
 
-    SkTDArray<Rec>  fArray;
-    int fNextIndex = 1;
+    std::unique_ptr<Rec[]>  fRecs;
+    int                     fCount = 0;
+    SkTHashMap<T, Rec*>     fMap;
+    SkTInternalLList<Rec>   fLRU;
 };
 
 class SkPipeDeduper : public SkDeduper {
@@ -58,6 +108,7 @@ public:
         fPictures.reset();
         fTypefaces.reset();
         fFactories.reset();
+        fPaths.reset();
     }
 
     void setCanvas(SkPipeCanvas* canvas) { fPipeCanvas = canvas; }
@@ -74,6 +125,9 @@ public:
     int findOrDefineTypeface(SkTypeface*) override;
     int findOrDefineFactory(SkFlattenable*) override;
 
+    // returns 0 if the path should be written inline (e.g. it is volatile)
+    int findOrDefinePath(const SkPath&);
+
 private:
     SkPipeCanvas*           fPipeCanvas = nullptr;
     SkWStream*              fStream = nullptr;
@@ -86,6 +140,19 @@ private:
     SkTIndexSet<uint32_t>   fPictures;
     SkTIndexSet<uint32_t>   fTypefaces;
     SkTIndexSet<SkFlattenable::Factory> fFactories;
+
+    // SkPath's genID doesn't cover the fill type, so we key on both.
+    struct PathKey {
+        uint32_t fGenID;
+        uint32_t fFillType;
+
+        bool operator==(const PathKey& other) const {
+            return fGenID == other.fGenID && fFillType == other.fFillType;
+        }
+    };
+    // Paths can come and go much faster than images or typefaces, so we only remember the most
+    // recently used, and the reader keeps just as many.
+    SkTLRUIndexSet<PathKey, kMaxPathDefinitions> fPaths;
 };
 
 
@@ -58,6 +58,7 @@ enum class SkPipeVerb : uint8_t {
     kEndPicture,        // extra == picture_index
     kWriteImage,        // extra == image_index
     kWritePicture,      // extra == picture_index
+    kDefinePath,        // extra == path_index (a slot, redefined as the writer reuses it)
 };
 
 enum PaintUsage {
@@ -115,7 +116,11 @@ enum {
     kUser_ObjectDefinitionMask      = 0x7 << kObjectDefinitionBits,
     kUndef_ObjectDefinitionMask     = 1 << 23,
     // (Undef:1 | User:3 | Index:20) must fit in extra:24
+
+    // Paths are defined into this many slots, and the writer reuses the least recently used.
+    kMaxPathDefinitions             = 1 << 10,
 };
+static_assert(kMaxPathDefinitions <= kIndex_ObjectDefinitionMask, "path_index must fit in extra");
 
 enum {
     kTypeMask_ConcatMask    = 0xF,
@@ -15,6 +15,7 @@
 #include "SkReadBuffer.h"
 #include "SkRefSet.h"
 #include "SkRSXform.h"
+#include "SkTArray.h"
 #include "SkTextBlob.h"
 #include "SkTypeface.h"
 
@@ -28,11 +29,12 @@ class SkPipeInflator : public SkInflator {
 public:
     SkPipeInflator(SkRefSet<SkImage>* images, SkRefSet<SkPicture>* pictures,
                    SkRefSet<SkTypeface>* typefaces, SkTDArray<SkFlattenable::Factory>* factories,
-                   SkTypefaceDeserializer* tfd, SkImageDeserializer* imd)
+                   SkTArray<SkPath>* paths, SkTypefaceDeserializer* tfd, SkImageDeserializer* imd)
         : fImages(images)
         , fPictures(pictures)
         , fTypefaces(typefaces)
         , fFactories(factories)
+        , fPaths(paths)
         , fTFDeserializer(tfd)
         , fIMDeserializer(imd)
     {}
@@ -49,6 +51,10 @@ public:
     SkFlattenable::Factory getFactory(int index) override {
         return index ? fFactories->getAt(index - 1) : nullptr;
     }
+    const SkPath* getPath(int index) {
+        index -= 1;
+        return (unsigned)index < (unsigned)fPaths->count() ? &(*fPaths)[index] : nullptr;
+    }
 
     bool setImage(int index, SkImage* img) {
         return fImages->set(index - 1, img);
@@ -74,6 +80,20 @@ public:
         SkDebugf("setFactory: index [%d] out of range %d\n", index, fFactories->count());
         return false;
     }
+    bool setPath(int index, const SkPath& path) {
+        SkASSERT(index > 0);
+        index -= 1;
+        if ((unsigned)index < (unsigned)fPaths->count()) {
+            (*fPaths)[index] = path;
+            return true;
+        }
+        if (fPaths->count() == index && index < kMaxPathDefinitions) {
+            fPaths->push_back(path);
+            return true;
+        }
+        SkDebugf("setPath: index [%d] out of range %d\n", index, fPaths->count());
+        return false;
+    }
 
     void setTypefaceDeserializer(SkTypefaceDeserializer* tfd) {
         fTFDeserializer = tfd;
@@ -91,6 +111,7 @@ private:
     SkRefSet<SkPicture>*                fPictures;
     SkRefSet<SkTypeface>*               fTypefaces;
     SkTDArray<SkFlattenable::Factory>*  fFactories;
+    SkTArray<SkPath>*                   fPaths;
 
     SkTypefaceDeserializer*             fTFDeserializer;
     SkImageDeserializer*                fIMDeserializer;
@@ -221,6 +242,21 @@ public:
     }
 };
 
+// Returns either a path previously sent with kDefinePath, or one read inline into storage.
+static const SkPath& read_path(SkPipeReader& reader, SkPath* storage) {
+    int index = reader.read32();
+    if (index) {
+        const SkPath* path = ((SkPipeInflator*)reader.getInflator())->getPath(index);
+        if (reader.validate(path != nullptr)) {
+            return *path;
+        }
+        SkDebugf("-------- bad path index %d\n", index);
+        return *storage;
+    }
+    reader.readPath(storage);
+    return *storage;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 typedef void (*SkPipeHandler)(SkPipeReader&, uint32_t packedVerb, SkCanvas*);
@@ -287,9 +323,8 @@ static void clipPath_handler(SkPipeReader& reader, uint32_t packedVerb, SkCanvas
     SkASSERT(SkPipeVerb::kClipPath == unpack_verb(packedVerb));
     SkClipOp op = (SkClipOp)(unpack_verb_extra(packedVerb) >> 1);
     bool isAA = unpack_verb_extra(packedVerb) & 1;
-    SkPath path;
-    reader.readPath(&path);
-    canvas->clipPath(path, op, isAA);
+    SkPath storage;
+    canvas->clipPath(read_path(reader, &storage), op, isAA);
 }
 
 static void clipRegion_handler(SkPipeReader& reader, uint32_t packedVerb, SkCanvas* canvas) {
@@ -389,8 +424,8 @@ static void drawTextOnPath_handler(SkPipeReader& reader, uint32_t packedVerb, Sk
         byteLength = reader.read32();
     }
     const void* text = reader.skip(SkAlign4(byteLength));
-    SkPath path;
-    reader.readPath(&path);
+    SkPath storage;
+    const SkPath& path = read_path(reader, &storage);
     const SkMatrix* matrix = nullptr;
     SkMatrix matrixStorage;
     if (tm != SkMatrix::kIdentity_Mask) {
@@ -473,8 +508,8 @@ static void drawRRect_handler(SkPipeReader& reader, uint32_t packedVerb, SkCanva
 
 static void drawPath_handler(SkPipeReader& reader, uint32_t packedVerb, SkCanvas* canvas) {
     SkASSERT(SkPipeVerb::kDrawPath == unpack_verb(packedVerb));
-    SkPath path;
-    reader.readPath(&path);
+    SkPath storage;
+    const SkPath& path = read_path(reader, &storage);
     canvas->drawPath(path, read_paint(reader));
 }
 
@@ -744,6 +779,15 @@ static void defineFactory_handler(SkPipeReader& reader, uint32_t packedVerb, SkC
     }
 }
 
+static void definePath_handler(SkPipeReader& reader, uint32_t packedVerb, SkCanvas* canvas) {
+    SkASSERT(SkPipeVerb::kDefinePath == unpack_verb(packedVerb));
+    SkPipeInflator* inflator = (SkPipeInflator*)reader.getInflator();
+    int index = unpack_verb_extra(packedVerb) & kIndex_ObjectDefinitionMask;
+    SkPath path;
+    reader.readPath(&path);
+    inflator->setPath(index, path);
+}
+
 static void definePicture_handler(SkPipeReader& reader, uint32_t packedVerb, SkCanvas* canvas) {
     SkASSERT(SkPipeVerb::kDefinePicture == unpack_verb(packedVerb));
     int deleteIndex = unpack_verb_extra(packedVerb);
@@ -767,6 +811,15 @@ static void endPicture_handler(SkPipeReader& reader, uint32_t packedVerb, SkCanv
     sk_throw();     // never call me
 }
 
+// Images and pictures are only written at the top level, read by readImage() and readPicture().
+static void writeImage_handler(SkPipeReader& reader, uint32_t packedVerb, SkCanvas* canvas) {
+    reader.validate(false);
+}
+
+static void writePicture_handler(SkPipeReader& reader, uint32_t packedVerb, SkCanvas* canvas) {
+    reader.validate(false);
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 struct HandlerRec {
@@ -819,8 +872,13 @@ const HandlerRec gPipeHandlers[] = {
     HANDLER(defineFactory),
     HANDLER(definePicture),
     HANDLER(endPicture),        // handled special -- should never be called
+    HANDLER(writeImage),
+    HANDLER(writePicture),
+    HANDLER(definePath),
 };
 #undef HANDLER
+static_assert(SK_ARRAY_COUNT(gPipeHandlers) == (unsigned)SkPipeVerb::kDefinePath + 1,
+              "gPipeHandlers must have one entry per SkPipeVerb, in order");
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -830,6 +888,7 @@ public:
     SkRefSet<SkPicture>                 fPictures;
     SkRefSet<SkTypeface>                fTypefaces;
     SkTDArray<SkFlattenable::Factory>   fFactories;
+    SkTArray<SkPath>                    fPaths;
 
     SkTypefaceDeserializer*             fTFDeserializer = nullptr;
     SkImageDeserializer*                fIMDeserializer = nullptr;
@@ -858,7 +917,7 @@ sk_sp<SkImage> SkPipeDeserializer::readImage(const void* data, size_t size) {
 
     if (SkPipeVerb::kDefineImage == unpack_verb(packedVerb)) {
         SkPipeInflator inflator(&fImpl->fImages, &fImpl->fPictures,
-                                &fImpl->fTypefaces, &fImpl->fFactories,
+                                &fImpl->fTypefaces, &fImpl->fFactories, &fImpl->fPaths,
                                 fImpl->fTFDeserializer, fImpl->fIMDeserializer);
         SkPipeReader reader(this, ptr, size);
         reader.setInflator(&inflator);
@@ -888,7 +947,7 @@ sk_sp<SkPicture> SkPipeDeserializer::readPicture(const void* data, size_t size)
 
     if (SkPipeVerb::kDefinePicture == unpack_verb(packedVerb)) {
         SkPipeInflator inflator(&fImpl->fImages, &fImpl->fPictures,
-                                &fImpl->fTypefaces, &fImpl->fFactories,
+                                &fImpl->fTypefaces, &fImpl->fFactories, &fImpl->fPaths,
                                 fImpl->fTFDeserializer, fImpl->fIMDeserializer);
         SkPipeReader reader(this, ptr, size);
         reader.setInflator(&inflator);
@@ -957,7 +1016,7 @@ static bool do_playback(SkPipeReader& reader, SkCanvas* canvas, int* endPictureI
 
 bool SkPipeDeserializer::playback(const void* data, size_t size, SkCanvas* canvas) {
     SkPipeInflator inflator(&fImpl->fImages, &fImpl->fPictures,
-                            &fImpl->fTypefaces, &fImpl->fFactories,
+                            &fImpl->fTypefaces, &fImpl->fFactories, &fImpl->fPaths,
                             fImpl->fTFDeserializer, fImpl->fIMDeserializer);
     SkPipeReader reader(this, data, size);
     reader.setInflator(&inflator);
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkMathPriv.h"
+#include "SkPipeRingBuffer.h"
+
+static size_t ring_capacity(size_t requested) {
+    // We need room for at least a chunk header and a few bytes of payload.
+    size_t capacity = SkTMax<size_t>(requested, 4096);
+    SkASSERT(capacity <= (1u << 30));
+    return SkNextPow2(SkToInt(capacity));
+}
+
+SkPipeRingBuffer::SkPipeRingBuffer(size_t capacity)
+    : fCapacity(ring_capacity(capacity))
+    , fStorage(fCapacity)
+    , fPublished(0)
+    , fReadPos(0)
+    , fWritePos(0)
+    , fChunkStart(0)
+    , fChunkOpen(false)
+    , fBytesWritten(0)
+{}
+
+void SkPipeRingBuffer::copyIn(size_t pos, const void* src, size_t size) {
+    size_t offset = pos & (fCapacity - 1);
+    size_t first = SkTMin(size, fCapacity - offset);
+    memcpy(fStorage.get() + offset, src, first);
+    memcpy(fStorage.get(), (const char*)src + first, size - first);
+}
+
+void SkPipeRingBuffer::copyOut(size_t pos, void* dst, size_t size) const {
+    size_t offset = pos & (fCapacity - 1);
+    size_t first = SkTMin(size, fCapacity - offset);
+    memcpy(dst, fStorage.get() + offset, first);
+    memcpy((char*)dst + first, fStorage.get(), size - first);
+}
+
+void SkPipeRingBuffer::openChunk() {
+    SkASSERT(!fChunkOpen);
+    // Leave room for the header and at least one byte of payload, so every chunk makes progress.
+    fSpaceWaiter.waitUntil([this] { return this->freeSpace() > kHeaderSize; });
+    fChunkStart = fWritePos;
+    fWritePos += kHeaderSize;
+    fChunkOpen = true;
+}
+
+void SkPipeRingBuffer::publishChunk(uint32_t flags) {
+    SkASSERT(fChunkOpen);
+    uint32_t header = SkToU32(fWritePos - fChunkStart - kHeaderSize) | flags;
+    this->copyIn(fChunkStart, &header, kHeaderSize);
+    fChunkOpen = false;
+
+    fPublished.store(fWritePos);
+    fDataWaiter.notify();
+}
+
+bool SkPipeRingBuffer::write(const void* buffer, size_t size) {
+    const char* src = (const char*)buffer;
+    while (size > 0) {
+        if (!fChunkOpen) {
+            this->openChunk();
+        }
+        size_t n = SkTMin(size, this->freeSpace());
+        if (0 == n) {
+            // The ring is full.  Hand over what we have so the reader can start draining it.
+            this->publishChunk(0);
+            continue;
+        }
+        this->copyIn(fWritePos, src, n);
+        fWritePos += n;
+        src += n;
+        size -= n;
+        fBytesWritten += n;
+    }
+    return true;
+}
+
+void SkPipeRingBuffer::endFrame() {
+    if (!fChunkOpen) {
+        this->openChunk();
+    }
+    this->publishChunk(kEndOfFrame_ChunkFlag);
+}
+
+void SkPipeRingBuffer::close() {
+    if (!fChunkOpen) {
+        this->openChunk();
+    }
+    this->publishChunk(kClose_ChunkFlag);
+}
+
+uint32_t SkPipeRingBuffer::readChunk(SkTDArray<char>* frame) {
+    size_t readPos = fReadPos.load(std::memory_order_relaxed);  // only we write fReadPos
+    fDataWaiter.waitUntil([this, readPos] { return fPublished.load() != readPos; });
+
+    uint32_t header;
+    this->copyOut(readPos, &header, kHeaderSize);
+    size_t length = header & kLengthMask;
+    this->copyOut(readPos + kHeaderSize, frame->append(SkToInt(length)), length);
+
+    fReadPos.store(readPos + kHeaderSize + length);
+    fSpaceWaiter.notify();
+
+    return header & ~kLengthMask;
+}
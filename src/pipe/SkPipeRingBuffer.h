@@ -0,0 +1,110 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPipeRingBuffer_DEFINED
+#define SkPipeRingBuffer_DEFINED
+
+#include "SkSemaphore.h"
+#include "SkStream.h"
+#include "SkTDArray.h"
+#include "SkTemplates.h"
+#include <atomic>
+
+/**
+ *  Lets one thread sleep until another tells it that something it cares about has changed.
+ *  notify() is a single atomic op when nobody is waiting.
+ */
+class SkPipeWaiter {
+public:
+    template <typename Pred>
+    void waitUntil(Pred ready) {
+        while (!ready()) {
+            fWaiting.store(true);
+            if (ready()) {
+                if (!fWaiting.exchange(false)) {
+                    fSemaphore.wait();  // Someone saw us waiting and signaled; eat that signal.
+                }
+                return;
+            }
+            fSemaphore.wait();
+        }
+    }
+
+    void notify() {
+        if (fWaiting.exchange(false)) {
+            fSemaphore.signal();
+        }
+    }
+
+private:
+    std::atomic<bool> fWaiting{false};
+    SkSemaphore       fSemaphore;
+};
+
+/**
+ *  A fixed-size, single-producer single-consumer byte queue that carries a pipe from the thread
+ *  recording it to the thread playing it back.
+ *
+ *  The writer sees an SkWStream.  Bytes are handed over in chunks: a chunk is published when the
+ *  writer ends a frame, or when the ring fills up mid-frame, so frames may be larger than the
+ *  ring.  The writer only blocks when the ring is full; the reader only blocks when it is empty.
+ */
+class SkPipeRingBuffer : public SkWStream {
+public:
+    enum ChunkFlags {
+        kEndOfFrame_ChunkFlag   = 1u << 31,
+        kClose_ChunkFlag        = 1u << 30,
+    };
+
+    // capacity is rounded up to a power of two.
+    explicit SkPipeRingBuffer(size_t capacity);
+
+    // Writer side.
+    bool write(const void* buffer, size_t size) override;
+    size_t bytesWritten() const override { return fBytesWritten; }
+
+    // Publishes everything written since the last endFrame() as a complete frame.
+    void endFrame();
+
+    // Tells the reader there will be nothing more.  The writer must not write after this.
+    void close();
+
+    // Reader side.  Blocks until a chunk is available, appends its bytes to frame, and returns its
+    // ChunkFlags.
+    uint32_t readChunk(SkTDArray<char>* frame);
+
+private:
+    enum {
+        kHeaderSize     = sizeof(uint32_t),
+        kLengthMask     = ~(kEndOfFrame_ChunkFlag | kClose_ChunkFlag),
+    };
+
+    size_t freeSpace() const { return fCapacity - (fWritePos - fReadPos.load()); }
+
+    void openChunk();
+    void publishChunk(uint32_t flags);
+
+    void copyIn(size_t pos, const void* src, size_t size);
+    void copyOut(size_t pos, void* dst, size_t size) const;
+
+    const size_t                fCapacity;
+    SkAutoTMalloc<char>         fStorage;
+
+    // Positions only ever increase; they're masked down to fStorage offsets on use.
+    // fPublished and fReadPos are shared, the rest belong to the writer.
+    std::atomic<size_t>         fPublished;
+    std::atomic<size_t>         fReadPos;
+    size_t                      fWritePos;
+    size_t                      fChunkStart;
+    bool                        fChunkOpen;
+    size_t                      fBytesWritten;
+
+    SkPipeWaiter                fDataWaiter;    // the reader waits for fPublished to move
+    SkPipeWaiter                fSpaceWaiter;   // the writer waits for fReadPos to move
+};
+
+#endif
@@ -6,6 +6,9 @@
  */
 
 #include "SkCpu.h"
+#include "SkData.h"
+#include "SkLRUCache.h"
+#include "SkMutex.h"
 #include "SkOpts.h"
 #include "SkRasterPipeline.h"
 #include "SkStream.h"
@@ -57,15 +60,16 @@ namespace {
         }
     }
 
+    // Spliced code never bakes in context pointers.  Instead each pipeline's contexts are
+    // stored right after its constants, and set_ctx() loads the one at byte offset off from k
+    // into the ctx argument register.  This lets pipelines that differ only in their contexts
+    // share the same code.
+
 #if defined(__aarch64__)
     static constexpr int kStride = 4;
-    static void set_ctx(SkWStream* buf, void* ctx) {
-        uint16_t parts[4];
-        memcpy(parts, &ctx, 8);
-        splice(buf, 0xd2f00000 | (parts[3] << 5) | 0x2);  // move  16-bit intermediate << 48 into x2
-        splice(buf, 0xf2c00000 | (parts[2] << 5) | 0x2);  // merge 16-bit intermediate << 32 into x2
-        splice(buf, 0xf2a00000 | (parts[1] << 5) | 0x2);  // merge 16-bit intermediate << 16 into x2
-        splice(buf, 0xf2800000 | (parts[0] << 5) | 0x2);  // merge 16-bit intermediate <<  0 into x2
+    static void set_ctx(SkWStream* buf, int off) {
+        SkASSERT(off % 8 == 0 && off / 8 < 4096);
+        splice(buf, 0xf9400062 | ((off / 8) << 10));  // ldr x2, [x3, #off]
     }
     static void loop(SkWStream* buf, int loop_start) {
         splice(buf, 0xeb01001f);        // cmp x0, x1
@@ -79,14 +83,9 @@ namespace {
     }
 #elif defined(__ARM_NEON__)
     static constexpr int kStride = 2;
-    static void set_ctx(SkWStream* buf, void* ctx) {
-        uint16_t parts[2];
-        auto encode = [](uint16_t part) -> uint32_t {
-            return (part & 0xf000) << 4 | (part & 0xfff);
-        };
-        memcpy(parts, &ctx, 4);
-        splice(buf, 0xe3002000 | encode(parts[0]));  // mov  r2, <bottom 16 bits>
-        splice(buf, 0xe3402000 | encode(parts[1]));  // movt r2,    <top 16 bits>
+    static void set_ctx(SkWStream* buf, int off) {
+        SkASSERT(off < 4096);
+        splice(buf, 0xe5932000 | off);  // ldr r2, [r3, #off]
     }
     static void loop(SkWStream* buf, int loop_start) {
         splice(buf, 0xe1500001);  // cmp r0, r1
@@ -100,10 +99,10 @@ namespace {
     }
 #else
     static constexpr int kStride = 8;
-    static void set_ctx(SkWStream* buf, void* ctx) {
-        static const uint8_t movabsq_rdx[] = { 0x48, 0xba };
-        splice(buf, movabsq_rdx);  // movabsq <next 8 bytes>, %rdx
-        splice(buf, ctx);
+    static void set_ctx(SkWStream* buf, int off) {
+        static const uint8_t movq_rcx_rdx[] = { 0x48, 0x8b, 0x91 };
+        splice(buf, movq_rcx_rdx);  // movq <next 4 bytes>(%rcx), %rdx
+        splice(buf, off);
     }
     static void loop(SkWStream* buf, int loop_start) {
         static const uint8_t cmp_rsi_rdi[] = { 0x48, 0x39, 0xf7 };
@@ -294,104 +293,176 @@ namespace {
         return true;
     }
 
-    struct Spliced {
+    // Where the contexts start in the block we pass as k, right after the constants.
+    static size_t ctx_offset(bool lowp) {
+        size_t constants = lowp ? sizeof(kConstants_lowp) : sizeof(kConstants);
+        return SkAlign8(constants);
+    }
 
-        Spliced(const SkRasterPipeline::Stage* stages, int nstages) {
-            // We always create a backup interpreter pipeline,
-            //   - to handle any program we can't, and
-            //   - to handle the n < stride tails.
-            fBackup     = SkOpts::compile_pipeline(stages, nstages);
-            fSplicedLen = 0;
-            fSpliced    = nullptr;
-            fLowp       = false;
-            // If we return early anywhere in here, !fSpliced means we'll use fBackup instead.
-
-        #if defined(__aarch64__)
-        #elif defined(__ARM_NEON__)
-            // Late generation ARMv7, e.g. Cortex A15 or Krait.
-            if (!SkCpu::Supports(SkCpu::NEON|SkCpu::NEON_FMA|SkCpu::VFP_FP16)) {
-                return;
+    // Executable code for one program, shared by every pipeline that uses it.
+    struct SplicedCode : public SkRefCnt {
+        SplicedCode(void* fn, size_t len, bool lowp) : fFn(fn), fLen(len), fLowp(lowp) {}
+        ~SplicedCode() override { cleanup_executable_mem(fFn, fLen); }
+
+        void*  fFn;
+        size_t fLen;
+        bool   fLowp;
+    };
+
+    // Splices stages into executable code, or returns null if we can't handle them all.
+    static sk_sp<SplicedCode> splice_stages(const SkRasterPipeline::Stage* stages, int nstages,
+                                            bool allowLowp) {
+    #if defined(__aarch64__)
+    #elif defined(__ARM_NEON__)
+        // Late generation ARMv7, e.g. Cortex A15 or Krait.
+        if (!SkCpu::Supports(SkCpu::NEON|SkCpu::NEON_FMA|SkCpu::VFP_FP16)) {
+            return nullptr;
+        }
+    #else
+        // To keep things simple, only one x86 target supported: Haswell+ x86-64.
+        if (!SkCpu::Supports(SkCpu::HSW) || sizeof(void*) != 8) {
+            return nullptr;
+        }
+    #endif
+
+        // See if all the stages can run in lowp mode.  If so, we can run at ~2x speed.
+        bool lowp = allowLowp;
+        for (int i = 0; lowp && i < nstages; i++) {
+            if (!splice_lowp(nullptr, stages[i].stage)) {
+                //SkDebugf("SkSplicer can't yet handle stage %d in lowp.\n", stages[i].stage);
+                lowp = false;
+                break;
             }
-        #else
-            // To keep things simple, only one x86 target supported: Haswell+ x86-64.
-            if (!SkCpu::Supports(SkCpu::HSW) || sizeof(void*) != 8) {
-                return;
+        }
+
+        SkDynamicMemoryWStream buf;
+
+        // Our loop is the equivalent of this C++ code:
+        //    do {
+        //        ... run spliced stages...
+        //        x += stride;
+        //    } while(x < limit);
+        before_loop(&buf);
+        auto loop_start = buf.bytesWritten();  // Think of this like a label, loop_start:
+
+        size_t ctx = ctx_offset(lowp);
+        for (int i = 0; i < nstages; i++) {
+            // If a stage has a context pointer, load it into rdx/x2, Stage argument 3 "ctx".
+            if (stages[i].ctx) {
+                set_ctx(&buf, SkToInt(ctx));
+                ctx += sizeof(void*);
             }
-        #endif
 
-            // See if all the stages can run in lowp mode.  If so, we can run at ~2x speed.
-            bool lowp = true;
-            for (int i = 0; i < nstages; i++) {
-                if (!splice_lowp(nullptr, stages[i].stage)) {
-                    //SkDebugf("SkSplicer can't yet handle stage %d in lowp.\n", stages[i].stage);
-                    lowp = false;
-                    break;
-                }
+            // Splice in the code for the Stages, generated offline into SkSplicer_generated.h.
+            if (lowp) {
+                SkAssertResult(splice_lowp(&buf, stages[i].stage));
+                continue;
             }
-            fLowp = lowp;
+            if (!splice_highp(&buf, stages[i].stage)) {
+                //SkDebugf("SkSplicer can't yet handle stage %d.\n", stages[i].stage);
+                return nullptr;
+            }
+        }
 
-            SkDynamicMemoryWStream buf;
+        lowp ? splice(&buf, kSplice_inc_x_lowp)
+             : splice(&buf, kSplice_inc_x);
+        loop(&buf, loop_start);  // Loop back to handle more pixels if not done.
+        after_loop(&buf);
+        ret(&buf);  // We're done.
 
-            // Our loop is the equivalent of this C++ code:
-            //    do {
-            //        ... run spliced stages...
-            //        x += stride;
-            //    } while(x < limit);
-            before_loop(&buf);
-            auto loop_start = buf.bytesWritten();  // Think of this like a label, loop_start:
+        auto data = buf.detachAsData();
+        size_t len = data->size();
+        void* fn = copy_to_executable_mem(data->data(), &len);
 
-            for (int i = 0; i < nstages; i++) {
-                // If a stage has a context pointer, load it into rdx/x2, Stage argument 3 "ctx".
-                if (stages[i].ctx) {
-                    set_ctx(&buf, stages[i].ctx);
-                }
+    #if defined(DUMP)
+        SkFILEWStream(DUMP).write(data->data(), data->size());
+    #endif
+        return fn ? sk_make_sp<SplicedCode>(fn, len, lowp) : nullptr;
+    }
 
-                // Splice in the code for the Stages, generated offline into SkSplicer_generated.h.
-                if (lowp) {
-                    SkAssertResult(splice_lowp(&buf, stages[i].stage));
-                    continue;
-                }
-                if (!splice_highp(&buf, stages[i].stage)) {
-                    //SkDebugf("SkSplicer can't yet handle stage %d.\n", stages[i].stage);
-                    return;
-                }
+    // Spliced code depends only on which stages we run, which of them take a context, and
+    // whether lowp is allowed.
+    struct Key {
+        std::vector<uint16_t> fProgram;  // stage << 1 | (has context), then allowLowp
+
+        Key(const SkRasterPipeline::Stage* stages, int nstages, bool allowLowp)
+                : fProgram(nstages + 1) {
+            for (int i = 0; i < nstages; i++) {
+                fProgram[i] = (uint16_t)(stages[i].stage << 1 | (stages[i].ctx ? 1 : 0));
             }
+            fProgram[nstages] = allowLowp;
+        }
+        bool operator==(const Key& that) const { return fProgram == that.fProgram; }
+    };
+    struct KeyHash {
+        uint32_t operator()(const Key& key) const {
+            return SkOpts::hash(key.fProgram.data(), key.fProgram.size() * sizeof(uint16_t));
+        }
+    };
+
+    // Enough for the handful of distinct pipelines a typical frame uses.
+    static const int kMaxCachedPrograms = 64;
 
-            lowp ? splice(&buf, kSplice_inc_x_lowp)
-                 : splice(&buf, kSplice_inc_x);
-            loop(&buf, loop_start);  // Loop back to handle more pixels if not done.
-            after_loop(&buf);
-            ret(&buf);  // We're done.
+    SK_DECLARE_STATIC_MUTEX(gCacheMutex);
 
-            auto data = buf.detachAsData();
-            fSplicedLen = data->size();
-            fSpliced    = copy_to_executable_mem(data->data(), &fSplicedLen);
+    // Finds or splices the code for these stages.  Failures are cached too, as null.
+    static sk_sp<SplicedCode> find_or_splice(const SkRasterPipeline::Stage* stages, int nstages,
+                                             bool allowLowp) {
+        static SkLRUCache<Key, sk_sp<SplicedCode>, KeyHash>* gCache =
+            new SkLRUCache<Key, sk_sp<SplicedCode>, KeyHash>(kMaxCachedPrograms);
 
-        #if defined(DUMP)
-            SkFILEWStream(DUMP).write(data->data(), data->size());
-        #endif
+        Key key(stages, nstages, allowLowp);
+        SkAutoMutexAcquire lock(gCacheMutex);
+        if (sk_sp<SplicedCode>* code = gCache->find(key)) {
+            return *code;
         }
+        return *gCache->insert(key, splice_stages(stages, nstages, allowLowp));
+    }
 
-        // Spliced is stored in a std::function, so it needs to be copyable.
-        Spliced(const Spliced& o) : fBackup    (o.fBackup)
-                                  , fSplicedLen(o.fSplicedLen)
-                                  , fSpliced   (copy_to_executable_mem(o.fSpliced, &fSplicedLen))
-                                  , fLowp      (o.fLowp) {}
+    struct Spliced {
 
-        ~Spliced() {
-            cleanup_executable_mem(fSpliced, fSplicedLen);
+        Spliced(const SkRasterPipeline::Stage* stages, int nstages, bool allowLowp) {
+            // We always create a backup interpreter pipeline,
+            //   - to handle any program we can't, and
+            //   - to handle the n < stride tails.
+            fBackup = SkOpts::compile_pipeline(stages, nstages, allowLowp);
+
+            // If we can't splice these stages, !fCode means we'll use fBackup instead.
+            fCode = find_or_splice(stages, nstages, allowLowp);
+            if (!fCode) {
+                return;
+            }
+
+            // Lay out our constants followed by each non-null context, as the code expects.
+            const bool lowp = fCode->fLowp;
+            size_t ctx = ctx_offset(lowp);
+            size_t size = ctx;
+            for (int i = 0; i < nstages; i++) {
+                size += stages[i].ctx ? sizeof(void*) : 0;
+            }
+            fK = SkData::MakeUninitialized(size);
+            char* k = (char*)fK->writable_data();
+            if (lowp) {
+                memcpy(k, &kConstants_lowp, sizeof(kConstants_lowp));
+            } else {
+                memcpy(k, &kConstants, sizeof(kConstants));
+            }
+            for (int i = 0; i < nstages; i++) {
+                if (stages[i].ctx) {
+                    memcpy(k + ctx, &stages[i].ctx, sizeof(void*));
+                    ctx += sizeof(void*);
+                }
+            }
         }
 
-        // Here's where we call fSpliced if we created it, fBackup if not.
+        // Here's where we call fCode if we have it, fBackup if not.
         void operator()(size_t x, size_t n) const {
-            size_t stride = fLowp ? kStride*2
-                                  : kStride;
+            size_t stride = fCode && fCode->fLowp ? kStride*2
+                                                  : kStride;
             size_t body = n/stride*stride;     // Largest multiple of stride (2, 4, 8, or 16) <= n.
-            if (fSpliced && body) {            // Can we run fSpliced for at least one stride?
+            if (fCode && body) {               // Can we run fCode for at least one stride?
                 using Fn = void(size_t x, size_t limit, void* ctx, const void* k);
-                auto k = fLowp ? (const void*)&kConstants_lowp
-                               : (const void*)&kConstants;
-                ((Fn*)fSpliced)(x, x+body, nullptr, k);
+                ((Fn*)fCode->fFn)(x, x+body, nullptr, fK->data());
 
                 // Fall through to fBackup for any n<stride last pixels.
                 x += body;
@@ -401,13 +472,12 @@ namespace {
         }
 
         std::function<void(size_t, size_t)> fBackup;
-        size_t                              fSplicedLen;
-        void*                               fSpliced;
-        bool                                fLowp;
+        sk_sp<SplicedCode>                  fCode;
+        sk_sp<SkData>                       fK;     // Constants, then contexts.
     };
 
 }
 
 std::function<void(size_t, size_t)> SkRasterPipeline::jit() const {
-    return Spliced(fStages.data(), SkToInt(fStages.size()));
+    return Spliced(fStages.data(), SkToInt(fStages.size()), fAllowLowp);
 }
@@ -9,6 +9,7 @@
 #include "SkDrawable.h"
 #include "SkPath.h"
 #include "SkRRect.h"
+#include "SkShader.h"
 #include "SkSurface.h"
 #include "SkTextBlob.h"
 #include "SkClipOpPriv.h"
@@ -45,12 +46,17 @@ void SkDeferredCanvas::Rec::setConcat(const SkMatrix& m) {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-SkDeferredCanvas::SkDeferredCanvas(SkCanvas* canvas)
-    : INHERITED(1, 1) {
+SkDeferredCanvas::SkDeferredCanvas(SkCanvas* canvas, EvalType evalType)
+    : INHERITED(1, 1)
+    , fEvalType(evalType) {
     this->reset(canvas);
 }
 
-SkDeferredCanvas::~SkDeferredCanvas() {}
+SkDeferredCanvas::~SkDeferredCanvas() {
+    if (fCanvas) {
+        this->flush_draws();
+    }
+}
 
 void SkDeferredCanvas::reset(SkCanvas* canvas) {
     if (fCanvas) {
@@ -58,6 +64,8 @@ void SkDeferredCanvas::reset(SkCanvas* canvas) {
         fCanvas = nullptr;
     }
     fRecs.reset();
+    fDraws.reset();
+    fStats = { 0, 0, 0 };
     if (canvas) {
         this->resetForNextPicture(SkIRect::MakeSize(canvas->getBaseLayerSize()));
         fCanvas = canvas;
@@ -128,6 +136,10 @@ void SkDeferredCanvas::flush_le(int index) {
     SkASSERT(index >= -1 && index < fRecs.count());
 
     int count = index + 1;
+    if (count > 0) {
+        // Held draws were made under the state we're about to change.
+        this->flush_draws();
+    }
     for (int i = 0; i < count; ++i) {
         this->emit(fRecs[i]);
     }
@@ -135,10 +147,12 @@ void SkDeferredCanvas::flush_le(int index) {
 }
 
 void SkDeferredCanvas::flush_all() {
+    this->flush_draws();
     this->flush_le(fRecs.count() - 1);
 }
 
 void SkDeferredCanvas::flush_before_saves() {
+    this->flush_draws();
     int i;
     for (i = fRecs.count() - 1; i >= 0; --i) {
         if (kSave_Type != fRecs[i].fType) {
@@ -153,9 +167,13 @@ enum Flags {
     kNoClip_Flag        = 1 << 1,
     kNoCull_Flag        = 1 << 2,
     kNoScale_Flag       = 1 << 3,
+    kKeepDraws_Flag     = 1 << 4,   // the caller will hold this draw too, so keep the others
 };
 
 void SkDeferredCanvas::flush_check(SkRect* bounds, const SkPaint* paint, unsigned flags) {
+    if (!(flags & kKeepDraws_Flag)) {
+        this->flush_draws();
+    }
     if (paint) {
         if (paint->getShader() || paint->getImageFilter()) {
             flags |= kNoTranslate_Flag | kNoScale_Flag;
@@ -239,6 +257,174 @@ void SkDeferredCanvas::flush_translate(SkScalar* x, SkScalar* y, const SkPaint&
     *y = tmp.y();
 }
 
+bool SkDeferredCanvas::flush_check_lazy(SkRect* bounds, const SkPaint* paint, unsigned flags) {
+    if (kLazy == fEvalType) {
+        this->flush_check(bounds, paint, flags | kKeepDraws_Flag);
+        return true;
+    }
+    this->flush_check(bounds, paint, flags);
+    return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// We never hold on to more than this many draws, so occlusion tests stay cheap.
+static const int kMaxHeldDraws = 512;
+
+static bool is_simple_fill(const SkPaint& paint) {
+    return paint.getStyle() == SkPaint::kFill_Style && !paint.getPathEffect() &&
+           !paint.getMaskFilter() && !paint.getLooper() && !paint.getImageFilter();
+}
+
+// Does this paint replace every pixel it fully covers, no matter what was there before?
+static bool replaces_dst(const SkPaint* paint, bool contentIsOpaque) {
+    if (!paint) {
+        return contentIsOpaque;
+    }
+    if (!is_simple_fill(*paint) || paint->getColorFilter()) {
+        return false;
+    }
+    switch (paint->getBlendMode()) {
+        case SkBlendMode::kSrc:
+            return true;
+        case SkBlendMode::kSrcOver:
+            return contentIsOpaque && 0xFF == paint->getAlpha() &&
+                   (!paint->getShader() || paint->getShader()->isOpaque());
+        default:
+            return false;
+    }
+}
+
+bool SkDeferredCanvas::init_draw(Draw* draw, Draw::Type type, const SkRect& geometry,
+                                 const SkPaint* paint) {
+    SkRect bounds = geometry;
+    if (paint) {
+        if (!paint->canComputeFastBounds()) {
+            this->flush_draws();
+            return false;
+        }
+        bounds = paint->computeFastBounds(geometry, &bounds);
+    }
+    fCanvas->getTotalMatrix().mapRect(&bounds);
+    bounds.roundOut(&draw->fDevBounds);
+    draw->fDevCover.setEmpty();
+
+    draw->fType = type;
+    draw->fRect = geometry;
+    draw->fHasSrc = false;
+    draw->fHasPaint = paint != nullptr;
+    if (paint) {
+        draw->fPaint = *paint;
+    }
+    return true;
+}
+
+void SkDeferredCanvas::set_cover(Draw* draw, bool contentIsOpaque) {
+    const SkMatrix& ctm = fCanvas->getTotalMatrix();
+    if (ctm.rectStaysRect() && replaces_dst(draw->fHasPaint ? &draw->fPaint : nullptr,
+                                            contentIsOpaque)) {
+        SkRect dev;
+        ctm.mapRect(&dev, draw->fRect);
+        dev.roundIn(&draw->fDevCover);  // only pixels with full coverage, in case of AA
+    } else {
+        draw->fDevCover.setEmpty();
+    }
+}
+
+SkIRect SkDeferredCanvas::Draw::touchedPixels() const {
+    // Antialiasing and hairlines can spill over fDevBounds.
+    if (fHasPaint && (fPaint.isAntiAlias() || fPaint.getStyle() != SkPaint::kFill_Style)) {
+        return fDevBounds.makeOutset(1, 1);
+    }
+    return fDevBounds;
+}
+
+// Two non-AA rects with the same paint that share a whole edge touch exactly the pixels their
+// union would, and no pixel twice, so one draw can do for both.
+static bool can_merge_rects(const SkRect& a, const SkRect& b, const SkPaint& paint) {
+    if (paint.isAntiAlias() || !is_simple_fill(paint)) {
+        return false;
+    }
+    if (a.fTop == b.fTop && a.fBottom == b.fBottom) {
+        return a.fRight == b.fLeft || b.fRight == a.fLeft;
+    }
+    if (a.fLeft == b.fLeft && a.fRight == b.fRight) {
+        return a.fBottom == b.fTop || b.fBottom == a.fTop;
+    }
+    return false;
+}
+
+void SkDeferredCanvas::push_draw(Draw&& draw) {
+    while (Draw::kRect_Type == draw.fType && !fDraws.empty()) {
+        const Draw& prev = fDraws.back();
+        if (Draw::kRect_Type != prev.fType || prev.fPaint != draw.fPaint ||
+            !can_merge_rects(prev.fRect, draw.fRect, draw.fPaint)) {
+            break;
+        }
+        draw.fRect.join(prev.fRect);
+        draw.fDevBounds.join(prev.fDevBounds);
+        fDraws.pop_back();
+        fStats.fMergedRects += 1;
+    }
+    if (Draw::kRect_Type == draw.fType) {
+        this->set_cover(&draw, true);
+    }
+
+    if (!draw.fDevCover.isEmpty()) {
+        int kept = 0;
+        for (int i = 0; i < fDraws.count(); ++i) {
+            if (draw.fDevCover.contains(fDraws[i].touchedPixels())) {
+                fStats.fOccludedDraws += 1;
+                fStats.fOccludedPixels += (int64_t)fDraws[i].fDevBounds.width() *
+                                          fDraws[i].fDevBounds.height();
+            } else {
+                if (kept != i) {
+                    fDraws[kept] = std::move(fDraws[i]);
+                }
+                kept += 1;
+            }
+        }
+        fDraws.pop_back_n(fDraws.count() - kept);
+    }
+
+    fDraws.push_back(std::move(draw));
+    if (fDraws.count() >= kMaxHeldDraws) {
+        this->flush_draws();
+    }
+}
+
+void SkDeferredCanvas::emit_draw(const Draw& draw) {
+    const SkPaint* paint = draw.fHasPaint ? &draw.fPaint : nullptr;
+    switch (draw.fType) {
+        case Draw::kRect_Type:
+            fCanvas->drawRect(draw.fRect, *paint);
+            break;
+        case Draw::kOval_Type:
+            fCanvas->drawOval(draw.fRect, *paint);
+            break;
+        case Draw::kRRect_Type:
+            fCanvas->drawRRect(draw.fRRect, *paint);
+            break;
+        case Draw::kPath_Type:
+            fCanvas->drawPath(draw.fPath, *paint);
+            break;
+        case Draw::kImage_Type:
+            fCanvas->drawImage(draw.fImage, draw.fRect.x(), draw.fRect.y(), paint);
+            break;
+        case Draw::kImageRect_Type:
+            fCanvas->legacy_drawImageRect(draw.fImage.get(), draw.fHasSrc ? &draw.fSrc : nullptr,
+                                          draw.fRect, paint, draw.fConstraint);
+            break;
+    }
+}
+
+void SkDeferredCanvas::flush_draws() {
+    for (const Draw& draw : fDraws) {
+        this->emit_draw(draw);
+    }
+    fDraws.pop_back_n(fDraws.count());
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 void SkDeferredCanvas::willSave() {
@@ -264,6 +450,7 @@ void SkDeferredCanvas::willRestore() {
         SkASSERT(kSave_Type != fRecs[i].fType);
     }
     fRecs.setCount(0);
+    this->flush_draws();
     fCanvas->restore();
     this->INHERITED::willRestore();
 }
@@ -314,6 +501,21 @@ void SkDeferredCanvas::onClipRegion(const SkRegion& deviceRgn, SkClipOp op) {
 }
 
 void SkDeferredCanvas::onDrawPaint(const SkPaint& paint) {
+    // An opaque drawPaint hides everything we're holding, unless a deferred clip would shrink it.
+    if (!fDraws.empty() && replaces_dst(&paint, true)) {
+        bool clipped = false;
+        for (const Rec& rec : fRecs) {
+            clipped |= (kClipRect_Type == rec.fType);
+        }
+        if (!clipped) {
+            for (const Draw& draw : fDraws) {
+                fStats.fOccludedDraws += 1;
+                fStats.fOccludedPixels += (int64_t)draw.fDevBounds.width() *
+                                          draw.fDevBounds.height();
+            }
+            fDraws.pop_back_n(fDraws.count());
+        }
+    }
     // TODO: Can we turn this into drawRect?
     this->flush_all();
     fCanvas->drawPaint(paint);
@@ -327,7 +529,13 @@ void SkDeferredCanvas::onDrawPoints(PointMode mode, size_t count, const SkPoint
 
 void SkDeferredCanvas::onDrawRect(const SkRect& rect, const SkPaint& paint) {
     SkRect modRect = rect;
-    this->flush_check(&modRect, &paint);
+    if (this->flush_check_lazy(&modRect, &paint)) {
+        Draw draw;
+        if (this->init_draw(&draw, Draw::kRect_Type, modRect, &paint)) {
+            this->push_draw(std::move(draw));
+            return;
+        }
+    }
     fCanvas->drawRect(modRect, paint);
 }
 
@@ -338,7 +546,13 @@ void SkDeferredCanvas::onDrawRegion(const SkRegion& region, const SkPaint& paint
 
 void SkDeferredCanvas::onDrawOval(const SkRect& rect, const SkPaint& paint) {
     SkRect modRect = rect;
-    this->flush_check(&modRect, &paint, kNoClip_Flag);
+    if (this->flush_check_lazy(&modRect, &paint, kNoClip_Flag)) {
+        Draw draw;
+        if (this->init_draw(&draw, Draw::kOval_Type, modRect, &paint)) {
+            this->push_draw(std::move(draw));
+            return;
+        }
+    }
     fCanvas->drawOval(modRect, paint);
 }
 
@@ -357,10 +571,19 @@ static SkRRect make_offset(const SkRRect& src, SkScalar dx, SkScalar dy) {
 
 void SkDeferredCanvas::onDrawRRect(const SkRRect& rrect, const SkPaint& paint) {
     SkRect modRect = rrect.getBounds();
-    this->flush_check(&modRect, &paint, kNoClip_Flag);
-    fCanvas->drawRRect(make_offset(rrect,
+    bool lazy = this->flush_check_lazy(&modRect, &paint, kNoClip_Flag);
+    SkRRect modRRect = make_offset(rrect,
                                    modRect.x() - rrect.getBounds().x(),
-                                   modRect.y() - rrect.getBounds().y()), paint);
+                                   modRect.y() - rrect.getBounds().y());
+    if (lazy) {
+        Draw draw;
+        if (this->init_draw(&draw, Draw::kRRect_Type, modRect, &paint)) {
+            draw.fRRect = modRRect;
+            this->push_draw(std::move(draw));
+            return;
+        }
+    }
+    fCanvas->drawRRect(modRRect, paint);
 }
 
 void SkDeferredCanvas::onDrawDRRect(const SkRRect& outer, const SkRRect& inner, const SkPaint& paint) {
@@ -373,7 +596,15 @@ void SkDeferredCanvas::onDrawPath(const SkPath& path, const SkPaint& paint) {
         this->flush_before_saves();
     } else {
         SkRect modRect = path.getBounds();
-        this->flush_check(&modRect, &paint, kNoClip_Flag | kNoTranslate_Flag | kNoScale_Flag);
+        if (this->flush_check_lazy(&modRect, &paint,
+                                   kNoClip_Flag | kNoTranslate_Flag | kNoScale_Flag)) {
+            Draw draw;
+            if (this->init_draw(&draw, Draw::kPath_Type, path.getBounds(), &paint)) {
+                draw.fPath = path;
+                this->push_draw(std::move(draw));
+                return;
+            }
+        }
     }
     fCanvas->drawPath(path, paint);
 }
@@ -424,7 +655,18 @@ void SkDeferredCanvas::onDrawImage(const SkImage* image, SkScalar x, SkScalar y,
     const SkScalar w = SkIntToScalar(image->width());
     const SkScalar h = SkIntToScalar(image->height());
     SkRect bounds = SkRect::MakeXYWH(x, y, w, h);
-    this->flush_check(&bounds, paint, kNoClip_Flag);
+    if (this->flush_check_lazy(&bounds, paint, kNoClip_Flag)) {
+        bool scaled = bounds.width() != w || bounds.height() != h;
+        Draw draw;
+        if (this->init_draw(&draw, scaled ? Draw::kImageRect_Type : Draw::kImage_Type,
+                            bounds, paint)) {
+            draw.fImage = sk_ref_sp(const_cast<SkImage*>(image));
+            draw.fConstraint = kStrict_SrcRectConstraint;
+            this->set_cover(&draw, image->isOpaque());
+            this->push_draw(std::move(draw));
+            return;
+        }
+    }
     if (bounds.width() == w && bounds.height() == h) {
         fCanvas->drawImage(image, bounds.x(), bounds.y(), paint);
     } else {
@@ -435,7 +677,20 @@ void SkDeferredCanvas::onDrawImage(const SkImage* image, SkScalar x, SkScalar y,
 void SkDeferredCanvas::onDrawImageRect(const SkImage* image, const SkRect* src, const SkRect& dst,
                                    const SkPaint* paint, SrcRectConstraint constraint) {
     SkRect modRect = dst;
-    this->flush_check(&modRect, paint, kNoClip_Flag);
+    if (this->flush_check_lazy(&modRect, paint, kNoClip_Flag)) {
+        Draw draw;
+        if (this->init_draw(&draw, Draw::kImageRect_Type, modRect, paint)) {
+            draw.fImage = sk_ref_sp(const_cast<SkImage*>(image));
+            draw.fHasSrc = src != nullptr;
+            if (src) {
+                draw.fSrc = *src;
+            }
+            draw.fConstraint = constraint;
+            this->set_cover(&draw, image->isOpaque());
+            this->push_draw(std::move(draw));
+            return;
+        }
+    }
     fCanvas->legacy_drawImageRect(image, src, modRect, paint, constraint);
 }
 
@@ -565,8 +820,12 @@ SkIRect SkDeferredCanvas::onGetDeviceClipBounds() const {
 }
 bool SkDeferredCanvas::isClipEmpty() const { return fCanvas->isClipEmpty(); }
 bool SkDeferredCanvas::isClipRect() const { return fCanvas->isClipRect(); }
-bool SkDeferredCanvas::onPeekPixels(SkPixmap* pixmap) { return fCanvas->peekPixels(pixmap); }
+bool SkDeferredCanvas::onPeekPixels(SkPixmap* pixmap) {
+    this->flush_draws();
+    return fCanvas->peekPixels(pixmap);
+}
 bool SkDeferredCanvas::onAccessTopLayerPixels(SkPixmap* pixmap) {
+    this->flush_draws();
     SkImageInfo info;
     size_t rowBytes;
     SkIPoint* origin = nullptr;
@@ -8,16 +8,39 @@
 #ifndef SkDeferredCanvas_DEFINED
 #define SkDeferredCanvas_DEFINED
 
+#include "../private/SkTArray.h"
 #include "../private/SkTDArray.h"
+#include "SkImage.h"
 #include "SkNoDrawCanvas.h"
+#include "SkPath.h"
+#include "SkRRect.h"
 
 class SK_API SkDeferredCanvas : public SkNoDrawCanvas {
 public:
-    SkDeferredCanvas(SkCanvas* = nullptr);
+    enum EvalType {
+        // Draws are passed on right away; only save/clip/matrix changes are deferred.
+        kEager,
+        // Simple draws (rects, ovals, rrects, paths and images) are also held back until the
+        // target's state has to change, or something else is drawn.  Held draws that a later
+        // opaque draw completely covers are dropped, and abutting rects that share a paint are
+        // merged into one.
+        kLazy,
+    };
+
+    SkDeferredCanvas(SkCanvas* = nullptr, EvalType = kEager);
     ~SkDeferredCanvas() override;
 
     void reset(SkCanvas*);
 
+    struct Stats {
+        int     fOccludedDraws; // held draws dropped because a later opaque draw hid them
+        int64_t fOccludedPixels;// (roughly) the pixels those draws would have touched
+        int     fMergedRects;   // rects folded into the previous rect
+    };
+
+    // What kLazy has saved since construction or the last reset().
+    const Stats& stats() const { return fStats; }
+
 #ifdef SK_SUPPORT_LEGACY_DRAWFILTER
     SkDrawFilter* setDrawFilter(SkDrawFilter*) override;
 #endif
@@ -106,6 +129,7 @@ protected:
 
 private:
     SkCanvas* fCanvas{nullptr};
+    const EvalType fEvalType;
 
     enum Type {
         kSave_Type,
@@ -133,6 +157,40 @@ private:
     };
     SkTDArray<Rec>  fRecs;
 
+    // A draw held back by kLazy, in fCanvas' current local coordinates.
+    struct Draw {
+        enum Type {
+            kRect_Type,
+            kOval_Type,
+            kRRect_Type,
+            kPath_Type,
+            kImage_Type,
+            kImageRect_Type,
+        };
+        Type                fType;
+        SkRect              fRect;      // rect, oval or image dst
+        SkRect              fSrc;       // image src (kImageRect_Type only)
+        bool                fHasSrc;
+        SrcRectConstraint   fConstraint;
+        SkRRect             fRRect;
+        SkPath              fPath;
+        sk_sp<SkImage>      fImage;
+        SkPaint             fPaint;
+        bool                fHasPaint;
+        SkIRect             fDevBounds; // pixels this draw could touch, before antialiasing
+        SkIRect             fDevCover;  // pixels this draw is sure to overwrite, may be empty
+
+        SkIRect touchedPixels() const;
+    };
+    SkTArray<Draw>  fDraws;
+    Stats           fStats;
+
+    bool init_draw(Draw*, Draw::Type, const SkRect& geometry, const SkPaint*);
+    void set_cover(Draw*, bool contentIsOpaque);
+    void push_draw(Draw&&);
+    void emit_draw(const Draw&);
+    void flush_draws();
+
     void push_save();
     void push_cliprect(const SkRect&);
     bool push_concat(const SkMatrix&);
@@ -145,6 +203,7 @@ private:
     void flush_translate(SkScalar* x, SkScalar* y, const SkPaint&);
     void flush_translate(SkScalar* x, SkScalar* y, const SkRect& bounds, const SkPaint* = nullptr);
     void flush_check(SkRect* bounds, const SkPaint*, unsigned flags = 0);
+    bool flush_check_lazy(SkRect* bounds, const SkPaint*, unsigned flags = 0);
 
     void internal_flush_translate(SkScalar* x, SkScalar* y, const SkRect* boundsOrNull);
 
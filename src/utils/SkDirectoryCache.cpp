@@ -0,0 +1,88 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkAtomics.h"
+#include "SkDirectoryCache.h"
+#include "SkMD5.h"
+#include "SkOSFile.h"
+#include "SkOSPath.h"
+#include "SkStream.h"
+#include <stdio.h>
+
+#if defined(SK_BUILD_FOR_WIN)
+    #include <process.h>
+    static int process_id() { return _getpid(); }
+#else
+    #include <unistd.h>
+    static int process_id() { return (int)getpid(); }
+#endif
+
+// Each file holds the size of its key, the key, then the data.  Storing the key lets us tell a
+// hash collision from a hit.  The data starts 8-byte aligned, so callers can use it in place.
+static size_t data_offset(size_t keySize) {
+    return SkAlign8(sizeof(uint32_t) + keySize);
+}
+
+sk_sp<SkDirectoryCache> SkDirectoryCache::Make(const char dir[]) {
+    if (!sk_isdir(dir) && !sk_mkdir(dir)) {
+        return nullptr;
+    }
+    return sk_sp<SkDirectoryCache>(new SkDirectoryCache(dir));
+}
+
+SkString SkDirectoryCache::path(const SkData& key) const {
+    SkMD5 md5;
+    md5.write(key.data(), key.size());
+    SkMD5::Digest digest;
+    md5.finish(digest);
+
+    SkString name;
+    for (uint8_t byte : digest.data) {
+        name.appendf("%02x", byte);
+    }
+    return SkOSPath::Join(fDir.c_str(), name.c_str());
+}
+
+sk_sp<SkData> SkDirectoryCache::load(const SkData& key) {
+    sk_sp<SkData> file = SkData::MakeFromFileName(this->path(key).c_str());
+    if (!file || file->size() < sizeof(uint32_t)) {
+        return nullptr;
+    }
+    const uint32_t keySize = *(const uint32_t*)file->data();
+    const size_t dataOffset = data_offset(keySize);
+    if (keySize != key.size() || file->size() < dataOffset ||
+        0 != memcmp(file->bytes() + sizeof(uint32_t), key.data(), key.size())) {
+        return nullptr;
+    }
+    return SkData::MakeSubset(file.get(), dataOffset, file->size() - dataOffset);
+}
+
+void SkDirectoryCache::store(const SkData& key, const SkData& data) {
+    // Write to a temporary file first, then rename it into place, so that readers never see a
+    // partly written file.  The temporary's name has our process ID and a per-process counter,
+    // so no two writers, in this process or any other, ever write to the same temporary.
+    static int32_t gNextTemp = 0;
+    const SkString path = this->path(key);
+    SkString temp = path;
+    temp.appendf(".%d.%d.tmp", process_id(), sk_atomic_inc(&gNextTemp));
+    bool written;
+    {
+        SkFILEWStream file(temp.c_str());
+        if (!file.isValid()) {
+            return;
+        }
+        static const char kZeros[8] = { 0 };
+        const size_t padding = data_offset(key.size()) - sizeof(uint32_t) - key.size();
+        written = file.write32(SkToU32(key.size()))
+               && file.write(key.data(), key.size())
+               && file.write(kZeros, padding)
+               && file.write(data.data(), data.size());
+    }
+    if (!written || 0 != rename(temp.c_str(), path.c_str())) {
+        remove(temp.c_str());
+    }
+}
@@ -9,6 +9,8 @@
 #include "SkCanvas.h"
 #include "SkColorPriv.h"
 #include "SkGradientShader.h"
+#include "SkOpts.h"
+#include "SkRandom.h"
 #include "SkRect.h"
 #include "Test.h"
 
@@ -257,3 +259,25 @@ DEF_TEST(BlitRow, reporter) {
     test_00_FF(reporter);
     test_diagonal(reporter);
 }
+
+// Longer rows may take wider SIMD paths.  They should match blending one pixel at a time.
+DEF_TEST(BlitRow_color32, reporter) {
+    const int kCount = 53;
+    SkPMColor src[kCount], dst[kCount];
+    SkRandom rand;
+    for (SkPMColor& px : src) {
+        px = SkPreMultiplyColor(rand.nextU());
+    }
+
+    for (SkColor c : { 0x80FF8040u, 0x01010101u, 0xFEFFFFFFu, 0x40102030u }) {
+        SkPMColor color = SkPreMultiplyColor(c);
+        for (int count = 0; count <= kCount; count++) {
+            SkOpts::blit_row_color32(dst, src, count, color);
+            for (int i = 0; i < count; i++) {
+                SkPMColor expected;
+                SkOpts::blit_row_color32(&expected, src+i, 1, color);
+                REPORTER_ASSERT(reporter, dst[i] == expected);
+            }
+        }
+    }
+}
@@ -13,8 +13,10 @@
 #include "SkEmbossMaskFilter.h"
 #include "SkLayerDrawLooper.h"
 #include "SkMath.h"
+#include "SkOpts.h"
 #include "SkPaint.h"
 #include "SkPath.h"
+#include "SkRandom.h"
 #include "Test.h"
 
 #if SK_SUPPORT_GPU
@@ -716,3 +718,37 @@ DEF_TEST(BlurredRRectNinePatchComputation, reporter) {
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////
+
+// Some box blur implementations work on several rows at once.  They should match blurring each
+// row on its own.
+DEF_TEST(BoxBlur_MultipleRows, reporter) {
+    const int kSize = 32, kWidth = 32, kHeight = 13;
+    SkPMColor src[kSize*kSize];
+    SkRandom rand;
+    for (SkPMColor& px : src) {
+        px = SkPreMultiplyColor(rand.nextU());
+    }
+
+    struct {
+        SkOpts::BoxBlur blur;
+        int             srcStrideY;
+    } procs[] = {
+        { SkOpts::box_blur_xx, kSize },
+        { SkOpts::box_blur_yx,     1 },
+    };
+    for (auto proc : procs) {
+        for (int kernelSize : { 1, 3, 7, 20 }) {
+            const int leftOffset = kernelSize / 2,
+                     rightOffset = kernelSize - leftOffset - 1;
+
+            SkPMColor all[kWidth*kHeight], one[kWidth];
+            proc.blur(src, kSize, SkIRect::MakeLTRB(3, 0, 29, kHeight), all,
+                      kernelSize, leftOffset, rightOffset, kWidth, kHeight);
+            for (int y = 0; y < kHeight; y++) {
+                proc.blur(src + y*proc.srcStrideY, kSize, SkIRect::MakeLTRB(3, 0, 29, 1), one,
+                          kernelSize, leftOffset, rightOffset, kWidth, 1);
+                REPORTER_ASSERT(reporter, 0 == memcmp(all + y*kWidth, one, sizeof(one)));
+            }
+        }
+    }
+}
@@ -745,6 +745,126 @@ DEF_TEST(DeferredCanvas, r) {
     canvas.restore();
 }
 
+static void draw_deferred_scene(SkCanvas* canvas, SkImage* image) {
+    SkPaint paint;
+    canvas->drawColor(SK_ColorWHITE);
+
+    // Things that will end up hidden...
+    paint.setColor(SK_ColorRED);
+    canvas->drawRect(SkRect::MakeXYWH(10, 10, 20, 20), paint);
+    paint.setAntiAlias(true);
+    canvas->drawOval(SkRect::MakeXYWH(12.5f, 40.5f, 15, 15), paint);
+    canvas->drawImage(image, 5, 60);
+
+    // ...some that won't...
+    canvas->save();
+    canvas->translate(60, 10);
+    paint.setColor(0x8000FF00);
+    canvas->drawRRect(SkRRect::MakeRectXY(SkRect::MakeWH(30, 30), 5, 5), paint);
+    canvas->restore();
+    paint.setAntiAlias(false);
+    paint.setColor(SK_ColorBLUE);
+    for (int i = 0; i < 4; ++i) {
+        canvas->drawRect(SkRect::MakeXYWH(60 + 5.0f * i, 50, 5, 10), paint);
+    }
+
+    // ...and the opaque cover.
+    paint.setColor(SK_ColorBLACK);
+    canvas->drawRect(SkRect::MakeLTRB(0, 0, 50, 100), paint);
+    paint.setColor(SK_ColorYELLOW);
+    canvas->drawCircle(75, 80, 10, paint);
+}
+
+static sk_sp<SkImage> make_deferred_image() {
+    sk_sp<SkSurface> surface = SkSurface::MakeRasterN32Premul(16, 16);
+    surface->getCanvas()->clear(SK_ColorCYAN);
+    return surface->makeImageSnapshot();
+}
+
+DEF_TEST(DeferredCanvas_lazy, r) {
+    sk_sp<SkImage> image = make_deferred_image();
+    SkBitmap expected, actual;
+    expected.allocN32Pixels(100, 100);
+    actual.allocN32Pixels(100, 100);
+
+    SkCanvas expectedCanvas(expected);
+    draw_deferred_scene(&expectedCanvas, image.get());
+
+    SkCanvas actualCanvas(actual);
+    SkDeferredCanvas deferred(&actualCanvas, SkDeferredCanvas::kLazy);
+    draw_deferred_scene(&deferred, image.get());
+    deferred.flush();
+
+    REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                   expected.getSafeSize()));
+    REPORTER_ASSERT(r, 3 == deferred.stats().fOccludedDraws);
+    REPORTER_ASSERT(r, 3 == deferred.stats().fMergedRects);
+}
+
+#include "SkOverdrawCanvas.h"
+
+static int64_t total_overdraw(const SkBitmap& bitmap) {
+    int64_t total = 0;
+    for (int y = 0; y < bitmap.height(); ++y) {
+        for (int x = 0; x < bitmap.width(); ++x) {
+            total += SkGetPackedA32(*bitmap.getAddr32(x, y));
+        }
+    }
+    return total;
+}
+
+DEF_TEST(DeferredCanvas_overdraw, r) {
+    auto draw = [](SkCanvas* canvas) {
+        SkPaint paint;
+        canvas->drawRect(SkRect::MakeWH(100, 100), paint);
+        for (int i = 0; i < 4; ++i) {
+            canvas->drawRect(SkRect::MakeXYWH(25.0f * i + 5, 5, 10, 10), paint);
+        }
+        canvas->save();
+        canvas->translate(0, 20);
+        canvas->drawRect(SkRect::MakeWH(50, 80), paint);
+        canvas->restore();
+    };
+
+    SkBitmap direct, lazy;
+    direct.allocN32Pixels(100, 100);
+    direct.eraseColor(0);
+    lazy.allocN32Pixels(100, 100);
+    lazy.eraseColor(0);
+
+    SkCanvas directCanvas(direct);
+    SkOverdrawCanvas directOverdraw(&directCanvas);
+    draw(&directOverdraw);
+
+    SkCanvas lazyCanvas(lazy);
+    SkOverdrawCanvas lazyOverdraw(&lazyCanvas);
+    SkDeferredCanvas deferred(&lazyOverdraw, SkDeferredCanvas::kLazy);
+    draw(&deferred);
+    deferred.flush();
+
+    // Nothing is hidden under the last rect, which doesn't cover the top 20 rows.
+    REPORTER_ASSERT(r, 0 == deferred.stats().fOccludedDraws);
+    REPORTER_ASSERT(r, total_overdraw(direct) == total_overdraw(lazy));
+
+    // Now cover the small rects in the left half.
+    direct.eraseColor(0);
+    lazy.eraseColor(0);
+    deferred.reset(&lazyOverdraw);
+    auto drawCovered = [&](SkCanvas* canvas) {
+        draw(canvas);
+        canvas->drawRect(SkRect::MakeWH(50, 100), SkPaint());
+    };
+    drawCovered(&directOverdraw);
+    drawCovered(&deferred);
+    deferred.flush();
+
+    // The two small rects and the earlier left-half rect are dropped.
+    REPORTER_ASSERT(r, 3 == deferred.stats().fOccludedDraws);
+    REPORTER_ASSERT(r, total_overdraw(direct) - total_overdraw(lazy) ==
+                       deferred.stats().fOccludedPixels);
+    REPORTER_ASSERT(r, 2 * 10 * 10 + 50 * 80 == deferred.stats().fOccludedPixels);
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "SkCanvasStack.h"
@@ -5,11 +5,13 @@
  * found in the LICENSE file.
  */
 
+#include "SkAnimationDecoder.h"
 #include "SkBitmap.h"
 #include "SkCodec.h"
 #include "SkCommonFlags.h"
 #include "SkImageEncoder.h"
 #include "SkOSPath.h"
+#include "SkRandom.h"
 #include "SkStream.h"
 
 #include "Resources.h"
@@ -182,3 +184,95 @@ DEF_TEST(Codec_frames, r) {
         }
     }
 }
+
+DEF_TEST(Codec_animationDecoder, r) {
+    for (const char* name : { "randPixelsAnim.gif", "test640x479.gif", "colorTables.gif",
+                              "box.gif" }) {
+        sk_sp<SkData> data(GetResourceAsData(name));
+        if (!data) {
+            continue;
+        }
+
+        std::unique_ptr<SkCodec> codec(SkCodec::NewFromData(data));
+        REPORTER_ASSERT(r, codec);
+        auto frameInfos = codec->getFrameInfo();
+        if (frameInfos.empty()) {
+            frameInfos.push_back({ SkCodec::kNone, 0, true });
+        }
+        // A cache smaller than the animation forces frames to be evicted and decoded again.
+        auto decoder = SkAnimationDecoder::Make(data, 2, 1);
+        REPORTER_ASSERT(r, decoder);
+        REPORTER_ASSERT(r, decoder->frameCount() == frameInfos.size());
+        const SkImageInfo& info = decoder->info();
+        REPORTER_ASSERT(r, kN32_SkColorType == info.colorType());
+        REPORTER_ASSERT(r, kUnpremul_SkAlphaType != info.alphaType());
+
+        // Decode every frame in order on this thread, handing each its required frame.
+        std::vector<SkBitmap> expected(frameInfos.size());
+        for (size_t i = 0; i < frameInfos.size(); i++) {
+            expected[i].allocPixels(info);
+            SkCodec::Options opts;
+            opts.fFrameIndex = i;
+            const size_t required = frameInfos[i].fRequiredFrame;
+            opts.fHasPriorFrame = SkCodec::kNone != required;
+            if (opts.fHasPriorFrame) {
+                REPORTER_ASSERT(r, expected[required].copyTo(&expected[i]));
+            }
+            REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(info,
+                    expected[i].getPixels(), expected[i].rowBytes(), &opts, nullptr, nullptr));
+        }
+
+        SkRandom rand;
+        std::vector<size_t> order;
+        for (int pass = 0; pass < 2; pass++) {
+            for (size_t i = 0; i < frameInfos.size(); i++) {
+                order.push_back(i);
+            }
+        }
+        for (size_t i = 0; i < 2 * frameInfos.size(); i++) {
+            order.push_back(rand.nextULessThan(SkToU32(frameInfos.size())));
+        }
+
+        for (size_t i : order) {
+            SkBitmap frame;
+            if (!decoder->getFrame(i, &frame)) {
+                ERRORF(r, "%s: failed to get frame " SK_SIZE_T_SPECIFIER, name, i);
+                continue;
+            }
+            REPORTER_ASSERT(r, frame.isImmutable());
+            SkAutoLockPixels alp(frame);
+            if (0 != memcmp(frame.getPixels(), expected[i].getPixels(), info.getSafeSize(
+                        expected[i].rowBytes()))) {
+                ERRORF(r, "%s: frame " SK_SIZE_T_SPECIFIER " does not match the sequential decode",
+                       name, i);
+            }
+        }
+    }
+}
+
+DEF_TEST(Codec_animationDecoder_frameAtTime, r) {
+    sk_sp<SkData> data(GetResourceAsData("test640x479.gif"));
+    if (!data) {
+        return;
+    }
+    // Four frames of 200ms, looping forever.
+    auto decoder = SkAnimationDecoder::Make(data);
+    REPORTER_ASSERT(r, decoder);
+    REPORTER_ASSERT(r, 0 == decoder->frameAtTime(0));
+    REPORTER_ASSERT(r, 1 == decoder->frameAtTime(250));
+    REPORTER_ASSERT(r, 3 == decoder->frameAtTime(799));
+    REPORTER_ASSERT(r, 0 == decoder->frameAtTime(800));
+    REPORTER_ASSERT(r, 2 == decoder->frameAtTime(80000 + 450));
+
+    data = GetResourceAsData("colorTables.gif");
+    if (!data) {
+        return;
+    }
+    // Two frames of 1000ms, played once and repeated five times.
+    decoder = SkAnimationDecoder::Make(data);
+    REPORTER_ASSERT(r, decoder);
+    REPORTER_ASSERT(r, 0 == decoder->frameAtTime(10500));
+    REPORTER_ASSERT(r, 1 == decoder->frameAtTime(11500));
+    REPORTER_ASSERT(r, 1 == decoder->frameAtTime(12000));
+    REPORTER_ASSERT(r, 1 == decoder->frameAtTime(50000));
+}
@@ -5,12 +5,15 @@
  * found in the LICENSE file.
  */
 
+#include "SkAndroidCodec.h"
 #include "SkBitmap.h"
 #include "SkCodec.h"
+#include "SkCodecPriv.h"
 #include "SkData.h"
 #include "SkImageInfo.h"
 #include "SkRWBuffer.h"
 #include "SkString.h"
+#include "SkTemplates.h"
 
 #include "FakeStreams.h"
 #include "Resources.h"
@@ -137,6 +140,99 @@ DEF_TEST(Codec_partial, r) {
     test_partial(r, "box.gif");
     test_partial(r, "randPixels.gif", 215);
     test_partial(r, "color_wheel.gif");
+
+    // Progressive jpegs.
+    test_partial(r, "brickwork-texture.jpg");
+    test_partial(r, "grayscale.jpg");
+}
+
+// A progressive jpeg should be drawn in full, at lower quality, long before all of it arrives,
+// and then refined as more scans come in.
+DEF_TEST(Codec_partialProgressiveJpeg, r) {
+    const char* name = "brickwork-texture.jpg";
+    sk_sp<SkData> file = make_from_resource(name);
+    if (!file) {
+        SkDebugf("missing resource %s\n", name);
+        return;
+    }
+
+    SkBitmap truth;
+    if (!create_truth(file, &truth)) {
+        ERRORF(r, "Failed to decode %s\n", name);
+        return;
+    }
+
+    HaltingStream* stream = new HaltingStream(file, 1000);
+    std::unique_ptr<SkCodec> partialCodec(SkCodec::NewFromStream(stream));
+    if (!partialCodec) {
+        ERRORF(r, "Failed to create codec for %s", name);
+        return;
+    }
+
+    const SkImageInfo info = standardize_info(partialCodec.get());
+    SkBitmap incremental;
+    incremental.allocPixels(info);
+    while (SkCodec::kSuccess != partialCodec->startIncrementalDecode(info,
+            incremental.getPixels(), incremental.rowBytes())) {
+        if (stream->isAllDataReceived()) {
+            ERRORF(r, "Failed to start incremental decode\n");
+            return;
+        }
+        stream->addNewData(1000);
+    }
+
+    size_t firstPixels = 0;
+    int refinements = 0;
+    SkAutoTMalloc<uint8_t> previous(incremental.getSafeSize());
+    while (true) {
+        int rowsDecoded = -1;
+        const SkCodec::Result result = partialCodec->incrementalDecode(&rowsDecoded);
+        if (SkCodec::kSuccess == result) {
+            break;
+        }
+
+        REPORTER_ASSERT(r, SkCodec::kIncompleteInput == result);
+        REPORTER_ASSERT(r, 0 == rowsDecoded || info.height() == rowsDecoded);
+        if (info.height() == rowsDecoded) {
+            // Keep track of how often what we show changes from one pass to the next.
+            if (0 == firstPixels) {
+                firstPixels = stream->getLength();
+                refinements++;
+            } else if (memcmp(incremental.getPixels(), previous.get(),
+                              incremental.getSafeSize()) != 0) {
+                refinements++;
+            }
+            memcpy(previous.get(), incremental.getPixels(), incremental.getSafeSize());
+        }
+
+        if (stream->isAllDataReceived()) {
+            ERRORF(r, "Failed to completely decode %s", name);
+            return;
+        }
+        stream->addNewData(1000);
+    }
+
+    REPORTER_ASSERT(r, firstPixels > 0 && firstPixels < file->size() / 2);
+    REPORTER_ASSERT(r, refinements > 1);
+    compare_bitmaps(r, truth, incremental);
+
+    // Sampling, which skips rows in each pass, should give the same pixels as a full decode.
+    std::unique_ptr<SkAndroidCodec> androidCodec(SkAndroidCodec::NewFromData(file));
+    const int sampleSize = 3;
+    const SkISize dims = androidCodec->getSampledDimensions(sampleSize);
+    SkBitmap sampled;
+    sampled.allocPixels(info.makeWH(dims.width(), dims.height()));
+    SkAndroidCodec::AndroidOptions options;
+    options.fSampleSize = sampleSize;
+    REPORTER_ASSERT(r, SkCodec::kSuccess == androidCodec->getAndroidPixels(sampled.info(),
+            sampled.getPixels(), sampled.rowBytes(), &options));
+    for (int y = 0; y < dims.height(); y++) {
+        for (int x = 0; x < dims.width(); x++) {
+            REPORTER_ASSERT(r, *sampled.getAddr32(x, y) ==
+                    *truth.getAddr32(get_start_coord(sampleSize) + x * sampleSize,
+                                     get_start_coord(sampleSize) + y * sampleSize));
+        }
+    }
 }
 
 DEF_TEST(Codec_partialAnim, r) {
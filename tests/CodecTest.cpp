@@ -12,10 +12,14 @@
 #include "SkBitmap.h"
 #include "SkCodec.h"
 #include "SkCodecImageGenerator.h"
+#include "SkCodecPriv.h"
+#include "SkColorSpacePriv.h"
 #include "SkColorSpace_XYZ.h"
+#include "SkColorSpaceXform.h"
 #include "SkData.h"
 #include "SkFrontBufferedStream.h"
 #include "SkImageEncoder.h"
+#include "SkImageEncoderPriv.h"
 #include "SkMD5.h"
 #include "SkPngChunkReader.h"
 #include "SkRandom.h"
@@ -500,6 +504,7 @@ DEF_TEST(Codec_jpg, r) {
     // grayscale.jpg is too small to test incomplete
     check(r, "grayscale.jpg", SkISize::Make(128, 128), true, false, false);
     check(r, "mandrill_512_q075.jpg", SkISize::Make(512, 512), true, false, true);
+    check(r, "mandrill_512_q075_restart.jpg", SkISize::Make(512, 512), true, false, true);
     // randPixels.jpg is too small to test incomplete
     check(r, "randPixels.jpg", SkISize::Make(8, 8), true, false, false);
 }
@@ -1043,7 +1048,112 @@ DEF_TEST(Codec_jpeg_rewind, r) {
     REPORTER_ASSERT(r, SkCodec::kSuccess == result);
 }
 
-static void check_color_xform(skiatest::Reporter* r, const char* path) {
+// Jpegs with restart markers decode in parallel bands when their data is in memory.  They should
+// match the same jpeg without restart markers exactly.
+static void check_restart_intervals(skiatest::Reporter* r, const char* path,
+                                    const char* restartPath) {
+    sk_sp<SkData> data = GetResourceAsData(path);
+    sk_sp<SkData> restartData = GetResourceAsData(restartPath);
+    if (!data || !restartData) {
+        return;
+    }
+    std::unique_ptr<SkCodec> codec(SkCodec::NewFromData(data));
+    std::unique_ptr<SkCodec> restartCodec(SkCodec::NewFromData(restartData));
+    if (!codec || !restartCodec) {
+        ERRORF(r, "Unable to create codec for '%s' or '%s'.", path, restartPath);
+        return;
+    }
+
+    const SkImageInfo infos[] = {
+        codec->getInfo().makeColorType(kRGBA_8888_SkColorType),
+        codec->getInfo().makeColorType(kBGRA_8888_SkColorType),
+        codec->getInfo().makeColorType(kRGB_565_SkColorType).makeColorSpace(nullptr),
+        codec->getInfo().makeColorType(kRGBA_F16_SkColorType)
+                        .makeColorSpace(SkColorSpace::MakeNamed(SkColorSpace::kSRGBLinear_Named)),
+    };
+    for (const SkImageInfo& info : infos) {
+        for (int num = 1; num <= 8; num++) {
+            const SkImageInfo scaledInfo =
+                    info.makeWH(codec->getScaledDimensions(num / 8.0f).width(),
+                                codec->getScaledDimensions(num / 8.0f).height());
+            SkBitmap expected, actual;
+            expected.allocPixels(scaledInfo);
+            actual.allocPixels(scaledInfo);
+            REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(scaledInfo,
+                    expected.getPixels(), expected.rowBytes()));
+            REPORTER_ASSERT(r, SkCodec::kSuccess == restartCodec->getPixels(scaledInfo,
+                    actual.getPixels(), actual.rowBytes()));
+            REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                           expected.getSafeSize()));
+        }
+    }
+}
+
+DEF_TEST(Codec_jpeg_restart, r) {
+    // Restart markers every 40 MCUs, which is every 5 MCU rows.  The chroma is subsampled
+    // vertically, so the bands must be decoded with some overlap.
+    check_restart_intervals(r, "mandrill_512_q075.jpg", "mandrill_512_q075_restart.jpg");
+    // Restart markers every MCU row.
+    check_restart_intervals(r, "mandrill_h2v1.jpg", "mandrill_h2v1_restart.jpg");
+}
+
+static void check_region_decode(skiatest::Reporter* r, const char* path) {
+    std::unique_ptr<SkAndroidCodec> codec(SkAndroidCodec::NewFromStream(GetResourceAsStream(path)));
+    if (!codec) {
+        ERRORF(r, "Unable to create codec '%s'.", path);
+        return;
+    }
+
+    // Subsets start on multiples of every sample size we use, so they line up with a
+    // sampled decode of the whole image.
+    const SkIRect subsets[] = {
+        SkIRect::MakeXYWH(  0,   0, 100,  90),
+        SkIRect::MakeXYWH( 96,  48, 200, 300),
+        SkIRect::MakeXYWH(336, 384, 176, 128),
+    };
+    for (int sampleSize : { 1, 2, 4, 6, 8, 16 }) {
+        SkImageInfo fullInfo = codec->getInfo().makeWH(codec->getSampledDimensions(sampleSize).width(),
+                                                       codec->getSampledDimensions(sampleSize).height())
+                                               .makeColorType(kN32_SkColorType);
+        SkBitmap full;
+        full.allocPixels(fullInfo);
+        SkAndroidCodec::AndroidOptions opts;
+        opts.fSampleSize = sampleSize;
+        REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getAndroidPixels(fullInfo,
+                full.getPixels(), full.rowBytes(), &opts));
+
+        for (SkIRect subset : subsets) {
+            SkISize size = codec->getSampledSubsetDimensions(sampleSize, subset);
+            SkBitmap region;
+            region.allocPixels(fullInfo.makeWH(size.width(), size.height()));
+            opts.fSubset = &subset;
+            SkCodec::Result result = codec->getAndroidPixels(region.info(), region.getPixels(),
+                                                             region.rowBytes(), &opts);
+            opts.fSubset = nullptr;
+            if (SkCodec::kSuccess != result) {
+                ERRORF(r, "%s: region decode failed, sample size %d", path, sampleSize);
+                continue;
+            }
+
+            const int left = subset.x() / sampleSize,
+                      top  = subset.y() / sampleSize;
+            int mismatches = 0;
+            for (int y = 0; y < region.height(); y++) {
+                mismatches += 0 != memcmp(region.getAddr32(0, y), full.getAddr32(left, top + y),
+                                          region.width() * sizeof(uint32_t));
+            }
+            REPORTER_ASSERT(r, 0 == mismatches);
+        }
+    }
+}
+
+DEF_TEST(Codec_jpeg_regionDecode, r) {
+    check_region_decode(r, "mandrill_512_q075.jpg");
+    check_region_decode(r, "mandrill_h1v1.jpg");
+}
+
+static void check_color_xform(skiatest::Reporter* r, const char* path,
+                              sk_sp<SkColorSpace> colorSpace) {
     std::unique_ptr<SkAndroidCodec> codec(SkAndroidCodec::NewFromStream(GetResourceAsStream(path)));
 
     SkAndroidCodec::AndroidOptions opts;
@@ -1055,9 +1165,6 @@ static void check_color_xform(skiatest::Reporter* r, const char* path) {
 
     const int dstWidth = subsetWidth / opts.fSampleSize;
     const int dstHeight = subsetHeight / opts.fSampleSize;
-    sk_sp<SkData> data = SkData::MakeFromFileName(
-            GetResourcePath("icc_profiles/HP_ZR30w.icc").c_str());
-    sk_sp<SkColorSpace> colorSpace = SkColorSpace::MakeICC(data->data(), data->size());
     SkImageInfo dstInfo = codec->getInfo().makeWH(dstWidth, dstHeight)
                                           .makeColorType(kN32_SkColorType)
                                           .makeColorSpace(colorSpace);
@@ -1066,11 +1173,54 @@ static void check_color_xform(skiatest::Reporter* r, const char* path) {
     SkAutoMalloc pixelStorage(dstInfo.getSafeSize(rowBytes));
     SkCodec::Result result = codec->getAndroidPixels(dstInfo, pixelStorage.get(), rowBytes, &opts);
     REPORTER_ASSERT(r, SkCodec::kSuccess == result);
+
+    // Converting while decoding should match decoding first and converting afterwards.
+    SkAutoMalloc legacyStorage(dstInfo.getSafeSize(rowBytes));
+    result = codec->getAndroidPixels(dstInfo.makeColorSpace(nullptr), legacyStorage.get(),
+                                     rowBytes, &opts);
+    REPORTER_ASSERT(r, SkCodec::kSuccess == result);
+
+    std::unique_ptr<SkColorSpaceXform> xform =
+            SkColorSpaceXform::New(codec->getInfo().colorSpace(), colorSpace.get());
+    SkAutoTMalloc<uint32_t> expected(dstWidth);
+    for (int y = 0; y < dstHeight; y++) {
+        const uint32_t* legacy = SkTAddOffset<uint32_t>(legacyStorage.get(), y * rowBytes);
+        const uint32_t* actual = SkTAddOffset<uint32_t>(pixelStorage.get(), y * rowBytes);
+        SkAssertResult(xform->apply(select_xform_format(kN32_SkColorType), expected.get(),
+                                    select_xform_format(kN32_SkColorType), legacy, dstWidth,
+                                    kOpaque_SkAlphaType));
+        for (int x = 0; x < dstWidth; x++) {
+            for (int shift : { 0, 8, 16, 24 }) {
+                int e = (expected[x] >> shift) & 0xFF,
+                    a = (actual[x]   >> shift) & 0xFF;
+                REPORTER_ASSERT(r, SkTAbs(e - a) <= 1);
+            }
+        }
+    }
 }
 
 DEF_TEST(Codec_ColorXform, r) {
-    check_color_xform(r, "mandrill_512_q075.jpg");
-    check_color_xform(r, "mandrill_512.png");
+    // A named gamma destination, where the xform loads 8-bit RGB png rows directly...
+    sk_sp<SkData> data = SkData::MakeFromFileName(
+            GetResourcePath("icc_profiles/HP_ZR30w.icc").c_str());
+    sk_sp<SkColorSpace> namedSpace = SkColorSpace::MakeICC(data->data(), data->size());
+    check_color_xform(r, "mandrill_512_q075.jpg", namedSpace);
+    check_color_xform(r, "mandrill_512.png", namedSpace);
+
+    // ...and a table gamma destination, where they are still swizzled to RGBA first.
+    SkColorSpaceTransferFn fn;
+    fn.fA = 1.0f;
+    fn.fB = 0.0f;
+    fn.fC = 0.0f;
+    fn.fD = 0.0f;
+    fn.fE = 0.0f;
+    fn.fF = 0.0f;
+    fn.fG = 1.8f;
+    SkMatrix44 toXYZD50(SkMatrix44::kUninitialized_Constructor);
+    toXYZD50.set3x3RowMajorf(gAdobeRGB_toXYZD50);
+    sk_sp<SkColorSpace> tableSpace = SkColorSpace::MakeRGB(fn, toXYZD50);
+    check_color_xform(r, "mandrill_512_q075.jpg", tableSpace);
+    check_color_xform(r, "mandrill_512.png", tableSpace);
 }
 
 static bool color_type_match(SkColorType origColorType, SkColorType codecColorType) {
@@ -1177,6 +1327,94 @@ DEF_TEST(Codec_PngRoundTrip, r) {
     }
 }
 
+// Parallel png encodes compress differently, but must decode to the same pixels.
+static void check_parallel_png_encode(skiatest::Reporter* r, const SkBitmap& bm,
+                                      SkEncodeOptions::PremulBehavior premulBehavior) {
+    SkPixmap pixmap;
+    REPORTER_ASSERT(r, bm.peekPixels(&pixmap));
+
+    SkEncodeOptions options;
+    options.fPremulBehavior = premulBehavior;
+    SkDynamicMemoryWStream serial, parallel;
+    REPORTER_ASSERT(r, SkEncodeImageAsPNG(&serial, pixmap, options));
+    options.fParallel = true;
+    REPORTER_ASSERT(r, SkEncodeImageAsPNG(&parallel, pixmap, options));
+
+    SkBitmap decoded[2];
+    sk_sp<SkData> data[2] = { serial.detachAsData(), parallel.detachAsData() };
+    for (int i = 0; i < 2; i++) {
+        std::unique_ptr<SkCodec> codec(SkCodec::NewFromData(data[i]));
+        if (!codec) {
+            ERRORF(r, "Unable to decode png encoded with fParallel = %d.", i);
+            return;
+        }
+        SkPMColor colors[256];
+        int colorCount = 256;
+        SkImageInfo info = codec->getInfo().makeColorType(bm.colorType()).makeColorSpace(nullptr);
+        if (kRGBA_F16_SkColorType == bm.colorType()) {
+            info = info.makeColorSpace(bm.info().refColorSpace());
+        }
+        sk_sp<SkColorTable> colorTable(new SkColorTable(colors, 256));
+        decoded[i].allocPixels(info, nullptr, colorTable.get());
+        REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(info, decoded[i].getPixels(),
+                decoded[i].rowBytes(), nullptr, const_cast<SkPMColor*>(colorTable->readColors()),
+                &colorCount));
+    }
+
+    SkMD5::Digest d1, d2;
+    md5(decoded[0], &d1);
+    md5(decoded[1], &d2);
+    REPORTER_ASSERT(r, d1 == d2);
+    if (kIndex_8_SkColorType == bm.colorType()) {
+        REPORTER_ASSERT(r, 0 == memcmp(decoded[0].getColorTable()->readColors(),
+                                       decoded[1].getColorTable()->readColors(),
+                                       decoded[0].getColorTable()->count() * sizeof(SkPMColor)));
+    }
+}
+
+DEF_TEST(Codec_PngParallelEncode, r) {
+    for (const char* path : { "mandrill_512.png", "yellow_rose.png", "index8.png" }) {
+        std::unique_ptr<SkCodec> codec(SkCodec::NewFromStream(GetResourceAsStream(path)));
+        if (!codec) {
+            continue;
+        }
+
+        const SkImageInfo info = codec->getInfo();
+        SkTArray<SkImageInfo> infos;
+        if (kIndex_8_SkColorType == info.colorType()) {
+            infos.push_back(info.makeColorSpace(nullptr));
+        } else {
+            const SkAlphaType alphaType = kOpaque_SkAlphaType == info.alphaType()
+                                        ? kOpaque_SkAlphaType : kPremul_SkAlphaType;
+            infos.push_back(info.makeColorType(kRGBA_8888_SkColorType).makeAlphaType(alphaType)
+                                .makeColorSpace(nullptr));
+            infos.push_back(info.makeColorType(kBGRA_8888_SkColorType).makeAlphaType(alphaType)
+                                .makeColorSpace(nullptr));
+            infos.push_back(info.makeColorType(kRGBA_8888_SkColorType)
+                                .makeAlphaType(kUnpremul_SkAlphaType).makeColorSpace(nullptr));
+            infos.push_back(info.makeColorType(kRGBA_F16_SkColorType).makeAlphaType(alphaType)
+                    .makeColorSpace(SkColorSpace::MakeNamed(SkColorSpace::kSRGBLinear_Named)));
+            if (kOpaque_SkAlphaType == alphaType) {
+                infos.push_back(info.makeColorType(kRGB_565_SkColorType).makeColorSpace(nullptr));
+            }
+        }
+
+        for (const SkImageInfo& dstInfo : infos) {
+            SkPMColor colors[256];
+            int colorCount = 256;
+            sk_sp<SkColorTable> colorTable(new SkColorTable(colors, 256));
+            SkBitmap bm;
+            bm.allocPixels(dstInfo, nullptr, colorTable.get());
+            REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(dstInfo, bm.getPixels(),
+                    bm.rowBytes(), nullptr, const_cast<SkPMColor*>(colorTable->readColors()),
+                    &colorCount));
+            check_parallel_png_encode(r, bm, dstInfo.colorSpace()
+                                             ? SkEncodeOptions::PremulBehavior::kGammaCorrect
+                                             : SkEncodeOptions::PremulBehavior::kLegacy);
+        }
+    }
+}
+
 static void test_conversion_possible(skiatest::Reporter* r, const char* path,
                                      bool supportsScanlineDecoder,
                                      bool supportsIncrementalDecoder) {
@@ -1341,7 +1579,6 @@ DEF_TEST(Codec_fallBack, r) {
 
     // Formats that currently do not support incremental decoding
     auto files = {
-            "CMYK.jpg",
             "color_wheel.ico",
             "mandrill.wbmp",
             "randPixels.bmp",
@@ -337,3 +337,48 @@ DEF_TEST(SkColorSpaceXform_LoadTail, r) {
     REPORTER_ASSERT(r, success);
 }
 
+
+DEF_TEST(SkColorSpaceXform_RGB888, r) {
+    // Packed RGB should convert just like the same pixels stored as opaque RGBA.
+    constexpr int width = 37;
+    uint8_t rgb[3*width];
+    uint32_t rgba[width];
+    for (int i = 0; i < width; i++) {
+        rgb[3*i+0] = (uint8_t) (i * 7);
+        rgb[3*i+1] = (uint8_t) (i * 29 + 3);
+        rgb[3*i+2] = (uint8_t) (255 - i * 5);
+        rgba[i] = 0xFF000000 | rgb[3*i+2] << 16 | rgb[3*i+1] << 8 | rgb[3*i+0];
+    }
+
+    sk_sp<SkColorSpace> adobe = SkColorSpace::MakeNamed(SkColorSpace::kAdobeRGB_Named);
+    sk_sp<SkColorSpace> srgb = SkColorSpace::MakeNamed(SkColorSpace::kSRGB_Named);
+    sk_sp<SkColorSpace> linear = SkColorSpace::MakeNamed(SkColorSpace::kSRGBLinear_Named);
+    SkColorSpaceTransferFn fn;
+    fn.fA = 1.0f;
+    fn.fB = fn.fC = fn.fD = fn.fE = fn.fF = 0.0f;
+    fn.fG = 1.8f;
+    sk_sp<SkColorSpace> gamma18 = SkColorSpace::MakeRGB(fn, SkMatrix44::I());
+    const std::pair<SkColorSpace*, SkColorSpace*> pairs[] = {
+        { adobe.get(), srgb.get() }, { srgb.get(), adobe.get() }, { linear.get(), srgb.get() },
+        { gamma18.get(), srgb.get() },
+    };
+    for (const auto& pair : pairs) {
+        std::unique_ptr<SkColorSpaceXform> xform = SkColorSpaceXform::New(pair.first, pair.second);
+        REPORTER_ASSERT(r, xform);
+        for (int count : { 1, 3, 4, 17, width }) {
+            uint32_t expected[width], actual[width];
+            REPORTER_ASSERT(r, xform->apply(SkColorSpaceXform::kBGRA_8888_ColorFormat, expected,
+                                            SkColorSpaceXform::kRGBA_8888_ColorFormat, rgba,
+                                            count, kPremul_SkAlphaType));
+            REPORTER_ASSERT(r, xform->apply(SkColorSpaceXform::kBGRA_8888_ColorFormat, actual,
+                                            SkColorSpaceXform::kRGB_888_ColorFormat, rgb,
+                                            count, kPremul_SkAlphaType));
+            for (int i = 0; i < count; i++) {
+                for (int shift : { 0, 8, 16, 24 }) {
+                    REPORTER_ASSERT(r, almost_equal((expected[i] >> shift) & 0xFF,
+                                                    (actual[i] >> shift) & 0xFF));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+
+#include "SkCanvas.h"
+#include "SkGraphics.h"
+#include "SkSurface.h"
+#include "SkTaskGroup.h"
+
+static void draw_text(SkCanvas* canvas) {
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    canvas->clear(SK_ColorWHITE);
+    for (int size = 8; size < 24; size += 3) {
+        paint.setTextSize(SkIntToScalar(size));
+        canvas->drawText("glyphs", 6, 4, SkIntToScalar(size * 4), paint);
+    }
+}
+
+// Threads hold on to the strikes they've used recently.  Make sure that's invisible, even while
+// other threads purge the cache out from under them.
+DEF_TEST(GlyphCache_Threads, r) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(80, 100);
+
+    auto expected = SkSurface::MakeRaster(info);
+    draw_text(expected->getCanvas());
+    SkBitmap a;
+    a.allocPixels(info);
+    REPORTER_ASSERT(r, expected->getCanvas()->readPixels(&a, 0, 0));
+
+    SkTaskGroup().batch(16, [&](int i) {
+        auto surface = SkSurface::MakeRaster(info);
+        for (int j = 0; j < 10; j++) {
+            if (i % 4 == 0 && j % 3 == 0) {
+                SkGraphics::PurgeFontCache();
+            }
+            draw_text(surface->getCanvas());
+
+            SkBitmap b;
+            b.allocPixels(info);
+            REPORTER_ASSERT(r, surface->getCanvas()->readPixels(&b, 0, 0));
+            REPORTER_ASSERT(r, 0 == memcmp(a.getPixels(), b.getPixels(), a.getSafeSize()));
+        }
+    });
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+
+#include "SkBBHFactory.h"
+#include "SkBlurMaskFilter.h"
+#include "SkCanvas.h"
+#include "SkMultiPictureDraw.h"
+#include "SkPictureRecorder.h"
+#include "SkRRect.h"
+#include "SkRandom.h"
+#include "SkSurface.h"
+
+static sk_sp<SkPicture> make_picture(bool useBBH) {
+    SkRTreeFactory factory;
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(300, 300, useBBH ? &factory : nullptr);
+
+    SkRandom rand;
+    SkPaint paint;
+    for (int i = 0; i < 200; i++) {
+        paint.setColor(rand.nextU() | 0xFF000000);
+        paint.setAntiAlias(rand.nextBool());
+        const SkRect r = SkRect::MakeXYWH(rand.nextRangeF(-20, 300), rand.nextRangeF(-20, 300),
+                                          rand.nextRangeF(1, 60), rand.nextRangeF(1, 60));
+        switch (i % 3) {
+            case 0: canvas->drawRect(r, paint);                             break;
+            case 1: canvas->drawOval(r, paint);                             break;
+            case 2: canvas->drawRRect(SkRRect::MakeRectXY(r, 5, 5), paint); break;
+        }
+    }
+
+    // Blurs reach across band boundaries.
+    SkPaint blurred;
+    blurred.setColor(0x8000FF00);
+    blurred.setMaskFilter(SkBlurMaskFilter::Make(kNormal_SkBlurStyle, 6));
+    canvas->drawCircle(150, 128, 40, blurred);
+
+    SkPaint layerPaint;
+    layerPaint.setAlpha(0x80);
+    canvas->saveLayer(nullptr, &layerPaint);
+        canvas->drawCircle(200, 60, 50, paint);
+    canvas->restore();
+
+    return recorder.finishRecordingAsPicture();
+}
+
+// Banded draws should match drawing the picture serially once per band, clipped to that band.
+// (This won't always match one unclipped draw exactly: clipping chops curves differently.)
+// Pass expectBands = false when the draw can't be banded and should match a plain draw.
+static void draw_banded(skiatest::Reporter* r, bool useBBH, int bandCount, bool expectBands,
+                        void (*setup)(SkCanvas*)) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(256, 256);
+    sk_sp<SkPicture> picture = make_picture(useBBH);
+    const SkMatrix matrix = SkMatrix::MakeScale(0.9f, 0.9f);
+
+    auto expected = SkSurface::MakeRaster(info);
+    auto banded   = SkSurface::MakeRaster(info);
+    for (SkSurface* surface : { expected.get(), banded.get() }) {
+        surface->getCanvas()->clear(SK_ColorWHITE);
+        setup(surface->getCanvas());
+    }
+
+    SkCanvas* canvas = expected->getCanvas();
+    if (expectBands) {
+        const SkIRect clip = canvas->getDeviceClipBounds();
+        const SkMatrix ctm = canvas->getTotalMatrix();
+        const int bandHeight = (clip.height() + bandCount - 1) / bandCount;
+        for (int top = clip.fTop; top < clip.fBottom; top += bandHeight) {
+            canvas->save();
+            canvas->resetMatrix();
+            canvas->clipRect(SkRect::Make(SkIRect::MakeLTRB(clip.fLeft, top, clip.fRight,
+                                                            top + bandHeight)));
+            canvas->setMatrix(ctm);
+            canvas->drawPicture(picture, &matrix, nullptr);
+            canvas->restore();
+        }
+    } else {
+        canvas->drawPicture(picture, &matrix, nullptr);
+    }
+
+    // Snapshot first to make sure banded draws still copy-on-write.
+    sk_sp<SkImage> before = banded->makeImageSnapshot();
+
+    SkMultiPictureDraw mpd;
+    mpd.addBanded(banded->getCanvas(), picture.get(), &matrix, nullptr, bandCount);
+    mpd.draw();
+
+    SkBitmap a, b, c;
+    a.allocPixels(info);
+    b.allocPixels(info);
+    c.allocPixels(info);
+    expected->getCanvas()->restoreToCount(1);
+    banded->getCanvas()->restoreToCount(1);
+    REPORTER_ASSERT(r, expected->getCanvas()->readPixels(&a, 0, 0));
+    REPORTER_ASSERT(r, banded->getCanvas()->readPixels(&b, 0, 0));
+    REPORTER_ASSERT(r, before->readPixels(info, c.getPixels(), c.rowBytes(), 0, 0));
+    REPORTER_ASSERT(r, 0 == memcmp(a.getPixels(), b.getPixels(), a.getSafeSize()));
+    REPORTER_ASSERT(r, 0 != memcmp(a.getPixels(), c.getPixels(), a.getSafeSize()));
+}
+
+DEF_TEST(MultiPictureDraw_Banded, r) {
+    for (bool useBBH : { false, true }) {
+        for (int bandCount : { 1, 3, 16, 256 }) {
+            draw_banded(r, useBBH, bandCount, true, [](SkCanvas*) {});
+            draw_banded(r, useBBH, bandCount, true, [](SkCanvas* canvas) {
+                canvas->clipRect(SkRect::MakeLTRB(17, 30, 230, 201));
+                canvas->translate(12, -7);
+                canvas->rotate(5);
+            });
+        }
+    }
+}
+
+DEF_TEST(MultiPictureDraw_BandedFallback, r) {
+    // Neither a complex clip nor drawing into a layer can be banded, but they must still draw.
+    draw_banded(r, true, 8, false, [](SkCanvas* canvas) {
+        canvas->clipRRect(SkRRect::MakeOval(SkRect::MakeLTRB(10, 10, 240, 200)), true);
+    });
+    draw_banded(r, true, 8, false, [](SkCanvas* canvas) {
+        const SkRect bounds = SkRect::MakeLTRB(20, 20, 200, 200);
+        canvas->saveLayer(&bounds, nullptr);
+    });
+}
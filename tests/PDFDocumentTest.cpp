@@ -9,6 +9,7 @@
 #include "Resources.h"
 #include "SkCanvas.h"
 #include "SkDocument.h"
+#include "SkImage.h"
 #include "SkOSFile.h"
 #include "SkOSPath.h"
 #include "SkStream.h"
@@ -222,3 +223,42 @@ DEF_TEST(SkPDF_pdfa_document, r) {
         }
     }
 }
+
+static sk_sp<SkData> make_report(bool parallel) {
+    SkDocument::PDFMetadata metadata;
+    metadata.fParallel = parallel;
+    SkDynamicMemoryWStream buffer;
+    auto doc = SkDocument::MakePDF(&buffer, SK_ScalarDefaultRasterDPI, metadata, nullptr, false);
+
+    sk_sp<SkImage> opaque = GetResourceAsImage("mandrill_64.png");
+    SkBitmap alpha;
+    alpha.allocN32Pixels(32, 32);
+    alpha.eraseColor(0x80FF0000);
+
+    SkPaint paint;
+    for (int page = 0; page < 20; ++page) {
+        SkCanvas* canvas = doc->beginPage(612, 792);
+        for (int line = 0; line < 30; ++line) {
+            SkString text = SkStringPrintf("Page %d, line %d: the quick brown fox.", page, line);
+            paint.setTextSize(SkIntToScalar(10 + line % 4));
+            paint.setFakeBoldText(line % 7 == 0);
+            canvas->drawText(text.c_str(), text.size(), 36, SkIntToScalar(36 + 24 * line), paint);
+        }
+        if (opaque) {
+            canvas->drawImage(opaque, 400, SkIntToScalar(100 + page));
+        }
+        canvas->drawBitmap(alpha, 450, 300);
+        doc->endPage();
+    }
+    doc->close();
+    return buffer.detachAsData();
+}
+
+// Serializing in parallel must not change a single byte of the output.
+DEF_TEST(SkPDF_parallel_document, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_parallel_document, r);
+    sk_sp<SkData> serial   = make_report(false),
+                  parallel = make_report(true);
+    REPORTER_ASSERT(r, serial->size() > 0);
+    REPORTER_ASSERT(r, serial->equals(parallel.get()));
+}
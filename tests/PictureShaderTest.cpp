@@ -6,9 +6,14 @@
  */
 
 #include "SkCanvas.h"
+#include "SkDirectoryCache.h"
+#include "SkGraphics.h"
+#include "SkOSPath.h"
 #include "SkPicture.h"
 #include "SkPictureRecorder.h"
+#include "SkPictureShader.h"
 #include "SkShader.h"
+#include "SkSurface.h"
 #include "Test.h"
 
 // Test that attempting to create a picture shader with a nullptr picture or
@@ -38,3 +43,89 @@ DEF_TEST(PictureShader_empty, reporter) {
     canvas.drawRect(SkRect::MakeWH(1,1), paint);
     REPORTER_ASSERT(reporter, *bitmap.getAddr32(0,0) == SK_ColorGREEN);
 }
+
+namespace {
+    // Counts loads and stores, passing them along to a real cache.
+    struct CountingCache : public SkPersistentCache {
+        explicit CountingCache(sk_sp<SkPersistentCache> cache) : fCache(std::move(cache)) {}
+
+        sk_sp<SkData> load(const SkData& key) override {
+            sk_sp<SkData> data = fCache->load(key);
+            (data ? fHits : fMisses)++;
+            return data;
+        }
+        void store(const SkData& key, const SkData& data) override {
+            fStores++;
+            fCache->store(key, data);
+        }
+
+        sk_sp<SkPersistentCache> fCache;
+        int fHits = 0, fMisses = 0, fStores = 0;
+    };
+}
+
+static sk_sp<SkPicture> make_tile_picture() {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(20, 20);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(SK_ColorRED);
+    canvas->drawCircle(10, 10, 8, paint);
+    paint.setColor(SK_ColorBLUE);
+    canvas->drawRect(SkRect::MakeXYWH(2, 12, 16, 4), paint);
+    return recorder.finishRecordingAsPicture();
+}
+
+static sk_sp<SkImage> draw_picture_shader(sk_sp<SkPicture> picture,
+                                          sk_sp<SkPersistentCache> tileCache = nullptr) {
+    SkPaint paint;
+    paint.setShader(SkPictureShader::Make(std::move(picture), SkShader::kRepeat_TileMode,
+                                          SkShader::kRepeat_TileMode, nullptr, nullptr,
+                                          std::move(tileCache)));
+    sk_sp<SkSurface> surface = SkSurface::MakeRasterN32Premul(100, 100);
+    surface->getCanvas()->scale(1.5f, 1.5f);
+    surface->getCanvas()->drawPaint(paint);
+    return surface->makeImageSnapshot();
+}
+
+static bool same_pixels(SkImage* a, SkImage* b) {
+    SkBitmap bitmaps[2];
+    SkImage* images[2] = { a, b };
+    for (int i = 0; i < 2; i++) {
+        bitmaps[i].allocN32Pixels(images[i]->width(), images[i]->height());
+        if (!images[i]->readPixels(bitmaps[i].info(), bitmaps[i].getPixels(),
+                                   bitmaps[i].rowBytes(), 0, 0)) {
+            return false;
+        }
+    }
+    return 0 == memcmp(bitmaps[0].getPixels(), bitmaps[1].getPixels(), bitmaps[0].getSafeSize());
+}
+
+DEF_TEST(PictureShader_persistentCache, r) {
+    SkString tmpDir = skiatest::GetTmpDir();
+    if (tmpDir.isEmpty()) {
+        return;
+    }
+    SkString dir = SkOSPath::Join(tmpDir.c_str(), "PictureShader_persistentCache");
+    sk_sp<SkDirectoryCache> directory = SkDirectoryCache::Make(dir.c_str());
+    REPORTER_ASSERT(r, directory);
+    if (!directory) {
+        return;
+    }
+
+    SkGraphics::PurgeResourceCache();
+    sk_sp<SkImage> expected = draw_picture_shader(make_tile_picture());
+
+    // The cache belongs to these shaders alone, not SkGraphics, so other tests can't touch it.
+    sk_sp<CountingCache> cache(new CountingCache(directory));
+
+    // The first time around, we draw the tile and store it, unless an earlier run already has.
+    // Recording the same content again gives a new picture ID, but finds the same tile.
+    for (int i = 0; i < 3; i++) {
+        sk_sp<SkImage> actual = draw_picture_shader(make_tile_picture(), cache);
+        REPORTER_ASSERT(r, same_pixels(expected.get(), actual.get()));
+    }
+    REPORTER_ASSERT(r, cache->fHits + cache->fMisses == 3);
+    REPORTER_ASSERT(r, cache->fMisses <= 1);
+    REPORTER_ASSERT(r, cache->fStores == cache->fMisses);
+}
@@ -30,6 +30,7 @@
 #include "SkRecord.h"
 #include "SkShader.h"
 #include "SkStream.h"
+#include "Resources.h"
 #include "sk_tool_utils.h"
 
 #include "Test.h"
@@ -1087,6 +1088,251 @@ DEF_TEST(Picture_preserveCullRect, r) {
     REPORTER_ASSERT(r, deserializedPicture->cullRect().bottom() == 4);
 }
 
+static sk_sp<SkPicture> make_mappable_picture() {
+    SkPictureRecorder inner;
+    SkCanvas* canvas = inner.beginRecording(SkRect::MakeWH(40, 40));
+    canvas->drawCircle(20, 20, 15, SkPaint());
+    canvas->drawRect(SkRect::MakeXYWH(5, 5, 10, 10), SkPaint());
+    sk_sp<SkPicture> innerPicture = inner.finishRecordingAsPicture();
+
+    SkPictureRecorder recorder;
+    canvas = recorder.beginRecording(SkRect::MakeWH(100, 100));
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    for (int i = 0; i < 10; i++) {
+        SkPath path;
+        path.moveTo(SkIntToScalar(i * 10), 0);
+        path.quadTo(50, SkIntToScalar(50 + i), SkIntToScalar(100 - i * 3), 100);
+        path.conicTo(0, 50, SkIntToScalar(i), 30, 0.5f);
+        paint.setColor(0xFF000000 | (i * 0x1F3A5B));
+        paint.setStyle(i % 2 ? SkPaint::kFill_Style : SkPaint::kStroke_Style);
+        canvas->drawPath(path, paint);
+    }
+    canvas->drawText("mapped", 6, 10, 90, paint);
+
+    SkBitmap bm;
+    make_bm(&bm, 10, 10, SK_ColorBLUE, true);
+    canvas->drawBitmap(bm, 60, 60);
+
+    const SkMatrix matrix = SkMatrix::MakeTrans(50, 10);
+    canvas->drawPicture(innerPicture, &matrix, nullptr);
+    return recorder.finishRecordingAsPicture();
+}
+
+static void draw_picture_to_bitmap(const SkPicture* picture, SkBitmap* bm) {
+    bm->allocN32Pixels(100, 100);
+    SkCanvas canvas(*bm);
+    canvas.clear(SK_ColorWHITE);
+    canvas.drawPicture(picture);
+}
+
+DEF_TEST(Picture_MakeFromMappedData, r) {
+    sk_sp<SkData> data = make_mappable_picture()->serialize();
+
+    // Also try data that can't be read in place, because it isn't 4-byte aligned.
+    sk_sp<SkData> storage = SkData::MakeUninitialized(data->size() + 1);
+    memcpy((char*)storage->writable_data() + 1, data->data(), data->size());
+    sk_sp<SkData> unaligned = SkData::MakeSubset(storage.get(), 1, data->size());
+
+    sk_sp<SkPicture> copied = SkPicture::MakeFromData(data.get());
+    REPORTER_ASSERT(r, copied);
+    SkBitmap expected;
+    draw_picture_to_bitmap(copied.get(), &expected);
+
+    for (const sk_sp<SkData>& mappedData : { data, unaligned }) {
+        sk_sp<SkPicture> mapped = SkPicture::MakeFromMappedData(mappedData);
+        REPORTER_ASSERT(r, mapped);
+        if (!mapped) {
+            continue;
+        }
+        REPORTER_ASSERT(r, mapped->cullRect() == copied->cullRect());
+        REPORTER_ASSERT(r, mapped->approximateOpCount() > 1);
+        REPORTER_ASSERT(r, mapped->willPlayBackBitmaps());
+
+        // Draw twice, the second time with paths that have already been read.
+        for (int i = 0; i < 2; i++) {
+            SkBitmap actual;
+            draw_picture_to_bitmap(mapped.get(), &actual);
+            REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                           expected.getSafeSize()));
+        }
+
+        // Mapped pictures serialize just like any other.
+        sk_sp<SkPicture> reloaded = SkPicture::MakeFromData(mapped->serialize().get());
+        REPORTER_ASSERT(r, reloaded);
+        if (reloaded) {
+            SkBitmap actual;
+            draw_picture_to_bitmap(reloaded.get(), &actual);
+            REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                           expected.getSafeSize()));
+        }
+    }
+
+    // Truncated data should fail cleanly.
+    REPORTER_ASSERT(r, !SkPicture::MakeFromMappedData(SkData::MakeSubset(data.get(), 0, 100)));
+}
+
+// Pictures recorded with a BBH carry an op index, which mapped pictures use to draw
+// only the ops in each tile.
+DEF_TEST(Picture_MappedOpIndex, r) {
+    sk_sp<SkImage> image = GetResourceAsImage("mandrill_128.png");
+    if (!image) {
+        return;
+    }
+
+    SkRTreeFactory factory;
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(256, 256), &factory);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    for (int i = 0; i < 8; i++) {
+        canvas->save();
+        canvas->translate(SkIntToScalar(i * 30), SkIntToScalar(i * 20));
+        canvas->clipRect(SkRect::MakeWH(60, 60));
+        paint.setColor(0xFF000000 | (i * 0x1F3A5B));
+        canvas->drawCircle(30, 30, 40, paint);
+        canvas->restore();
+    }
+    canvas->save();
+    canvas->clipRect(SkRect::MakeEmpty());
+    canvas->drawRect(SkRect::MakeWH(256, 256), paint);
+    canvas->restore();
+    canvas->drawImage(image, 120, 10);
+    canvas->saveLayer(nullptr, nullptr);
+    canvas->drawRect(SkRect::MakeXYWH(10, 150, 80, 80), paint);
+    canvas->restore();
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+    sk_sp<SkPicture> mapped = SkPicture::MakeFromMappedData(picture->serialize());
+    REPORTER_ASSERT(r, mapped);
+    if (!mapped) {
+        return;
+    }
+    // Mapped pictures keep their op index when serialized again.
+    sk_sp<SkPicture> remapped = SkPicture::MakeFromMappedData(mapped->serialize());
+    REPORTER_ASSERT(r, remapped);
+    if (!remapped) {
+        return;
+    }
+
+    for (int y = 0; y < 256; y += 64) {
+        for (int x = 0; x < 256; x += 64) {
+            auto draw_tile = [x, y](const SkPicture* pic, SkBitmap* bm) {
+                bm->allocN32Pixels(64, 64);
+                SkCanvas canvas(*bm);
+                canvas.clear(SK_ColorWHITE);
+                canvas.translate(SkIntToScalar(-x), SkIntToScalar(-y));
+                canvas.drawPicture(pic);
+            };
+            SkBitmap expected, actual, reloaded;
+            draw_tile(picture.get(), &expected);
+            draw_tile(mapped.get(), &actual);
+            draw_tile(remapped.get(), &reloaded);
+            REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                           expected.getSafeSize()));
+            REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), reloaded.getPixels(),
+                                           expected.getSafeSize()));
+        }
+    }
+}
+
+// A picture of nothing but a horizontal hairline has a zero-height cull.
+DEF_TEST(Picture_MappedZeroHeightCull, r) {
+    SkRTreeFactory factory;
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(100, 100), &factory);
+    SkPaint paint;
+    for (int i = 0; i < 8; i++) {
+        canvas->drawLine(0, 0, SkIntToScalar(10 * (i + 1)), 0, paint);
+    }
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPictureWithCull(
+            SkRect::MakeWH(100, 0));
+
+    sk_sp<SkPicture> mapped = SkPicture::MakeFromMappedData(picture->serialize());
+    REPORTER_ASSERT(r, mapped);
+    if (mapped) {
+        REPORTER_ASSERT(r, mapped->cullRect().height() == 0);
+        SkBitmap bm;
+        bm.allocN32Pixels(100, 10);
+        SkCanvas(bm).drawPicture(mapped);
+    }
+}
+
+// A grid of cells on a background, with one cell highlighted.
+static void draw_cells(SkCanvas* canvas, int highlight) {
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(SK_ColorLTGRAY);
+    canvas->drawRect(SkRect::MakeWH(200, 200), paint);
+    for (int i = 0; i < 100; i++) {
+        paint.setColor(i == highlight ? SK_ColorRED : SK_ColorBLUE);
+        canvas->drawCircle(SkIntToScalar(i % 10 * 20 + 10), SkIntToScalar(i / 10 * 20 + 10), 8,
+                           paint);
+    }
+}
+
+static SkRect cell_bounds(int i) {
+    return SkRect::MakeXYWH(SkIntToScalar(i % 10 * 20), SkIntToScalar(i / 10 * 20), 20, 20);
+}
+
+static void assert_same_pixels(skiatest::Reporter* r, const SkPicture* expected,
+                               const SkPicture* actual) {
+    SkBitmap bitmaps[2];
+    const SkPicture* pics[2] = { expected, actual };
+    for (int i = 0; i < 2; i++) {
+        bitmaps[i].allocN32Pixels(200, 200);
+        SkCanvas canvas(bitmaps[i]);
+        canvas.clear(SK_ColorWHITE);
+        canvas.drawPicture(pics[i]);
+    }
+    REPORTER_ASSERT(r, 0 == memcmp(bitmaps[0].getPixels(), bitmaps[1].getPixels(),
+                                   bitmaps[0].getSafeSize()));
+}
+
+DEF_TEST(Picture_recordDamage, r) {
+    SkPictureRecorder recorder;
+    draw_cells(recorder.beginRecording(200, 200), 0);
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+    SkRandom rand;
+    int highlight = 0;
+    for (int frame = 0; frame < 200; frame++) {
+        const int next = rand.nextULessThan(100);
+        SkRect damage = cell_bounds(highlight);
+        damage.join(cell_bounds(next));
+        highlight = next;
+
+        // Redraw everything; the recorder's clip keeps just what's inside damage.
+        SkRTreeFactory factory;
+        draw_cells(recorder.beginRecordingDamage(*picture, damage, &factory), highlight);
+        picture = recorder.finishRecordingAsPicture();
+
+        draw_cells(recorder.beginRecording(200, 200), highlight);
+        sk_sp<SkPicture> expected = recorder.finishRecordingAsPicture();
+
+        assert_same_pixels(r, expected.get(), picture.get());
+        // Undamaged content is shared, not re-recorded: the picture itself is just four ops for
+        // each of a few groups.  Draws hidden by later damage are eventually dropped, so all
+        // the groups together don't keep growing either.
+        REPORTER_ASSERT(r, picture->approximateOpCount() <= 4 * 8);
+        REPORTER_ASSERT(r, SkPictureUtils::ApproximateBytesUsed(picture.get()) <
+                           32 * SkPictureUtils::ApproximateBytesUsed(expected.get()));
+    }
+
+    // Pictures from anywhere can be updated, even those without an SkRecord.
+    recorder.beginRecording(200, 200)->drawRect(SkRect::MakeWH(200, 200), SkPaint());
+    picture = recorder.finishRecordingAsPicture();
+    REPORTER_ASSERT(r, !picture->asSkBigPicture());
+    draw_cells(recorder.beginRecordingDamage(*picture, cell_bounds(42)), 42);
+    picture = recorder.finishRecordingAsPicture();
+
+    SkCanvas* canvas = recorder.beginRecording(200, 200);
+    canvas->drawRect(SkRect::MakeWH(200, 200), SkPaint());
+    canvas->clipRect(cell_bounds(42));
+    draw_cells(canvas, 42);
+    assert_same_pixels(r, recorder.finishRecordingAsPicture().get(), picture.get());
+}
+
 #if SK_SUPPORT_GPU
 
 DEF_TEST(PictureGpuAnalyzer, r) {
@@ -11,6 +11,7 @@
 #include "SkPaint.h"
 #include "SkStream.h"
 #include "SkSurface.h"
+#include "SkTArray.h"
 #include "Test.h"
 
 #include "SkNullCanvas.h"
@@ -185,3 +186,166 @@ DEF_TEST(Pipe_picture_draw_second, reporter) {
     size_t offset2 = stream.bytesWritten();
     REPORTER_ASSERT(reporter, offset2 <= 16);
 }
+
+static SkPath make_star() {
+    SkPath path;
+    path.moveTo(50, 0);
+    for (int i = 1; i < 5; ++i) {
+        SkScalar angle = i * 4 * SK_ScalarPI / 5;
+        path.lineTo(50 + 50 * SkScalarSin(angle), 50 - 50 * SkScalarCos(angle));
+    }
+    path.close();
+    return path;
+}
+
+DEF_TEST(Pipe_path_dedup, reporter) {
+    const SkPath star = make_star();
+
+    SkPipeSerializer serializer;
+    SkPipeDeserializer deserializer;
+    SkDynamicMemoryWStream stream;
+
+    SkCanvas* wc = serializer.beginWrite(SkRect::MakeWH(100, 100), &stream);
+    wc->drawPath(star, SkPaint());
+    serializer.endWrite();
+    size_t offset0 = stream.bytesWritten();
+    drain(&deserializer, &stream);
+
+    // The same path in a later frame (drawn or clipped) should just be an index.
+    wc = serializer.beginWrite(SkRect::MakeWH(100, 100), &stream);
+    wc->drawPath(star, SkPaint());
+    serializer.endWrite();
+    size_t offset1 = stream.bytesWritten();
+    REPORTER_ASSERT(reporter, offset1 < offset0);
+    drain(&deserializer, &stream);
+
+    wc = serializer.beginWrite(SkRect::MakeWH(100, 100), &stream);
+    wc->clipPath(star);
+    serializer.endWrite();
+    size_t offset2 = stream.bytesWritten();
+    REPORTER_ASSERT(reporter, offset2 <= 16);
+    drain(&deserializer, &stream);
+
+    // Volatile paths are always written inline.
+    SkPath volatileStar = star;
+    volatileStar.setIsVolatile(true);
+    for (int i = 0; i < 2; ++i) {
+        wc = serializer.beginWrite(SkRect::MakeWH(100, 100), &stream);
+        wc->drawPath(volatileStar, SkPaint());
+        serializer.endWrite();
+        REPORTER_ASSERT(reporter, stream.bytesWritten() > offset1);
+        drain(&deserializer, &stream);
+    }
+
+    // A fill type change must not reuse the old definition.
+    SkPath evenOdd = star;
+    evenOdd.setFillType(SkPath::kEvenOdd_FillType);
+    sk_sp<SkSurface> surfaces[2] = {
+        SkSurface::MakeRasterN32Premul(100, 100), SkSurface::MakeRasterN32Premul(100, 100),
+    };
+    wc = serializer.beginWrite(SkRect::MakeWH(100, 100), &stream);
+    wc->drawPath(evenOdd, SkPaint());
+    serializer.endWrite();
+    REPORTER_ASSERT(reporter, stream.bytesWritten() > offset1);
+    sk_sp<SkData> data = stream.detachAsData();
+    surfaces[0]->getCanvas()->clear(SK_ColorWHITE);
+    deserializer.playback(data->data(), data->size(), surfaces[0]->getCanvas());
+    surfaces[1]->getCanvas()->clear(SK_ColorWHITE);
+    surfaces[1]->getCanvas()->drawPath(evenOdd, SkPaint());
+
+    sk_sp<SkImage> a = surfaces[0]->makeImageSnapshot(),
+                   b = surfaces[1]->makeImageSnapshot();
+    REPORTER_ASSERT(reporter, deep_equal(a.get(), b.get()));
+}
+
+// The writer only remembers the 1024 most recently used paths, and the reader keeps just as many.
+DEF_TEST(Pipe_path_lru, reporter) {
+    const int kPaths = 1024 + 100;
+    SkTArray<SkPath> paths;
+    for (int i = 0; i < kPaths; ++i) {
+        paths.push_back().addCircle(SkIntToScalar(i % 100), SkIntToScalar(i / 100), 5);
+    }
+
+    SkPipeSerializer serializer;
+    SkPipeDeserializer deserializer;
+    SkDynamicMemoryWStream stream;
+
+    SkCanvas* wc = serializer.beginWrite(SkRect::MakeWH(100, 100), &stream);
+    for (const SkPath& path : paths) {
+        wc->drawPath(path, SkPaint());
+    }
+    serializer.endWrite();
+    drain(&deserializer, &stream);
+
+    // A recently used path is still just an index...
+    wc = serializer.beginWrite(SkRect::MakeWH(100, 100), &stream);
+    wc->drawPath(paths[kPaths - 1], SkPaint());
+    serializer.endWrite();
+    const size_t recent = stream.bytesWritten();
+    drain(&deserializer, &stream);
+
+    // ... but the first paths were evicted, so are defined again, into a reused slot.
+    wc = serializer.beginWrite(SkRect::MakeWH(100, 100), &stream);
+    wc->drawPath(paths[0], SkPaint());
+    serializer.endWrite();
+    REPORTER_ASSERT(reporter, stream.bytesWritten() > recent);
+
+    sk_sp<SkSurface> surfaces[2] = {
+        SkSurface::MakeRasterN32Premul(100, 100), SkSurface::MakeRasterN32Premul(100, 100),
+    };
+    sk_sp<SkData> data = stream.detachAsData();
+    surfaces[0]->getCanvas()->clear(SK_ColorWHITE);
+    REPORTER_ASSERT(reporter, deserializer.playback(data->data(), data->size(),
+                                                    surfaces[0]->getCanvas()));
+    surfaces[1]->getCanvas()->clear(SK_ColorWHITE);
+    surfaces[1]->getCanvas()->drawPath(paths[0], SkPaint());
+
+    sk_sp<SkImage> a = surfaces[0]->makeImageSnapshot(),
+                   b = surfaces[1]->makeImageSnapshot();
+    REPORTER_ASSERT(reporter, deep_equal(a.get(), b.get()));
+}
+
+static void draw_frame(SkCanvas* canvas, int frame, const SkPath& path, SkImage* image) {
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    canvas->clear(SK_ColorWHITE);
+    for (int i = 0; i < 200; ++i) {
+        paint.setColor(0xFF000000 | (frame * 0x1234567 + i * 0x345));
+        canvas->save();
+        canvas->translate(SkIntToScalar((i * 37) % 200), SkIntToScalar((i * 53 + frame) % 200));
+        canvas->drawPath(path, paint);
+        canvas->drawRect(SkRect::MakeXYWH(0, 0, 8, 8), paint);
+        canvas->restore();
+    }
+    canvas->drawImage(image, SkIntToScalar(frame), 0);
+}
+
+DEF_TEST(Pipe_async_player, reporter) {
+    const SkPath star = make_star();
+    sk_sp<SkImage> img = GetResourceAsImage("mandrill_128.png");
+    if (!img) {
+        return;
+    }
+
+    sk_sp<SkSurface> expected = SkSurface::MakeRasterN32Premul(256, 256),
+                     actual   = SkSurface::MakeRasterN32Premul(256, 256);
+
+    // The first frame, with the image, is much bigger than the ring.
+    SkPipeAsyncPlayer player(actual->getCanvas(), 4096);
+    for (int frame = 0; frame < 10; ++frame) {
+        draw_frame(player.beginFrame(SkRect::MakeWH(256, 256)), frame, star, img.get());
+        player.endFrame();
+        draw_frame(expected->getCanvas(), frame, star, img.get());
+
+        if (frame % 3 == 0) {
+            player.flush();
+            sk_sp<SkImage> a = expected->makeImageSnapshot(),
+                           b = actual->makeImageSnapshot();
+            REPORTER_ASSERT(reporter, deep_equal(a.get(), b.get()));
+        }
+    }
+    player.flush();
+    sk_sp<SkImage> a = expected->makeImageSnapshot(),
+                   b = actual->makeImageSnapshot();
+    REPORTER_ASSERT(reporter, deep_equal(a.get(), b.get()));
+}
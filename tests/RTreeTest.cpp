@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "SkPackedRTree.h"
 #include "SkRTree.h"
 #include "SkRandom.h"
 #include "Test.h"
@@ -44,7 +45,7 @@ static bool verify_query(SkRect query, SkRect rects[], SkTDArray<int>& found) {
 }
 
 static void run_queries(skiatest::Reporter* reporter, SkRandom& rand, SkRect rects[],
-                        const SkRTree& tree) {
+                        const SkBBoxHierarchy& tree) {
     for (size_t i = 0; i < NUM_QUERIES; ++i) {
         SkTDArray<int> hits;
         SkRect query = random_rect(rand);
@@ -89,3 +90,32 @@ DEF_TEST(RTree, reporter) {
                                   expectedDepthMax >= rtree.getDepth());
     }
 }
+
+DEF_TEST(PackedRTree, reporter) {
+    SkRandom rand;
+    SkAutoTMalloc<SkRect> rects(NUM_RECTS);
+    for (size_t i = 0; i < NUM_ITERATIONS; ++i) {
+        SkPackedRTree rtree;
+        REPORTER_ASSERT(reporter, 0 == rtree.getCount());
+
+        for (int j = 0; j < NUM_RECTS; j++) {
+            rects[j] = random_rect(rand);
+        }
+
+        rtree.insert(rects.get(), NUM_RECTS);
+        run_queries(reporter, rand, rects, rtree);
+        REPORTER_ASSERT(reporter, NUM_RECTS == rtree.getCount());
+        // 200 rects need 50, 13, 4, then 1 node.
+        REPORTER_ASSERT(reporter, 4 == rtree.getDepth());
+    }
+
+    // Empty rects are never found, and a tree of them is empty.
+    SkPackedRTree empty;
+    rects[0].setEmpty();
+    empty.insert(rects.get(), 1);
+    REPORTER_ASSERT(reporter, 0 == empty.getCount());
+    REPORTER_ASSERT(reporter, empty.getRootBound().isEmpty());
+    SkTDArray<int> hits;
+    empty.search(SkRect::MakeLargest(), &hits);
+    REPORTER_ASSERT(reporter, hits.isEmpty());
+}
@@ -15,6 +15,8 @@
 #include "SkRecords.h"
 #include "SkPictureRecorder.h"
 #include "SkPictureImageFilter.h"
+#include "SkRandom.h"
+#include "SkShader.h"
 #include "SkSurface.h"
 
 static const int W = 1920, H = 1080;
@@ -185,7 +187,7 @@ DEF_TEST(RecordOpts_NoopSaveLayerDrawRestore, r) {
 
     const SkRecords::DrawRect* drawRect = assert_type<SkRecords::DrawRect>(r, record, 16);
     REPORTER_ASSERT(r, drawRect != nullptr);
-    REPORTER_ASSERT(r, drawRect->paint.getColor() == 0x03020202);
+    REPORTER_ASSERT(r, drawRect->paint->getColor() == 0x03020202);
 
     // saveLayer w/ backdrop should NOT go away
     sk_sp<SkImageFilter> filter(SkBlurImageFilter::Make(3, 3, nullptr));
@@ -411,3 +413,202 @@ DEF_TEST(savelayer_srcmode_alpha, r) {
     do_savelayer_srcmode(r, 0x80FF0000);
 }
 
+
+DEF_TEST(RecordOpts_NoopRedundantClipRects, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    // A non-AA clip inside the one before it makes that one redundant...
+    recorder.clipRect(SkRect::MakeWH(200, 200));
+    recorder.clipRect(SkRect::MakeWH(100, 100));
+    recorder.drawRect(SkRect::MakeWH(50, 50), SkPaint());
+    // ... and vice versa.
+    recorder.clipRect(SkRect::MakeWH(50, 50));
+    recorder.clipRect(SkRect::MakeWH(60, 60));
+    recorder.drawRect(SkRect::MakeWH(50, 50), SkPaint());
+    // Anti-aliased clips always stay.
+    recorder.clipRect(SkRect::MakeWH(40, 40), true);
+    recorder.clipRect(SkRect::MakeWH(30, 30), true);
+
+    SkRecordNoopRedundantClipRects(&record);
+    assert_type<SkRecords::NoOp>    (r, record, 0);
+    assert_type<SkRecords::ClipRect>(r, record, 1);
+    assert_type<SkRecords::ClipRect>(r, record, 3);
+    assert_type<SkRecords::NoOp>    (r, record, 4);
+    assert_type<SkRecords::ClipRect>(r, record, 6);
+    assert_type<SkRecords::ClipRect>(r, record, 7);
+}
+
+static sk_sp<SkShader> make_shader(SkColor color) {
+    return SkShader::MakeColorShader(color);
+}
+
+DEF_TEST(RecordOpts_ReorderDraws, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPaint red, blue;
+    red.setShader(make_shader(SK_ColorRED));
+    blue.setShader(make_shader(SK_ColorBLUE));
+
+    recorder.drawRect(SkRect::MakeXYWH(  0, 0, 50, 50), red);
+    recorder.drawRect(SkRect::MakeXYWH(100, 0, 50, 50), blue);
+    recorder.drawRect(SkRect::MakeXYWH(200, 0, 50, 50), red);   // Moves up past the blue rect.
+    recorder.drawRect(SkRect::MakeXYWH(300, 0, 50, 50), blue);
+    recorder.drawRect(SkRect::MakeXYWH(120, 0, 50, 50), red);   // Overlaps blue, so stays put.
+    recorder.translate(10, 10);
+    recorder.drawRect(SkRect::MakeXYWH(400, 0, 50, 50), blue);  // Never moves past a translate.
+
+    SkRecordReorderDraws(&record, SkRect::MakeWH(W, H));
+
+    const SkScalar expected[] = { 0, 200, 100, 300, 120 };
+    for (int i = 0; i < (int)SK_ARRAY_COUNT(expected); i++) {
+        const SkRecords::DrawRect* draw = assert_type<SkRecords::DrawRect>(r, record, i);
+        REPORTER_ASSERT(r, draw && draw->rect.left() == expected[i]);
+    }
+    assert_type<SkRecords::Translate>(r, record, 5);
+    assert_type<SkRecords::DrawRect> (r, record, 6);
+
+    // Draws that only share an anti-aliased edge pixel must stay in order.
+    SkRecord adjacent;
+    SkRecorder adjacentRecorder(&adjacent, W, H);
+    adjacentRecorder.drawRect(SkRect::MakeLTRB( 0, 0, 10.5f, 10), red);
+    adjacentRecorder.drawRect(SkRect::MakeLTRB(10.5f, 0, 20, 10), blue);
+    adjacentRecorder.drawRect(SkRect::MakeLTRB(20.5f, 0, 30, 10), red);
+
+    SkRecordReorderDraws(&adjacent, SkRect::MakeWH(W, H));
+    const SkRecords::DrawRect* draw = assert_type<SkRecords::DrawRect>(r, adjacent, 1);
+    REPORTER_ASSERT(r, draw && draw->rect.left() == 10.5f);
+}
+
+// A draw must never move up past a restore (or any other state change) right before it.
+DEF_TEST(RecordOpts_ReorderDrawsStopsAtRestore, r) {
+    SkPaint red;
+    red.setColor(SK_ColorRED);
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(200, 20, nullptr,
+                                               SkPictureRecorder::kOptimizeDrawOrder_RecordFlag);
+    canvas->save();
+    canvas->translate(100, 0);
+    canvas->drawRect(SkRect::MakeWH(10, 10), red);
+    canvas->restore();
+    canvas->drawRect(SkRect::MakeWH(10, 10), red);
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+    sk_sp<SkSurface> surface = SkSurface::MakeRasterN32Premul(200, 20);
+    surface->getCanvas()->clear(SK_ColorWHITE);
+    surface->getCanvas()->drawPicture(picture);
+
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(200, 20);
+    surface->readPixels(bitmap.info(), bitmap.getPixels(), bitmap.rowBytes(), 0, 0);
+    REPORTER_ASSERT(r, SK_ColorRED == bitmap.getColor(  5, 5));
+    REPORTER_ASSERT(r, SK_ColorRED == bitmap.getColor(105, 5));
+}
+
+DEF_TEST(RecordOpts_MergeDrawPoints, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    const SkPoint pts[] = { {10, 10}, {20, 20}, {30, 30}, {40, 40} };
+    SkPaint paint;
+    paint.setStrokeWidth(3);
+
+    recorder.drawPoints(SkCanvas::kPoints_PointMode, 4, pts, paint);
+    recorder.drawPoints(SkCanvas::kPoints_PointMode, 2, pts, paint);
+    recorder.drawPoints(SkCanvas::kLines_PointMode,  4, pts, paint);  // Different mode.
+    recorder.drawPoints(SkCanvas::kLines_PointMode,  3, pts, paint);  // Odd number of points.
+    recorder.drawPoints(SkCanvas::kLines_PointMode,  2, pts, paint);
+
+    SkRecordMergeDrawPoints(&record);
+
+    const SkRecords::DrawPoints* points = assert_type<SkRecords::DrawPoints>(r, record, 0);
+    REPORTER_ASSERT(r, points && 6 == points->count);
+    REPORTER_ASSERT(r, points && points->pts[4] == pts[0] && points->pts[5] == pts[1]);
+    assert_type<SkRecords::NoOp>(r, record, 1);
+    for (int i = 2; i < 5; i++) {
+        assert_type<SkRecords::DrawPoints>(r, record, i);
+    }
+}
+
+// Draw a busy scene, with and without kOptimizeDrawOrder_RecordFlag, making sure the
+// optimizations actually happen, and that the pixels are just the same.
+DEF_TEST(RecordOpts_OptimizeDrawOrderIsPixelIdentical, r) {
+    const int kSize = 256;
+    auto scene = [](SkCanvas* canvas) {
+        SkRandom rand;
+        sk_sp<SkShader> shaders[] = {
+            SkShader::MakeColorShader(0x80FF0000),
+            SkShader::MakeColorShader(0xFF00FF00),
+            nullptr,
+        };
+        for (int i = 0; i < 400; i++) {
+            if (i % 100 == 0) {
+                canvas->restoreToCount(1);
+                canvas->save();
+                canvas->clipRect(SkRect::MakeWH(kSize - i/10, kSize));
+                canvas->clipRect(SkRect::MakeWH(kSize - i/10 - 1, kSize - 1));
+            }
+            SkPaint paint;
+            paint.setColor(rand.nextU() | 0x40000000);
+            paint.setAntiAlias(rand.nextBool());
+            paint.setShader(shaders[rand.nextULessThan(SK_ARRAY_COUNT(shaders))]);
+            if (rand.nextULessThan(4) == 0) {
+                paint.setBlendMode(SkBlendMode::kMultiply);
+            }
+
+            const SkScalar x = rand.nextRangeScalar(0, kSize),
+                           y = rand.nextRangeScalar(0, kSize);
+            switch (rand.nextULessThan(3)) {
+                case 0:
+                    canvas->drawRect(SkRect::MakeXYWH(x, y, rand.nextRangeScalar(1, 20),
+                                                            rand.nextRangeScalar(1, 20)), paint);
+                    break;
+                case 1:
+                    canvas->drawOval(SkRect::MakeXYWH(x, y, rand.nextRangeScalar(1, 20),
+                                                            rand.nextRangeScalar(1, 20)), paint);
+                    break;
+                default: {
+                    paint.setShader(nullptr);
+                    paint.setColor(SK_ColorBLUE);
+                    paint.setAntiAlias(false);
+                    paint.setStrokeWidth(4);
+                    const SkPoint pts[] = { {x, y}, {x + 8, y + 3} };
+                    canvas->drawPoints(SkCanvas::kPoints_PointMode, 2, pts, paint);
+                } break;
+            }
+        }
+    };
+
+    SkPictureRecorder plainRecorder, optimizedRecorder;
+    scene(plainRecorder.beginRecording(kSize, kSize));
+    scene(optimizedRecorder.beginRecording(kSize, kSize, nullptr,
+                                           SkPictureRecorder::kOptimizeDrawOrder_RecordFlag));
+    sk_sp<SkPicture> plain     = plainRecorder.finishRecordingAsPicture(),
+                     optimized = optimizedRecorder.finishRecordingAsPicture();
+    REPORTER_ASSERT(r, optimized->approximateOpCount() < plain->approximateOpCount());
+
+    for (SkScalar scale : { 1.0f, 1.5f }) {
+        sk_sp<SkSurface> surfaces[] = {
+            SkSurface::MakeRasterN32Premul(kSize, kSize),
+            SkSurface::MakeRasterN32Premul(kSize, kSize),
+        };
+        const SkPicture* pictures[] = { plain.get(), optimized.get() };
+        for (int i = 0; i < 2; i++) {
+            surfaces[i]->getCanvas()->clear(SK_ColorWHITE);
+            surfaces[i]->getCanvas()->translate(0.25f, 0.5f);
+            surfaces[i]->getCanvas()->scale(scale, scale);
+            surfaces[i]->getCanvas()->drawPicture(pictures[i]);
+        }
+
+        SkBitmap bitmaps[2];
+        for (int i = 0; i < 2; i++) {
+            bitmaps[i].allocN32Pixels(kSize, kSize);
+            surfaces[i]->readPixels(bitmaps[i].info(), bitmaps[i].getPixels(),
+                                    bitmaps[i].rowBytes(), 0, 0);
+        }
+        REPORTER_ASSERT(r, 0 == memcmp(bitmaps[0].getPixels(), bitmaps[1].getPixels(),
+                                       bitmaps[0].getSize()));
+    }
+}
@@ -61,7 +61,7 @@ DEF_TEST(Record, r) {
     // Add a simple DrawRect command.
     SkRect rect = SkRect::MakeWH(10, 10);
     SkPaint paint;
-    APPEND(record, SkRecords::DrawRect, paint, rect);
+    APPEND(record, SkRecords::DrawRect, SkRecords::SharedPaint(record.copyPaint(paint)), rect);
 
     // Its area should be 100.
     AreaSummer summer;
@@ -96,6 +96,26 @@ DEF_TEST(Record_defrag, r) {
     assert_type<SkRecords::Restore >(r, record, 3);
 }
 
+DEF_TEST(Record_move, r) {
+    SkRecord record;
+    APPEND(record, SkRecords::Save);
+    APPEND(record, SkRecords::ClipRect);
+    APPEND(record, SkRecords::DrawRect);
+    APPEND(record, SkRecords::Restore);
+
+    record.move(2, 0);
+    assert_type<SkRecords::DrawRect>(r, record, 0);
+    assert_type<SkRecords::Save    >(r, record, 1);
+    assert_type<SkRecords::ClipRect>(r, record, 2);
+    assert_type<SkRecords::Restore >(r, record, 3);
+
+    record.move(0, 3);
+    assert_type<SkRecords::Save    >(r, record, 0);
+    assert_type<SkRecords::ClipRect>(r, record, 1);
+    assert_type<SkRecords::Restore >(r, record, 2);
+    assert_type<SkRecords::DrawRect>(r, record, 3);
+}
+
 #undef APPEND
 
 template <typename T>
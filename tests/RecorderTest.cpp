@@ -9,6 +9,7 @@
 
 #include "SkPictureRecorder.h"
 #include "SkRecord.h"
+#include "SkRecordPattern.h"
 #include "SkRecorder.h"
 #include "SkRecords.h"
 #include "SkShader.h"
@@ -108,3 +109,31 @@ DEF_TEST(Recorder_drawImage_takeReference, reporter) {
     }
     REPORTER_ASSERT(reporter, image->unique());
 }
+
+// Draws with equal paints should share one copy of that paint, which the SkRecord owns.
+DEF_TEST(Recorder_sharesPaints, r) {
+    SkPaint paint;
+    paint.setShader(SkShader::MakeEmptyShader());
+    SkPaint red;
+    red.setColor(SK_ColorRED);
+
+    REPORTER_ASSERT(r, paint.getShader()->unique());
+    {
+        SkRecord record;
+        SkRecorder recorder(&record, 100, 100);
+        recorder.drawRect(SkRect::MakeWH(10, 10), paint);
+        recorder.drawOval(SkRect::MakeWH(20, 20), paint);
+        recorder.drawRect(SkRect::MakeWH(30, 30), red);
+        REPORTER_ASSERT(r, !paint.getShader()->unique());
+
+        SkRecords::Is<SkRecords::DrawRect> first, third;
+        SkRecords::Is<SkRecords::DrawOval> second;
+        REPORTER_ASSERT(r, record.mutate(0, first));
+        REPORTER_ASSERT(r, record.mutate(1, second));
+        REPORTER_ASSERT(r, record.mutate(2, third));
+        REPORTER_ASSERT(r, first.get()->paint.get() == second.get()->paint.get());
+        REPORTER_ASSERT(r, first.get()->paint.get() != third.get()->paint.get());
+        REPORTER_ASSERT(r, third.get()->paint->getColor() == SK_ColorRED);
+    }
+    REPORTER_ASSERT(r, paint.getShader()->unique());
+}
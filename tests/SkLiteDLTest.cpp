@@ -31,3 +31,106 @@ DEF_TEST(SkLiteRecorder, r) {
         c->drawRect(SkRect{0,0,9,9}, SkPaint{});
     c->restore();
 }
+
+#include "SkBlurImageFilter.h"
+#include "SkClipOpPriv.h"
+#include "SkOffsetImageFilter.h"
+#include "SkSurface.h"
+
+DEF_TEST(SkLiteDL_banded, r) {
+    sk_sp<SkLiteDL> dl { SkLiteDL::New({0,0,200,300}) };
+
+    SkLiteRecorder rec;
+    SkCanvas* c = &rec;
+    rec.reset(dl.get());
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    for (int i = 0; i < 40; i++) {
+        paint.setColor(0xFF000000 | (i * 0x3F1D27));
+        c->drawRect(SkRect::MakeXYWH(i * 5, i * 7, 30, 12), paint);
+    }
+
+    // State set up in one band must carry through to draws in later bands.
+    c->save();
+        c->translate(10, 20);
+        c->clipRect(SkRect::MakeLTRB(0, 0, 150, 200), kIntersect_SkClipOp, true);
+        c->rotate(15);
+        paint.setStyle(SkPaint::kStroke_Style);
+        paint.setStrokeWidth(6);
+        c->drawOval(SkRect::MakeXYWH(20, 40, 120, 160), paint);
+        paint.setStyle(SkPaint::kFill_Style);
+        c->save();
+            c->setMatrix(SkMatrix::MakeTrans(0, 150));
+            c->drawCircle(60, 60, 40, paint);
+        c->restore();
+    c->restore();
+
+    // These layer filters move draws into bands they weren't recorded in.
+    SkPaint layerPaint;
+    layerPaint.setImageFilter(SkOffsetImageFilter::Make(0, 120, nullptr));
+    c->saveLayer(nullptr, &layerPaint);
+        paint.setColor(SK_ColorRED);
+        c->drawRect(SkRect::MakeXYWH(120, 10, 40, 40), paint);
+    c->restore();
+    layerPaint.setImageFilter(SkBlurImageFilter::Make(8, 8, nullptr));
+    c->saveLayer(nullptr, &layerPaint);
+        paint.setColor(SK_ColorBLUE);
+        c->drawRect(SkRect::MakeXYWH(40, 140, 100, 20), paint);
+    c->restore();
+
+    SkPath path;
+    path.moveTo(0, 300);
+    path.lineTo(100, 150);
+    path.lineTo(200, 300);
+    paint.setColor(0x8000FF00);
+    c->drawPath(path, paint);
+
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(200, 300);
+    const SkMatrix matrix = SkMatrix::MakeTrans(5, -3);
+
+    for (int bands : { 1, 2, 7, 300 }) {
+        // Edges get clipped to each band, which can nudge pixels along the seams,
+        // so compare against playing back every op serially under the same band clips.
+        SkBitmap expected;
+        expected.allocPixels(info);
+        expected.eraseColor(SK_ColorWHITE);
+        for (int band = 0; band < bands; band++) {
+            SkCanvas canvas(expected);
+            canvas.clipRect(SkRect::MakeLTRB(0, 300 * band / bands, 200, 300 * (band+1) / bands));
+            dl->draw(&canvas, &matrix);
+        }
+
+        SkBitmap actual;
+        actual.allocPixels(info);
+        actual.eraseColor(SK_ColorWHITE);
+        SkPixmap pixmap;
+        REPORTER_ASSERT(r, actual.peekPixels(&pixmap));
+        dl->drawBanded(pixmap, &matrix, bands);
+
+        REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                       expected.getSize()));
+    }
+
+    // A replace clip would let a band draw outside its rows, so it must draw as one band.
+    c->clipRect(SkRect::MakeLTRB(0, 0, 200, 300), kReplace_SkClipOp);
+    paint.setColor(SK_ColorBLACK);
+    c->drawRect(SkRect::MakeLTRB(20, 0, 40, 300), paint);
+
+    SkBitmap expected;
+    expected.allocPixels(info);
+    expected.eraseColor(SK_ColorWHITE);
+    {
+        SkCanvas canvas(expected);
+        dl->draw(&canvas, &matrix);
+    }
+
+    SkBitmap actual;
+    actual.allocPixels(info);
+    actual.eraseColor(SK_ColorWHITE);
+    SkPixmap pixmap;
+    REPORTER_ASSERT(r, actual.peekPixels(&pixmap));
+    dl->drawBanded(pixmap, &matrix, 7);
+
+    REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(), expected.getSize()));
+}
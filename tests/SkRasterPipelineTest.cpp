@@ -6,7 +6,9 @@
  */
 
 #include "Test.h"
+#include "SkColorPriv.h"
 #include "SkHalf.h"
+#include "SkRandom.h"
 #include "SkRasterPipeline.h"
 
 DEF_TEST(SkRasterPipeline, r) {
@@ -90,3 +92,91 @@ DEF_TEST(SkRasterPipeline_JIT, r) {
         }
     }
 }
+
+DEF_TEST(SkRasterPipeline_JIT_sharedCode, r) {
+    // Pipelines with the same stages but different contexts may share compiled code.
+    // Make sure each still reads and writes its own buffers, even after the first goes away.
+    uint32_t srcA[16], srcB[16], dstA[16], dstB[16];
+    for (int i = 0; i < 16; i++) {
+        srcA[i] = i;
+        srcB[i] = 100 + i;
+        dstA[i] = dstB[i] = 0;
+    }
+
+    auto compile = [](const uint32_t** src, uint32_t** dst) {
+        SkRasterPipeline p;
+        p.append(SkRasterPipeline:: load_8888, src);
+        p.append(SkRasterPipeline::store_8888, dst);
+        return p.compile();
+    };
+
+    const uint32_t* srcAPtr = srcA;
+    const uint32_t* srcBPtr = srcB;
+    uint32_t* dstAPtr = dstA;
+    uint32_t* dstBPtr = dstB;
+
+    auto b = compile(&srcBPtr, &dstBPtr);
+    {
+        auto a = compile(&srcAPtr, &dstAPtr);
+        a(0, 16);
+    }
+    b(0, 16);
+
+    for (int i = 0; i < 16; i++) {
+        REPORTER_ASSERT(r, dstA[i] == (uint32_t)i);
+        REPORTER_ASSERT(r, dstB[i] == (uint32_t)(100 + i));
+    }
+}
+
+DEF_TEST(SkRasterPipeline_lowp, r) {
+    // Pipelines that can run in 16-bit fixed point should stay within 1 of the float results.
+    // 37 pixels exercises both full strides and a tail.
+    const int kN = 37;
+    uint32_t src[kN], dst[kN], lowp[kN], highp[kN];
+    uint8_t coverage[kN];
+    SkRandom rand;
+    for (int i = 0; i < kN; i++) {
+        src[i] = SkPreMultiplyColor(rand.nextU());
+        dst[i] = SkPreMultiplyColor(rand.nextU());
+        coverage[i] = rand.nextU() & 0xff;
+    }
+    coverage[0] = 0;
+    coverage[1] = 0xff;
+
+    const SkRasterPipeline::StockStage blends[] = {
+        SkRasterPipeline::srcover,  SkRasterPipeline::dstover, SkRasterPipeline::srcatop,
+        SkRasterPipeline::modulate, SkRasterPipeline::screen,  SkRasterPipeline::plus_,
+        SkRasterPipeline::xor_,     SkRasterPipeline::multiply,
+    };
+    for (auto blend : blends) {
+        uint32_t* result;
+        const uint32_t* srcPtr = src;
+        const uint8_t* coveragePtr = coverage;
+
+        for (bool useLowp : { true, false }) {
+            SkRasterPipeline p(useLowp);
+            p.append(SkRasterPipeline::load_8888, &result);
+            p.append(SkRasterPipeline::move_src_dst);
+            p.append(SkRasterPipeline::load_8888, &srcPtr);
+            p.append(blend);
+            p.append(SkRasterPipeline::clamp_a);
+            p.append(SkRasterPipeline::lerp_u8, &coveragePtr);
+            p.append(SkRasterPipeline::store_8888, &result);
+
+            result = useLowp ? lowp : highp;
+            memcpy(result, dst, sizeof(dst));
+            p.run(0, kN);
+        }
+
+        for (int i = 0; i < kN; i++) {
+            for (int shift = 0; shift < 32; shift += 8) {
+                int l = (lowp[i] >> shift) & 0xff,
+                    h = (highp[i] >> shift) & 0xff;
+                REPORTER_ASSERT(r, SkTAbs(l - h) <= 1);
+            }
+        }
+        // Zero coverage must leave dst untouched, in either mode.
+        REPORTER_ASSERT(r, lowp[0] == dst[0]);
+        REPORTER_ASSERT(r, highp[0] == dst[0]);
+    }
+}
@@ -14,6 +14,7 @@
 #include "SkPictureRecorder.h"
 #include "SkResourceCache.h"
 #include "SkSurface.h"
+#include "SkTaskGroup.h"
 #include "SkTypes.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -335,3 +336,65 @@ DEF_TEST(BitmapCache_discarded_image, reporter) {
         });
     }
 }
+
+namespace {
+static int gTestKeyNamespace;
+
+struct TestKey : public SkResourceCache::Key {
+    int fValue;
+
+    TestKey(int value) : fValue(value) {
+        this->init(&gTestKeyNamespace, 0, sizeof(fValue));
+    }
+};
+
+struct TestRec : public SkResourceCache::Rec {
+    TestKey fKey;
+    size_t  fBytes;
+
+    TestRec(int value, size_t bytes) : fKey(value), fBytes(bytes) {}
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return fBytes; }
+    const char* getCategory() const override { return "resourcecache-test"; }
+
+    static bool Visitor(const SkResourceCache::Rec& rec, void* context) {
+        *(int*)context = ((const TestRec&)rec).fKey.fValue;
+        return true;
+    }
+};
+}
+
+static bool purge_visitor(const SkResourceCache::Rec&, void*) {
+    return false;   // Report the Rec as stale, which purges it.
+}
+
+// The global cache is sharded to cut contention between threads.  Other tests share it, so this
+// only checks what can't be disturbed by them, and cleans up after itself.
+DEF_TEST(ResourceCache_global_threaded, reporter) {
+    const int kThreads = 8,
+              kPerThread = 1000;
+    SkTaskGroup().batch(kThreads, [&](int thread) {
+        for (int i = 0; i < kPerThread; i++) {
+            const int value = thread * kPerThread + i;
+            SkResourceCache::Add(new TestRec(value, 100));
+            int found;
+            if (SkResourceCache::Find(TestKey(value), TestRec::Visitor, &found)) {
+                REPORTER_ASSERT(reporter, found == value);
+            }
+        }
+    });
+    for (int value = 0; value < kThreads * kPerThread; value++) {
+        SkResourceCache::Find(TestKey(value), purge_visitor, nullptr);
+    }
+
+    // The shards share one budget, so an entry much bigger than an even share of it should fit.
+    if (!SkResourceCache::GetDiscardableFactory()) {
+        const int kBig = -1;
+        SkResourceCache::Add(new TestRec(kBig, SkResourceCache::GetTotalByteLimit() / 2));
+        int found = 0;
+        REPORTER_ASSERT(reporter, SkResourceCache::Find(TestKey(kBig), TestRec::Visitor, &found));
+        REPORTER_ASSERT(reporter, kBig == found);
+        SkResourceCache::Find(TestKey(kBig), purge_visitor, nullptr);
+    }
+}
@@ -5,10 +5,12 @@
  * found in the LICENSE file.
  */
 
+#include "SkCodecPriv.h"
 #include "SkSwizzle.h"
 #include "SkSwizzler.h"
 #include "Test.h"
 #include "SkOpts.h"
+#include "SkRandom.h"
 
 // These are the values that we will look for to indicate that the fill was successful
 static const uint8_t kFillIndex = 0x11;
@@ -159,6 +161,180 @@ DEF_TEST(SwizzleOpts, r) {
     REPORTER_ASSERT(r, dst == 0xFA04ADCA);
 }
 
+// Longer runs may take wider SIMD paths.  They should match converting one pixel at a time.
+DEF_TEST(SwizzleOpts_long, r) {
+    const int kCount = 53;
+    uint32_t src[kCount], dst[kCount];
+    SkRandom rand;
+    for (uint32_t& px : src) {
+        px = rand.nextU();
+    }
+
+    for (auto proc : { SkOpts::RGBA_to_rgbA, SkOpts::RGBA_to_bgrA, SkOpts::RGBA_to_BGRA }) {
+        for (int count = 0; count <= kCount; count++) {
+            proc(dst, src, count);
+            for (int i = 0; i < count; i++) {
+                uint32_t expected;
+                proc(&expected, src+i, 1);
+                REPORTER_ASSERT(r, dst[i] == expected);
+            }
+        }
+    }
+}
+
+// 16-bit channels are big-endian, and are narrowed by keeping their high bytes.
+DEF_TEST(SwizzleOpts_16bit, r) {
+    const int kCount = 53;
+    uint8_t src[8*kCount];
+    SkRandom rand;
+    for (uint8_t& byte : src) {
+        byte = rand.nextU() >> 24;
+    }
+
+    auto pack = [](uint32_t r, uint32_t g, uint32_t b, uint32_t a) {
+        return a << 24 | b << 16 | g << 8 | r;
+    };
+
+    uint32_t dst[kCount];
+    for (int count = 0; count <= kCount; count++) {
+        SkOpts::RGB16_to_RGB1(dst, src, count);
+        for (int i = 0; i < count; i++) {
+            const uint8_t* px = src + 6*i;
+            REPORTER_ASSERT(r, dst[i] == pack(px[0], px[2], px[4], 0xFF));
+        }
+        SkOpts::RGB16_to_BGR1(dst, src, count);
+        for (int i = 0; i < count; i++) {
+            const uint8_t* px = src + 6*i;
+            REPORTER_ASSERT(r, dst[i] == pack(px[4], px[2], px[0], 0xFF));
+        }
+        SkOpts::RGBA16_to_RGBA(dst, src, count);
+        for (int i = 0; i < count; i++) {
+            const uint8_t* px = src + 8*i;
+            REPORTER_ASSERT(r, dst[i] == pack(px[0], px[2], px[4], px[6]));
+        }
+        SkOpts::RGBA16_to_BGRA(dst, src, count);
+        for (int i = 0; i < count; i++) {
+            const uint8_t* px = src + 8*i;
+            REPORTER_ASSERT(r, dst[i] == pack(px[4], px[2], px[0], px[6]));
+        }
+        SkOpts::RGBA16_to_rgbA(dst, src, count);
+        for (int i = 0; i < count; i++) {
+            const uint8_t* px = src + 8*i;
+            uint32_t expected = pack(px[0], px[2], px[4], px[6]);
+            SkOpts::RGBA_to_rgbA(&expected, &expected, 1);
+            REPORTER_ASSERT(r, dst[i] == expected);
+        }
+        SkOpts::RGBA16_to_bgrA(dst, src, count);
+        for (int i = 0; i < count; i++) {
+            const uint8_t* px = src + 8*i;
+            uint32_t expected = pack(px[0], px[2], px[4], px[6]);
+            SkOpts::RGBA_to_bgrA(&expected, &expected, 1);
+            REPORTER_ASSERT(r, dst[i] == expected);
+        }
+    }
+}
+
+DEF_TEST(SwizzleOpts_index8, r) {
+    const int kCount = 53;
+    uint8_t src[kCount];
+    uint32_t table[256], dst[kCount];
+    SkRandom rand;
+    for (uint8_t& index : src) {
+        index = rand.nextU() >> 24;
+    }
+    for (uint32_t& color : table) {
+        color = rand.nextU();
+    }
+
+    for (int count = 0; count <= kCount; count++) {
+        SkOpts::index8_to_8888(dst, src, count, table);
+        for (int i = 0; i < count; i++) {
+            REPORTER_ASSERT(r, dst[i] == table[src[i]]);
+        }
+    }
+}
+
+DEF_TEST(SwizzleOpts_gather, r) {
+    const int kCount = 53;
+    const int kMaxBpp = 8;
+    const int kMaxStride = 7*kMaxBpp;
+    uint8_t src[kCount*kMaxStride], dst[kCount*kMaxBpp];
+    SkRandom rand;
+    for (uint8_t& byte : src) {
+        byte = rand.nextU() >> 24;
+    }
+
+    for (int bpp : { 1, 2, 3, 4, 6, 8 }) {
+        for (int sample : { 1, 2, 3, 4, 7 }) {
+            const int stride = sample * bpp;
+            for (int count = 0; count <= kCount; count++) {
+                SkOpts::gather_pixels(dst, src, count, bpp, stride);
+                for (int i = 0; i < count; i++) {
+                    REPORTER_ASSERT(r, 0 == memcmp(dst + i*bpp, src + i*stride, bpp));
+                }
+            }
+        }
+    }
+}
+
+// A sampled row should be every sampleX'th pixel of the full row, however the swizzler gets there.
+DEF_TEST(Swizzler_sampled, r) {
+    const struct {
+        SkEncodedInfo::Color fColor;
+        SkEncodedInfo::Alpha fAlpha;
+        int                  fBits;
+    } encodings[] = {
+        { SkEncodedInfo::kGray_Color,          SkEncodedInfo::kOpaque_Alpha,   8 },
+        { SkEncodedInfo::kGrayAlpha_Color,     SkEncodedInfo::kUnpremul_Alpha, 8 },
+        { SkEncodedInfo::kPalette_Color,       SkEncodedInfo::kOpaque_Alpha,   8 },
+        { SkEncodedInfo::kRGB_Color,           SkEncodedInfo::kOpaque_Alpha,   8 },
+        { SkEncodedInfo::kRGB_Color,           SkEncodedInfo::kOpaque_Alpha,   16 },
+        { SkEncodedInfo::kRGBA_Color,          SkEncodedInfo::kUnpremul_Alpha, 8 },
+        { SkEncodedInfo::kRGBA_Color,          SkEncodedInfo::kUnpremul_Alpha, 16 },
+        { SkEncodedInfo::kBGRA_Color,          SkEncodedInfo::kUnpremul_Alpha, 8 },
+        { SkEncodedInfo::kInvertedCMYK_Color,  SkEncodedInfo::kOpaque_Alpha,   8 },
+    };
+
+    const int kWidth = 67;
+    uint8_t src[kWidth * 8];
+    SkPMColor ctable[256];
+    SkRandom rand;
+    for (uint8_t& byte : src) {
+        byte = rand.nextU() >> 24;
+    }
+    for (SkPMColor& color : ctable) {
+        color = rand.nextU() | 0xFF000000;
+    }
+
+    for (const auto& e : encodings) {
+        const SkEncodedInfo encodedInfo = SkEncodedInfo::Make(e.fColor, e.fAlpha, e.fBits);
+        for (SkColorType ct : { kRGBA_8888_SkColorType, kBGRA_8888_SkColorType }) {
+            for (SkAlphaType at : { kPremul_SkAlphaType, kUnpremul_SkAlphaType }) {
+                const SkImageInfo dstInfo = SkImageInfo::Make(kWidth, 1, ct, at);
+                uint32_t full[kWidth], sampled[kWidth];
+
+                std::unique_ptr<SkSwizzler> swizzler(SkSwizzler::CreateSwizzler(
+                        encodedInfo, ctable, dstInfo, SkCodec::Options()));
+                REPORTER_ASSERT(r, swizzler);
+                if (!swizzler) {
+                    continue;
+                }
+                swizzler->swizzle(full, src);
+
+                for (int sampleX : { 2, 3, 4, 7 }) {
+                    const int width = swizzler->setSampleX(sampleX);
+                    REPORTER_ASSERT(r, width == get_scaled_dimension(kWidth, sampleX));
+                    swizzler->swizzle(sampled, src);
+                    for (int x = 0; x < width; x++) {
+                        const int srcX = get_start_coord(sampleX) + x * sampleX;
+                        REPORTER_ASSERT(r, sampled[x] == full[srcX]);
+                    }
+                }
+            }
+        }
+    }
+}
+
 DEF_TEST(PublicSwizzleOpts, r) {
     uint32_t dst, src;
 
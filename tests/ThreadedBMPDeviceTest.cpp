@@ -0,0 +1,140 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+
+#include "SkBlurMaskFilter.h"
+#include "SkCanvas.h"
+#include "SkGradientShader.h"
+#include "SkPath.h"
+#include "SkRRect.h"
+#include "SkRandom.h"
+#include "SkSurface.h"
+#include "SkSurfacePriv.h"
+#include "SkTaskGroup.h"
+
+static void draw_scene(SkCanvas* canvas) {
+    SkRandom rand;
+    SkPaint paint;
+
+    canvas->drawColor(SK_ColorWHITE);
+
+    // Antialiased and aliased geometry straddling many tile boundaries.
+    for (int i = 0; i < 40; i++) {
+        paint.setColor(rand.nextU() | 0xFF000000);
+        paint.setAntiAlias(rand.nextBool());
+        paint.setStyle(rand.nextBool() ? SkPaint::kFill_Style : SkPaint::kStroke_Style);
+        paint.setStrokeWidth(rand.nextRangeF(0, 6));
+        const SkRect r = SkRect::MakeXYWH(rand.nextRangeF(-20, 300), rand.nextRangeF(-20, 300),
+                                          rand.nextRangeF(1, 120), rand.nextRangeF(1, 120));
+        switch (i % 4) {
+            case 0: canvas->drawRect(r, paint);                                 break;
+            case 1: canvas->drawOval(r, paint);                                 break;
+            case 2: canvas->drawRRect(SkRRect::MakeRectXY(r, 7, 9), paint);     break;
+            case 3: canvas->drawLine(r.fLeft, r.fTop, r.fRight, r.fBottom, paint); break;
+        }
+    }
+
+    // Antialiased hairlines and points, which blit pixel pairs that may straddle a tile seam.
+    SkPaint hairline;
+    hairline.setAntiAlias(true);
+    hairline.setStyle(SkPaint::kStroke_Style);
+    SkPoint points[32];
+    for (SkPoint& p : points) {
+        p.set(rand.nextRangeF(0, 256), rand.nextRangeF(0, 256));
+    }
+    canvas->drawPoints(SkCanvas::kPolygon_PointMode, SK_ARRAY_COUNT(points), points, hairline);
+    hairline.setStrokeWidth(3);
+    hairline.setAntiAlias(false);
+    canvas->drawPoints(SkCanvas::kPoints_PointMode, SK_ARRAY_COUNT(points), points, hairline);
+    // Single pixel points are written straight to the pixels, which must stay in each tile.
+    hairline.setStrokeWidth(0);
+    canvas->drawPoints(SkCanvas::kPoints_PointMode, SK_ARRAY_COUNT(points), points, hairline);
+
+    // Shaders, mask filters, and clipped, transformed paths.
+    canvas->save();
+    canvas->rotate(17);
+    canvas->clipRRect(SkRRect::MakeOval(SkRect::MakeXYWH(40, 10, 200, 240)), true);
+    SkPath path;
+    path.moveTo(20, 20);
+    path.cubicTo(300, 40, -60, 180, 250, 260);
+    path.close();
+    const SkPoint pts[] = {{0, 0}, {256, 256}};
+    const SkColor colors[] = {SK_ColorBLUE, SK_ColorYELLOW};
+    SkPaint shaded;
+    shaded.setAntiAlias(true);
+    shaded.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2,
+                                                  SkShader::kClamp_TileMode));
+    canvas->drawPath(path, shaded);
+    canvas->restore();
+
+    SkPaint blurred;
+    blurred.setColor(0x8000FF00);
+    blurred.setMaskFilter(SkBlurMaskFilter::Make(kNormal_SkBlurStyle, 6));
+    canvas->drawCircle(128, 128, 60, blurred);
+
+    // A layer, drawn back through the threaded device.
+    SkPaint layerPaint;
+    layerPaint.setAlpha(0x80);
+    canvas->saveLayer(nullptr, &layerPaint);
+    canvas->drawCircle(200, 60, 50, paint);
+    canvas->restore();
+
+    // Mutable pixels must be captured as they were when drawn.
+    SkBitmap bm;
+    bm.allocN32Pixels(40, 40);
+    bm.eraseColor(SK_ColorRED);
+    canvas->drawBitmap(bm, 10, 200);
+    bm.eraseColor(SK_ColorGREEN);
+    canvas->drawBitmap(bm, 60, 200);
+
+    SkPaint text;
+    text.setAntiAlias(true);
+    text.setTextSize(24);
+    canvas->drawText("threaded", 8, 20, 150, text);
+}
+
+static void test_threaded_matches_raster(skiatest::Reporter* r, int tileCount) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(256, 256);
+
+    auto expected = SkSurface::MakeRaster(info);
+    auto threaded = SkMakeThreadedRasterSurface(info, tileCount);
+    REPORTER_ASSERT(r, expected && threaded);
+
+    draw_scene(expected->getCanvas());
+    draw_scene(threaded->getCanvas());
+
+    SkBitmap a, b;
+    a.allocPixels(info);
+    b.allocPixels(info);
+    REPORTER_ASSERT(r, expected->getCanvas()->readPixels(&a, 0, 0));
+    REPORTER_ASSERT(r, threaded->getCanvas()->readPixels(&b, 0, 0));
+    REPORTER_ASSERT(r, 0 == memcmp(a.getPixels(), b.getPixels(), a.getSafeSize()));
+}
+
+DEF_TEST(ThreadedBMPDevice, r) {
+    for (int tileCount : { 0, 1, 3, 16, 256 }) {
+        test_threaded_matches_raster(r, tileCount);
+    }
+}
+
+DEF_TEST(ThreadedBMPDevice_Snapshot, r) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(64, 64);
+    auto surface = SkMakeThreadedRasterSurface(info, 4);
+
+    surface->getCanvas()->clear(SK_ColorBLUE);
+    sk_sp<SkImage> blue = surface->makeImageSnapshot();
+    surface->getCanvas()->clear(SK_ColorRED);
+    sk_sp<SkImage> red = surface->makeImageSnapshot();
+
+    SkPMColor pixel;
+    const SkImageInfo onePixel = SkImageInfo::MakeN32Premul(1, 1);
+    REPORTER_ASSERT(r, blue->readPixels(onePixel, &pixel, 4, 32, 63));
+    REPORTER_ASSERT(r, SkPreMultiplyColor(SK_ColorBLUE) == pixel);
+    REPORTER_ASSERT(r, red->readPixels(onePixel, &pixel, 4, 32, 63));
+    REPORTER_ASSERT(r, SkPreMultiplyColor(SK_ColorRED) == pixel);
+}
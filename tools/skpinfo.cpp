@@ -159,6 +159,24 @@ int tool_main(int argc, char** argv) {
                 SkDebugf("SK_PICT_BUFFER_SIZE_TAG %d\n", chunkSize);
             }
             break;
+        case SK_PICT_OP_INDEX_TAG:
+            if (FLAGS_tags && !FLAGS_quiet) {
+                SkDebugf("SK_PICT_OP_INDEX_TAG %d\n", chunkSize);
+            }
+            // The chunk size is the number of entries.
+            if (chunkSize > (totStreamSize - curPos) / sizeof(SkPictureData::OpIndexEntry)) {
+                if (!FLAGS_quiet) {
+                    SkDebugf("truncated file\n");
+                }
+                return kTruncatedFile;
+            }
+            chunkSize *= sizeof(SkPictureData::OpIndexEntry);
+            break;
+        case SK_PICT_PADDING_TAG:
+            if (FLAGS_tags && !FLAGS_quiet) {
+                SkDebugf("SK_PICT_PADDING_TAG %d\n", chunkSize);
+            }
+            break;
         default:
             if (!FLAGS_quiet) {
                 SkDebugf("Unknown tag %d\n", chunkSize);